@@ -0,0 +1,127 @@
+// GrlRPC Serializer Benchmark
+// Reflection-based ISerializer vs the type-specific user serializers, per
+// format and message
+//
+//   serializer_benchmark [--iterations N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "serialization_framework.h"
+#include "user_types.h"
+
+namespace {
+
+struct Result {
+    double encode_ns = 0;
+    double decode_ns = 0;
+    size_t bytes = 0;
+};
+
+template<typename Encode, typename Decode>
+Result Measure(size_t iterations, Encode encode, Decode decode) {
+    using Clock = std::chrono::steady_clock;
+    Result result;
+    std::string buffer;
+    if (!encode(buffer) || !decode(buffer)) {
+        std::cerr << "round trip failed" << std::endl;
+        std::exit(1);
+    }
+    result.bytes = buffer.size();
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        encode(buffer);
+    }
+    Clock::time_point middle = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        decode(buffer);
+    }
+    Clock::time_point end = Clock::now();
+    result.encode_ns = std::chrono::duration<double, std::nano>(middle - start).count() / iterations;
+    result.decode_ns = std::chrono::duration<double, std::nano>(end - middle).count() / iterations;
+    return result;
+}
+
+void Print(const char* message, const char* format, const char* path, const Result& result) {
+    std::printf("%-22s %-7s %-8s %10.0f %10.0f %8zu\n", message, format, path,
+                result.encode_ns, result.decode_ns, result.bytes);
+}
+
+// Both paths over the same object; the generic one goes through the
+// descriptor exactly as SerializerHandle does when no typed serializer exists
+template<typename T>
+void Compare(const char* message, const T& obj, size_t iterations) {
+    const grlrpc::MessageDescriptor* desc = grlrpc::ReflectionRegistry::Instance().GetDescriptor(
+        grlrpc::SerializerFactory::GetDemangled<T>());
+    for (const char* format : {"json", "binary"}) {
+        grlrpc::ISerializer* generic = grlrpc::SerializerRegistry::Instance().GetSerializer(format);
+        grlrpc::ITypeSerializer<T>* typed =
+            grlrpc::SerializerRegistry::Instance().GetTypeSerializer<T>(format);
+        T out;
+        if (desc && generic) {
+            Print(message, format, "generic", Measure(iterations,
+                [&](std::string& buffer) { return generic->Serialize(&obj, *desc, buffer); },
+                [&](const std::string& buffer) { return generic->Deserialize(buffer, &out, *desc); }));
+        }
+        Print(message, format, "typed", Measure(iterations,
+            [&](std::string& buffer) { return typed->Serialize(obj, buffer); },
+            [&](const std::string& buffer) { return typed->Deserialize(buffer, out); }));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 200000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--iterations") == 0) {
+            iterations = std::strtoull(argv[i + 1], nullptr, 10);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--iterations N]" << std::endl;
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    grlrpc::RegisterBuiltinSerializers();
+    grlrpc::RegisterUserTypes();
+
+    grlrpc::GetUserRequest get;
+    get.user_id = 123456789;
+
+    grlrpc::GetUserResponse user;
+    user.user_id = 123456789;
+    user.found = true;
+    user.name = "user_123456789";
+    user.email = "user_123456789@example.com";
+    user.age = 34;
+    user.created_at_ms = 1700000000000;
+    user.updated_at_ms = 1700000123456;
+
+    grlrpc::GetUserResponse with_avatar = user;
+    with_avatar.avatar.assign(4096, '\x5a');
+
+    grlrpc::CreateUserRequest create;
+    create.name = user.name;
+    create.email = user.email;
+    create.age = user.age;
+
+    grlrpc::BatchGetUsersResponse batch;
+    batch.users.assign(100, user);
+
+    std::printf("%-22s %-7s %-8s %10s %10s %8s\n", "message", "format", "path",
+                "encode ns", "decode ns", "bytes");
+    Compare("GetUserRequest", get, iterations);
+    Compare("GetUserResponse", user, iterations);
+    Compare("GetUserResponse+4KB", with_avatar, iterations / 10);
+    Compare("CreateUserRequest", create, iterations);
+    // No descriptor: only the typed path exists
+    Compare("BatchGetUsers x100", batch, iterations / 100);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// GrlRPC User Store Memory Benchmark
+// Resident memory per user after bulk creation, with the store's own
+// accounting of where it goes
+//
+//   user_store_memory_benchmark [--users N]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "user_store.h"
+
+namespace {
+
+// Linux only: resident set size from /proc
+size_t ResidentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    statm >> pages >> resident;
+    return resident * 4096;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t users = 1000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--users") == 0) {
+            users = std::strtoull(argv[i + 1], nullptr, 10);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--users N]" << std::endl;
+            return 1;
+        }
+    }
+    if (users == 0) {
+        users = 1;
+    }
+
+    // A handful of providers cover most addresses
+    const char* domains[] = {"@gmail.com", "@yahoo.com", "@outlook.com", "@hotmail.com",
+                             "@icloud.com", "@example.org", "@mail.example.net", "@proton.me"};
+
+    size_t before = ResidentBytes();
+    grlrpc::UserStore store(16, 1024);
+    grlrpc::CreateUserRequest create;
+    for (size_t i = 0; i < users; ++i) {
+        create.name = "user_" + std::to_string(i);
+        create.email = create.name + domains[i % (sizeof(domains) / sizeof(domains[0]))];
+        create.age = static_cast<int32_t>(18 + i % 60);
+        uint64_t id = 0;
+        store.Create(create, 1700000000000 + static_cast<int64_t>(i), id);
+    }
+    size_t after = ResidentBytes();
+
+    grlrpc::UserStoreMemory usage = store.GetMemoryUsage();
+    std::printf("users                 %12zu\n", store.Size());
+    std::printf("rss delta (bytes)     %12zu  %6.1f per user\n", after - before,
+                static_cast<double>(after - before) / users);
+    std::printf("records (bytes)       %12zu  %6.1f per user\n", usage.record_bytes,
+                static_cast<double>(usage.record_bytes) / users);
+    std::printf("arena slabs (bytes)   %12zu\n", usage.arena_bytes);
+    std::printf("slot tables (bytes)   %12zu\n", usage.table_bytes);
+    std::printf("interned (bytes)      %12zu  %zu strings\n", usage.interned_bytes,
+                usage.interned_strings);
+    return 0;
+}
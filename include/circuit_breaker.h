@@ -0,0 +1,188 @@
+// GrlRPC Circuit Breaker Header
+// Per-endpoint and per-method circuit breakers for GrlRpcClient
+
+#ifndef GRLRPC_CIRCUIT_BREAKER_H
+#define GRLRPC_CIRCUIT_BREAKER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// Circuit Breaker Configuration
+// ============================================================================
+
+struct CircuitBreakerConfig {
+    // Sliding window covered by the statistics, split into equal buckets
+    std::chrono::milliseconds window{10000};
+    size_t bucket_count = 10;
+
+    // No decision is taken before the window holds this many calls
+    uint32_t min_requests = 20;
+
+    // Trip when either rate reaches its threshold
+    double failure_rate_threshold = 0.5;
+    double slow_call_rate_threshold = 0.8;
+    std::chrono::milliseconds slow_call_duration{1000};
+
+    // Time spent open before probing
+    std::chrono::milliseconds open_duration{5000};
+
+    // Half-open probe rate limiting
+    uint32_t half_open_max_probes = 1;
+    std::chrono::milliseconds half_open_probe_interval{100};
+    uint32_t half_open_success_threshold = 3;
+};
+
+enum class CircuitState : uint8_t {
+    CLOSED = 0,
+    OPEN = 1,
+    HALF_OPEN = 2
+};
+
+// ============================================================================
+// SlidingWindowStats
+// Lock-free bucketed counters of calls, failures and slow calls
+// ============================================================================
+
+struct WindowSnapshot {
+    uint64_t total = 0;
+    uint64_t failures = 0;
+    uint64_t slow = 0;
+
+    double FailureRate() const { return total ? static_cast<double>(failures) / total : 0.0; }
+    double SlowRate() const { return total ? static_cast<double>(slow) / total : 0.0; }
+};
+
+class SlidingWindowStats {
+public:
+    SlidingWindowStats(std::chrono::milliseconds window, size_t bucket_count);
+
+    void Record(bool failure, bool slow, RpcClock::time_point now);
+    WindowSnapshot Snapshot(RpcClock::time_point now) const;
+    void Reset();
+
+private:
+    struct alignas(64) Bucket {
+        std::atomic<int64_t> epoch{-1};
+        std::atomic<uint32_t> total{0};
+        std::atomic<uint32_t> failures{0};
+        std::atomic<uint32_t> slow{0};
+    };
+
+    int64_t EpochOf(RpcClock::time_point now) const;
+
+    int64_t bucket_width_ns_;
+    std::vector<Bucket> buckets_;
+};
+
+// ============================================================================
+// CircuitBreaker
+// ============================================================================
+
+class CircuitBreaker {
+public:
+    explicit CircuitBreaker(const CircuitBreakerConfig& config = CircuitBreakerConfig());
+
+    /**
+     * @brief Admit or reject a call before it is sent
+     * @return false if the call must fail fast with RpcStatus::CIRCUIT_OPEN
+     *
+     * In the half-open state only a limited number of probes are let
+     * through, spaced by half_open_probe_interval.
+     */
+    bool AllowRequest(RpcClock::time_point now = RpcClock::now());
+
+    /**
+     * @brief Report the outcome of a call that AllowRequest() admitted
+     */
+    void RecordResult(RpcStatus status, std::chrono::nanoseconds latency,
+                      RpcClock::time_point now = RpcClock::now());
+
+    /**
+     * @brief Return a half-open probe slot for a call that was admitted but never sent
+     */
+    void ReleaseProbe();
+
+    CircuitState GetState() const {
+        return static_cast<CircuitState>(state_.load(std::memory_order_acquire));
+    }
+
+    WindowSnapshot GetStats(RpcClock::time_point now = RpcClock::now()) const {
+        return stats_.Snapshot(now);
+    }
+
+private:
+    static int64_t ToNanos(RpcClock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    bool TryTransition(CircuitState from, CircuitState to);
+    void Trip(RpcClock::time_point now);
+    void DecrementProbes();
+
+    CircuitBreakerConfig config_;
+    SlidingWindowStats stats_;
+    std::atomic<uint8_t> state_{static_cast<uint8_t>(CircuitState::CLOSED)};
+    std::atomic<int64_t> open_until_ns_{0};
+    std::atomic<int64_t> last_probe_ns_{0};
+    std::atomic<uint32_t> probes_in_flight_{0};
+    std::atomic<uint32_t> probe_successes_{0};
+};
+
+/**
+ * @brief Whether a status says anything about backend health
+ *
+ * Caller mistakes (bad request, unknown method) never trip a breaker.
+ */
+bool IsBreakerFailure(RpcStatus status);
+
+std::string CircuitStateToString(CircuitState state);
+
+// ============================================================================
+// CircuitBreakerRegistry
+// Owns one breaker per endpoint and one per (endpoint, method) pair
+// ============================================================================
+
+class CircuitBreakerRegistry {
+public:
+    explicit CircuitBreakerRegistry(const CircuitBreakerConfig& config = CircuitBreakerConfig())
+        : config_(config) {}
+
+    // Breaker pointers stay valid for the registry's lifetime, so callers may cache them
+    CircuitBreaker* GetEndpointBreaker(const std::string& endpoint);
+    CircuitBreaker* GetMethodBreaker(const std::string& endpoint, const std::string& method);
+
+    /**
+     * @brief Check both the endpoint and the method breaker
+     */
+    bool AllowRequest(const std::string& endpoint, const std::string& method,
+                      RpcClock::time_point now = RpcClock::now());
+
+    /**
+     * @brief Feed a call outcome into both breakers
+     */
+    void RecordResult(const std::string& endpoint, const std::string& method,
+                      RpcStatus status, std::chrono::nanoseconds latency,
+                      RpcClock::time_point now = RpcClock::now());
+
+private:
+    CircuitBreaker* GetOrCreate(const std::string& key);
+
+    CircuitBreakerConfig config_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<CircuitBreaker>> breakers_;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_CIRCUIT_BREAKER_H
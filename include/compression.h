@@ -0,0 +1,125 @@
+// GrlRPC Payload Compression Header
+// Pluggable compressors for the MessageCodec compression stage.
+// LZ4 and zstd are compiled in when GRLRPC_HAVE_LZ4 / GRLRPC_HAVE_ZSTD are set.
+
+#ifndef GRLRPC_COMPRESSION_H
+#define GRLRPC_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace grlrpc {
+
+// ============================================================================
+// ICompressor Interface
+// ============================================================================
+
+class ICompressor {
+public:
+    virtual ~ICompressor() = default;
+
+    /**
+     * @brief Compress `input`, appending the result to `output`
+     *
+     * Implementations keep their contexts per thread, so the only buffer
+     * touched per message is `output`, whose capacity callers reuse.
+     */
+    virtual bool Compress(std::string_view input, std::string& output) = 0;
+
+    /**
+     * @brief Decompress `input`, appending exactly `original_size` bytes to `output`
+     * @param original_size Uncompressed size, carried on the wire; decoding
+     *        fails if the data does not expand to exactly this size
+     */
+    virtual bool Decompress(std::string_view input, size_t original_size, std::string& output) = 0;
+
+    // Name used in the connection handshake (e.g. "lz4", "zstd")
+    virtual std::string GetName() const = 0;
+};
+
+// ============================================================================
+// CompressorRegistry Singleton
+// ============================================================================
+
+class CompressorRegistry {
+public:
+    static CompressorRegistry& Instance() {
+        static CompressorRegistry instance;
+        return instance;
+    }
+
+    void RegisterCompressor(const std::string& name, std::unique_ptr<ICompressor> compressor);
+
+    /**
+     * @brief Look up a compressor; "none" and unknown names return nullptr
+     */
+    ICompressor* GetCompressor(const std::string& name) const;
+
+    /**
+     * @brief Names to offer in a ConnectionHello, in registration order, ending with "none"
+     */
+    std::vector<std::string> GetAvailableNames() const;
+
+private:
+    CompressorRegistry();
+    CompressorRegistry(const CompressorRegistry&) = delete;
+    CompressorRegistry& operator=(const CompressorRegistry&) = delete;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<ICompressor>> compressors_;
+    std::vector<std::string> order_;
+};
+
+// ============================================================================
+// Compression Policy
+// ============================================================================
+
+/**
+ * @brief Heuristic check for payloads that will not shrink
+ *
+ * Recognizes the magic numbers of common compressed formats (gzip, zstd,
+ * LZ4 frame, zip, PNG, JPEG, GIF, WebP) and otherwise samples the leading
+ * bytes: data using nearly every byte value is treated as incompressible.
+ */
+bool LooksCompressed(std::string_view payload);
+
+struct CompressionPolicy {
+    ICompressor* compressor = nullptr;
+    // Payloads smaller than this are sent as-is
+    size_t min_bytes = 1024;
+
+    bool ShouldCompress(std::string_view payload) const {
+        return compressor != nullptr && payload.size() >= min_bytes && !LooksCompressed(payload);
+    }
+};
+
+#ifdef GRLRPC_HAVE_ZSTD
+/**
+ * @brief Train a zstd dictionary from sample payloads
+ * @return Dictionary bytes, empty on failure (too few or too uniform samples)
+ */
+std::string TrainZstdDictionary(const std::vector<std::string>& samples, size_t dictionary_size);
+
+/**
+ * @brief Create a zstd compressor, optionally bound to a trained dictionary
+ *
+ * Dictionary compressors are registered under their own name (e.g.
+ * "zstd-dict-users") so both peers must have loaded the same dictionary.
+ */
+std::unique_ptr<ICompressor> MakeZstdCompressor(int level = 3, const std::string& dictionary = "",
+                                                const std::string& name = "zstd");
+#endif
+
+#ifdef GRLRPC_HAVE_LZ4
+std::unique_ptr<ICompressor> MakeLz4Compressor(int acceleration = 1);
+#endif
+
+} // namespace grlrpc
+
+#endif // GRLRPC_COMPRESSION_H
@@ -0,0 +1,152 @@
+// GrlRPC Epoch Manager Header
+// Epoch-based reclamation for lock-free readers: readers pin the current
+// epoch, writers hand unlinked objects over and they are freed once no
+// pinned reader can still hold them
+
+#ifndef GRLRPC_EPOCH_MANAGER_H
+#define GRLRPC_EPOCH_MANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace grlrpc {
+
+/**
+ * @brief Deferred reclamation for data read without locks
+ *
+ * A reader pins before it follows shared pointers and unpins when done;
+ * pinning is a store to a per-thread slot and never waits. A writer that
+ * unlinks an object retires it instead of freeing it, onto a list of its
+ * own thread, without locking. Retired objects are freed after the global
+ * epoch has moved two steps past their retirement, which requires every
+ * reader pinned at the time to have unpinned. Each thread frees its own
+ * objects in retirement order; there is no order between threads.
+ *
+ * Collection is what takes the manager's lock, and a pinned thread defers
+ * it to its unpin: a writer that pins before taking its own locks never
+ * collects while holding them. A thread's slot is recycled when it exits,
+ * and whatever it still had retired is left for the other threads.
+ *
+ * A pin protects everything reachable after it was taken, for any thread:
+ * a reader may hand pointers to helper threads as long as its pin outlives
+ * their use.
+ */
+class EpochManager {
+private:
+    struct Participant;
+
+public:
+    /**
+     * @brief Scoped pin; destroy it on the thread that created it
+     */
+    class Guard {
+    public:
+        Guard() = default;
+        Guard(Guard&& other) noexcept : participant_(other.participant_) { other.participant_ = nullptr; }
+        Guard& operator=(Guard&& other) noexcept;
+        ~Guard() { Release(); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        friend class EpochManager;
+        explicit Guard(Participant* participant) : participant_(participant) {}
+        void Release();
+
+        Participant* participant_ = nullptr;
+    };
+
+    // A thread collects after this many retirements: at once if it is not
+    // pinned, otherwise when it unpins
+    static constexpr size_t kCollectInterval = 64;
+
+    EpochManager();
+    // Runs every pending reclaim; no reader may still be pinned
+    ~EpochManager();
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Pin the current epoch; pins of one thread nest
+     */
+    Guard Pin();
+
+    /**
+     * @brief Run `reclaim` once no reader pinned now can reach the object
+     *
+     * Call after the object has been unlinked. Reclaims usually run on the
+     * retiring thread, but those of exited threads run on whichever thread
+     * collects, under an internal lock: they must not retire, collect or pin.
+     */
+    void Retire(std::function<void()> reclaim);
+
+    /**
+     * @brief Advance the epoch if every pinned reader has caught up and run
+     *        the reclaims of this thread and of exited threads that became due
+     */
+    void Collect();
+
+    /**
+     * @brief Run every pending reclaim of every thread now; only when no
+     *        other thread can pin or retire (e.g. while the owner is being
+     *        destroyed)
+     */
+    void Drain();
+
+    uint64_t GetEpoch() const { return epoch_.load(std::memory_order_relaxed); }
+    size_t GetPendingCount() const;
+    // Slots ever handed out; exited threads' slots are reused
+    size_t GetParticipantCount() const;
+    uint64_t GetReclaimedCount() const { return reclaimed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> reclaim;
+    };
+
+    struct alignas(64) Participant {
+        explicit Participant(EpochManager& manager) : owner(manager) {}
+
+        std::atomic<uint64_t> epoch{0};   // pinned epoch, 0 = not pinned
+        EpochManager& owner;
+        // Owner thread only, or under the mutex once the slot is released
+        uint32_t depth = 0;
+        std::deque<Retired> retired;
+        size_t retired_since_collect = 0;
+        // Every retirement through this slot, for GetPendingCount()
+        std::atomic<uint64_t> retired_total{0};
+    };
+
+    // Per-thread participant cache; hands the slots back when the thread exits
+    struct ThreadCache;
+    static ThreadCache& LocalCache();
+
+    Participant& LocalParticipant();
+    // Collection by the owner of `self`; takes the mutex only to advance
+    void CollectFor(Participant& self);
+    // Advance if possible and return the epoch; the mutex is held
+    uint64_t AdvanceLocked();
+    // The owning thread has exited: recycle the slot, adopt its retirements
+    void ReleaseParticipant(Participant& participant);
+
+    const uint64_t id_;   // tells managers apart in the per-thread participant cache
+    std::atomic<uint64_t> epoch_{1};
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Participant>> participants_;
+    std::vector<Participant*> free_participants_;
+    std::deque<Retired> orphaned_;   // retired by threads that have exited
+    std::atomic<uint64_t> reclaimed_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_EPOCH_MANAGER_H
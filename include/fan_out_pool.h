@@ -0,0 +1,63 @@
+// GrlRPC Fan-Out Pool Header
+// Runs the independent parts of one request (e.g. the per-shard groups of
+// a multi-get) on several cores and returns when all are done
+
+#ifndef GRLRPC_FAN_OUT_POOL_H
+#define GRLRPC_FAN_OUT_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace grlrpc {
+
+class FanOutPool {
+public:
+    /**
+     * @param worker_count Helper threads; 0 runs everything on the caller
+     */
+    explicit FanOutPool(size_t worker_count);
+    ~FanOutPool();
+
+    FanOutPool(const FanOutPool&) = delete;
+    FanOutPool& operator=(const FanOutPool&) = delete;
+
+    /**
+     * @brief Call task(0) .. task(count - 1) and wait for all of them
+     *
+     * The caller claims tasks too, so a call never waits on a task nobody
+     * has started, even when every worker is busy with other callers.
+     * Concurrent calls share the workers.
+     */
+    void Run(size_t count, const std::function<void(size_t index)>& task);
+
+    size_t WorkerCount() const { return workers_.size(); }
+
+private:
+    struct Job {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        size_t next = 0;        // next index to claim
+        size_t completed = 0;
+        size_t workers = 0;     // workers currently inside the job
+    };
+
+    // Claim and run indexes until none are left; `lock` is held on entry and exit
+    void Work(Job& job, std::unique_lock<std::mutex>& lock);
+    void WorkerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable job_finished_;
+    std::deque<Job*> jobs_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_FAN_OUT_POOL_H
@@ -0,0 +1,175 @@
+// GrlRPC Frame Relay Header
+// Transparent proxy mode: frames received by a GrlRpcServer are relayed to
+// upstream GrlRpcClient connections without deserializing the payload
+
+#ifndef GRLRPC_FRAME_RELAY_H
+#define GRLRPC_FRAME_RELAY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// Writes a frame to the connection identified by the first argument
+using FrameSink = std::function<bool(uint64_t connection_id, const FrameView& frame)>;
+
+// Picks the upstream for a request from its header and (undecoded) payload
+using UpstreamSelector = std::function<size_t(const FrameHeader& header, std::string_view payload)>;
+
+enum class RelayResult {
+    FORWARDED,
+    INVALID_FRAME,
+    DEADLINE_EXCEEDED,
+    NO_UPSTREAM,
+    SEND_FAILED,
+    UNKNOWN_REQUEST,
+    MESSAGE_ABORTED   // a chunk of a chunked request that was already given up on
+};
+
+std::string RelayResultToString(RelayResult result);
+
+// ============================================================================
+// FrameRelay
+// ============================================================================
+
+struct FrameRelayConfig {
+    // Charged against the caller's deadline on top of the time spent queued here
+    std::chrono::milliseconds hop_cost{1};
+    // How long a request without a deadline may wait for its response
+    std::chrono::milliseconds route_timeout{30000};
+};
+
+class FrameRelay {
+public:
+    /**
+     * @param upstream_count Number of upstream connections
+     * @param upstream_sink Sends a request frame to upstream `connection_id`
+     * @param downstream_sink Sends a response frame back to inbound `connection_id`
+     * @param selector Chooses the upstream index for each request
+     */
+    FrameRelay(size_t upstream_count, FrameSink upstream_sink, FrameSink downstream_sink,
+               UpstreamSelector selector, const FrameRelayConfig& config = FrameRelayConfig());
+
+    /**
+     * @brief Relay a request frame received on an inbound connection
+     *
+     * The header is rewritten in place: the request id is replaced by a
+     * relay-unique id and the remaining deadline is reduced by the time the
+     * frame spent in this hop. The payload is never parsed.
+     *
+     * Chunks of one message (FRAME_FLAG_CHUNK) keep the relay id and
+     * upstream chosen for their first chunk. Only the first chunk's deadline
+     * is checked and rewritten; once it is relayed the rest always follow.
+     *
+     * A chunked message that is refused or dropped part way (first chunk
+     * rejected, a chunk failing to send, the route expiring) is remembered
+     * as aborted: its remaining chunks are MESSAGE_ABORTED up to and
+     * including the final one, so none of them reaches an upstream as a
+     * request of its own.
+     */
+    RelayResult OnInboundFrame(uint64_t inbound_connection, FrameView frame,
+                               RpcClock::time_point received_at);
+
+    /**
+     * @brief Relay a response frame from upstream back to the original caller
+     */
+    RelayResult OnUpstreamFrame(FrameView frame);
+
+    /**
+     * @brief Forget requests whose deadline (or route_timeout) is not after `now`
+     * @return Number of routes dropped
+     *
+     * Covers upstreams that drop a request or close without answering, and
+     * chunked requests whose caller stops sending chunks; aborted messages
+     * whose final chunk never comes are forgotten route_timeout after they
+     * were aborted. The caller's own
+     * deadline fires on its side; a response arriving later is
+     * UNKNOWN_REQUEST. Costs O(expired) plus the heap upkeep.
+     */
+    size_t ExpireBefore(RpcClock::time_point now);
+
+    size_t GetPendingCount() const;
+    // Chunked requests whose final chunk has not been relayed yet
+    size_t GetChunkRunCount() const;
+    // Aborted chunked requests whose final chunk has not arrived yet
+    size_t GetAbortedRunCount() const;
+
+private:
+    struct Route {
+        uint64_t inbound_connection;
+        uint64_t original_request_id;
+        RpcClock::time_point expires_at;
+    };
+    // Min-heap entry; entries of routes that completed are skipped when popped
+    using Expiry = std::pair<RpcClock::time_point, uint64_t>;
+
+    // Request id remapping is striped so loops relaying different requests
+    // rarely touch the same lock
+    static constexpr size_t kStripes = 16;
+    // Chunked request still being forwarded, keyed by inbound connection
+    // and original request id
+    struct ChunkRun {
+        uint64_t relay_id = 0;
+        size_t upstream = 0;
+    };
+    struct ChunkKey {
+        uint64_t inbound_connection;
+        uint64_t request_id;
+        bool operator==(const ChunkKey& other) const {
+            return inbound_connection == other.inbound_connection && request_id == other.request_id;
+        }
+    };
+    struct ChunkKeyHash {
+        size_t operator()(const ChunkKey& key) const {
+            return std::hash<uint64_t>()(key.inbound_connection * 0x9E3779B97F4A7C15ull ^ key.request_id);
+        }
+    };
+
+    struct AbortedExpiry {
+        RpcClock::time_point expires_at;
+        ChunkKey key;
+        bool operator>(const AbortedExpiry& other) const { return expires_at > other.expires_at; }
+    };
+
+    struct alignas(64) Stripe {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Route> routes;
+        std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiries;
+        std::unordered_map<ChunkKey, ChunkRun, ChunkKeyHash> chunk_runs;
+        // Chunked requests given up on, until their final chunk; same stripe
+        // as their run, by original request id
+        std::unordered_map<ChunkKey, RpcClock::time_point, ChunkKeyHash> aborted_runs;
+        std::priority_queue<AbortedExpiry, std::vector<AbortedExpiry>, std::greater<AbortedExpiry>>
+            aborted_expiries;
+    };
+
+    Stripe& StripeFor(uint64_t relay_id) { return stripes_[relay_id % kStripes]; }
+
+    // Drop the rest of the message `key`; the stripe of its request id is locked
+    void AbortRunLocked(Stripe& stripe, const ChunkKey& key, RpcClock::time_point now);
+
+    size_t upstream_count_;
+    FrameSink upstream_sink_;
+    FrameSink downstream_sink_;
+    UpstreamSelector selector_;
+    FrameRelayConfig config_;
+    std::atomic<uint64_t> next_relay_id_{1};
+    std::array<Stripe, kStripes> stripes_;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_FRAME_RELAY_H
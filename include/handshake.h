@@ -0,0 +1,144 @@
+// GrlRPC Connection Handshake Header
+// Client and server agree once per connection on protocol version,
+// serializer, compression and optional features
+
+#ifndef GRLRPC_HANDSHAKE_H
+#define GRLRPC_HANDSHAKE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "compression.h"
+#include "rpc_framework.h"
+#include "serialization_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// Protocol Features
+// ============================================================================
+
+enum ProtocolFeature : uint64_t {
+    FEATURE_NONE = 0,
+    FEATURE_ONE_WAY = 1ull << 0
+};
+
+// ============================================================================
+// Handshake Messages
+// ============================================================================
+
+/**
+ * @brief Capabilities offered by one side, most preferred first
+ *
+ * The client sends its hello as the first bytes on a new connection; the
+ * server answers with a HandshakeAccept carrying the agreed settings.
+ */
+struct ConnectionHello {
+    uint8_t min_version = FrameHeader::kMinVersion;
+    uint8_t max_version = FrameHeader::kVersion;
+    std::vector<std::string> serializers;
+    std::vector<std::string> compressions{"none"};
+    uint64_t features = FEATURE_NONE;
+};
+
+struct HandshakeAccept {
+    bool accepted = false;
+    uint8_t version = 0;
+    std::string serializer;
+    std::string compression;
+    uint64_t features = FEATURE_NONE;
+    std::string error_message;
+};
+
+enum class HandshakeParse {
+    OK,
+    INCOMPLETE,  // wait for more bytes
+    INVALID      // close the connection
+};
+
+class HandshakeCodec {
+public:
+    static void EncodeHello(const ConnectionHello& hello, std::string& out);
+    static HandshakeParse DecodeHello(const char* data, size_t length,
+                                      ConnectionHello& hello, size_t& consumed);
+
+    static void EncodeAccept(const HandshakeAccept& accept, std::string& out);
+    static HandshakeParse DecodeAccept(const char* data, size_t length,
+                                       HandshakeAccept& accept, size_t& consumed);
+};
+
+/**
+ * @brief Server-side negotiation
+ * @param server What the server supports, in its own preference order
+ * @param client The client's hello
+ *
+ * Picks the highest common protocol version and the first serializer and
+ * compression in the client's list that the server also supports. Features
+ * are the intersection of both sides.
+ */
+HandshakeAccept NegotiateConnection(const ConnectionHello& server, const ConnectionHello& client);
+
+// ============================================================================
+// ConnectionCodec
+// Settings bound to one connection after the handshake. Every message on
+// the connection uses these pointers directly, with no per-message lookup.
+// ============================================================================
+
+struct ConnectionCodec {
+    uint8_t version = FrameHeader::kVersion;
+    uint64_t features = FEATURE_NONE;
+    std::string serializer_name;
+    // Generic serializer under that name; null when only ITypeSerializer
+    // specializations are registered for it
+    ISerializer* serializer = nullptr;
+    std::string compression_name;
+    // Null when the connection agreed on "none"
+    ICompressor* compressor = nullptr;
+    size_t compression_threshold = 1024;
+
+    CompressionPolicy GetCompressionPolicy() const {
+        CompressionPolicy policy;
+        policy.compressor = compressor;
+        policy.min_bytes = compression_threshold;
+        return policy;
+    }
+
+    bool HasFeature(ProtocolFeature feature) const { return (features & feature) != 0; }
+
+    /**
+     * @brief Resolve the agreed settings against the registries, once
+     * @return false if the handshake was rejected
+     */
+    bool Bind(const HandshakeAccept& accept);
+
+    /**
+     * @brief Frame a message for this connection
+     *
+     * Stamps the agreed version and compresses the payload when the bound
+     * policy allows. `scratch` holds the compressed payload; reusing it
+     * across calls keeps the stage allocation-free.
+     */
+    void EncodeFrame(FrameHeader header, std::string_view payload, std::string& out,
+                     std::string& scratch) const;
+
+    /**
+     * @brief Read one complete frame received on this connection
+     * @param payload The message payload, inside `data` or, when it arrived
+     *        compressed, inside `scratch`
+     * @return false for a frame in another version than the agreed one, a
+     *         compressed frame on a connection without a compressor, or a
+     *         payload that does not decompress to at most `max_size` bytes
+     *
+     * On success FRAME_FLAG_COMPRESSED is cleared and payload_length is the
+     * size of `payload`.
+     */
+    bool DecodeFrame(const char* data, size_t length, size_t max_size, FrameHeader& header,
+                     std::string_view& payload, std::string& scratch) const;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_HANDSHAKE_H
@@ -0,0 +1,131 @@
+// GrlRPC HTTP Gateway Header
+// HTTP/1.1 JSON front end: POST /Service/Method is dispatched through the
+// same MethodTable as binary requests, with bodies in the "json" format
+
+#ifndef GRLRPC_HTTP_GATEWAY_H
+#define GRLRPC_HTTP_GATEWAY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// HttpRequestView
+// Every field is a view into the connection's receive buffer; nothing is
+// copied or allocated while parsing
+// ============================================================================
+
+struct HttpHeader {
+    std::string_view name;
+    std::string_view value;
+};
+
+struct HttpRequestView {
+    static constexpr size_t kMaxHeaders = 32;
+
+    std::string_view method;
+    std::string_view target;
+    int version_minor = 1;
+    std::array<HttpHeader, kMaxHeaders> headers;
+    size_t header_count = 0;
+    std::string_view body;
+    bool keep_alive = true;
+
+    /**
+     * @brief Case-insensitive header lookup
+     * @return Empty view if the header is absent
+     */
+    std::string_view GetHeader(std::string_view name) const;
+};
+
+enum class HttpParseStatus {
+    COMPLETE,
+    INCOMPLETE,      // need more bytes
+    BAD_REQUEST,     // 400, connection must be closed
+    UNSUPPORTED,     // 501, e.g. chunked request bodies
+    TOO_LARGE        // 413/431, headers or body above the configured limit
+};
+
+// ============================================================================
+// HttpRequestParser
+// ============================================================================
+
+class HttpRequestParser {
+public:
+    explicit HttpRequestParser(size_t max_header_bytes = 8 * 1024,
+                               size_t max_body_bytes = 4 * 1024 * 1024)
+        : max_header_bytes_(max_header_bytes), max_body_bytes_(max_body_bytes) {}
+
+    /**
+     * @brief Parse the request at the start of `buffer`
+     * @param buffer Unconsumed bytes of the connection, starting at a request
+     * @param consumed Set to the request's total size on COMPLETE
+     *
+     * Incremental: after INCOMPLETE, call again with the same (grown) buffer;
+     * bytes already scanned for the end of the headers are not rescanned.
+     * With pipelining, call again on buffer.substr(consumed).
+     */
+    HttpParseStatus Parse(std::string_view buffer, HttpRequestView& request, size_t& consumed);
+
+    void Reset() {
+        scanned_ = 0;
+        header_end_ = 0;
+        content_length_ = 0;
+    }
+
+private:
+    HttpParseStatus ParseHead(std::string_view head, HttpRequestView& request,
+                              size_t& content_length);
+
+    size_t max_header_bytes_;
+    size_t max_body_bytes_;
+    size_t scanned_ = 0;      // prefix known not to contain the header terminator
+    size_t header_end_ = 0;   // offset of the body once headers are complete
+    size_t content_length_ = 0;
+};
+
+// ============================================================================
+// HttpGatewayConnection
+// Per-connection state; plugs into the connection's read callback
+// ============================================================================
+
+class HttpGatewayConnection {
+public:
+    /**
+     * @param methods Dispatch table shared with the binary protocol
+     * @param serializer_name Serializer handed to handlers for HTTP bodies
+     */
+    explicit HttpGatewayConnection(const MethodTable& methods,
+                                   std::string serializer_name = "json");
+
+    /**
+     * @brief Handle every complete request in `buffer`
+     * @param output Responses are appended in request order (pipelining)
+     * @param close_connection Set when the connection must be closed after
+     *        `output` has been written
+     * @return Number of bytes consumed from `buffer`
+     */
+    size_t OnData(std::string_view buffer, std::string& output, bool& close_connection);
+
+private:
+    void Dispatch(const HttpRequestView& request, std::string& output);
+
+    const MethodTable& methods_;
+    std::string serializer_name_;
+    HttpRequestParser parser_;
+};
+
+/**
+ * @brief Map an RPC status to the HTTP status code returned by the gateway
+ */
+int HttpStatusFromRpcStatus(RpcStatus status);
+
+} // namespace grlrpc
+
+#endif // GRLRPC_HTTP_GATEWAY_H
@@ -0,0 +1,89 @@
+// GrlRPC Inline Watchdog Header
+// Runs inline-safe handlers directly on the IO loop thread and flags any
+// that exceed their time budget
+
+#ifndef GRLRPC_INLINE_WATCHDOG_H
+#define GRLRPC_INLINE_WATCHDOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// InlineWatchdog
+// ============================================================================
+
+struct InlineOverrun {
+    const MethodEntry* method = nullptr;
+    std::chrono::nanoseconds elapsed{0};
+    // True when reported by Scan() while the handler had not yet returned
+    bool still_running = false;
+};
+
+/**
+ * @brief Called once per overrunning inline call, from the loop thread or
+ *        from whichever thread calls Scan(); keep it cheap (log, metric)
+ */
+using InlineOverrunCallback = std::function<void(const InlineOverrun& overrun)>;
+
+/**
+ * @brief Dispatch side of MethodOptions::inline_safe
+ *
+ * The IO loop looks up the MethodEntry for a decoded request; when
+ * options.inline_safe is set it calls Run() and writes the response in the
+ * same loop iteration, otherwise it hands the request to the worker pool.
+ * Each loop owns one slot, so Run() itself touches no shared state.
+ *
+ * An overrun is reported when the handler returns late, or earlier by
+ * Scan() if it is still running, which catches handlers that block the
+ * loop outright. Call Scan() periodically from a timer or a monitor thread.
+ */
+class InlineWatchdog {
+public:
+    InlineWatchdog(size_t loop_count, InlineOverrunCallback on_overrun);
+
+    /**
+     * @brief Run `entry`'s handler on the calling loop thread
+     * @param loop_index Index of the calling IO loop, in [0, loop_count)
+     */
+    RpcStatus Run(size_t loop_index, const MethodEntry& entry,
+                  const RpcRequestData& request, RpcResponseData& response);
+
+    // Bracket an inline handler explicitly; Run() is Enter + handler + Exit
+    void Enter(size_t loop_index, const MethodEntry& entry, RpcClock::time_point now);
+    void Exit(size_t loop_index, RpcClock::time_point now);
+
+    /**
+     * @brief Report inline handlers still running past their budget
+     * @return Number of newly reported overruns
+     */
+    size_t Scan(RpcClock::time_point now);
+
+    uint64_t GetOverrunCount() const { return overruns_.load(std::memory_order_relaxed); }
+    size_t GetLoopCount() const { return loop_count_; }
+
+private:
+    struct alignas(64) LoopSlot {
+        std::atomic<const MethodEntry*> method{nullptr};
+        std::atomic<int64_t> started_ns{0};
+        std::atomic<bool> reported{false};
+    };
+
+    void Report(const MethodEntry* method, int64_t elapsed_ns, bool still_running);
+
+    size_t loop_count_;
+    std::unique_ptr<LoopSlot[]> slots_;
+    InlineOverrunCallback on_overrun_;
+    std::atomic<uint64_t> overruns_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_INLINE_WATCHDOG_H
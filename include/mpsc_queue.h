@@ -0,0 +1,103 @@
+// GrlRPC MPSC Queue Header
+// Bounded lock-free multi-producer single-consumer queue used to hand work
+// to the thread that owns an EventLoop
+
+#ifndef GRLRPC_MPSC_QUEUE_H
+#define GRLRPC_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace grlrpc {
+
+/**
+ * @brief Bounded MPSC ring with per-cell sequence numbers
+ * @tparam T Element type, must be default-constructible and movable
+ *
+ * Producers claim a slot with one CAS on the tail; the single consumer needs
+ * no atomic read-modify-write at all. No allocation after construction.
+ */
+template<typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Enqueue from any thread
+     * @return false if the queue is full; `value` is then left as it was,
+     *         so the caller can still use it (e.g. to reply with an error)
+     */
+    bool TryPush(T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(T&& value) { return TryPush(value); }
+
+    /**
+     * @brief Dequeue; only the owning consumer thread may call this
+     * @return false if the queue is empty
+     */
+    bool TryPop(T& out) {
+        Cell* cell = &cells_[head_ & mask_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (seq != head_ + 1) {
+            return false;
+        }
+        out = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    size_t mask_ = 0;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_MPSC_QUEUE_H
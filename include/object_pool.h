@@ -0,0 +1,231 @@
+// GrlRPC Object Pool Header
+// Per-thread cached object pools with a bounded lock-free global overflow,
+// used for the framework's own per-call structures
+
+#ifndef GRLRPC_OBJECT_POOL_H
+#define GRLRPC_OBJECT_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace grlrpc {
+
+// ============================================================================
+// PoolStats
+// ============================================================================
+
+struct PoolStats {
+    uint64_t hits = 0;       // served from a thread cache or the global overflow
+    uint64_t misses = 0;     // had to construct a new object
+    uint64_t discards = 0;   // released while every cache was full
+
+    double HitRate() const {
+        uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+// ============================================================================
+// ObjectPool
+// ============================================================================
+
+/**
+ * @brief Pool of reusable T objects
+ * @tparam T Default-constructible type with a Clear() method that resets it
+ *           for reuse while keeping already-allocated capacity
+ *
+ * Acquire/Release touch only a thread-local cache. Batches move between
+ * thread caches and a bounded global ring with a CAS per element, so no
+ * lock is ever taken. Counters are flushed from threads in batches and are
+ * therefore approximate for threads that are still running.
+ */
+template<typename T>
+class ObjectPool {
+public:
+    static constexpr size_t kLocalCapacity = 256;
+    static constexpr size_t kBatchSize = kLocalCapacity / 2;
+    static constexpr size_t kGlobalCapacity = 16384;
+
+    static ObjectPool& Instance() {
+        static ObjectPool instance;
+        return instance;
+    }
+
+    T* Acquire() {
+        LocalCache& local = Local();
+        if (local.objects.empty()) {
+            Refill(local);
+        }
+        if (!local.objects.empty()) {
+            T* object = local.objects.back();
+            local.objects.pop_back();
+            ++local.hits;
+            return object;
+        }
+        ++local.misses;
+        return new T();
+    }
+
+    void Release(T* object) {
+        if (!object) {
+            return;
+        }
+        object->Clear();
+        LocalCache& local = Local();
+        if (local.objects.size() >= kLocalCapacity) {
+            Spill(local, kBatchSize);
+        }
+        local.objects.push_back(object);
+    }
+
+    PoolStats GetStats() {
+        LocalCache& local = Local();
+        PoolStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed) + local.hits;
+        stats.misses = misses_.load(std::memory_order_relaxed) + local.misses;
+        stats.discards = discards_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct LocalCache {
+        std::vector<T*> objects;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        LocalCache() { objects.reserve(kLocalCapacity); }
+        ~LocalCache() {
+            ObjectPool& pool = ObjectPool::Instance();
+            pool.Spill(*this, objects.size());
+            pool.FlushCounters(*this);
+        }
+    };
+
+    // Bounded MPMC ring (per-cell sequence numbers) holding overflow objects
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T* object = nullptr;
+    };
+
+    ObjectPool() : cells_(new Cell[kGlobalCapacity]) {
+        for (size_t i = 0; i < kGlobalCapacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~ObjectPool() {
+        T* object = nullptr;
+        while (PopGlobal(object)) {
+            delete object;
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    static LocalCache& Local() {
+        thread_local LocalCache cache;
+        return cache;
+    }
+
+    bool PushGlobal(T* object) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % kGlobalCapacity];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.object = object;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool PopGlobal(T*& object) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % kGlobalCapacity];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    object = cell.object;
+                    cell.sequence.store(pos + kGlobalCapacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Refill(LocalCache& local) {
+        T* object = nullptr;
+        while (local.objects.size() < kBatchSize && PopGlobal(object)) {
+            local.objects.push_back(object);
+        }
+        FlushCounters(local);
+    }
+
+    void Spill(LocalCache& local, size_t count) {
+        while (count-- > 0 && !local.objects.empty()) {
+            T* object = local.objects.back();
+            local.objects.pop_back();
+            if (!PushGlobal(object)) {
+                delete object;
+                discards_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        FlushCounters(local);
+    }
+
+    void FlushCounters(LocalCache& local) {
+        hits_.fetch_add(local.hits, std::memory_order_relaxed);
+        misses_.fetch_add(local.misses, std::memory_order_relaxed);
+        local.hits = 0;
+        local.misses = 0;
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> discards_{0};
+};
+
+// ============================================================================
+// PooledPtr
+// ============================================================================
+
+template<typename T>
+struct PoolReleaser {
+    void operator()(T* object) const { ObjectPool<T>::Instance().Release(object); }
+};
+
+template<typename T>
+using PooledPtr = std::unique_ptr<T, PoolReleaser<T>>;
+
+/**
+ * @brief Take a cleared T from its pool; returned to the pool when the pointer dies
+ */
+template<typename T>
+PooledPtr<T> MakePooled() {
+    return PooledPtr<T>(ObjectPool<T>::Instance().Acquire());
+}
+
+} // namespace grlrpc
+
+#endif // GRLRPC_OBJECT_POOL_H
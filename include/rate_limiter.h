@@ -0,0 +1,134 @@
+// GrlRPC Rate Limiter Header
+// Server-side admission control per client identity, connection or method
+
+#ifndef GRLRPC_RATE_LIMITER_H
+#define GRLRPC_RATE_LIMITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// AtomicTokenBucket
+// Token bucket expressed as GCRA: the whole state is one "theoretical arrival
+// time", so admitting a request is a single compare-and-swap
+// ============================================================================
+
+class AtomicTokenBucket {
+public:
+    AtomicTokenBucket() = default;
+    AtomicTokenBucket(double rate_per_second, uint32_t burst) { Configure(rate_per_second, burst); }
+
+    void Configure(double rate_per_second, uint32_t burst);
+
+    /**
+     * @brief Take one token
+     * @param now_ns Monotonic time in nanoseconds
+     * @return false if the bucket is empty
+     */
+    bool TryAcquire(int64_t now_ns);
+
+    // Give back a token taken by TryAcquire()
+    void Refund();
+
+    /**
+     * @brief Whether the bucket has been full for at least one burst period
+     *
+     * An idle bucket is in the same state as a fresh one, so its slot can be
+     * handed to another key without changing anyone's budget.
+     */
+    bool IsIdle(int64_t now_ns) const;
+
+private:
+    int64_t interval_ns_ = 0;
+    int64_t tolerance_ns_ = 0;
+    std::atomic<int64_t> tat_ns_{0};
+};
+
+// ============================================================================
+// Rate Limit Rules
+// ============================================================================
+
+enum class RateLimitScope : uint8_t {
+    CLIENT = 0,      // keyed by authenticated client identity
+    CONNECTION = 1,  // keyed by server-side connection id
+    METHOD = 2       // one global bucket per method
+};
+
+struct RateLimitRule {
+    RateLimitScope scope = RateLimitScope::CLIENT;
+    // Restrict the rule to one method, 0 applies it to every method
+    uint32_t method_id = 0;
+    double rate_per_second = 1000.0;
+    uint32_t burst = 100;
+};
+
+/**
+ * @brief Hash a client identity string into the key used by RateLimiter
+ */
+uint64_t HashClientIdentity(std::string_view identity);
+
+// ============================================================================
+// RateLimiter
+// ============================================================================
+
+class RateLimiter {
+public:
+    /**
+     * @param rules Limits checked for every request, in order
+     * @param slots_per_rule Bucket table size per rule, rounded up to a power of two
+     */
+    explicit RateLimiter(std::vector<RateLimitRule> rules, size_t slots_per_rule = 4096);
+
+    /**
+     * @brief Admit a request using only its decoded frame header
+     * @return false if any matching rule is exhausted; the caller answers with
+     *         RpcStatus::RATE_LIMITED and skips reading the payload into a message
+     *
+     * Runs between MessageCodec::DecodeHeader and payload deserialization.
+     * A rejected request consumes no tokens: those taken from earlier rules
+     * are refunded.
+     */
+    bool Admit(const FrameHeader& header, uint64_t client_key, uint64_t connection_id,
+               RpcClock::time_point now = RpcClock::now());
+
+    uint64_t GetRejectedCount() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    // Buckets keyed by hash live in an open-addressing table claimed with CAS.
+    // A slot whose bucket has gone idle is taken over by the next key that
+    // needs one, so keys that stop sending (closed connections, departed
+    // clients) free their slots. Only when every probed slot is busy do keys
+    // share their home slot, merging two clients' budgets.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> key{0};
+        AtomicTokenBucket bucket;
+    };
+
+    struct RuleTable {
+        RateLimitRule rule;
+        size_t mask = 0;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    static constexpr size_t kMaxProbes = 8;
+
+    AtomicTokenBucket& FindBucket(RuleTable& table, uint64_t key, int64_t now_ns);
+
+    // Bucket of `table` charged for the request, or nullptr if the rule does not match
+    AtomicTokenBucket* MatchBucket(RuleTable& table, const FrameHeader& header, uint64_t client_key,
+                                   uint64_t connection_id, int64_t now_ns);
+
+    std::vector<RuleTable> tables_;
+    std::atomic<uint64_t> rejected_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_RATE_LIMITER_H
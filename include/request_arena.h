@@ -0,0 +1,180 @@
+// GrlRPC Request Arena Header
+// Request-scoped bump allocation spanning payload decode, handler execution
+// and response encode, released in one shot once the response is written
+
+#ifndef GRLRPC_REQUEST_ARENA_H
+#define GRLRPC_REQUEST_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace grlrpc {
+
+// ============================================================================
+// RequestArena
+// A std::pmr::memory_resource, so handlers allocate from it through
+// std::pmr containers (std::pmr::string, std::pmr::vector, ...)
+// ============================================================================
+
+class RequestArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultBlockSize = 16 * 1024;
+    // Blocks kept across Reset() so steady-state requests never call malloc
+    static constexpr size_t kDefaultRetainBytes = 256 * 1024;
+
+    explicit RequestArena(size_t block_size = kDefaultBlockSize,
+                          size_t retain_bytes = kDefaultRetainBytes);
+    ~RequestArena() override;
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    /**
+     * @brief Bump-allocate `bytes`; memory is only reclaimed by Reset()
+     */
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Construct a T in the arena
+     *
+     * Non-trivially destructible objects are destroyed in reverse order by Reset().
+     */
+    template<typename T, typename... Args>
+    T* New(Args&&... args) {
+        void* memory = Allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            RegisterFinalizer([](void* p) { static_cast<T*>(p)->~T(); }, object);
+        }
+        return object;
+    }
+
+    /**
+     * @brief Run finalizers and rewind; keeps up to retain_bytes of blocks
+     */
+    void Reset();
+
+    /**
+     * @brief Reusable buffer for encoding the response of the current request
+     *
+     * Cleared by Reset() but keeps its capacity, so serializers writing into
+     * a std::string do not allocate once the buffer has grown to size.
+     */
+    std::string& ResponseBuffer() { return response_buffer_; }
+
+    size_t BytesAllocated() const { return bytes_allocated_; }
+    size_t BlockCount() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return Allocate(bytes, alignment);
+    }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+        // Payload follows the header
+        char* Data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    void RegisterFinalizer(void (*destroy)(void*), void* object);
+    void AddBlock(size_t min_size);
+
+    size_t block_size_;
+    size_t retain_bytes_;
+    Block* head_ = nullptr;      // blocks in use, current one first
+    Block* spare_ = nullptr;     // blocks retained by Reset()
+    char* cursor_ = nullptr;
+    char* limit_ = nullptr;
+    Finalizer* finalizers_ = nullptr;
+    size_t bytes_allocated_ = 0;
+    std::string response_buffer_;
+};
+
+// ============================================================================
+// ArenaPool
+// Per-thread cache of arenas; acquiring and releasing never takes a lock
+// ============================================================================
+
+class ArenaPool {
+public:
+    static constexpr size_t kMaxCachedArenas = 64;
+
+    /**
+     * @brief Take an arena from the calling thread's pool, creating one if empty
+     */
+    static RequestArena* Acquire();
+
+    /**
+     * @brief Reset an arena and return it to the calling thread's pool
+     */
+    static void Release(RequestArena* arena);
+
+    static size_t CachedCount();
+};
+
+struct ArenaReleaser {
+    void operator()(RequestArena* arena) const { ArenaPool::Release(arena); }
+};
+
+using ArenaHandle = std::unique_ptr<RequestArena, ArenaReleaser>;
+
+/**
+ * @brief Acquire an arena for one request; released when the handle dies
+ *
+ * The server holds the handle from frame decode until the response bytes
+ * have been written, so everything allocated for the request is freed at once.
+ */
+inline ArenaHandle AcquireRequestArena() {
+    return ArenaHandle(ArenaPool::Acquire());
+}
+
+// ============================================================================
+// RequestArenaScope
+// Makes an arena visible to handler code running on the current thread
+// ============================================================================
+
+class RequestArenaScope {
+public:
+    explicit RequestArenaScope(RequestArena* arena);
+    ~RequestArenaScope();
+
+    RequestArenaScope(const RequestArenaScope&) = delete;
+    RequestArenaScope& operator=(const RequestArenaScope&) = delete;
+
+private:
+    RequestArena* previous_;
+};
+
+/**
+ * @brief Arena of the request being handled on this thread
+ * @return nullptr outside of a RequestArenaScope
+ */
+RequestArena* CurrentRequestArena();
+
+/**
+ * @brief Memory resource for handler allocations: the current request arena,
+ *        or the default heap resource outside a request
+ */
+std::pmr::memory_resource* CurrentRequestResource();
+
+} // namespace grlrpc
+
+#endif // GRLRPC_REQUEST_ARENA_H
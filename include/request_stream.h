@@ -0,0 +1,233 @@
+// GrlRPC Request Stream Header
+// Opt-in streaming of a request's bulk BYTES field (e.g. an avatar upload)
+// into its handler while the rest of the request is still arriving
+//
+// Payload layout of a streaming method:
+//   [head_length:u32][head][body]
+// `head` is the request message without its bulk field, encoded with the
+// connection's serializer; `body` is the raw bulk bytes. Large requests are
+// chunked (FRAME_FLAG_CHUNK): the first chunk carries the total length,
+// head length and head, every following chunk is a slice of the body.
+
+#ifndef GRLRPC_REQUEST_STREAM_H
+#define GRLRPC_REQUEST_STREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// Payload Layout
+// ============================================================================
+
+void EncodeStreamingPayload(std::string_view head, std::string_view body, std::string& out);
+
+/**
+ * @brief Split [head_length][head][body]; `body` may be a prefix of the full body
+ * @return false if the head is truncated
+ */
+bool SplitStreamingPayload(std::string_view payload, std::string_view& head, std::string_view& body);
+
+// ============================================================================
+// RequestStream
+// Bounded hand-off of body chunks from the connection to the handler
+// ============================================================================
+
+/**
+ * @brief One slice of the body, pointing into the connection's receive buffer
+ *
+ * `storage` keeps that buffer alive until the handler drops the chunk; it is
+ * null when the bytes are owned by the request being handled.
+ */
+struct StreamChunk {
+    std::shared_ptr<const std::string> storage;
+    std::string_view data;
+};
+
+class RequestStream {
+public:
+    /**
+     * @param max_buffered_chunks Chunks received but not yet read; together
+     *        with the chunk size this bounds the memory held per upload
+     * @param declared_size Body size announced by the sender
+     */
+    RequestStream(size_t max_buffered_chunks, uint64_t declared_size);
+
+    // ---- Handler side --------------------------------------------------
+
+    /**
+     * @brief Wait for the next chunk
+     * @return false at the end of the body or if the upload was aborted
+     */
+    bool Read(StreamChunk& chunk);
+
+    bool IsAborted() const;
+    uint64_t GetDeclaredSize() const { return declared_size_; }
+
+    // ---- Connection side -----------------------------------------------
+
+    /**
+     * @brief Queue a chunk without blocking
+     * @return false if the stream is full; stop reading the connection and
+     *         retry once the space callback fires. Chunks pushed after the
+     *         handler has returned are dropped and reported as accepted.
+     */
+    bool TryPush(StreamChunk chunk);
+
+    // No more chunks will follow
+    void Finish();
+
+    // Wakes a blocked Read() with false; used on disconnect and when the
+    // handler returns early
+    void Abort();
+
+    /**
+     * @brief Called from the handler's thread after a full stream gains room
+     */
+    void SetSpaceCallback(std::function<void()> callback);
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable readable_;
+    std::vector<StreamChunk> ring_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint64_t declared_size_;
+    bool finished_ = false;
+    bool aborted_ = false;
+    bool producer_blocked_ = false;
+    std::function<void()> on_space_;
+};
+
+/**
+ * @brief Run a streaming handler over an already buffered payload
+ *
+ * Backs MethodEntry::handler for streaming methods, so small unchunked
+ * uploads and non-streaming transports (HTTP gateway, LocalChannel) work
+ * unchanged.
+ */
+RpcStatus RunStreamingHandler(const StreamingHandler& handler, const RpcRequestData& request,
+                              RpcResponseData& response);
+
+// ============================================================================
+// StreamingRequestDispatcher
+// Per-connection routing of chunked requests to streaming handlers
+// ============================================================================
+
+struct StreamingConfig {
+    size_t max_buffered_chunks = 8;
+    // Upper bound on head plus body; streams exist for large uploads, so
+    // this is separate from ChunkingConfig::max_message_size
+    size_t max_stream_size = 256 * 1024 * 1024;
+};
+
+enum class StreamFrameResult {
+    DELIVERED,      // frame consumed by a streaming handler
+    NOT_STREAMING,  // not part of a streamed request; use the regular path
+    BACKPRESSURE,   // stream full; keep the frame and retry after the resume callback
+    INVALID         // malformed or oversize; the stream was aborted
+};
+
+std::string StreamFrameResultToString(StreamFrameResult result);
+
+// Runs a handler invocation on the worker pool
+using StreamTaskRunner = std::function<void(std::function<void()> task)>;
+
+// Sends the response of a streamed request; called from the worker thread,
+// never for one-way requests
+using StreamResponder = std::function<void(uint64_t request_id, RpcStatus status,
+                                           const RpcResponseData& response)>;
+
+class StreamingRequestDispatcher {
+public:
+    /**
+     * @param serializer_name Serializer handed to handlers for the head
+     */
+    StreamingRequestDispatcher(const MethodTable& methods, std::string serializer_name,
+                               StreamTaskRunner run, StreamResponder respond,
+                               const StreamingConfig& config = StreamingConfig());
+    ~StreamingRequestDispatcher();
+
+    /**
+     * @brief Offer a complete received frame; called on the connection's loop thread
+     *
+     * The handler is started as soon as the first chunk (with the head)
+     * arrives; body chunks are then handed to it without copying.
+     */
+    StreamFrameResult OnFrame(const FrameView& frame);
+
+    /**
+     * @brief Called when a stream that returned BACKPRESSURE has room again
+     */
+    void SetResumeCallback(std::function<void()> callback) { on_resume_ = std::move(callback); }
+
+    size_t GetActiveCount() const { return streams_.size(); }
+
+    // Connection closed: wake every handler still reading
+    void AbortAll();
+
+private:
+    struct ActiveStream {
+        std::shared_ptr<RequestStream> stream;
+        uint64_t remaining = 0;
+    };
+
+    StreamFrameResult StartStream(const FrameHeader& header, const MethodEntry& entry,
+                                  const FrameView& frame);
+
+    const MethodTable& methods_;
+    std::string serializer_name_;
+    StreamTaskRunner run_;
+    StreamResponder respond_;
+    StreamingConfig config_;
+    std::function<void()> on_resume_;
+    std::unordered_map<uint64_t, ActiveStream> streams_;
+};
+
+// ============================================================================
+// StreamingRequestWriter
+// Client side: frames head and body without concatenating them
+// ============================================================================
+
+class StreamingRequestWriter {
+public:
+    /**
+     * @param head Encoded request without its bulk field
+     * @param body Bulk bytes; both views must outlive the writer
+     */
+    StreamingRequestWriter(const FrameHeader& header, std::string_view head, std::string_view body,
+                           const ChunkingConfig& config = ChunkingConfig());
+
+    bool Done() const { return done_; }
+
+    /**
+     * @brief Append the next frame to `out`; interleave with other frames freely
+     * @return false once every frame has been produced
+     */
+    bool Next(std::string& out);
+
+private:
+    FrameHeader header_;
+    std::string_view head_;
+    std::string_view body_;
+    size_t chunk_size_;
+    bool chunked_;
+    bool head_sent_ = false;
+    size_t offset_ = 0;
+    bool done_ = false;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_REQUEST_STREAM_H
@@ -0,0 +1,187 @@
+// GrlRPC Retry Policy Header
+// Status classification, jittered exponential backoff and retry budgets
+// used by GrlRpcClient when an attempt fails
+
+#ifndef GRLRPC_RETRY_POLICY_H
+#define GRLRPC_RETRY_POLICY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// Retry Configuration
+// ============================================================================
+
+struct RetryPolicyConfig {
+    // Total attempts including the original call
+    int max_attempts = 3;
+
+    // Exponential backoff parameters; the actual delay is drawn uniformly
+    // from [0, min(max_backoff, initial_backoff * multiplier^(n-1))]
+    std::chrono::milliseconds initial_backoff{10};
+    std::chrono::milliseconds max_backoff{1000};
+    double backoff_multiplier = 2.0;
+
+    // Retry budget: every original request deposits budget_ratio tokens,
+    // every retry withdraws one, so retries stay below that fraction of traffic
+    double budget_ratio = 0.1;
+    double budget_max_tokens = 10.0;
+
+    // Bit mask of retryable statuses, built with StatusBit()
+    uint32_t retryable_statuses = DefaultRetryableStatuses();
+
+    static constexpr uint32_t StatusBit(RpcStatus status) {
+        return 1u << static_cast<uint32_t>(status);
+    }
+
+    // Only failures where the request may not have reached a healthy backend
+    static constexpr uint32_t DefaultRetryableStatuses() {
+        return StatusBit(RpcStatus::NETWORK_ERROR) | StatusBit(RpcStatus::TIMEOUT);
+    }
+};
+
+// ============================================================================
+// RetryBudget
+// Lock-free token bucket shared by all calls of one client
+// ============================================================================
+
+class RetryBudget {
+public:
+    explicit RetryBudget(double ratio = 0.1, double max_tokens = 10.0);
+
+    /**
+     * @brief Credit the budget for an original (non-retry) request
+     */
+    void OnRequest();
+
+    /**
+     * @brief Take one token for a retry
+     * @return true if a retry is allowed, false if the budget is exhausted
+     */
+    bool TryAcquire();
+
+    double AvailableTokens() const;
+
+private:
+    // Tokens are kept in fixed point so a single atomic integer suffices
+    static constexpr int64_t kScale = 1000;
+
+    const int64_t deposit_;
+    const int64_t max_;
+    std::atomic<int64_t> tokens_;
+};
+
+// ============================================================================
+// RetryDecision
+// ============================================================================
+
+enum class RetryVerdict {
+    RETRY,
+    NOT_RETRYABLE,
+    ATTEMPTS_EXHAUSTED,
+    BUDGET_EXHAUSTED,
+    DEADLINE_EXCEEDED
+};
+
+struct RetryDecision {
+    RetryVerdict verdict = RetryVerdict::NOT_RETRYABLE;
+    // Delay to arm on the event-loop timer before the next attempt
+    std::chrono::milliseconds delay{0};
+    // Endpoint index for the next attempt
+    size_t endpoint_index = 0;
+
+    bool ShouldRetry() const { return verdict == RetryVerdict::RETRY; }
+};
+
+// ============================================================================
+// RetryState
+// Per-call bookkeeping: attempts made and endpoints already tried
+// ============================================================================
+
+struct RetryState {
+    RpcClock::time_point deadline = RpcClock::time_point::max();
+    int attempts = 0;
+    std::vector<size_t> tried_endpoints;
+
+    void RecordAttempt(size_t endpoint_index) {
+        ++attempts;
+        tried_endpoints.push_back(endpoint_index);
+    }
+};
+
+// ============================================================================
+// RetryPolicy
+// ============================================================================
+
+class RetryPolicy {
+public:
+    explicit RetryPolicy(const RetryPolicyConfig& config = RetryPolicyConfig());
+
+    const RetryPolicyConfig& GetConfig() const { return config_; }
+    RetryBudget& GetBudget() { return budget_; }
+
+    /**
+     * @brief Check whether a status may be retried at all
+     */
+    bool IsRetryable(RpcStatus status) const {
+        return (config_.retryable_statuses & RetryPolicyConfig::StatusBit(status)) != 0;
+    }
+
+    /**
+     * @brief Must be called once per original request to feed the budget
+     */
+    void OnRequest() { budget_.OnRequest(); }
+
+    /**
+     * @brief Compute the full-jitter backoff before retry number `retry`
+     * @param retry 1 for the first retry, 2 for the second, ...
+     * @param unit_random Uniform random value in [0, 1)
+     */
+    std::chrono::milliseconds ComputeBackoff(int retry, double unit_random) const;
+
+    /**
+     * @brief Same as above using a thread-local random generator
+     */
+    std::chrono::milliseconds ComputeBackoff(int retry) const;
+
+    /**
+     * @brief Decide whether and when a failed attempt is retried
+     * @param status Status of the failed attempt
+     * @param state Per-call state; attempts must already include the failed one
+     * @param endpoint_count Number of endpoints the client can reach
+     * @param now Current time
+     *
+     * A retry is only granted if the backoff expires before the call's
+     * deadline, so retries never extend the caller's latency budget.
+     * The budget is only charged when every other check has passed.
+     */
+    RetryDecision Decide(RpcStatus status, const RetryState& state,
+                         size_t endpoint_count, RpcClock::time_point now);
+
+private:
+    RetryPolicyConfig config_;
+    RetryBudget budget_;
+};
+
+/**
+ * @brief Pick the endpoint for the next attempt, preferring one not tried yet
+ * @param endpoint_count Number of candidate endpoints
+ * @param tried Indices already used by this call, in attempt order
+ * @return Index of the endpoint to use; differs from the last tried one
+ *         whenever more than one endpoint exists
+ */
+size_t SelectRetryEndpoint(size_t endpoint_count, const std::vector<size_t>& tried);
+
+std::string RetryVerdictToString(RetryVerdict verdict);
+
+} // namespace grlrpc
+
+#endif // GRLRPC_RETRY_POLICY_H
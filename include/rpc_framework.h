@@ -5,9 +5,20 @@
 #define GRLRPC_RPC_FRAMEWORK_H
 
 #include <string>
+#include <string_view>
+#include <cstddef>
 #include <cstdint>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "object_pool.h"
+#include "serialization_framework.h"
 
 namespace grlrpc {
 
@@ -20,12 +31,794 @@ enum class RpcStatus {
     NETWORK_ERROR = 3,
     TIMEOUT = 4,
     INVALID_REQUEST = 5,
-    UNKNOWN_ERROR = 6
+    UNKNOWN_ERROR = 6,
+    CIRCUIT_OPEN = 7,
+    RATE_LIMITED = 8
+};
+
+using RpcClock = std::chrono::steady_clock;
+
+std::string RpcStatusToString(RpcStatus status);
+
+// ============================================================================
+// Method Identifiers
+// ============================================================================
+
+/**
+ * @brief Compute the 32-bit wire id of a method name ("Service/Method")
+ *
+ * FNV-1a, usable at compile time so typed stubs can carry constant ids.
+ */
+constexpr uint32_t MethodIdOf(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ============================================================================
+// Frame Header
+// Fixed-size header preceding every payload on the wire (little-endian):
+//   magic(2) version(1) flags(1) method_id(4) request_id(8)
+//   deadline_ms(4) payload_length(4)
+// ============================================================================
+
+enum FrameFlags : uint8_t {
+    FRAME_FLAG_NONE = 0x00,
+    FRAME_FLAG_RESPONSE = 0x01,
+    // Fire-and-forget request: never tracked by the client, never answered
+    FRAME_FLAG_ONE_WAY = 0x02,
+    // Payload is [original_size:u32][compressed bytes], see MessageCodec::CompressPayload
+    FRAME_FLAG_COMPRESSED = 0x04,
+    // Part of a chunked message and more chunks follow; the final chunk
+    // clears it. See FrameChunker / ChunkReassembler
+    FRAME_FLAG_CHUNK = 0x08
+};
+
+struct FrameHeader {
+    static constexpr uint16_t kMagic = 0x4752;  // "GR"
+    // Newest version this build writes, and the oldest it still decodes
+    static constexpr uint8_t kVersion = 1;
+    static constexpr uint8_t kMinVersion = 1;
+    static constexpr size_t kSize = 24;
+
+    uint8_t version = kVersion;
+    uint8_t flags = FRAME_FLAG_NONE;
+    uint32_t method_id = 0;
+    uint64_t request_id = 0;
+    // Remaining caller budget in milliseconds, 0 means no deadline
+    uint32_t deadline_ms = 0;
+    uint32_t payload_length = 0;
+
+    bool HasFlag(uint8_t flag) const { return (flags & flag) != 0; }
+    bool IsOneWay() const { return HasFlag(FRAME_FLAG_ONE_WAY); }
+};
+
+// ============================================================================
+// FrameView
+// A complete frame (header + payload) inside a shared receive buffer.
+// Copying a FrameView shares the bytes instead of duplicating them.
+// ============================================================================
+
+struct FrameView {
+    std::shared_ptr<std::string> storage;
+    size_t offset = 0;
+    size_t length = 0;
+
+    char* Data() { return &(*storage)[offset]; }
+    const char* Data() const { return storage->data() + offset; }
+
+    std::string_view Payload() const {
+        return std::string_view(Data() + FrameHeader::kSize, length - FrameHeader::kSize);
+    }
 };
 
 struct RpcRequestData;
-struct RpcResponseData;
-class MessageCodec;
+class ICompressor;
+struct CompressionPolicy;
+
+// ============================================================================
+// MessageCodec
+// ============================================================================
+
+class MessageCodec {
+public:
+    /**
+     * @brief Write a header into exactly FrameHeader::kSize bytes at `out`
+     */
+    static void EncodeHeader(const FrameHeader& header, char* out);
+
+    /**
+     * @brief Append an encoded header to `out`
+     */
+    static void EncodeHeader(const FrameHeader& header, std::string& out);
+
+    /**
+     * @brief Parse a header without touching the payload
+     * @return false if fewer than kSize bytes are available, the magic does
+     *         not match or the version is outside [kMinVersion, kVersion]
+     */
+    static bool DecodeHeader(const char* data, size_t length, FrameHeader& header);
+
+    // In-place patching of an already encoded header, used by relays that
+    // forward frames without re-encoding them
+    static void RewriteRequestId(char* header, uint64_t request_id);
+    static void RewriteDeadline(char* header, uint32_t deadline_ms);
+
+    /**
+     * @brief Append header and payload of a request; payload_length is filled in
+     */
+    static void EncodeRequest(const RpcRequestData& request, std::string& out);
+
+    /**
+     * @brief Whether the server must encode and send a response for a request
+     */
+    static bool ExpectsResponse(const FrameHeader& header) {
+        return !header.HasFlag(FRAME_FLAG_RESPONSE) && !header.IsOneWay();
+    }
+
+    /**
+     * @brief Compression stage applied before a payload is framed
+     * @param policy Compressor bound to the connection and its size threshold
+     * @param header Gets FRAME_FLAG_COMPRESSED when the payload is compressed
+     * @param out Receives the wire payload; its capacity is reused across calls
+     * @return false if the payload should be sent uncompressed (below the
+     *         threshold, already compressed, or no gain); `out` is then empty
+     */
+    static bool CompressPayload(const CompressionPolicy& policy, FrameHeader& header,
+                                std::string_view payload, std::string& out);
+
+    /**
+     * @brief Reverse of CompressPayload for a FRAME_FLAG_COMPRESSED payload
+     * @param max_size Reject payloads claiming a larger original size
+     */
+    static bool DecompressPayload(ICompressor* compressor, std::string_view wire_payload,
+                                  size_t max_size, std::string& out);
+
+    /**
+     * @brief Reject a frame from its header alone, before reading its payload
+     *
+     * Unchunked frames carry the whole message, so payload_length bounds it.
+     * Chunks are bounded by the sender's chunk size; the total of a chunked
+     * message is checked by ChunkReassembler on its first chunk.
+     */
+    static bool ExceedsMessageLimit(const FrameHeader& header, size_t max_message_size) {
+        return header.payload_length > max_message_size + kChunkPrefixSize;
+    }
+
+    // First chunk of a message: payload is [total_length:u32][chunk bytes]
+    static constexpr size_t kChunkPrefixSize = sizeof(uint32_t);
+};
+
+// ============================================================================
+// Chunking
+// Payloads above a threshold are sent as a run of chunk frames sharing the
+// request id, so the writer can interleave other frames between chunks and
+// a large message no longer holds the connection until it is fully written
+// ============================================================================
+
+struct ChunkingConfig {
+    // Payloads up to this size are sent as a single frame
+    size_t chunk_threshold = 64 * 1024;
+    // Bytes of message per chunk frame
+    size_t chunk_size = 16 * 1024;
+    // Largest message a receiver accepts, chunked or not
+    size_t max_message_size = 16 * 1024 * 1024;
+};
+
+/**
+ * @brief Produces the frames of one outgoing message, one chunk at a time
+ *
+ * The payload is not copied; it must outlive the chunker. A connection
+ * writer keeps one chunker per message in flight and takes one frame from
+ * each in turn, between small frames.
+ */
+class FrameChunker {
+public:
+    FrameChunker(const FrameHeader& header, std::string_view payload, const ChunkingConfig& config);
+
+    bool Done() const { return done_; }
+
+    /**
+     * @brief Append the next frame (header and chunk) to `out`
+     * @return false once every frame has been produced
+     */
+    bool Next(std::string& out);
+
+private:
+    FrameHeader header_;
+    std::string_view payload_;
+    size_t chunk_size_;
+    size_t offset_ = 0;
+    bool chunked_;
+    bool done_ = false;
+};
+
+enum class ReassemblyStatus {
+    COMPLETE,   // `message` holds the full payload
+    PENDING,    // chunk buffered, more to come
+    TOO_LARGE,  // message above max_message_size, or buffering it would pass
+                // max_pending_bytes; partial state dropped
+    INVALID     // malformed chunk sequence, partial state dropped
+};
+
+/**
+ * @brief Rebuilds chunked messages on the receive side
+ *
+ * Messages with different request ids may be interleaved. Unchunked frames
+ * pass straight through without copying. Buffers grow with the bytes that
+ * actually arrive, never with the total a first chunk announces, and all
+ * partial messages together are held to max_pending_bytes.
+ */
+class ChunkReassembler {
+public:
+    explicit ChunkReassembler(size_t max_message_size = ChunkingConfig().max_message_size,
+                              size_t max_pending_messages = 64,
+                              size_t max_pending_bytes = 64 * 1024 * 1024);
+
+    /**
+     * @brief Feed one decoded frame
+     * @param header Frame header; on COMPLETE its FRAME_FLAG_CHUNK is cleared
+     *        and payload_length is the message size
+     * @param message On COMPLETE, the message payload; valid until the next
+     *        call to OnFrame
+     */
+    ReassemblyStatus OnFrame(FrameHeader& header, std::string_view payload,
+                             std::string_view& message);
+
+    // Drop a partial message, e.g. when its call is cancelled or times out
+    void Discard(uint64_t request_id);
+
+    size_t GetPendingCount() const { return pending_.size(); }
+    size_t GetPendingBytes() const { return pending_bytes_; }
+
+private:
+    struct Partial {
+        uint32_t total_length = 0;
+        std::string data;
+    };
+
+    // Forget a partial message and the bytes it holds
+    void Drop(std::unordered_map<uint64_t, Partial>::iterator it);
+
+    size_t max_message_size_;
+    size_t max_pending_messages_;
+    size_t max_pending_bytes_;
+    size_t pending_bytes_ = 0;
+    std::unordered_map<uint64_t, Partial> pending_;
+    std::string completed_;
+};
+
+// ============================================================================
+// Request / Response Envelopes
+// Clear() resets an envelope for reuse but keeps buffer capacity, so pooled
+// envelopes stop allocating once warmed up (see object_pool.h)
+// ============================================================================
+
+struct RpcRequestData {
+    FrameHeader header;
+    std::string method_name;
+    std::string serializer_name;
+    std::string payload;
+
+    void Clear() {
+        header = FrameHeader();
+        method_name.clear();
+        serializer_name.clear();
+        payload.clear();
+    }
+};
+
+struct RpcResponseData {
+    uint64_t request_id = 0;
+    RpcStatus status = RpcStatus::SUCCESS;
+    std::string error_message;
+    std::string payload;
+
+    void Clear() {
+        request_id = 0;
+        status = RpcStatus::SUCCESS;
+        error_message.clear();
+        payload.clear();
+    }
+};
+
+using RpcCallback = std::function<void(RpcStatus status, const RpcResponseData& response)>;
+
+// ============================================================================
+// PendingCall
+// Client-side record of a request awaiting its response
+// ============================================================================
+
+struct PendingCall {
+    uint64_t request_id = 0;
+    uint32_t method_id = 0;
+    size_t endpoint_index = 0;
+    RpcClock::time_point sent_at;
+    RpcClock::time_point deadline = RpcClock::time_point::max();
+    RpcCallback callback;
+    // Position in the owning table's deadline heap
+    size_t heap_index = static_cast<size_t>(-1);
+
+    void Clear() {
+        request_id = 0;
+        method_id = 0;
+        endpoint_index = 0;
+        sent_at = RpcClock::time_point();
+        deadline = RpcClock::time_point::max();
+        callback = nullptr;
+        heap_index = static_cast<size_t>(-1);
+    }
+};
+
+// ============================================================================
+// PendingCallTable
+// Requests sent by a client that still wait for a response or a timeout.
+// Calls live in an open-addressing table of pooled records and calls with a
+// deadline also in a min-heap, so tracking allocates nothing once warmed up
+// and expiry only touches the calls that expire
+// ============================================================================
+
+class PendingCallTable {
+public:
+    PendingCallTable();
+
+    /**
+     * @brief Start tracking a sent request
+     * @return false for one-way requests, which are not tracked at all: no
+     *         record, no deadline timer, and the callback is dropped; and for
+     *         a request id that is already pending, whose callback then runs
+     *         at once with INVALID_REQUEST while the earlier call is kept
+     */
+    bool Track(const FrameHeader& header, RpcCallback callback,
+               RpcClock::time_point deadline, RpcClock::time_point now = RpcClock::now());
+
+    /**
+     * @brief Complete a call with its response and run the callback
+     * @return false if no call with this id is pending (late or duplicate response)
+     */
+    bool Complete(const RpcResponseData& response);
+
+    /**
+     * @brief Fail every call whose deadline is not after `now` with TIMEOUT
+     * @return Number of expired calls
+     */
+    size_t ExpireBefore(RpcClock::time_point now);
+
+    size_t Size() const;
+
+private:
+    struct Slot {
+        uint64_t request_id = 0;
+        PooledPtr<PendingCall> call;   // null = empty
+    };
+
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    size_t FindLocked(uint64_t request_id) const;
+    void InsertLocked(PooledPtr<PendingCall> call);
+    PooledPtr<PendingCall> RemoveLocked(size_t slot);
+    void GrowLocked();
+
+    void HeapPush(PendingCall* call);
+    void HeapRemove(PendingCall* call);
+    void HeapSiftUp(size_t index);
+    void HeapSiftDown(size_t index);
+    void HeapPlace(PendingCall* call, size_t index);
+
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;   // power-of-two size, at most half full
+    size_t size_ = 0;
+    std::vector<PendingCall*> deadlines_;   // earliest deadline first
+};
+
+// ============================================================================
+// MethodTable
+// Method dispatch table shared by the binary protocol and the HTTP gateway
+// ============================================================================
+
+/**
+ * @brief Server-side method implementation
+ *
+ * Handlers decode request.payload with request.serializer_name and encode
+ * response.payload with the same serializer, so one handler serves every
+ * negotiated format.
+ */
+using RpcHandler = std::function<RpcStatus(const RpcRequestData& request, RpcResponseData& response)>;
+
+struct MethodOptions {
+    // Run on the IO loop thread that read the request instead of handing it
+    // to the worker pool. Only for handlers that never block: no locks held
+    // across IO, no disk, no downstream calls.
+    bool inline_safe = false;
+    // Inline runs longer than this are reported by the InlineWatchdog
+    std::chrono::microseconds inline_budget{100};
+    // Fire-and-forget method: every request is handled as if it carried
+    // FRAME_FLAG_ONE_WAY, so no response is encoded or sent
+    bool one_way = false;
+};
+
+class RequestStream;
+
+/**
+ * @brief Handler for an upload whose bulk BYTES field arrives as a stream
+ *
+ * request.payload holds only the small head fields; the bulk bytes are
+ * read from `body` while the rest of the request is still being received.
+ * See request_stream.h for the wire layout.
+ */
+using StreamingHandler = std::function<RpcStatus(const RpcRequestData& request, RequestStream& body,
+                                                 RpcResponseData& response)>;
+
+struct MethodEntry {
+    std::string name;
+    uint32_t id = 0;
+    // Always set; for streaming methods it runs streaming_handler over a
+    // fully buffered payload, so unchunked requests need no special path
+    RpcHandler handler;
+    StreamingHandler streaming_handler;
+    MethodOptions options;
+
+    bool IsStreaming() const { return static_cast<bool>(streaming_handler); }
+
+    // Whether a request to this method gets a response; see MessageCodec::ExpectsResponse
+    bool ExpectsResponse(const FrameHeader& header) const {
+        return !options.one_way && MessageCodec::ExpectsResponse(header);
+    }
+};
+
+class MethodTable {
+public:
+    /**
+     * @brief Register a method under "Service/Method"
+     * @return false if the name, or another name with the same id, is taken
+     *
+     * Registration happens before serving starts; lookups afterwards are
+     * plain reads with no locking.
+     */
+    bool Register(const std::string& name, RpcHandler handler,
+                  const MethodOptions& options = MethodOptions());
+
+    /**
+     * @brief Register a method that receives its bulk field as a stream
+     * @return false if the name, or another name with the same id, is taken
+     */
+    bool RegisterStreaming(const std::string& name, StreamingHandler handler,
+                           const MethodOptions& options = MethodOptions());
+
+    const MethodEntry* Find(uint32_t method_id) const;
+    const MethodEntry* Find(std::string_view name) const;
+    size_t Size() const { return methods_.size(); }
+
+private:
+    std::unordered_map<uint32_t, MethodEntry> methods_;
+};
+
+// ============================================================================
+// Typed Service API
+// ============================================================================
+
+/**
+ * @brief Compile-time description of one method
+ *
+ * Declare methods with GRLRPC_METHOD rather than instantiating this
+ * directly, so the id always matches the name.
+ */
+template<typename Req, typename Resp, uint32_t Id>
+struct MethodDescriptor {
+    using Request = Req;
+    using Response = Resp;
+    static constexpr uint32_t kId = Id;
+};
+
+// GRLRPC_METHOD(GetUserMethod, "UserService/GetUser", GetUserRequest, GetUserResponse);
+#define GRLRPC_METHOD(descriptor_name, method_name, request_type, response_type) \
+    struct descriptor_name : grlrpc::MethodDescriptor<request_type, response_type, \
+                                                      grlrpc::MethodIdOf(method_name)> { \
+        static constexpr const char* kName = method_name; \
+    }
+
+/**
+ * @brief Transport used by typed stubs
+ *
+ * Implemented by the client connection; LocalChannel dispatches in process.
+ */
+class RpcChannel {
+public:
+    virtual ~RpcChannel() = default;
+
+    virtual RpcStatus Call(const RpcRequestData& request, RpcResponseData& response) = 0;
+
+    // Default runs Call() and completes inline
+    virtual void CallAsync(const RpcRequestData& request, RpcCallback done) {
+        PooledPtr<RpcResponseData> response = MakePooled<RpcResponseData>();
+        RpcStatus status = Call(request, *response);
+        done(status, *response);
+    }
+
+    /**
+     * @brief Deliver a FRAME_FLAG_ONE_WAY request without waiting for an answer
+     *
+     * Default runs Call(), which for a one-way request leaves the response
+     * empty; connections override it to return once the frame is written.
+     */
+    virtual RpcStatus Send(const RpcRequestData& request) {
+        PooledPtr<RpcResponseData> response = MakePooled<RpcResponseData>();
+        return Call(request, *response);
+    }
+};
+
+/**
+ * @brief Channel that calls handlers from a MethodTable directly
+ *
+ * One-way requests still run their handler and report its status, but the
+ * response payload is left empty.
+ */
+class LocalChannel : public RpcChannel {
+public:
+    explicit LocalChannel(const MethodTable& methods) : methods_(methods) {}
+
+    RpcStatus Call(const RpcRequestData& request, RpcResponseData& response) override;
+
+private:
+    const MethodTable& methods_;
+};
+
+/**
+ * @brief Typed client stub for a set of methods
+ *
+ * Request and response serializers of every method are resolved in the
+ * constructor; a call only encodes, sends and decodes. The stub must
+ * outlive its pending CallAsync() calls.
+ *
+ *   ServiceStub<GetUserMethod, CreateUserMethod> stub(channel, "binary");
+ *   RpcStatus status = stub.Call<GetUserMethod>(request, response);
+ */
+template<typename... Methods>
+class ServiceStub {
+public:
+    ServiceStub(RpcChannel& channel, const std::string& serializer_name)
+        : channel_(channel),
+          serializer_name_(serializer_name),
+          handles_(Handles<Methods>{
+              SerializerHandle<typename Methods::Request>::Resolve(serializer_name),
+              SerializerHandle<typename Methods::Response>::Resolve(serializer_name)}...) {}
+
+    /**
+     * @brief Whether every method's types are serializable in this format
+     */
+    bool IsBound() const {
+        return (... && (std::get<Handles<Methods>>(handles_).request.IsValid() &&
+                        std::get<Handles<Methods>>(handles_).response.IsValid()));
+    }
+
+    template<typename Method>
+    RpcStatus Call(const typename Method::Request& request, typename Method::Response& response,
+                   uint32_t deadline_ms = 0) {
+        const Handles<Method>& handles = std::get<Handles<Method>>(handles_);
+        PooledPtr<RpcRequestData> data = MakePooled<RpcRequestData>();
+        if (!Encode<Method>(handles, request, deadline_ms, *data)) {
+            return RpcStatus::SERIALIZATION_ERROR;
+        }
+        PooledPtr<RpcResponseData> reply = MakePooled<RpcResponseData>();
+        RpcStatus status = channel_.Call(*data, *reply);
+        if (status == RpcStatus::SUCCESS && !handles.response.Deserialize(reply->payload, response)) {
+            return RpcStatus::SERIALIZATION_ERROR;
+        }
+        return status;
+    }
+
+    /**
+     * @brief Send a one-way request: no response is tracked, encoded or decoded
+     * @return The channel's status for delivering the request, never a
+     *         result of the handler on a remote server
+     */
+    template<typename Method>
+    RpcStatus Send(const typename Method::Request& request, uint32_t deadline_ms = 0) {
+        PooledPtr<RpcRequestData> data = MakePooled<RpcRequestData>();
+        if (!Encode<Method>(std::get<Handles<Method>>(handles_), request, deadline_ms, *data)) {
+            return RpcStatus::SERIALIZATION_ERROR;
+        }
+        data->header.flags |= FRAME_FLAG_ONE_WAY;
+        return channel_.Send(*data);
+    }
+
+    template<typename Method>
+    void CallAsync(const typename Method::Request& request,
+                   std::function<void(RpcStatus, const typename Method::Response&)> done,
+                   uint32_t deadline_ms = 0) {
+        using Response = typename Method::Response;
+        const Handles<Method>& handles = std::get<Handles<Method>>(handles_);
+        PooledPtr<RpcRequestData> data = MakePooled<RpcRequestData>();
+        if (!Encode<Method>(handles, request, deadline_ms, *data)) {
+            done(RpcStatus::SERIALIZATION_ERROR, Response());
+            return;
+        }
+        const SerializerHandle<Response>* decoder = &handles.response;
+        channel_.CallAsync(*data, [decoder, done = std::move(done)](RpcStatus status,
+                                                                     const RpcResponseData& reply) {
+            Response response;
+            if (status == RpcStatus::SUCCESS && !decoder->Deserialize(reply.payload, response)) {
+                status = RpcStatus::SERIALIZATION_ERROR;
+            }
+            done(status, response);
+        });
+    }
+
+private:
+    template<typename Method>
+    struct Handles {
+        SerializerHandle<typename Method::Request> request;
+        SerializerHandle<typename Method::Response> response;
+    };
+
+    template<typename Method>
+    bool Encode(const Handles<Method>& handles, const typename Method::Request& request,
+                uint32_t deadline_ms, RpcRequestData& data) {
+        data.header.method_id = Method::kId;
+        data.header.deadline_ms = deadline_ms;
+        data.method_name.assign(Method::kName);
+        data.serializer_name.assign(serializer_name_);
+        return handles.request.Serialize(request, data.payload);
+    }
+
+    RpcChannel& channel_;
+    std::string serializer_name_;
+    std::tuple<Handles<Methods>...> handles_;
+};
+
+template<typename Method>
+using TypedHandler = std::function<RpcStatus(const typename Method::Request& request,
+                                             typename Method::Response& response)>;
+
+// Method::Request is the head message, without the streamed bulk field
+template<typename Method>
+using TypedStreamingHandler = std::function<RpcStatus(const typename Method::Request& request,
+                                                      RequestStream& body,
+                                                      typename Method::Response& response)>;
+
+// Writes the response payload itself in the negotiated format, e.g. from
+// parts encoded once and shared between calls
+template<typename Method>
+using EncodingHandler = std::function<RpcStatus(const typename Method::Request& request,
+                                                const std::string& serializer_name,
+                                                std::string& payload)>;
+
+/**
+ * @brief Server skeleton registering typed handlers into a MethodTable
+ *
+ * Serializers are resolved at registration for every format the server
+ * accepts; a request picks its pair by comparing serializer names, with
+ * no registry access while serving.
+ */
+class ServiceSkeleton {
+public:
+    ServiceSkeleton(MethodTable& methods, std::vector<std::string> serializer_names)
+        : methods_(methods), serializer_names_(std::move(serializer_names)) {}
+
+    /**
+     * @return false if the method name is already registered
+     */
+    template<typename Method>
+    bool Register(TypedHandler<Method> handler, const MethodOptions& options = MethodOptions()) {
+        using Request = typename Method::Request;
+        using Response = typename Method::Response;
+        static_assert(Method::kId == MethodIdOf(Method::kName), "declare methods with GRLRPC_METHOD");
+
+        return methods_.Register(Method::kName,
+            [formats = ResolveFormats<Method>(), handler = std::move(handler), one_way = options.one_way](
+                const RpcRequestData& data, RpcResponseData& reply) {
+                const Format<Method>* format = SelectFormat(formats, data.serializer_name);
+                Request request;
+                if (!format || !format->request.Deserialize(data.payload, request)) {
+                    reply.error_message = "cannot decode request as " + data.serializer_name;
+                    return RpcStatus::SERIALIZATION_ERROR;
+                }
+                Response response;
+                RpcStatus status = handler(request, response);
+                if (status == RpcStatus::SUCCESS && !one_way && MessageCodec::ExpectsResponse(data.header) &&
+                    !format->response.Serialize(response, reply.payload)) {
+                    return RpcStatus::SERIALIZATION_ERROR;
+                }
+                return status;
+            }, options);
+    }
+
+    /**
+     * @brief Register a handler that encodes its own response
+     *
+     * The payload must decode with Method::Response's serializer for the
+     * request's format; the handler reports formats it cannot write with
+     * SERIALIZATION_ERROR. For one-way requests the handler still writes
+     * it, and the payload is dropped.
+     */
+    template<typename Method>
+    bool RegisterEncoded(EncodingHandler<Method> handler, const MethodOptions& options = MethodOptions()) {
+        using Request = typename Method::Request;
+        static_assert(Method::kId == MethodIdOf(Method::kName), "declare methods with GRLRPC_METHOD");
+
+        return methods_.Register(Method::kName,
+            [formats = ResolveFormats<Method>(), handler = std::move(handler), one_way = options.one_way](
+                const RpcRequestData& data, RpcResponseData& reply) {
+                const Format<Method>* format = SelectFormat(formats, data.serializer_name);
+                Request request;
+                if (!format || !format->request.Deserialize(data.payload, request)) {
+                    reply.error_message = "cannot decode request as " + data.serializer_name;
+                    return RpcStatus::SERIALIZATION_ERROR;
+                }
+                RpcStatus status = handler(request, data.serializer_name, reply.payload);
+                if (one_way || !MessageCodec::ExpectsResponse(data.header)) {
+                    reply.payload.clear();
+                }
+                return status;
+            }, options);
+    }
+
+    /**
+     * @brief Register a streaming upload; the head is decoded before the body arrives
+     */
+    template<typename Method>
+    bool RegisterStreaming(TypedStreamingHandler<Method> handler,
+                           const MethodOptions& options = MethodOptions()) {
+        using Request = typename Method::Request;
+        using Response = typename Method::Response;
+        static_assert(Method::kId == MethodIdOf(Method::kName), "declare methods with GRLRPC_METHOD");
+
+        return methods_.RegisterStreaming(Method::kName,
+            [formats = ResolveFormats<Method>(), handler = std::move(handler), one_way = options.one_way](
+                const RpcRequestData& data, RequestStream& body, RpcResponseData& reply) {
+                const Format<Method>* format = SelectFormat(formats, data.serializer_name);
+                Request request;
+                if (!format || !format->request.Deserialize(data.payload, request)) {
+                    reply.error_message = "cannot decode request as " + data.serializer_name;
+                    return RpcStatus::SERIALIZATION_ERROR;
+                }
+                Response response;
+                RpcStatus status = handler(request, body, response);
+                if (status == RpcStatus::SUCCESS && !one_way && MessageCodec::ExpectsResponse(data.header) &&
+                    !format->response.Serialize(response, reply.payload)) {
+                    return RpcStatus::SERIALIZATION_ERROR;
+                }
+                return status;
+            }, options);
+    }
+
+private:
+    template<typename Method>
+    struct Format {
+        std::string name;
+        SerializerHandle<typename Method::Request> request;
+        SerializerHandle<typename Method::Response> response;
+    };
+
+    template<typename Method>
+    std::vector<Format<Method>> ResolveFormats() const {
+        std::vector<Format<Method>> formats;
+        for (const auto& name : serializer_names_) {
+            formats.push_back(Format<Method>{
+                name, SerializerHandle<typename Method::Request>::Resolve(name),
+                SerializerHandle<typename Method::Response>::Resolve(name)});
+        }
+        return formats;
+    }
+
+    template<typename Method>
+    static const Format<Method>* SelectFormat(const std::vector<Format<Method>>& formats,
+                                              const std::string& serializer_name) {
+        for (const auto& candidate : formats) {
+            if (candidate.name == serializer_name) {
+                return &candidate;
+            }
+        }
+        return nullptr;
+    }
+
+    MethodTable& methods_;
+    std::vector<std::string> serializer_names_;
+};
+
 class GrlRpcServer;
 class GrlRpcClient;
 
@@ -355,6 +355,98 @@ public:
 };
 
 
+// ============================================================================
+// SerializerHandle
+// Serializer for one type and format, resolved once up front so per-message
+// code skips the registry lock, type-name demangling and map lookups
+// ============================================================================
+
+template<typename T>
+class SerializerHandle {
+public:
+    SerializerHandle() = default;
+
+    // Same precedence as SerializerFactory: type-specific, then generic
+    static SerializerHandle Resolve(const std::string& serializer_name) {
+        SerializerHandle handle;
+        handle.typed_ = SerializerRegistry::Instance().GetTypeSerializer<T>(serializer_name);
+        if (!handle.typed_) {
+            handle.descriptor_ = ReflectionRegistry::Instance().GetDescriptor(
+                SerializerFactory::GetDemangled<T>());
+            if (handle.descriptor_) {
+                handle.generic_ = SerializerRegistry::Instance().GetSerializer(serializer_name);
+            }
+        }
+        return handle;
+    }
+
+    bool IsValid() const { return typed_ != nullptr || generic_ != nullptr; }
+
+    bool Serialize(const T& obj, std::string& output) const {
+        if (typed_) {
+            return typed_->Serialize(obj, output);
+        }
+        return generic_ && generic_->Serialize(&obj, *descriptor_, output);
+    }
+
+    bool Deserialize(const std::string& input, T& obj) const {
+        if (typed_) {
+            return typed_->Deserialize(input, obj);
+        }
+        return generic_ && generic_->Deserialize(input, &obj, *descriptor_);
+    }
+
+private:
+    ITypeSerializer<T>* typed_ = nullptr;
+    ISerializer* generic_ = nullptr;
+    const MessageDescriptor* descriptor_ = nullptr;
+};
+
+
+// ============================================================================
+// JsonSerializer
+// Generic reflection-based JSON serializer (registered as "json")
+// BYTES fields are carried as base64 strings; MESSAGE fields are not supported
+// ============================================================================
+
+class JsonSerializer : public ISerializer {
+public:
+    bool Serialize(const void* obj, const MessageDescriptor& desc,
+                  std::string& output) override;
+    bool Deserialize(const std::string& input, void* obj,
+                    const MessageDescriptor& desc) override;
+    std::string GetName() const override { return "json"; }
+};
+
+// ============================================================================
+// BinarySerializer
+// Generic reflection-based binary serializer (registered as "binary")
+// Fields follow each other in descriptor order without tags: integers and
+// floats are fixed width little-endian, BOOL is one byte and STRING/BYTES a
+// u32 length followed by the bytes. MESSAGE fields are not supported.
+// ============================================================================
+
+class BinarySerializer : public ISerializer {
+public:
+    bool Serialize(const void* obj, const MessageDescriptor& desc,
+                  std::string& output) override;
+    // Fails on truncated input and on bytes left over after the last field
+    bool Deserialize(const std::string& input, void* obj,
+                    const MessageDescriptor& desc) override;
+    std::string GetName() const override { return "binary"; }
+};
+
+/**
+ * @brief Register the generic serializers shipped with the framework
+ */
+void RegisterBuiltinSerializers();
+
+std::string Base64Encode(const std::string& input);
+// Appends the encoding of input to output
+void AppendBase64(const std::string& input, std::string& output);
+bool Base64Decode(const std::string& input, std::string& output);
+
+
 // ============================================================================
 // Helper Functions and Macros
 // ============================================================================
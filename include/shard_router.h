@@ -0,0 +1,149 @@
+// GrlRPC Shard Router Header
+// Key-affinity sharding for GrlRpcServer: each request is mapped to the core
+// that owns its routing key, and shard-local state is touched by one thread only
+
+#ifndef GRLRPC_SHARD_ROUTER_H
+#define GRLRPC_SHARD_ROUTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mpsc_queue.h"
+#include "rpc_framework.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// Routing Key Extraction
+// ============================================================================
+
+/**
+ * @brief Reads a routing key straight from an encoded payload
+ * @return false if the payload is too short or malformed; the request is
+ *         then served by the accepting shard
+ */
+using RoutingKeyExtractor = std::function<bool(std::string_view payload, uint64_t& key)>;
+
+/**
+ * @brief Extractor for a little-endian uint64 at a fixed payload offset
+ *
+ * Binary encodings that write a fixed-width key first (e.g. user_id in
+ * GetUserRequest) are routed with FixedOffsetKeyExtractor(0), without
+ * decoding the rest of the message.
+ */
+RoutingKeyExtractor FixedOffsetKeyExtractor(size_t offset);
+
+// ============================================================================
+// ShardRouter
+// ============================================================================
+
+class ShardRouter {
+public:
+    static constexpr size_t kAnyShard = static_cast<size_t>(-1);
+
+    explicit ShardRouter(size_t shard_count);
+
+    // Extractors must be registered before the server starts; lookups are lock-free reads
+    void SetKeyExtractor(uint32_t method_id, RoutingKeyExtractor extractor);
+
+    /**
+     * @brief Map a request to its owning shard
+     * @return Shard index, or kAnyShard if the method has no affinity
+     */
+    size_t Route(const FrameHeader& header, std::string_view payload) const;
+
+    size_t ShardOf(uint64_t key) const;
+    size_t ShardCount() const { return shard_count_; }
+
+private:
+    size_t shard_count_;
+    std::unordered_map<uint32_t, RoutingKeyExtractor> extractors_;
+};
+
+// ============================================================================
+// ShardLocal
+// One cache-line-isolated instance of T per shard, accessed without locks by
+// the thread that owns the shard
+// ============================================================================
+
+template<typename T>
+class ShardLocal {
+public:
+    explicit ShardLocal(size_t shard_count) : slots_(shard_count) {}
+
+    T& Get(size_t shard) { return slots_[shard].value; }
+    const T& Get(size_t shard) const { return slots_[shard].value; }
+    size_t Size() const { return slots_.size(); }
+
+private:
+    struct alignas(64) Slot {
+        T value{};
+    };
+    std::vector<Slot> slots_;
+};
+
+// ============================================================================
+// ShardExecutor
+// Forwards work to the owning loop through its MPSC inbox
+// ============================================================================
+
+using ShardTask = std::function<void()>;
+
+class ShardExecutor {
+public:
+    explicit ShardExecutor(size_t shard_count, size_t inbox_capacity = 65536);
+
+    /**
+     * @brief Declare that the calling thread runs the loop of `shard`
+     */
+    static void BindCurrentThread(size_t shard);
+    static size_t CurrentShard();
+
+    /**
+     * @brief Hook run after a task is queued for `shard` (e.g. EventLoop eventfd write)
+     */
+    void SetWakeup(size_t shard, std::function<void()> wakeup);
+
+    /**
+     * @brief Run `task` on the owner of `target_shard`
+     * @return false if `target_shard` is out of range or the owner's inbox
+     *         is full; `task` is then left untouched and the caller should
+     *         reply with an overload error instead of blocking the loop
+     *
+     * Runs inline when the calling thread already owns the shard.
+     */
+    bool Dispatch(size_t target_shard, ShardTask& task);
+    bool Dispatch(size_t target_shard, ShardTask&& task) { return Dispatch(target_shard, task); }
+
+    /**
+     * @brief Run queued tasks; called by the owning loop once per iteration
+     * @return Number of tasks executed
+     */
+    size_t Drain(size_t shard, size_t max_tasks = static_cast<size_t>(-1));
+
+    uint64_t GetForwardedCount(size_t shard) const {
+        return shards_[shard]->forwarded.load(std::memory_order_relaxed);
+    }
+
+    size_t ShardCount() const { return shards_.size(); }
+
+private:
+    struct alignas(64) Shard {
+        explicit Shard(size_t capacity) : inbox(capacity) {}
+        MpscQueue<ShardTask> inbox;
+        std::function<void()> wakeup;
+        std::atomic<uint64_t> forwarded{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_SHARD_ROUTER_H
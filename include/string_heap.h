@@ -0,0 +1,90 @@
+// GrlRPC String Heap Header
+// Append-only storage for interned strings, addressed by 32-bit references
+// and read without locks
+
+#ifndef GRLRPC_STRING_HEAP_H
+#define GRLRPC_STRING_HEAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace grlrpc {
+
+/**
+ * @brief Interning table for low-cardinality strings (e.g. email domains)
+ *
+ * Each distinct string is stored once, as a length byte and its bytes, in
+ * fixed-size chunks that are never moved or freed before the heap. A
+ * reference is the entry's offset plus one, so a record can hold a string
+ * in 4 bytes. View() only reads. Intern() finds strings already present in
+ * a published hash table without locking; only appending a new one takes
+ * the mutex.
+ */
+class StringHeap {
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr size_t kMaxChunks = 1024;   // 64 MB of strings
+    static constexpr size_t kMaxLength = 255;
+    // Never returned by a successful Intern()
+    static constexpr uint32_t kNone = 0;
+
+    StringHeap();
+    ~StringHeap();
+
+    StringHeap(const StringHeap&) = delete;
+    StringHeap& operator=(const StringHeap&) = delete;
+
+    /**
+     * @brief Reference to `value`, appending it on first use
+     * @return kNone if `value` is empty or longer than kMaxLength, or the heap is full
+     */
+    uint32_t Intern(std::string_view value);
+
+    /**
+     * @brief The string behind a reference returned by Intern()
+     *
+     * Safe on any thread that obtained the reference through a
+     * release/acquire pair (e.g. from a published record).
+     */
+    std::string_view View(uint32_t ref) const {
+        size_t offset = ref - 1;
+        const char* entry = chunks_[offset / kChunkSize].load(std::memory_order_acquire) + offset % kChunkSize;
+        return std::string_view(entry + 1, static_cast<uint8_t>(entry[0]));
+    }
+
+    size_t Size() const;
+    // Bytes of chunks allocated so far
+    size_t Capacity() const;
+
+private:
+    // Open-addressing table of references, kept at most half full; growing
+    // publishes a larger copy
+    struct Table {
+        explicit Table(size_t capacity);
+
+        size_t mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> refs;   // kNone = empty
+    };
+
+    uint32_t Find(const Table& table, std::string_view value, size_t hash) const;
+    void InsertLocked(uint32_t ref, size_t hash);
+
+    mutable std::mutex mutex_;
+    std::atomic<Table*> table_;
+    // Every table so far, the current one last: readers may still probe a
+    // replaced one, and all of them together stay under twice the last
+    std::vector<std::unique_ptr<Table>> tables_;
+    size_t count_ = 0;
+    std::unique_ptr<std::atomic<char*>[]> chunks_;
+    size_t chunk_count_ = 0;
+    size_t used_ = 0;   // bytes appended, including chunk tails skipped
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_STRING_HEAP_H
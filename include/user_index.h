@@ -0,0 +1,110 @@
+// GrlRPC User Index Header
+// Secondary indexes of the user store: a hash index on email and an
+// ordered index on name for prefix search
+//
+// Readers never lock. Index entries are hints: a lookup yields candidate
+// user ids and the store checks each against the user's current record, so
+// an entry that is briefly stale (added before the record is written, or
+// removed after it changed) is never returned as a match.
+//
+// Tables and nodes a writer unlinks are retired to an EpochManager, so
+// readers must hold a pin of that manager.
+
+#ifndef GRLRPC_USER_INDEX_H
+#define GRLRPC_USER_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "epoch_manager.h"
+
+namespace grlrpc {
+
+// Return false to stop the lookup
+using IndexVisitor = std::function<bool(uint64_t user_id)>;
+using NameIndexVisitor = std::function<bool(std::string_view name, uint64_t user_id)>;
+
+// ============================================================================
+// EmailIndex
+// Striped open-addressing tables of (email hash, user id)
+// ============================================================================
+
+class EmailIndex {
+public:
+    explicit EmailIndex(EpochManager& epochs, size_t stripe_count = 16);
+    ~EmailIndex();
+
+    EmailIndex(const EmailIndex&) = delete;
+    EmailIndex& operator=(const EmailIndex&) = delete;
+
+    void Insert(std::string_view email, uint64_t user_id);
+    void Remove(std::string_view email, uint64_t user_id);
+
+    // Visit every user id whose email hashes like `email`
+    void Find(std::string_view email, const IndexVisitor& visit) const;
+
+private:
+    struct Table;
+    struct Stripe;
+
+    static uint64_t Hash(std::string_view email);
+    Stripe& StripeOf(uint64_t hash) const;
+
+    EpochManager& epochs_;
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+};
+
+// ============================================================================
+// NameIndex
+// Skip list of (name, user id) with a single writer at a time
+// ============================================================================
+
+class NameIndex {
+public:
+    explicit NameIndex(EpochManager& epochs);
+    ~NameIndex();
+
+    NameIndex(const NameIndex&) = delete;
+    NameIndex& operator=(const NameIndex&) = delete;
+
+    void Insert(std::string_view name, uint64_t user_id);
+    void Remove(std::string_view name, uint64_t user_id);
+
+    /**
+     * @brief Visit entries whose name starts with `prefix`, in (name, id) order
+     */
+    void FindPrefix(std::string_view prefix, const NameIndexVisitor& visit) const;
+
+    size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kMaxHeight = 20;
+
+    struct Node;
+
+    static Node* NewNode(std::string_view name, uint64_t user_id, int height);
+    static void DeleteNode(Node* node);
+    static bool Less(const Node* node, std::string_view name, uint64_t user_id);
+    int RandomHeight();
+
+    // Fill `preds` with the last node before (name, user_id) on each level
+    Node* FindGreaterOrEqual(std::string_view name, uint64_t user_id, Node** preds) const;
+
+    EpochManager& epochs_;
+    Node* head_;
+    std::mutex write_mutex_;
+    uint64_t rng_state_ = 0x9E3779B97F4A7C15ull;
+    std::atomic<int> height_{1};
+    std::atomic<size_t> size_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_INDEX_H
@@ -0,0 +1,201 @@
+// GrlRPC User Persistence Header
+// Makes UserStore writes survive restarts: every write is logged to a
+// WriteAheadLog and acknowledged after its group commit; compacted
+// snapshots bound the log and are mapped back in at startup
+//
+// Directory layout:
+//   snapshot        latest compacted snapshot
+//   snapshot.tmp    snapshot being written (ignored on startup)
+//   wal.<segment>   log segments written after the snapshot
+//
+// Log records carry the user's full state after the write, so replaying a
+// record is idempotent and only the order of records for the same user
+// matters. That order is the shard's write order, which is what lets replay
+// run one thread per group of shards.
+//
+// Exports use the snapshot format with no log behind them, so an export can
+// be imported into a running store or installed as an empty directory's
+// snapshot.
+
+#ifndef GRLRPC_USER_PERSISTENCE_H
+#define GRLRPC_USER_PERSISTENCE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "user_store.h"
+#include "write_ahead_log.h"
+
+namespace grlrpc {
+
+struct PersistenceConfig {
+    // Threads applying the snapshot and log at startup; 0 = one per core
+    size_t replay_threads = 0;
+    // Snapshot at least this often while writes arrive; 0 disables the
+    // background snapshot thread
+    std::chrono::milliseconds snapshot_interval{std::chrono::minutes(10)};
+    // ...or as soon as the current log segment grows past this
+    uint64_t snapshot_log_bytes = 64ull * 1024 * 1024;
+    // Threads encoding a snapshot; more finish sooner but compete with serving
+    size_t snapshot_threads = 1;
+};
+
+struct RecoveryStats {
+    uint64_t snapshot_users = 0;
+    uint64_t log_records = 0;
+    uint64_t log_segments = 0;
+    uint64_t torn_bytes = 0;     // discarded from segment tails
+};
+
+struct BulkTransferConfig {
+    // Workers encoding or decoding; 0 = one per core
+    size_t threads = 0;
+};
+
+struct BulkTransferStats {
+    uint64_t users = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief Write every user, as of one ReadView, to a new file at `path`
+ *
+ * Workers take whole shards and encode them in parallel, appending 1 MB
+ * runs of records to the file as they fill, so the order of users in the
+ * file is unspecified. Writers are not blocked.
+ */
+bool ExportUsers(const UserStore& store, const std::string& path, const BulkTransferConfig& config,
+                 BulkTransferStats& stats, std::string& error);
+
+/**
+ * @brief Restore every user of an export (or snapshot) file into `store`
+ *
+ * The file is mapped, split at record boundaries into chunks, and workers
+ * check, decode and restore one chunk at a time. Users already in the
+ * store are overwritten. Like recovery, this bypasses the write listener:
+ * import before UserPersistence::Open(), or take a Snapshot() afterwards
+ * to make the users durable.
+ */
+bool ImportUsers(UserStore& store, const std::string& path, const BulkTransferConfig& config,
+                 BulkTransferStats& stats, std::string& error);
+
+// ============================================================================
+// UserColdStore
+// ============================================================================
+
+/**
+ * @brief Read-only users served straight from a mapped export file
+ *
+ * Only an id -> offset table (16 bytes a slot) is kept in memory; records
+ * are read from the mapping on demand, so a lookup of a user whose pages
+ * are not resident blocks on the disk. Records are CRC-checked when read,
+ * not when the file is opened.
+ */
+class UserColdStore {
+public:
+    UserColdStore() = default;
+
+    UserColdStore(const UserColdStore&) = delete;
+    UserColdStore& operator=(const UserColdStore&) = delete;
+
+    // Map `path` (an export or snapshot) and index its records
+    bool Open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Find a user's encoded record
+     * @param payload Set to the record inside the mapping
+     * @return false if the user is not in the file or its record is corrupt
+     */
+    bool Find(uint64_t user_id, std::string_view& payload) const;
+
+    static bool Decode(std::string_view payload, UserRecord& record);
+
+    size_t Size() const { return size_; }
+    uint64_t MaxUserId() const { return max_user_id_; }
+    size_t IndexBytes() const { return slots_.size() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint64_t user_id = 0;   // 0 = empty
+        uint64_t offset = 0;    // of the record frame
+    };
+
+    MappedFile file_;
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    uint64_t max_user_id_ = 0;
+};
+
+// ============================================================================
+// UserPersistence
+// ============================================================================
+
+class UserPersistence {
+public:
+    UserPersistence(UserStore& store, std::string directory, PersistenceConfig config = {});
+
+    // Stops the snapshot thread and flushes the log; stop serving first
+    ~UserPersistence();
+
+    UserPersistence(const UserPersistence&) = delete;
+    UserPersistence& operator=(const UserPersistence&) = delete;
+
+    /**
+     * @brief Load the snapshot, replay the log into the (empty) store, then
+     *        start logging the store's writes
+     */
+    bool Open(std::string& error);
+
+    /**
+     * @brief Wait until the write that returned `sequence` is on disk
+     *
+     * UserStore applies a write before it is logged, so a concurrent reader
+     * can see it before it is durable; only the writer's acknowledgement
+     * waits for the sync.
+     */
+    bool WaitDurable(uint64_t sequence) { return log_.WaitDurable(sequence); }
+
+    /**
+     * @brief Write a compacted snapshot and drop the log it covers
+     *
+     * Writers keep going: the log is rotated first, so every write the
+     * snapshot may miss is in a newer segment.
+     */
+    bool Snapshot(std::string& error);
+
+    const RecoveryStats& GetRecoveryStats() const { return recovery_; }
+    uint64_t GetSyncCount() const { return log_.GetSyncCount(); }
+    uint64_t GetSnapshotCount() const { return snapshot_count_.load(std::memory_order_relaxed); }
+    // Background snapshots that failed; the log keeps growing until one succeeds
+    uint64_t GetSnapshotFailureCount() const { return snapshot_failures_.load(std::memory_order_relaxed); }
+
+private:
+    bool Recover(std::string& error);
+    void SnapshotLoop();
+
+    UserStore& store_;
+    const std::string directory_;
+    const PersistenceConfig config_;
+    WriteAheadLog log_;
+    RecoveryStats recovery_;
+
+    std::mutex snapshot_mutex_;   // one snapshot at a time
+    std::atomic<uint64_t> snapshot_count_{0};
+    std::atomic<uint64_t> snapshot_failures_{0};
+
+    std::mutex loop_mutex_;
+    std::condition_variable loop_wakeup_;
+    bool stopping_ = false;
+    std::thread snapshot_thread_;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_PERSISTENCE_H
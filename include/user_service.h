@@ -0,0 +1,115 @@
+// GrlRPC User Service Header
+// GetUser / CreateUser / UpdateUser backed by the sharded UserStore, plus
+// lookups, batched reads and change watching
+
+#ifndef GRLRPC_USER_SERVICE_H
+#define GRLRPC_USER_SERVICE_H
+
+#include "fan_out_pool.h"
+#include "rpc_framework.h"
+#include "shard_router.h"
+#include "user_persistence.h"
+#include "user_store.h"
+#include "user_tier.h"
+#include "user_types.h"
+#include "user_watch.h"
+
+namespace grlrpc {
+
+GRLRPC_METHOD(GetUserMethod, "UserService/GetUser", GetUserRequest, GetUserResponse);
+GRLRPC_METHOD(CreateUserMethod, "UserService/CreateUser", CreateUserRequest, CreateUserResponse);
+GRLRPC_METHOD(UpdateUserMethod, "UserService/UpdateUser", UpdateUserRequest, UpdateUserResponse);
+GRLRPC_METHOD(BatchGetUsersMethod, "UserService/BatchGetUsers", BatchGetUsersRequest, BatchGetUsersResponse);
+GRLRPC_METHOD(FindUserByEmailMethod, "UserService/FindUserByEmail", FindUserByEmailRequest, GetUserResponse);
+GRLRPC_METHOD(SearchUsersMethod, "UserService/SearchUsers", SearchUsersRequest, SearchUsersResponse);
+GRLRPC_METHOD(WatchUsersMethod, "UserService/WatchUsers", WatchUsersRequest, WatchUsersResponse);
+
+// ============================================================================
+// UserService
+// ============================================================================
+
+class UserService {
+public:
+    // Larger BatchGetUsers requests are rejected with INVALID_REQUEST
+    static constexpr size_t kMaxBatchSize = 1000;
+    // Smaller batches are cheaper to serve on one core than to fan out
+    static constexpr size_t kParallelBatchThreshold = 64;
+
+    /**
+     * @param persistence If set, Create/Update reply only once the write is
+     *        durable; a failed sync is reported as success = false with
+     *        error "NOT_DURABLE"
+     *
+     * NOT_DURABLE does not undo the write: it is already visible and only
+     * its survival across a restart is unknown. CreateUser still returns
+     * the assigned user_id then, so a caller can check on that user rather
+     * than retry and create a second one.
+     */
+    explicit UserService(UserStore& store, UserPersistence* persistence = nullptr)
+        : store_(store), persistence_(persistence) {}
+
+    /**
+     * @brief Register all methods; GetUser and FindUserByEmail never block,
+     *        so they run inline on the IO loop (GetUser only without a tier)
+     * @return false if any method name is already taken
+     */
+    bool Register(ServiceSkeleton& skeleton);
+
+    /**
+     * @brief Route GetUser/UpdateUser to the shard owning the user id
+     * @param serializer_name Format of every request the router will see
+     * @return false, installing nothing, unless that format is "binary"
+     *
+     * The key is read as the leading little-endian u64 of the payload,
+     * which is the user id only in the binary encoding; other formats would
+     * all hash the same leading bytes onto one shard.
+     */
+    bool ConfigureRouting(ShardRouter& router, const std::string& serializer_name) const;
+
+    /**
+     * @brief Look up the shard groups of large batches in parallel; without
+     *        a pool they are served one after another on the calling thread
+     */
+    void SetFanOutPool(FanOutPool* pool) { fan_out_ = pool; }
+
+    /**
+     * @brief Serve WatchUsers from `hub`; call before Register(), which
+     *        leaves WatchUsers out without a hub
+     */
+    void SetWatchHub(UserWatchHub* hub) { watch_hub_ = hub; }
+
+    /**
+     * @brief Fall back to `tier` for users the store does not hold; call
+     *        before Register()
+     *
+     * GetUser and BatchGetUsers then read through to the cold tier, and
+     * UpdateUser makes a cold user resident first. GetUser may wait for the
+     * disk, so it moves off the IO loop. FindUserByEmail and SearchUsers
+     * only see resident users.
+     */
+    void SetTieredStore(TieredUserStore* tier) { tier_ = tier; }
+
+    RpcStatus GetUser(const GetUserRequest& request, GetUserResponse& response);
+    RpcStatus CreateUser(const CreateUserRequest& request, CreateUserResponse& response);
+    RpcStatus UpdateUser(const UpdateUserRequest& request, UpdateUserResponse& response);
+    RpcStatus BatchGetUsers(const BatchGetUsersRequest& request, BatchGetUsersResponse& response);
+    RpcStatus FindUserByEmail(const FindUserByEmailRequest& request, GetUserResponse& response);
+    RpcStatus SearchUsers(const SearchUsersRequest& request, SearchUsersResponse& response);
+    // Long-polls, so never inline; encodes the response itself (see user_watch.h)
+    RpcStatus WatchUsers(const WatchUsersRequest& request, const std::string& serializer_name,
+                         std::string& payload);
+
+private:
+    // Fill the users a batch did not find in the store from the tier
+    void ReadThroughMisses(const BatchGetUsersRequest& request, BatchGetUsersResponse& response);
+
+    UserStore& store_;
+    UserPersistence* persistence_;
+    FanOutPool* fan_out_ = nullptr;
+    UserWatchHub* watch_hub_ = nullptr;
+    TieredUserStore* tier_ = nullptr;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_SERVICE_H
@@ -0,0 +1,295 @@
+// GrlRPC User Store Header
+// Sharded in-memory user table behind the user service: multi-version
+// records with lock-free, consistent reads and one write lock per shard
+
+#ifndef GRLRPC_USER_STORE_H
+#define GRLRPC_USER_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "epoch_manager.h"
+#include "shard_router.h"
+#include "string_heap.h"
+#include "user_index.h"
+#include "user_types.h"
+
+namespace grlrpc {
+
+enum class UserStoreStatus {
+    OK,
+    NOT_FOUND,
+    INVALID_ARGUMENT
+};
+
+std::string UserStoreStatusToString(UserStoreStatus status);
+
+// Complete state of one user, as persisted and restored
+struct UserRecord {
+    uint64_t user_id = 0;
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+    int64_t created_at_ms = 0;
+    int64_t updated_at_ms = 0;
+    std::string avatar;
+};
+
+// Memory held by a UserStore, excluding avatars and indexes
+struct UserStoreMemory {
+    size_t record_bytes = 0;     // live versions, rounded to their size classes
+    size_t arena_bytes = 0;      // slabs reserved for versions
+    size_t table_bytes = 0;      // slot tables
+    size_t interned_bytes = 0;   // string heap chunks
+    size_t interned_strings = 0;
+};
+
+/**
+ * @brief Observes every successful write with the user's new state
+ * @param avatar_changed false when record.avatar was left empty because
+ *        the write did not touch it
+ * @return A sequence number handed back to the writer (e.g. a log position)
+ *
+ * Called under the shard's write lock, so calls for one user arrive in the
+ * order the writes were applied.
+ */
+using UserWriteListener = std::function<uint64_t(const UserRecord& record, bool avatar_changed)>;
+
+/**
+ * @brief Observes the same writes as UserWriteListener, after it, and also
+ *        tells creates from updates (change data capture)
+ */
+using UserChangeListener = std::function<void(const UserRecord& record, bool created, bool avatar_changed)>;
+
+// ============================================================================
+// UserStore
+// ============================================================================
+
+/**
+ * @brief Users sharded by id, with lock-free reads
+ *
+ * Shards use the same multiply-shift mapping as ShardRouter, so with equal
+ * shard counts store shard i is only ever written by server shard i.
+ *
+ * Each shard is an open-addressing table of slots pointing at the newest
+ * version of a user. Versions are immutable and carry the timestamp of the
+ * write that created them; a write builds a new version under the shard's
+ * mutex and publishes it with one pointer store, linking the version it
+ * replaces behind it. Readers pin an epoch of the store's EpochManager and
+ * follow the pointers without locking or retrying, however busy the
+ * writers are. A ReadView reads every user as of one timestamp; a replaced
+ * version is reclaimed once no reader pinned before the replacement is
+ * left, so only views that are open at the time keep old versions alive.
+ * The avatar is shared by all versions of a user until it changes.
+ *
+ * A version is one variable-length block: timestamps, age and lengths
+ * packed together, then the name and email bytes, carved from a per-shard
+ * slab arena in 16-byte size classes. Email domains are interned in a
+ * StringHeap and stored as 32-bit references. Strings are only copied out
+ * when a response or record is built.
+ *
+ * Email and name are indexed (see user_index.h). Writers update the indexes
+ * under the shard lock; index readers take no lock and check every hit
+ * against the record, so they only ever return users as they currently are.
+ */
+class UserStore {
+public:
+    static constexpr size_t kMaxNameLength = 80;
+    static constexpr size_t kMaxEmailLength = 120;
+    static constexpr size_t kMaxSearchResults = 100;
+
+    /**
+     * @param initial_capacity Slots per shard before the first growth
+     */
+    explicit UserStore(size_t shard_count = 16, size_t initial_capacity = 1024);
+    ~UserStore();
+
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+
+    /**
+     * @brief Insert a new user and assign its id (ids start at 1)
+     * @return INVALID_ARGUMENT if the name is empty or a field is too long
+     */
+    UserStoreStatus Create(const CreateUserRequest& request, int64_t now_ms, uint64_t& user_id,
+                           uint64_t* write_sequence = nullptr);
+
+    /**
+     * @brief Update a user; fields left at their defaults (empty string, age 0) are unchanged
+     */
+    UserStoreStatus Update(const UpdateUserRequest& request, int64_t now_ms,
+                           uint64_t* write_sequence = nullptr);
+
+    /**
+     * @brief Insert or overwrite a user with a given id (recovery)
+     * @param set_avatar false keeps the stored avatar
+     *
+     * Later Create() calls never reuse a restored id. Not reported to the
+     * write or change listener.
+     */
+    void Restore(const UserRecord& record, bool set_avatar);
+
+    /**
+     * @brief Restore() a user from outside the log (e.g. a cold tier) and
+     *        report it to the write listener as a full record
+     *
+     * Logged under the shard lock like any write, so later updates of the
+     * user replay on top of it. Not reported to the change listener: the
+     * user itself does not change.
+     */
+    void Promote(const UserRecord& record, uint64_t* write_sequence = nullptr);
+
+    // Later Create() calls assign ids above `user_id`, e.g. ids held in another tier
+    void ReserveUserIds(uint64_t user_id);
+
+    /**
+     * @brief Visit every user as of one point in time, shard by shard
+     *
+     * Runs on a ReadView: writers are not blocked and writes made during
+     * the walk are not seen. Versions replaced during a long walk are only
+     * reclaimed after it.
+     */
+    void ForEach(const std::function<void(const UserRecord& record)>& visit) const;
+
+    /**
+     * @brief Install the write listener; call before serving
+     */
+    void SetWriteListener(UserWriteListener listener) { listener_ = std::move(listener); }
+
+    /**
+     * @brief Install the change listener; call before serving
+     */
+    void SetChangeListener(UserChangeListener listener) { change_listener_ = std::move(listener); }
+
+    /**
+     * @brief Fill `response` with the user's latest fields; never blocks on writers
+     * @return false if the user does not exist
+     */
+    bool Get(uint64_t user_id, bool include_avatar, GetUserResponse& response) const;
+
+    // ---- Snapshots -------------------------------------------------------
+
+    /**
+     * @brief Consistent view of the whole store
+     *
+     * Sees exactly the writes committed before it was opened, on whichever
+     * thread it is read. Replaced versions it may need stay allocated while
+     * it is open, so keep it short-lived. Destroy it on the thread that
+     * opened it.
+     */
+    class ReadView {
+    public:
+        // Commit timestamp of the newest write the view sees
+        uint64_t Timestamp() const { return timestamp_; }
+
+    private:
+        friend class UserStore;
+        ReadView(EpochManager::Guard guard, uint64_t timestamp)
+            : guard_(std::move(guard)), timestamp_(timestamp) {}
+
+        EpochManager::Guard guard_;
+        uint64_t timestamp_;
+    };
+
+    ReadView OpenView() const;
+
+    /**
+     * @brief Get() as of the view
+     * @return false if the user did not exist when the view was opened
+     */
+    bool Get(const ReadView& view, uint64_t user_id, bool include_avatar,
+             GetUserResponse& response) const;
+
+    /**
+     * @brief Visit one shard's users as of the view
+     *
+     * Different shards may be walked in parallel on one view.
+     */
+    void ForEach(const ReadView& view, size_t shard,
+                 const std::function<void(const UserRecord& record)>& visit) const;
+
+    // ---- Multi-get -------------------------------------------------------
+
+    /**
+     * @brief Request positions grouped by owning shard
+     *
+     * Shard s owns positions order[shard_begin[s]] .. order[shard_begin[s + 1] - 1].
+     */
+    struct BatchPlan {
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> shard_begin;
+    };
+
+    void PlanBatch(const std::vector<uint64_t>& user_ids, BatchPlan& plan) const;
+
+    /**
+     * @brief Look up one shard's group of a planned batch as of `view`
+     *
+     * Writes responses[i] for every position i the shard owns; `responses`
+     * must already have one entry per id. Slots and then versions a few ids
+     * ahead are prefetched so their cache misses overlap. Groups of
+     * different shards touch disjoint responses and may run in parallel
+     * on one view.
+     */
+    void GetShardBatch(const ReadView& view, const BatchPlan& plan, size_t shard,
+                       const std::vector<uint64_t>& user_ids, bool include_avatar,
+                       std::vector<GetUserResponse>& responses) const;
+
+    /**
+     * @brief Look a user up by exact email; with duplicates the lowest id wins
+     * @return false if no user has that email
+     */
+    bool FindByEmail(const std::string& email, bool include_avatar, GetUserResponse& response) const;
+
+    /**
+     * @brief Users whose name starts with `prefix`, in (name, id) order
+     * @param limit Capped at kMaxSearchResults
+     */
+    void SearchByNamePrefix(const std::string& prefix, size_t limit, SearchUsersResponse& response) const;
+
+    size_t Size() const;
+    size_t ShardCount() const { return shards_.size(); }
+    size_t ShardOf(uint64_t user_id) const { return router_.ShardOf(user_id); }
+
+    // Timestamp of the latest committed write
+    uint64_t GetCommitTimestamp() const { return commit_ts_.load(std::memory_order_acquire); }
+
+    // Replaced versions and tables freed so far / still waiting for readers
+    uint64_t GetReclaimedCount() const { return epochs_.GetReclaimedCount(); }
+    size_t GetPendingReclaimCount() const { return epochs_.GetPendingCount(); }
+
+    UserStoreMemory GetMemoryUsage() const;
+
+private:
+    struct Shard;
+
+    void Put(const UserRecord& record, bool set_avatar, bool logged, uint64_t* write_sequence);
+
+    // Declared first: the indexes and shards retire into it
+    mutable EpochManager epochs_;
+    // Email domains, shared by every shard
+    StringHeap strings_;
+    ShardRouter router_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> next_user_id_{1};
+    UserWriteListener listener_;
+    UserChangeListener change_listener_;
+    EmailIndex email_index_;
+    NameIndex name_index_;
+
+    // Commits of all shards are ordered by timestamp: a short section that
+    // only stamps and publishes, so a view opened at timestamp t sees every
+    // version up to t
+    std::mutex commit_mutex_;
+    std::atomic<uint64_t> commit_ts_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_STORE_H
@@ -0,0 +1,192 @@
+// GrlRPC User Tier Header
+// Read-through tiering for user sets larger than memory: the UserStore holds
+// the resident users, a UserColdStore the rest on disk, and an S3-FIFO cache
+// keeps the cold users that are being read in memory
+//
+// Lookups try the store, then the cache, then the cold file. Cold reads run
+// on the tier's own IO threads, so GetAsync() never waits for the disk. A
+// cold user is copied into the store before its first write and is resident
+// from then on; the copy goes through the store's write listener, so with
+// persistence it survives a restart. The cold file itself is never written.
+
+#ifndef GRLRPC_USER_TIER_H
+#define GRLRPC_USER_TIER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "user_persistence.h"
+#include "user_store.h"
+#include "user_types.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// UserCache
+// ============================================================================
+
+struct UserCacheConfig {
+    size_t capacity_bytes = 64 * 1024 * 1024;
+    size_t shards = 16;
+    // Share of the capacity for entries seen once (S3-FIFO's small queue)
+    double small_ratio = 0.1;
+};
+
+struct UserCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t inserts = 0;
+    uint64_t promotions = 0;   // small queue -> main queue
+    uint64_t ghost_hits = 0;   // inserted straight into main after a recent eviction
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    size_t entries = 0;
+};
+
+/**
+ * @brief Byte-bounded S3-FIFO cache of encoded user records
+ *
+ * New entries go to a small FIFO queue. One read again before it reaches
+ * the tail moves to the main queue; the rest are evicted and remembered in
+ * a ghost queue of ids, so that a quick return is inserted into main
+ * directly. Main is a FIFO with up to three second chances per entry. A
+ * hit only bumps a counter, so hits never reorder the queues. Shards each
+ * have their own lock and their own share of the capacity.
+ */
+class UserCache {
+public:
+    explicit UserCache(UserCacheConfig config = UserCacheConfig());
+    ~UserCache();
+
+    UserCache(const UserCache&) = delete;
+    UserCache& operator=(const UserCache&) = delete;
+
+    /**
+     * @brief Call `visit` with the cached record of `user_id`, under the shard lock
+     * @return false on a miss
+     */
+    bool Lookup(uint64_t user_id, const std::function<void(std::string_view payload)>& visit);
+
+    // Add or replace a record, evicting as needed
+    void Insert(uint64_t user_id, std::string_view payload);
+
+    void Erase(uint64_t user_id);
+
+    UserCacheStats GetStats() const;
+
+private:
+    struct Entry;
+    struct Shard;
+
+    Shard& ShardOf(uint64_t user_id) const;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// ============================================================================
+// TieredUserStore
+// ============================================================================
+
+struct TierConfig {
+    UserCacheConfig cache;
+    // Threads reading the cold file; misses beyond that many wait in a queue
+    size_t io_threads = 4;
+};
+
+struct TierStats {
+    uint64_t resident_hits = 0;    // served by the store
+    UserCacheStats cache;          // lookups that missed the store
+    uint64_t cold_reads = 0;       // records read from the cold file
+    uint64_t coalesced_reads = 0;  // misses that joined a read already queued
+    uint64_t made_resident = 0;    // cold users copied into the store for a write
+    size_t pending_reads = 0;
+};
+
+class TieredUserStore {
+public:
+    // Called once; response.found tells whether the user exists
+    using GetCallback = std::function<void(GetUserResponse& response)>;
+
+    /**
+     * @brief Serve `cold` behind `store`; both must outlive the tier
+     *
+     * Reserves the cold file's ids in the store, so users created from now
+     * on never collide with cold ones.
+     */
+    TieredUserStore(UserStore& store, const UserColdStore& cold, TierConfig config = TierConfig());
+
+    // Completes the reads already queued
+    ~TieredUserStore();
+
+    TieredUserStore(const TieredUserStore&) = delete;
+    TieredUserStore& operator=(const TieredUserStore&) = delete;
+
+    /**
+     * @brief Look a user up in every tier
+     *
+     * Resident users and cache hits complete on the calling thread before
+     * this returns. Anything else completes later on an IO thread; misses
+     * for a user whose read is already queued share that read.
+     */
+    void GetAsync(uint64_t user_id, bool include_avatar, GetCallback done);
+
+    // GetAsync() that waits for the result
+    bool Get(uint64_t user_id, bool include_avatar, GetUserResponse& response);
+
+    /**
+     * @brief Copy a cold user into the store so it can be written
+     * @return false if the user is in neither tier
+     *
+     * Reads the cold file on the calling thread if needed.
+     */
+    bool MakeResident(uint64_t user_id);
+
+    TierStats GetStats() const;
+
+private:
+    struct Waiter {
+        bool include_avatar;
+        GetCallback done;
+    };
+
+    // Fill `response` from the store or the cache
+    bool GetInMemory(uint64_t user_id, bool include_avatar, GetUserResponse& response);
+    void IoLoop();
+
+    static constexpr size_t kResidentLockStripes = 64;
+
+    UserStore& store_;
+    const UserColdStore& cold_;
+    UserCache cache_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable read_queued_;
+    std::deque<uint64_t> read_queue_;
+    // Users with a read queued or running, and whom to tell
+    std::unordered_map<uint64_t, std::vector<Waiter>> pending_;
+    bool stopping_ = false;
+    std::vector<std::thread> io_threads_;
+
+    // Two writers making the same user resident must not both restore it
+    std::mutex resident_locks_[kResidentLockStripes];
+
+    std::atomic<uint64_t> resident_hits_{0};
+    std::atomic<uint64_t> cold_reads_{0};
+    std::atomic<uint64_t> coalesced_reads_{0};
+    std::atomic<uint64_t> made_resident_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_TIER_H
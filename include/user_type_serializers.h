@@ -1,15 +1,52 @@
 // GrlRPC User Type Serializers Header
-// This file will be implemented in task 11.2
+// Hand-written "binary" and "json" serializers for every user message,
+// used in place of the reflection-based serializers
 
 #ifndef GRLRPC_USER_TYPE_SERIALIZERS_H
 #define GRLRPC_USER_TYPE_SERIALIZERS_H
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "serialization_framework.h"
 #include "user_types.h"
 
 namespace grlrpc {
 
-// Forward declarations - will be implemented in task 11.2
+/**
+ * @brief Register the type-specific serializers of all user messages
+ *
+ * Each message gets a "binary" and a "json" serializer. Field order, field
+ * names and value encodings are those of BinarySerializer and
+ * JsonSerializer with the descriptors from RegisterUserTypes(), so either
+ * side of a call may use the generic path. Messages holding lists, which
+ * reflection cannot describe, extend the same rules:
+ *
+ *   binary: a list is a u32 count followed by its elements, each element
+ *           encoded like a message of its own
+ *   json:   a list is an array, e.g. {"users":[{"user_id":1,..}],"more":false}
+ *
+ * Existing registrations are kept, so handles resolved earlier stay valid.
+ */
+void RegisterUserTypeSerializers();
+
+/**
+ * @brief Encode one event as an element of WatchUsersResponse::events
+ * @return false unless `format` is "binary" or "json"
+ */
+bool EncodeUserChangeEvent(const std::string& format, const UserChangeEvent& event, std::string& out);
+
+/**
+ * @brief Assemble a WatchUsersResponse around events from EncodeUserChangeEvent()
+ *
+ * The result is byte for byte what the typed serializer writes for the
+ * same response, so an event is encoded once however many watchers it is
+ * sent to.
+ * @return false unless `format` is "binary" or "json"
+ */
+bool AssembleWatchUsersResponse(const std::string& format, const std::vector<std::string_view>& events,
+                                uint64_t next_sequence, bool gap, uint64_t incarnation, std::string& out);
 
 } // namespace grlrpc
 
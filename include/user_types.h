@@ -1,22 +1,159 @@
 // GrlRPC User Types Header
-// This file will be implemented in task 11.1
+// Request/response messages of the user service
 
 #ifndef GRLRPC_USER_TYPES_H
 #define GRLRPC_USER_TYPES_H
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 namespace grlrpc {
 
-// Forward declarations - will be implemented in task 11.1
+// ============================================================================
+// User Service Messages
+// Messages keyed by a user carry user_id as the first field, so binary
+// encodings start with it and can be routed with FixedOffsetKeyExtractor(0)
+// ============================================================================
 
-class GetUserRequest;
-class GetUserResponse;
-class CreateUserRequest;
-class CreateUserResponse;
-class UpdateUserRequest;
-class UpdateUserResponse;
+struct GetUserRequest {
+    uint64_t user_id = 0;
+    // The avatar can be large; it is only returned when asked for
+    bool include_avatar = false;
+};
+
+struct GetUserResponse {
+    uint64_t user_id = 0;
+    bool found = false;
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+    int64_t created_at_ms = 0;
+    int64_t updated_at_ms = 0;
+    std::string avatar;
+};
+
+struct CreateUserRequest {
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+    std::string avatar;
+};
+
+struct CreateUserResponse {
+    uint64_t user_id = 0;
+    bool success = false;
+    std::string error;
+};
+
+struct UpdateUserRequest {
+    uint64_t user_id = 0;
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+};
+
+struct UpdateUserResponse {
+    uint64_t user_id = 0;
+    bool success = false;
+    std::string error;
+};
+
+// Many users in one call (e.g. rendering a feed). Answered in request
+// order; unknown ids come back with found = false.
+struct BatchGetUsersRequest {
+    std::vector<uint64_t> user_ids;
+    bool include_avatar = false;
+};
+
+struct BatchGetUsersResponse {
+    std::vector<GetUserResponse> users;
+};
+
+// Secondary index lookups; answered from whichever shard receives them
+
+// Answered with a GetUserResponse. Emails are not unique: the user with the
+// lowest id wins.
+struct FindUserByEmailRequest {
+    std::string email;
+    bool include_avatar = false;
+};
+
+struct SearchUsersRequest {
+    std::string name_prefix;
+    // Capped at UserStore::kMaxSearchResults
+    uint32_t limit = 20;
+};
+
+struct UserSummary {
+    uint64_t user_id = 0;
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+};
+
+// Matches in (name, user_id) order
+struct SearchUsersResponse {
+    std::vector<UserSummary> users;
+    // More users match than were returned
+    bool more = false;
+};
+
+// Change data capture: watchers long-poll for the writes that follow the
+// last sequence number they saw, instead of polling GetUser
+
+// One committed CreateUser or UpdateUser with the user as written. The
+// avatar is left out; avatar_changed tells caches to fetch it again.
+struct UserChangeEvent {
+    uint64_t user_id = 0;
+    // Increases by one per write to the store, starting at 1
+    uint64_t sequence = 0;
+    bool created = false;
+    std::string name;
+    std::string email;
+    int32_t age = 0;
+    int64_t updated_at_ms = 0;
+    bool avatar_changed = false;
+};
+
+struct WatchUsersRequest {
+    // Resume point: only events with a larger sequence are returned
+    uint64_t after_sequence = 0;
+    // `incarnation` of the response that gave after_sequence; 0 when not
+    // resuming. Sequences restart with every hub, so they only mean
+    // something to the hub that handed them out
+    uint64_t incarnation = 0;
+    // Only events of these users; empty = every user
+    std::vector<uint64_t> user_ids;
+    // Capped at UserWatchHub::kMaxEventsPerResponse; 0 just reports the
+    // current position
+    uint32_t max_events = 256;
+    // How long to wait while no event matches; capped at UserWatchHub::kMaxWaitMs
+    uint32_t wait_ms = 0;
+};
+
+struct WatchUsersResponse {
+    std::vector<UserChangeEvent> events;
+    // after_sequence of the next call; also moves past filtered-out events
+    uint64_t next_sequence = 0;
+    // Events after the resume point are no longer buffered (or the server
+    // restarted): the watcher missed changes and must resynchronise
+    bool gap = false;
+    // Identifies the hub; send it back with next_sequence
+    uint64_t incarnation = 0;
+};
+
+/**
+ * @brief Register reflection metadata for every user message
+ *
+ * Makes the messages usable with the generic "json" and "binary"
+ * serializers, and registers the faster type-specific serializers from
+ * user_type_serializers.h, which also cover the messages holding lists
+ * (BatchGetUsers*, SearchUsersResponse, WatchUsers*) that reflection
+ * cannot describe.
+ * Safe to call more than once.
+ */
+void RegisterUserTypes();
 
 } // namespace grlrpc
 
@@ -0,0 +1,108 @@
+// GrlRPC User Watch Header
+// Change data capture for the user store: every committed create and update
+// becomes an event in a bounded in-memory ring, which watchers read with
+// long-polling WatchUsers calls from the last sequence number they saw
+//
+// Each event is encoded when it is published, once per wire format, and
+// watch responses are assembled from those bytes; however many watchers
+// receive an event, it is never encoded again.
+
+#ifndef GRLRPC_USER_WATCH_H
+#define GRLRPC_USER_WATCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "user_store.h"
+#include "user_types.h"
+
+namespace grlrpc {
+
+// ============================================================================
+// UserWatchHub
+// ============================================================================
+
+/**
+ * @brief Ring of recent user changes, shared by every watcher
+ *
+ * The hub is the store's change listener, so events of one user arrive in
+ * the order the writes were applied; sequence numbers give all events one
+ * total order. Once the ring is full the oldest events are dropped, and a
+ * watcher that falls further behind is told so with `gap`.
+ */
+class UserWatchHub {
+public:
+    static constexpr size_t kMaxEventsPerResponse = 1000;
+    static constexpr uint32_t kMaxWaitMs = 30000;
+    // Events looked at per call, matching or not, so a narrow filter over
+    // a long backlog cannot hold the ring for long; the watcher continues
+    // from next_sequence
+    static constexpr size_t kMaxScanPerCall = 8192;
+
+    /**
+     * @param capacity Events kept for watchers that fall behind
+     */
+    explicit UserWatchHub(UserStore& store, size_t capacity = 65536);
+
+    // Detaches from the store and wakes every waiting watcher; stop serving first
+    ~UserWatchHub();
+
+    UserWatchHub(const UserWatchHub&) = delete;
+    UserWatchHub& operator=(const UserWatchHub&) = delete;
+
+    /**
+     * @brief Append a change; called by the store under the user's shard lock
+     */
+    void Publish(const UserRecord& record, bool created, bool avatar_changed);
+
+    /**
+     * @brief Answer a WatchUsers call with a response payload in `format`
+     *
+     * Waits up to request.wait_ms for a matching event when there is none
+     * yet. A resume point from another hub (request.incarnation differs,
+     * e.g. from before a restart) or ahead of the newest event is treated
+     * as a gap, and the watcher is sent the oldest buffered events.
+     * Responses carry GetIncarnation().
+     * @return false unless `format` is "binary" or "json"
+     */
+    bool Watch(const WatchUsersRequest& request, const std::string& format, std::string& payload);
+
+    // Wake waiting watchers early and make further waits return at once
+    void Close();
+
+    // Sequence of the newest event; 0 before the first write
+    uint64_t GetLastSequence() const;
+    // Random, nonzero, fixed for the life of the hub
+    uint64_t GetIncarnation() const { return incarnation_; }
+    size_t GetCapacity() const { return ring_.size(); }
+    uint64_t GetDeliveredCount() const { return delivered_.load(std::memory_order_relaxed); }
+
+private:
+    // One change in every supported format, shared by the responses carrying it
+    struct Event {
+        uint64_t user_id;
+        std::string binary;
+        std::string json;
+    };
+
+    UserStore& store_;
+    const uint64_t incarnation_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable published_;
+    // Event with sequence s lives at ring_[s % ring_.size()]
+    std::vector<std::shared_ptr<const Event>> ring_;
+    uint64_t last_sequence_ = 0;
+    bool closed_ = false;
+
+    std::atomic<uint64_t> delivered_{0};
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_USER_WATCH_H
@@ -0,0 +1,165 @@
+// GrlRPC Write-Ahead Log Header
+// Append-only record log with group commit: concurrent writers share one
+// fdatasync per batch instead of paying one each
+//
+// A log is a directory of numbered segment files (wal.<segment>). Every
+// record is framed as
+//   [length:u32][crc32:u32][type:u8][payload]
+// where length covers type plus payload and the CRC covers the same bytes.
+// A crash can leave a torn record at the end of the newest segment; readers
+// stop at the first record that does not check out.
+
+#ifndef GRLRPC_WRITE_AHEAD_LOG_H
+#define GRLRPC_WRITE_AHEAD_LOG_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace grlrpc {
+
+// ============================================================================
+// Record Framing
+// ============================================================================
+
+constexpr size_t kLogRecordHeaderSize = 9;
+
+uint32_t Crc32(std::string_view data);
+
+void AppendLogRecord(uint8_t type, std::string_view payload, std::string& out);
+
+/**
+ * @brief Visit the intact records at the start of `data`
+ * @return Bytes consumed; less than data.size() if the tail is torn or corrupt
+ */
+size_t ParseLogRecords(std::string_view data,
+                       const std::function<void(uint8_t type, std::string_view payload)>& visit);
+
+// Make a created or renamed file's directory entry durable
+bool SyncDirectory(const std::string& directory);
+
+// ============================================================================
+// MappedFile
+// ============================================================================
+
+/**
+ * @brief Read-only mmap of a whole file
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& path, std::string& error);
+    std::string_view Data() const { return std::string_view(data_, size_); }
+
+    // Start reading a range in ahead of use (e.g. a chunk another thread parses)
+    void WillNeed(size_t offset, size_t length) const;
+
+private:
+    void Close();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// WriteAheadLog
+// ============================================================================
+
+class WriteAheadLog {
+public:
+    explicit WriteAheadLog(std::string directory);
+
+    // Flushes what is buffered
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Start a new segment after the existing ones
+     *
+     * Existing segments are never appended to, so a torn tail left by a
+     * crash stays at the end of its segment.
+     */
+    bool Open(std::string& error);
+
+    /**
+     * @brief Buffer a record without waiting for the disk
+     * @return Log sequence number to pass to WaitDurable()
+     *
+     * Once the log has failed the record is dropped instead of buffered,
+     * so a dead log does not grow without bound.
+     */
+    uint64_t Append(uint8_t type, std::string_view payload);
+
+    /**
+     * @brief Block until every record up to `lsn` is on disk
+     *
+     * The first waiter to find no flush in progress writes everything
+     * buffered so far and syncs once; writers arriving meanwhile queue up
+     * behind it and go out together in the next batch.
+     *
+     * @return false once a write or sync has failed; the log then refuses
+     *         all further commits
+     */
+    bool WaitDurable(uint64_t lsn);
+
+    /**
+     * @brief Flush, sync and switch to a new segment
+     * @param segment Receives the new segment number; all records appended
+     *        before the call are in lower-numbered segments
+     */
+    bool Rotate(uint64_t& segment, std::string& error);
+
+    // Delete whole segments numbered below `segment`
+    void RemoveSegmentsBefore(uint64_t segment);
+
+    // True once a write or sync has failed
+    bool HasFailed() const;
+
+    uint64_t GetSegmentBytes() const;
+    uint64_t GetSyncCount() const;
+
+    static std::vector<uint64_t> ListSegments(const std::string& directory);
+    static std::string SegmentPath(const std::string& directory, uint64_t segment);
+
+private:
+    bool OpenSegment(uint64_t segment, std::string& error);
+
+    // Write and sync `batch`; called without the mutex by the flush leader
+    bool WriteBatch(int fd, const std::string& batch);
+
+    // Refuse further commits and release whatever is still buffered
+    void FailLocked();
+
+    const std::string directory_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable durable_;
+    std::string buffer_;
+    std::string spare_;          // reused by the flush leader
+    uint64_t last_lsn_ = 0;      // last record appended
+    uint64_t durable_lsn_ = 0;   // last record synced
+    bool flushing_ = false;
+    bool failed_ = false;
+    int fd_ = -1;
+    uint64_t segment_ = 0;
+    uint64_t segment_bytes_ = 0;
+    uint64_t sync_count_ = 0;
+};
+
+} // namespace grlrpc
+
+#endif // GRLRPC_WRITE_AHEAD_LOG_H
@@ -0,0 +1,273 @@
+// GrlRPC Circuit Breaker Implementation
+
+#include "circuit_breaker.h"
+
+#include <mutex>
+
+namespace grlrpc {
+
+// ============================================================================
+// SlidingWindowStats
+// ============================================================================
+
+SlidingWindowStats::SlidingWindowStats(std::chrono::milliseconds window, size_t bucket_count)
+    : bucket_width_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(window).count() /
+                       static_cast<int64_t>(bucket_count ? bucket_count : 1)),
+      buckets_(bucket_count ? bucket_count : 1) {
+    if (bucket_width_ns_ <= 0) {
+        bucket_width_ns_ = 1;
+    }
+}
+
+int64_t SlidingWindowStats::EpochOf(RpcClock::time_point now) const {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    return ns / bucket_width_ns_;
+}
+
+void SlidingWindowStats::Record(bool failure, bool slow, RpcClock::time_point now) {
+    int64_t epoch = EpochOf(now);
+    Bucket& bucket = buckets_[static_cast<size_t>(epoch) % buckets_.size()];
+
+    // The first writer of a new epoch recycles the bucket. Increments racing
+    // with the reset may be lost, which only makes the window slightly lenient.
+    int64_t seen = bucket.epoch.load(std::memory_order_acquire);
+    if (seen != epoch) {
+        if (seen < epoch && bucket.epoch.compare_exchange_strong(seen, epoch,
+                                                                  std::memory_order_acq_rel)) {
+            bucket.total.store(0, std::memory_order_relaxed);
+            bucket.failures.store(0, std::memory_order_relaxed);
+            bucket.slow.store(0, std::memory_order_relaxed);
+        } else if (seen > epoch) {
+            return;
+        }
+    }
+
+    bucket.total.fetch_add(1, std::memory_order_relaxed);
+    if (failure) {
+        bucket.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (slow) {
+        bucket.slow.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+WindowSnapshot SlidingWindowStats::Snapshot(RpcClock::time_point now) const {
+    WindowSnapshot snapshot;
+    int64_t current = EpochOf(now);
+    int64_t oldest = current - static_cast<int64_t>(buckets_.size()) + 1;
+
+    for (const auto& bucket : buckets_) {
+        int64_t epoch = bucket.epoch.load(std::memory_order_acquire);
+        if (epoch < oldest || epoch > current) {
+            continue;
+        }
+        snapshot.total += bucket.total.load(std::memory_order_relaxed);
+        snapshot.failures += bucket.failures.load(std::memory_order_relaxed);
+        snapshot.slow += bucket.slow.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void SlidingWindowStats::Reset() {
+    for (auto& bucket : buckets_) {
+        bucket.epoch.store(-1, std::memory_order_release);
+        bucket.total.store(0, std::memory_order_relaxed);
+        bucket.failures.store(0, std::memory_order_relaxed);
+        bucket.slow.store(0, std::memory_order_relaxed);
+    }
+}
+
+// ============================================================================
+// CircuitBreaker
+// ============================================================================
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config)
+    : config_(config),
+      stats_(config.window, config.bucket_count) {}
+
+bool CircuitBreaker::TryTransition(CircuitState from, CircuitState to) {
+    uint8_t expected = static_cast<uint8_t>(from);
+    return state_.compare_exchange_strong(expected, static_cast<uint8_t>(to),
+                                          std::memory_order_acq_rel);
+}
+
+void CircuitBreaker::Trip(RpcClock::time_point now) {
+    // Publish the reopen time and reset probe counters before the state flips
+    open_until_ns_.store(ToNanos(now + config_.open_duration), std::memory_order_relaxed);
+    probes_in_flight_.store(0, std::memory_order_relaxed);
+    probe_successes_.store(0, std::memory_order_relaxed);
+    state_.store(static_cast<uint8_t>(CircuitState::OPEN), std::memory_order_release);
+}
+
+bool CircuitBreaker::AllowRequest(RpcClock::time_point now) {
+    int64_t now_ns = ToNanos(now);
+
+    switch (GetState()) {
+        case CircuitState::CLOSED:
+            return true;
+
+        case CircuitState::OPEN:
+            if (now_ns < open_until_ns_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            TryTransition(CircuitState::OPEN, CircuitState::HALF_OPEN);
+            if (GetState() != CircuitState::HALF_OPEN) {
+                return GetState() == CircuitState::CLOSED;
+            }
+            break;
+
+        case CircuitState::HALF_OPEN:
+            break;
+    }
+
+    // Half-open: space probes out and cap how many are outstanding
+    int64_t interval_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config_.half_open_probe_interval).count();
+    int64_t last = last_probe_ns_.load(std::memory_order_relaxed);
+    if (last != 0 && now_ns - last < interval_ns) {
+        return false;
+    }
+
+    uint32_t in_flight = probes_in_flight_.load(std::memory_order_relaxed);
+    do {
+        if (in_flight >= config_.half_open_max_probes) {
+            return false;
+        }
+    } while (!probes_in_flight_.compare_exchange_weak(in_flight, in_flight + 1,
+                                                      std::memory_order_relaxed));
+
+    if (!last_probe_ns_.compare_exchange_strong(last, now_ns, std::memory_order_relaxed)) {
+        // Another thread claimed this probe slot
+        probes_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void CircuitBreaker::RecordResult(RpcStatus status, std::chrono::nanoseconds latency,
+                                  RpcClock::time_point now) {
+    bool failure = IsBreakerFailure(status);
+    bool slow = latency >= config_.slow_call_duration;
+
+    switch (GetState()) {
+        case CircuitState::CLOSED: {
+            stats_.Record(failure, slow, now);
+            WindowSnapshot snapshot = stats_.Snapshot(now);
+            if (snapshot.total >= config_.min_requests &&
+                (snapshot.FailureRate() >= config_.failure_rate_threshold ||
+                 snapshot.SlowRate() >= config_.slow_call_rate_threshold)) {
+                Trip(now);
+            }
+            break;
+        }
+
+        case CircuitState::HALF_OPEN: {
+            DecrementProbes();
+            if (failure || slow) {
+                Trip(now);
+                break;
+            }
+            uint32_t successes = probe_successes_.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (successes >= config_.half_open_success_threshold &&
+                TryTransition(CircuitState::HALF_OPEN, CircuitState::CLOSED)) {
+                stats_.Reset();
+                last_probe_ns_.store(0, std::memory_order_relaxed);
+            }
+            break;
+        }
+
+        case CircuitState::OPEN:
+            // Late results of calls admitted before the trip carry no new information
+            break;
+    }
+}
+
+void CircuitBreaker::ReleaseProbe() {
+    if (GetState() == CircuitState::HALF_OPEN) {
+        DecrementProbes();
+    }
+}
+
+void CircuitBreaker::DecrementProbes() {
+    uint32_t in_flight = probes_in_flight_.load(std::memory_order_relaxed);
+    while (in_flight > 0 &&
+           !probes_in_flight_.compare_exchange_weak(in_flight, in_flight - 1,
+                                                    std::memory_order_relaxed)) {
+    }
+}
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+bool IsBreakerFailure(RpcStatus status) {
+    switch (status) {
+        case RpcStatus::NETWORK_ERROR:
+        case RpcStatus::TIMEOUT:
+        case RpcStatus::UNKNOWN_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string CircuitStateToString(CircuitState state) {
+    switch (state) {
+        case CircuitState::CLOSED:    return "CLOSED";
+        case CircuitState::OPEN:      return "OPEN";
+        case CircuitState::HALF_OPEN: return "HALF_OPEN";
+        default: return "UNKNOWN";
+    }
+}
+
+// ============================================================================
+// CircuitBreakerRegistry
+// ============================================================================
+
+CircuitBreaker* CircuitBreakerRegistry::GetOrCreate(const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = breakers_.find(key);
+        if (it != breakers_.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& slot = breakers_[key];
+    if (!slot) {
+        slot = std::make_unique<CircuitBreaker>(config_);
+    }
+    return slot.get();
+}
+
+CircuitBreaker* CircuitBreakerRegistry::GetEndpointBreaker(const std::string& endpoint) {
+    return GetOrCreate(endpoint);
+}
+
+CircuitBreaker* CircuitBreakerRegistry::GetMethodBreaker(const std::string& endpoint,
+                                                         const std::string& method) {
+    return GetOrCreate(endpoint + "/" + method);
+}
+
+bool CircuitBreakerRegistry::AllowRequest(const std::string& endpoint, const std::string& method,
+                                          RpcClock::time_point now) {
+    CircuitBreaker* endpoint_breaker = GetEndpointBreaker(endpoint);
+    if (!endpoint_breaker->AllowRequest(now)) {
+        return false;
+    }
+    if (!GetMethodBreaker(endpoint, method)->AllowRequest(now)) {
+        endpoint_breaker->ReleaseProbe();
+        return false;
+    }
+    return true;
+}
+
+void CircuitBreakerRegistry::RecordResult(const std::string& endpoint, const std::string& method,
+                                          RpcStatus status, std::chrono::nanoseconds latency,
+                                          RpcClock::time_point now) {
+    GetEndpointBreaker(endpoint)->RecordResult(status, latency, now);
+    GetMethodBreaker(endpoint, method)->RecordResult(status, latency, now);
+}
+
+} // namespace grlrpc
@@ -0,0 +1,241 @@
+// GrlRPC Epoch Manager Implementation
+
+#include "epoch_manager.h"
+
+#include <unordered_map>
+#include <utility>
+
+namespace grlrpc {
+
+namespace {
+
+std::atomic<uint64_t> next_manager_id{1};
+
+// Managers still alive, so an exiting thread only touches slots whose
+// manager has not been destroyed. Taken on construction, destruction and
+// thread exit only
+struct LiveManagers {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, EpochManager*> managers;
+};
+
+LiveManagers& Live() {
+    static LiveManagers live;
+    return live;
+}
+
+} // namespace
+
+// ============================================================================
+// ThreadCache
+// ============================================================================
+
+struct EpochManager::ThreadCache {
+    struct Entry {
+        uint64_t manager_id;
+        Participant* participant;
+    };
+
+    ~ThreadCache() {
+        LiveManagers& live = Live();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        for (const Entry& entry : entries) {
+            // Ids are never reused, so a destroyed manager is simply not found
+            auto it = live.managers.find(entry.manager_id);
+            if (it != live.managers.end()) {
+                it->second->ReleaseParticipant(*entry.participant);
+            }
+        }
+    }
+
+    std::vector<Entry> entries;
+};
+
+EpochManager::ThreadCache& EpochManager::LocalCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+// ============================================================================
+// Guard
+// ============================================================================
+
+EpochManager::Guard& EpochManager::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        Release();
+        participant_ = other.participant_;
+        other.participant_ = nullptr;
+    }
+    return *this;
+}
+
+void EpochManager::Guard::Release() {
+    if (participant_ && --participant_->depth == 0) {
+        participant_->epoch.store(0, std::memory_order_release);
+        // Deferred from Retire(): now that we are unpinned, the caller's
+        // locks taken inside the pin have been released too
+        if (participant_->retired_since_collect >= kCollectInterval) {
+            participant_->owner.CollectFor(*participant_);
+        }
+    }
+    participant_ = nullptr;
+}
+
+// ============================================================================
+// EpochManager
+// ============================================================================
+
+EpochManager::EpochManager() : id_(next_manager_id.fetch_add(1, std::memory_order_relaxed)) {
+    LiveManagers& live = Live();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.managers.emplace(id_, this);
+}
+
+EpochManager::~EpochManager() {
+    {
+        // Waits out any exiting thread that is handing its slot back
+        LiveManagers& live = Live();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        live.managers.erase(id_);
+    }
+    Drain();
+}
+
+EpochManager::Participant& EpochManager::LocalParticipant() {
+    ThreadCache& cache = LocalCache();
+    for (const ThreadCache::Entry& entry : cache.entries) {
+        if (entry.manager_id == id_) {
+            return *entry.participant;
+        }
+    }
+    // First use by this thread: take a slot an exited thread left behind
+    std::lock_guard<std::mutex> lock(mutex_);
+    Participant* participant = nullptr;
+    if (!free_participants_.empty()) {
+        participant = free_participants_.back();
+        free_participants_.pop_back();
+    } else {
+        participants_.push_back(std::make_unique<Participant>(*this));
+        participant = participants_.back().get();
+    }
+    cache.entries.push_back(ThreadCache::Entry{id_, participant});
+    return *participant;
+}
+
+void EpochManager::ReleaseParticipant(Participant& participant) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Retired& retired : participant.retired) {
+        orphaned_.push_back(std::move(retired));
+    }
+    participant.retired.clear();
+    participant.retired_since_collect = 0;
+    participant.depth = 0;
+    participant.epoch.store(0, std::memory_order_release);
+    free_participants_.push_back(&participant);
+}
+
+EpochManager::Guard EpochManager::Pin() {
+    Participant& participant = LocalParticipant();
+    if (participant.depth++ == 0) {
+        // Re-check after announcing: once the announcement is visible with
+        // the epoch still unchanged, the epoch can move at most one step
+        // further while we stay pinned
+        uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        for (;;) {
+            participant.epoch.store(epoch, std::memory_order_seq_cst);
+            uint64_t current = epoch_.load(std::memory_order_seq_cst);
+            if (current == epoch) {
+                break;
+            }
+            epoch = current;
+        }
+    }
+    return Guard(&participant);
+}
+
+void EpochManager::Retire(std::function<void()> reclaim) {
+    Participant& participant = LocalParticipant();
+    participant.retired.push_back(Retired{epoch_.load(std::memory_order_seq_cst), std::move(reclaim)});
+    participant.retired_total.store(participant.retired_total.load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_release);
+    if (++participant.retired_since_collect >= kCollectInterval && participant.depth == 0) {
+        CollectFor(participant);
+    }
+}
+
+void EpochManager::Collect() {
+    CollectFor(LocalParticipant());
+}
+
+void EpochManager::CollectFor(Participant& self) {
+    self.retired_since_collect = 0;
+    uint64_t epoch = 0;
+    uint64_t reclaimed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        epoch = AdvanceLocked();
+        while (!orphaned_.empty() && orphaned_.front().epoch + 2 <= epoch) {
+            orphaned_.front().reclaim();
+            orphaned_.pop_front();
+            ++reclaimed;
+        }
+    }
+
+    // Objects retired in epoch e were unlinked before anyone could pin e + 1,
+    // and every pinned reader is now at epoch - 1 or later
+    while (!self.retired.empty() && self.retired.front().epoch + 2 <= epoch) {
+        self.retired.front().reclaim();
+        self.retired.pop_front();
+        ++reclaimed;
+    }
+    reclaimed_.fetch_add(reclaimed, std::memory_order_release);
+}
+
+uint64_t EpochManager::AdvanceLocked() {
+    uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    for (const auto& participant : participants_) {
+        uint64_t pinned = participant->epoch.load(std::memory_order_seq_cst);
+        if (pinned != 0 && pinned != epoch) {
+            return epoch;
+        }
+    }
+    epoch_.store(++epoch, std::memory_order_seq_cst);
+    return epoch;
+}
+
+void EpochManager::Drain() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t reclaimed = orphaned_.size();
+    for (Retired& retired : orphaned_) {
+        retired.reclaim();
+    }
+    orphaned_.clear();
+    for (const auto& participant : participants_) {
+        reclaimed += participant->retired.size();
+        for (Retired& retired : participant->retired) {
+            retired.reclaim();
+        }
+        participant->retired.clear();
+        participant->retired_since_collect = 0;
+    }
+    reclaimed_.fetch_add(reclaimed, std::memory_order_release);
+}
+
+size_t EpochManager::GetPendingCount() const {
+    // Reclaimed first: every reclaim it counts follows a retirement the
+    // totals read afterwards include
+    uint64_t reclaimed = reclaimed_.load(std::memory_order_acquire);
+    uint64_t retired = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& participant : participants_) {
+        retired += participant->retired_total.load(std::memory_order_acquire);
+    }
+    return static_cast<size_t>(retired - reclaimed);
+}
+
+size_t EpochManager::GetParticipantCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return participants_.size();
+}
+
+} // namespace grlrpc
@@ -0,0 +1,93 @@
+// GrlRPC Fan-Out Pool Implementation
+
+#include "fan_out_pool.h"
+
+#include <algorithm>
+
+namespace grlrpc {
+
+FanOutPool::FanOutPool(size_t worker_count) {
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+FanOutPool::~FanOutPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void FanOutPool::Run(size_t count, const std::function<void(size_t index)>& task) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobs_.push_back(&job);
+    lock.unlock();
+    // The caller takes one task itself, so at most count - 1 helpers are useful
+    if (count - 1 >= workers_.size()) {
+        work_available_.notify_all();
+    } else {
+        for (size_t i = 0; i + 1 < count; ++i) {
+            work_available_.notify_one();
+        }
+    }
+    lock.lock();
+
+    Work(job, lock);
+    // The job lives on this stack: wait until no worker can still touch it
+    job_finished_.wait(lock, [&job] { return job.completed == job.count && job.workers == 0; });
+}
+
+void FanOutPool::Work(Job& job, std::unique_lock<std::mutex>& lock) {
+    while (job.next < job.count) {
+        size_t index = job.next++;
+        if (job.next == job.count) {
+            // Fully claimed; later workers look at the next job
+            auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+            if (it != jobs_.end()) {
+                jobs_.erase(it);
+            }
+        }
+        lock.unlock();
+        (*job.task)(index);
+        lock.lock();
+        ++job.completed;
+    }
+}
+
+void FanOutPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_available_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        Job& job = *jobs_.front();
+        ++job.workers;
+        Work(job, lock);
+        --job.workers;
+        if (job.completed == job.count && job.workers == 0) {
+            job_finished_.notify_all();
+        }
+    }
+}
+
+} // namespace grlrpc
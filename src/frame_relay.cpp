@@ -0,0 +1,241 @@
+// GrlRPC Frame Relay Implementation
+
+#include "frame_relay.h"
+
+namespace grlrpc {
+
+FrameRelay::FrameRelay(size_t upstream_count, FrameSink upstream_sink, FrameSink downstream_sink,
+                       UpstreamSelector selector, const FrameRelayConfig& config)
+    : upstream_count_(upstream_count),
+      upstream_sink_(std::move(upstream_sink)),
+      downstream_sink_(std::move(downstream_sink)),
+      selector_(std::move(selector)),
+      config_(config) {}
+
+RelayResult FrameRelay::OnInboundFrame(uint64_t inbound_connection, FrameView frame,
+                                       RpcClock::time_point received_at) {
+    FrameHeader header;
+    if (!frame.storage || frame.offset + frame.length > frame.storage->size() ||
+        !MessageCodec::DecodeHeader(frame.Data(), frame.length, header) ||
+        frame.length != FrameHeader::kSize + header.payload_length) {
+        return RelayResult::INVALID_FRAME;
+    }
+
+    // Continuation chunks follow their first chunk whatever their deadline
+    // says: dropping one would leave the upstream holding a truncated message
+    bool more = header.HasFlag(FRAME_FLAG_CHUNK);
+    ChunkKey key{inbound_connection, header.request_id};
+    Stripe& run_stripe = StripeFor(header.request_id);
+    ChunkRun run;
+    bool continuation = false;
+    {
+        std::lock_guard<std::mutex> lock(run_stripe.mutex);
+        auto it = run_stripe.chunk_runs.find(key);
+        if (it != run_stripe.chunk_runs.end()) {
+            run = it->second;
+            continuation = true;
+            if (!more) {
+                run_stripe.chunk_runs.erase(it);
+            }
+        } else {
+            // The rest of an aborted message, final chunk included, must not
+            // pass for a request of its own
+            auto aborted = run_stripe.aborted_runs.find(key);
+            if (aborted != run_stripe.aborted_runs.end()) {
+                if (!more) {
+                    run_stripe.aborted_runs.erase(aborted);
+                }
+                return RelayResult::MESSAGE_ABORTED;
+            }
+        }
+    }
+    if (continuation) {
+        MessageCodec::RewriteRequestId(frame.Data(), run.relay_id);
+        if (upstream_sink_(run.upstream, frame)) {
+            return RelayResult::FORWARDED;
+        }
+        // The message cannot be completed; no response will come for it
+        if (more) {
+            std::lock_guard<std::mutex> lock(run_stripe.mutex);
+            run_stripe.chunk_runs.erase(key);
+            AbortRunLocked(run_stripe, key, received_at);
+        }
+        Stripe& stripe = StripeFor(run.relay_id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.routes.erase(run.relay_id);
+        return RelayResult::SEND_FAILED;
+    }
+
+    // A refused first chunk takes the rest of its message with it
+    auto refuse = [&](RelayResult result) {
+        if (more) {
+            std::lock_guard<std::mutex> lock(run_stripe.mutex);
+            AbortRunLocked(run_stripe, key, received_at);
+        }
+        return result;
+    };
+
+    if (header.deadline_ms != 0) {
+        auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         RpcClock::now() - received_at) + config_.hop_cost;
+        if (spent.count() >= header.deadline_ms) {
+            return refuse(RelayResult::DEADLINE_EXCEEDED);
+        }
+        MessageCodec::RewriteDeadline(frame.Data(),
+                                      header.deadline_ms - static_cast<uint32_t>(spent.count()));
+    }
+
+    // The first chunk of a chunked message starts with its total length
+    std::string_view payload = frame.Payload();
+    if (more) {
+        if (payload.size() < MessageCodec::kChunkPrefixSize) {
+            return refuse(RelayResult::INVALID_FRAME);
+        }
+        payload.remove_prefix(MessageCodec::kChunkPrefixSize);
+    }
+    size_t upstream = selector_(header, payload);
+    if (upstream >= upstream_count_) {
+        return refuse(RelayResult::NO_UPSTREAM);
+    }
+
+    RpcClock::time_point expires_at = received_at + (header.deadline_ms != 0
+        ? std::chrono::milliseconds(header.deadline_ms) : config_.route_timeout);
+    uint64_t relay_id = next_relay_id_.fetch_add(1, std::memory_order_relaxed);
+    {
+        Stripe& stripe = StripeFor(relay_id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.routes.emplace(relay_id, Route{inbound_connection, header.request_id, expires_at});
+        stripe.expiries.emplace(expires_at, relay_id);
+    }
+    MessageCodec::RewriteRequestId(frame.Data(), relay_id);
+
+    if (!upstream_sink_(upstream, frame)) {
+        {
+            Stripe& stripe = StripeFor(relay_id);
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            stripe.routes.erase(relay_id);
+        }
+        return refuse(RelayResult::SEND_FAILED);
+    }
+    if (more) {
+        std::lock_guard<std::mutex> lock(run_stripe.mutex);
+        run_stripe.chunk_runs.emplace(key, ChunkRun{relay_id, upstream});
+    }
+    return RelayResult::FORWARDED;
+}
+
+void FrameRelay::AbortRunLocked(Stripe& stripe, const ChunkKey& key, RpcClock::time_point now) {
+    RpcClock::time_point expires_at = now + config_.route_timeout;
+    stripe.aborted_runs[key] = expires_at;
+    stripe.aborted_expiries.push(AbortedExpiry{expires_at, key});
+}
+
+RelayResult FrameRelay::OnUpstreamFrame(FrameView frame) {
+    FrameHeader header;
+    if (!frame.storage || frame.offset + frame.length > frame.storage->size() ||
+        !MessageCodec::DecodeHeader(frame.Data(), frame.length, header)) {
+        return RelayResult::INVALID_FRAME;
+    }
+
+    Route route;
+    {
+        Stripe& stripe = StripeFor(header.request_id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.routes.find(header.request_id);
+        if (it == stripe.routes.end()) {
+            return RelayResult::UNKNOWN_REQUEST;
+        }
+        route = it->second;
+        // A chunked response keeps its route until the final chunk
+        if (!header.HasFlag(FRAME_FLAG_CHUNK)) {
+            stripe.routes.erase(it);
+        }
+    }
+
+    MessageCodec::RewriteRequestId(frame.Data(), route.original_request_id);
+    return downstream_sink_(route.inbound_connection, frame) ? RelayResult::FORWARDED
+                                                             : RelayResult::SEND_FAILED;
+}
+
+size_t FrameRelay::ExpireBefore(RpcClock::time_point now) {
+    std::vector<std::pair<uint64_t, Route>> expired;
+    for (auto& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        while (!stripe.expiries.empty() && stripe.expiries.top().first <= now) {
+            uint64_t relay_id = stripe.expiries.top().second;
+            stripe.expiries.pop();
+            auto it = stripe.routes.find(relay_id);
+            if (it != stripe.routes.end()) {
+                expired.emplace_back(relay_id, it->second);
+                stripe.routes.erase(it);
+            }
+        }
+        // Entries re-aborted since carry a later time and stay
+        while (!stripe.aborted_expiries.empty() && stripe.aborted_expiries.top().expires_at <= now) {
+            const AbortedExpiry& top = stripe.aborted_expiries.top();
+            auto it = stripe.aborted_runs.find(top.key);
+            if (it != stripe.aborted_runs.end() && it->second == top.expires_at) {
+                stripe.aborted_runs.erase(it);
+            }
+            stripe.aborted_expiries.pop();
+        }
+    }
+
+    // A request still being received when it expires stops being relayed,
+    // and so does the rest of it; its chunk run lives in the stripe of the
+    // original id
+    for (const auto& entry : expired) {
+        const Route& route = entry.second;
+        Stripe& stripe = StripeFor(route.original_request_id);
+        ChunkKey key{route.inbound_connection, route.original_request_id};
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.chunk_runs.find(key);
+        if (it != stripe.chunk_runs.end() && it->second.relay_id == entry.first) {
+            stripe.chunk_runs.erase(it);
+            AbortRunLocked(stripe, key, now);
+        }
+    }
+    return expired.size();
+}
+
+size_t FrameRelay::GetPendingCount() const {
+    size_t count = 0;
+    for (const auto& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        count += stripe.routes.size();
+    }
+    return count;
+}
+
+size_t FrameRelay::GetChunkRunCount() const {
+    size_t count = 0;
+    for (const auto& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        count += stripe.chunk_runs.size();
+    }
+    return count;
+}
+
+size_t FrameRelay::GetAbortedRunCount() const {
+    size_t count = 0;
+    for (const auto& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        count += stripe.aborted_runs.size();
+    }
+    return count;
+}
+
+std::string RelayResultToString(RelayResult result) {
+    switch (result) {
+        case RelayResult::FORWARDED:         return "FORWARDED";
+        case RelayResult::INVALID_FRAME:     return "INVALID_FRAME";
+        case RelayResult::DEADLINE_EXCEEDED: return "DEADLINE_EXCEEDED";
+        case RelayResult::NO_UPSTREAM:       return "NO_UPSTREAM";
+        case RelayResult::SEND_FAILED:       return "SEND_FAILED";
+        case RelayResult::UNKNOWN_REQUEST:   return "UNKNOWN_REQUEST";
+        case RelayResult::MESSAGE_ABORTED:   return "MESSAGE_ABORTED";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace grlrpc
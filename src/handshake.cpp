@@ -0,0 +1,244 @@
+// GrlRPC Connection Handshake Implementation
+
+#include "handshake.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace grlrpc {
+
+namespace {
+
+constexpr char kHelloMagic[4] = {'G', 'R', 'H', 'S'};
+constexpr char kAcceptMagic[4] = {'G', 'R', 'H', 'A'};
+
+void PutU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void PutU64(std::string& out, uint64_t value) {
+    for (size_t i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void PutString(std::string& out, const std::string& value) {
+    PutU8(out, static_cast<uint8_t>(std::min<size_t>(value.size(), 255)));
+    out.append(value, 0, std::min<size_t>(value.size(), 255));
+}
+
+void PutStringList(std::string& out, const std::vector<std::string>& values) {
+    size_t count = std::min<size_t>(values.size(), 255);
+    PutU8(out, static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        PutString(out, values[i]);
+    }
+}
+
+// Bounds-checked reader; any read past the end marks the input incomplete
+class Reader {
+public:
+    Reader(const char* data, size_t length) : data_(data), length_(length) {}
+
+    bool U8(uint8_t& value) {
+        if (!Need(1)) return false;
+        value = static_cast<uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool U64(uint64_t& value) {
+        if (!Need(8)) return false;
+        value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 8;
+        return true;
+    }
+
+    bool String(std::string& value) {
+        uint8_t size = 0;
+        if (!U8(size) || !Need(size)) return false;
+        value.assign(data_ + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool StringList(std::vector<std::string>& values) {
+        uint8_t count = 0;
+        if (!U8(count)) return false;
+        values.resize(count);
+        for (auto& value : values) {
+            if (!String(value)) return false;
+        }
+        return true;
+    }
+
+    bool Magic(const char (&magic)[4]) {
+        if (!Need(4)) return false;
+        matched_ = std::memcmp(data_ + pos_, magic, 4) == 0;
+        pos_ += 4;
+        return true;
+    }
+
+    bool MagicMatched() const { return matched_; }
+    size_t Position() const { return pos_; }
+
+private:
+    bool Need(size_t bytes) const { return length_ - pos_ >= bytes; }
+
+    const char* data_;
+    size_t length_;
+    size_t pos_ = 0;
+    bool matched_ = false;
+};
+
+bool Contains(const std::vector<std::string>& values, const std::string& value) {
+    return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+} // namespace
+
+// ============================================================================
+// HandshakeCodec
+// ============================================================================
+
+void HandshakeCodec::EncodeHello(const ConnectionHello& hello, std::string& out) {
+    out.append(kHelloMagic, 4);
+    PutU8(out, hello.min_version);
+    PutU8(out, hello.max_version);
+    PutU64(out, hello.features);
+    PutStringList(out, hello.serializers);
+    PutStringList(out, hello.compressions);
+}
+
+HandshakeParse HandshakeCodec::DecodeHello(const char* data, size_t length,
+                                           ConnectionHello& hello, size_t& consumed) {
+    Reader reader(data, length);
+    if (!reader.Magic(kHelloMagic)) return HandshakeParse::INCOMPLETE;
+    if (!reader.MagicMatched()) return HandshakeParse::INVALID;
+    if (!reader.U8(hello.min_version) || !reader.U8(hello.max_version) ||
+        !reader.U64(hello.features) || !reader.StringList(hello.serializers) ||
+        !reader.StringList(hello.compressions)) {
+        return HandshakeParse::INCOMPLETE;
+    }
+    consumed = reader.Position();
+    return HandshakeParse::OK;
+}
+
+void HandshakeCodec::EncodeAccept(const HandshakeAccept& accept, std::string& out) {
+    out.append(kAcceptMagic, 4);
+    PutU8(out, accept.accepted ? 1 : 0);
+    PutU8(out, accept.version);
+    PutU64(out, accept.features);
+    PutString(out, accept.serializer);
+    PutString(out, accept.compression);
+    PutString(out, accept.error_message);
+}
+
+HandshakeParse HandshakeCodec::DecodeAccept(const char* data, size_t length,
+                                            HandshakeAccept& accept, size_t& consumed) {
+    Reader reader(data, length);
+    if (!reader.Magic(kAcceptMagic)) return HandshakeParse::INCOMPLETE;
+    if (!reader.MagicMatched()) return HandshakeParse::INVALID;
+    uint8_t accepted = 0;
+    if (!reader.U8(accepted) || !reader.U8(accept.version) || !reader.U64(accept.features) ||
+        !reader.String(accept.serializer) || !reader.String(accept.compression) ||
+        !reader.String(accept.error_message)) {
+        return HandshakeParse::INCOMPLETE;
+    }
+    accept.accepted = accepted != 0;
+    consumed = reader.Position();
+    return HandshakeParse::OK;
+}
+
+// ============================================================================
+// Negotiation
+// ============================================================================
+
+HandshakeAccept NegotiateConnection(const ConnectionHello& server, const ConnectionHello& client) {
+    HandshakeAccept accept;
+
+    uint8_t high = std::min(server.max_version, client.max_version);
+    uint8_t low = std::max(server.min_version, client.min_version);
+    if (high < low) {
+        accept.error_message = "no common protocol version";
+        return accept;
+    }
+    accept.version = high;
+
+    for (const auto& name : client.serializers) {
+        if (Contains(server.serializers, name)) {
+            accept.serializer = name;
+            break;
+        }
+    }
+    if (accept.serializer.empty()) {
+        accept.error_message = "no common serializer";
+        return accept;
+    }
+
+    // "none" is always acceptable, so compression never fails the handshake
+    accept.compression = "none";
+    for (const auto& name : client.compressions) {
+        if (Contains(server.compressions, name)) {
+            accept.compression = name;
+            break;
+        }
+    }
+
+    accept.features = server.features & client.features;
+    accept.accepted = true;
+    return accept;
+}
+
+// ============================================================================
+// ConnectionCodec
+// ============================================================================
+
+bool ConnectionCodec::Bind(const HandshakeAccept& accept) {
+    if (!accept.accepted) {
+        return false;
+    }
+    version = accept.version;
+    features = accept.features;
+    serializer_name = accept.serializer;
+    serializer = SerializerRegistry::Instance().GetSerializer(accept.serializer);
+    compression_name = accept.compression;
+    compressor = CompressorRegistry::Instance().GetCompressor(accept.compression);
+    return true;
+}
+
+void ConnectionCodec::EncodeFrame(FrameHeader header, std::string_view payload, std::string& out,
+                                  std::string& scratch) const {
+    header.version = version;
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_COMPRESSED);
+    if (MessageCodec::CompressPayload(GetCompressionPolicy(), header, payload, scratch)) {
+        payload = scratch;
+    }
+    header.payload_length = static_cast<uint32_t>(payload.size());
+    out.reserve(out.size() + FrameHeader::kSize + payload.size());
+    MessageCodec::EncodeHeader(header, out);
+    out.append(payload.data(), payload.size());
+}
+
+bool ConnectionCodec::DecodeFrame(const char* data, size_t length, size_t max_size, FrameHeader& header,
+                                  std::string_view& payload, std::string& scratch) const {
+    if (!MessageCodec::DecodeHeader(data, length, header) || header.version != version ||
+        length != FrameHeader::kSize + header.payload_length) {
+        return false;
+    }
+    payload = std::string_view(data + FrameHeader::kSize, header.payload_length);
+    if (!header.HasFlag(FRAME_FLAG_COMPRESSED)) {
+        return payload.size() <= max_size;
+    }
+    if (!MessageCodec::DecompressPayload(compressor, payload, max_size, scratch)) {
+        return false;
+    }
+    payload = scratch;
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_COMPRESSED);
+    header.payload_length = static_cast<uint32_t>(payload.size());
+    return true;
+}
+
+} // namespace grlrpc
@@ -0,0 +1,346 @@
+// GrlRPC HTTP Gateway Implementation
+
+#include "http_gateway.h"
+
+#include <charconv>
+
+namespace grlrpc {
+
+namespace {
+
+char ToLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ToLower(a[i]) != ToLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ContainsTokenIgnoreCase(std::string_view value, std::string_view token) {
+    if (token.size() > value.size()) {
+        return false;
+    }
+    for (size_t i = 0; i + token.size() <= value.size(); ++i) {
+        if (EqualsIgnoreCase(value.substr(i, token.size()), token)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view Trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+const char* ReasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default:  return "Unknown";
+    }
+}
+
+void AppendNumber(std::string& output, size_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    output.append(digits, result.ptr);
+}
+
+void WriteResponse(std::string& output, int status, std::string_view body, bool keep_alive,
+                   std::string_view extra_header = std::string_view()) {
+    output.append("HTTP/1.1 ");
+    AppendNumber(output, static_cast<size_t>(status));
+    output.push_back(' ');
+    output.append(ReasonPhrase(status));
+    output.append("\r\nContent-Type: application/json\r\nContent-Length: ");
+    AppendNumber(output, body.size());
+    output.append("\r\n");
+    if (!keep_alive) {
+        output.append("Connection: close\r\n");
+    }
+    if (!extra_header.empty()) {
+        output.append(extra_header);
+        output.append("\r\n");
+    }
+    output.append("\r\n");
+    output.append(body);
+}
+
+void AppendJsonEscaped(std::string& output, std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            output.push_back('\\');
+            output.push_back(c);
+        } else if (static_cast<uint8_t>(c) < 0x20) {
+            output.push_back(' ');
+        } else {
+            output.push_back(c);
+        }
+    }
+}
+
+void WriteError(std::string& output, int status, std::string_view error,
+                std::string_view message, bool keep_alive,
+                std::string_view extra_header = std::string_view()) {
+    std::string body;
+    body.reserve(32 + error.size() + message.size());
+    body.append("{\"error\":\"");
+    AppendJsonEscaped(body, error);
+    body.append("\",\"message\":\"");
+    AppendJsonEscaped(body, message);
+    body.append("\"}");
+    WriteResponse(output, status, body, keep_alive, extra_header);
+}
+
+} // namespace
+
+// ============================================================================
+// HttpRequestView
+// ============================================================================
+
+std::string_view HttpRequestView::GetHeader(std::string_view name) const {
+    for (size_t i = 0; i < header_count; ++i) {
+        if (EqualsIgnoreCase(headers[i].name, name)) {
+            return headers[i].value;
+        }
+    }
+    return std::string_view();
+}
+
+// ============================================================================
+// HttpRequestParser
+// ============================================================================
+
+HttpParseStatus HttpRequestParser::Parse(std::string_view buffer, HttpRequestView& request,
+                                         size_t& consumed) {
+    bool head_parsed = false;
+    if (header_end_ == 0) {
+        // Resume a few bytes early in case the terminator straddles two reads
+        size_t start = scanned_ >= 3 ? scanned_ - 3 : 0;
+        size_t pos = buffer.find("\r\n\r\n", start);
+        if (pos == std::string_view::npos) {
+            if (buffer.size() > max_header_bytes_) {
+                Reset();
+                return HttpParseStatus::TOO_LARGE;
+            }
+            scanned_ = buffer.size();
+            return HttpParseStatus::INCOMPLETE;
+        }
+        if (pos + 4 > max_header_bytes_) {
+            Reset();
+            return HttpParseStatus::TOO_LARGE;
+        }
+
+        HttpParseStatus status = ParseHead(buffer.substr(0, pos + 2), request, content_length_);
+        if (status != HttpParseStatus::COMPLETE) {
+            Reset();
+            return status;
+        }
+        if (content_length_ > max_body_bytes_) {
+            Reset();
+            return HttpParseStatus::TOO_LARGE;
+        }
+        header_end_ = pos + 4;
+        head_parsed = true;
+    }
+
+    if (buffer.size() < header_end_ + content_length_) {
+        return HttpParseStatus::INCOMPLETE;
+    }
+
+    // Views must point into the buffer of this call, which may have moved
+    if (!head_parsed) {
+        size_t content_length = 0;
+        ParseHead(buffer.substr(0, header_end_ - 2), request, content_length);
+    }
+    request.body = buffer.substr(header_end_, content_length_);
+    consumed = header_end_ + content_length_;
+    Reset();
+    return HttpParseStatus::COMPLETE;
+}
+
+HttpParseStatus HttpRequestParser::ParseHead(std::string_view head, HttpRequestView& request,
+                                             size_t& content_length) {
+    // Request line: METHOD SP target SP HTTP/1.x CRLF
+    size_t line_end = head.find("\r\n");
+    std::string_view line = head.substr(0, line_end);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+    if (sp1 == 0 || sp2 == std::string_view::npos || sp2 == sp1 + 1) {
+        return HttpParseStatus::BAD_REQUEST;
+    }
+    std::string_view version = line.substr(sp2 + 1);
+    if (version == "HTTP/1.1") {
+        request.version_minor = 1;
+    } else if (version == "HTTP/1.0") {
+        request.version_minor = 0;
+    } else {
+        return HttpParseStatus::BAD_REQUEST;
+    }
+    request.method = line.substr(0, sp1);
+    request.target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    request.keep_alive = request.version_minor == 1;
+    request.header_count = 0;
+    request.body = std::string_view();
+    content_length = 0;
+    bool has_content_length = false;
+
+    size_t pos = line_end + 2;
+    while (pos < head.size()) {
+        size_t end = head.find("\r\n", pos);
+        if (end == std::string_view::npos) {
+            return HttpParseStatus::BAD_REQUEST;
+        }
+        std::string_view header_line = head.substr(pos, end - pos);
+        pos = end + 2;
+
+        size_t colon = header_line.find(':');
+        if (colon == 0 || colon == std::string_view::npos ||
+            header_line.substr(0, colon).find_first_of(" \t") != std::string_view::npos) {
+            return HttpParseStatus::BAD_REQUEST;
+        }
+        if (request.header_count == HttpRequestView::kMaxHeaders) {
+            return HttpParseStatus::TOO_LARGE;
+        }
+        HttpHeader& header = request.headers[request.header_count++];
+        header.name = header_line.substr(0, colon);
+        header.value = Trim(header_line.substr(colon + 1));
+
+        if (EqualsIgnoreCase(header.name, "Content-Length")) {
+            // Another hop may frame the body by the other copy: refuse rather
+            // than pick one and let the rest be read as a smuggled request
+            if (has_content_length) {
+                return HttpParseStatus::BAD_REQUEST;
+            }
+            has_content_length = true;
+            auto result = std::from_chars(header.value.data(),
+                                          header.value.data() + header.value.size(),
+                                          content_length);
+            if (result.ec != std::errc() ||
+                result.ptr != header.value.data() + header.value.size()) {
+                return HttpParseStatus::BAD_REQUEST;
+            }
+        } else if (EqualsIgnoreCase(header.name, "Transfer-Encoding") &&
+                   !EqualsIgnoreCase(header.value, "identity")) {
+            return HttpParseStatus::UNSUPPORTED;
+        } else if (EqualsIgnoreCase(header.name, "Connection")) {
+            if (ContainsTokenIgnoreCase(header.value, "close")) {
+                request.keep_alive = false;
+            } else if (ContainsTokenIgnoreCase(header.value, "keep-alive")) {
+                request.keep_alive = true;
+            }
+        }
+    }
+    return HttpParseStatus::COMPLETE;
+}
+
+// ============================================================================
+// HttpGatewayConnection
+// ============================================================================
+
+HttpGatewayConnection::HttpGatewayConnection(const MethodTable& methods,
+                                             std::string serializer_name)
+    : methods_(methods), serializer_name_(std::move(serializer_name)) {}
+
+size_t HttpGatewayConnection::OnData(std::string_view buffer, std::string& output,
+                                     bool& close_connection) {
+    size_t total = 0;
+    close_connection = false;
+
+    while (total < buffer.size()) {
+        HttpRequestView request;
+        size_t consumed = 0;
+        HttpParseStatus status = parser_.Parse(buffer.substr(total), request, consumed);
+        if (status == HttpParseStatus::INCOMPLETE) {
+            break;
+        }
+        if (status != HttpParseStatus::COMPLETE) {
+            int code = status == HttpParseStatus::UNSUPPORTED ? 501
+                     : status == HttpParseStatus::TOO_LARGE ? 413 : 400;
+            WriteError(output, code, ReasonPhrase(code), "malformed or unsupported request", false);
+            close_connection = true;
+            return buffer.size();
+        }
+
+        Dispatch(request, output);
+        total += consumed;
+        if (!request.keep_alive) {
+            close_connection = true;
+            break;
+        }
+    }
+    return total;
+}
+
+void HttpGatewayConnection::Dispatch(const HttpRequestView& request, std::string& output) {
+    if (request.method != "POST") {
+        WriteError(output, 405, "METHOD_NOT_ALLOWED", "only POST is supported",
+                   request.keep_alive, "Allow: POST");
+        return;
+    }
+
+    std::string_view path = request.target.substr(0, request.target.find('?'));
+    if (path.size() < 2 || path.front() != '/') {
+        WriteError(output, 404, "METHOD_NOT_FOUND", path, request.keep_alive);
+        return;
+    }
+    const MethodEntry* entry = methods_.Find(path.substr(1));
+    if (!entry) {
+        WriteError(output, 404, "METHOD_NOT_FOUND", path, request.keep_alive);
+        return;
+    }
+
+    PooledPtr<RpcRequestData> rpc_request = MakePooled<RpcRequestData>();
+    rpc_request->header.method_id = entry->id;
+    rpc_request->method_name.assign(entry->name);
+    rpc_request->serializer_name.assign(serializer_name_);
+    rpc_request->payload.assign(request.body.data(), request.body.size());
+
+    PooledPtr<RpcResponseData> rpc_response = MakePooled<RpcResponseData>();
+    RpcStatus status = entry->handler(*rpc_request, *rpc_response);
+    if (status == RpcStatus::SUCCESS) {
+        WriteResponse(output, 200, rpc_response->payload, request.keep_alive);
+    } else {
+        WriteError(output, HttpStatusFromRpcStatus(status), RpcStatusToString(status),
+                   rpc_response->error_message, request.keep_alive);
+    }
+}
+
+int HttpStatusFromRpcStatus(RpcStatus status) {
+    switch (status) {
+        case RpcStatus::SUCCESS:             return 200;
+        case RpcStatus::METHOD_NOT_FOUND:    return 404;
+        case RpcStatus::SERIALIZATION_ERROR: return 400;
+        case RpcStatus::INVALID_REQUEST:     return 400;
+        case RpcStatus::RATE_LIMITED:        return 429;
+        case RpcStatus::NETWORK_ERROR:       return 502;
+        case RpcStatus::CIRCUIT_OPEN:        return 503;
+        case RpcStatus::TIMEOUT:             return 504;
+        default:                             return 500;
+    }
+}
+
+} // namespace grlrpc
@@ -0,0 +1,89 @@
+// GrlRPC Inline Watchdog Implementation
+
+#include "inline_watchdog.h"
+
+namespace grlrpc {
+
+namespace {
+
+int64_t ToNanos(RpcClock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+int64_t BudgetNanos(const MethodEntry* method) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(method->options.inline_budget).count();
+}
+
+} // namespace
+
+InlineWatchdog::InlineWatchdog(size_t loop_count, InlineOverrunCallback on_overrun)
+    : loop_count_(loop_count),
+      slots_(new LoopSlot[loop_count]),
+      on_overrun_(std::move(on_overrun)) {}
+
+RpcStatus InlineWatchdog::Run(size_t loop_index, const MethodEntry& entry,
+                              const RpcRequestData& request, RpcResponseData& response) {
+    Enter(loop_index, entry, RpcClock::now());
+    RpcStatus status = entry.handler(request, response);
+    Exit(loop_index, RpcClock::now());
+    return status;
+}
+
+void InlineWatchdog::Enter(size_t loop_index, const MethodEntry& entry, RpcClock::time_point now) {
+    LoopSlot& slot = slots_[loop_index];
+    slot.started_ns.store(ToNanos(now), std::memory_order_relaxed);
+    slot.reported.store(false, std::memory_order_relaxed);
+    // Publishing the method makes the slot visible to Scan()
+    slot.method.store(&entry, std::memory_order_release);
+}
+
+void InlineWatchdog::Exit(size_t loop_index, RpcClock::time_point now) {
+    LoopSlot& slot = slots_[loop_index];
+    const MethodEntry* method = slot.method.load(std::memory_order_relaxed);
+    slot.method.store(nullptr, std::memory_order_release);
+    if (!method) {
+        return;
+    }
+
+    int64_t elapsed = ToNanos(now) - slot.started_ns.load(std::memory_order_relaxed);
+    if (elapsed > BudgetNanos(method) && !slot.reported.exchange(true, std::memory_order_acq_rel)) {
+        Report(method, elapsed, false);
+    }
+}
+
+size_t InlineWatchdog::Scan(RpcClock::time_point now) {
+    int64_t now_ns = ToNanos(now);
+    size_t reported = 0;
+    for (size_t i = 0; i < loop_count_; ++i) {
+        LoopSlot& slot = slots_[i];
+        const MethodEntry* method = slot.method.load(std::memory_order_acquire);
+        if (!method) {
+            continue;
+        }
+        int64_t elapsed = now_ns - slot.started_ns.load(std::memory_order_relaxed);
+        if (elapsed <= BudgetNanos(method) ||
+            slot.reported.load(std::memory_order_relaxed) ||
+            slot.method.load(std::memory_order_acquire) != method) {
+            continue;
+        }
+        // The loop may finish concurrently; whoever flips the flag reports
+        if (!slot.reported.exchange(true, std::memory_order_acq_rel)) {
+            Report(method, elapsed, true);
+            ++reported;
+        }
+    }
+    return reported;
+}
+
+void InlineWatchdog::Report(const MethodEntry* method, int64_t elapsed_ns, bool still_running) {
+    overruns_.fetch_add(1, std::memory_order_relaxed);
+    if (on_overrun_) {
+        InlineOverrun overrun;
+        overrun.method = method;
+        overrun.elapsed = std::chrono::nanoseconds(elapsed_ns);
+        overrun.still_running = still_running;
+        on_overrun_(overrun);
+    }
+}
+
+} // namespace grlrpc
@@ -1,9 +1,303 @@
 // GrlRPC Main Entry Point
-// This file will be implemented in task 12.x
+// Hosts the user service. Until the TCP server lands, requests are driven
+// in process through LocalChannel as a read-heavy load generator:
+//   grlrpc_server [--users N] [--threads T] [--seconds S] [--read-percent P]
+//                 [--data-dir DIR] [--batch-size B] [--watchers W]
+//                 [--cold-file FILE] [--cache-mb M]
+// With --data-dir the store is recovered from DIR and writes are logged
+// there; seeding only tops the store up to N users. With --batch-size each
+// read is one BatchGetUsers call for B random users. With --watchers, W
+// more threads follow every write through WatchUsers long-polls. With
+// --cold-file, users of that export not in the store are read through an
+// M MB cache and count towards N.
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
-int main() {
-    std::cout << "GrlRPC Framework - Not yet implemented" << std::endl;
-    return 0;
+#include "fan_out_pool.h"
+#include "rpc_framework.h"
+#include "serialization_framework.h"
+#include "user_persistence.h"
+#include "user_service.h"
+#include "user_store.h"
+#include "user_tier.h"
+#include "user_types.h"
+#include "user_watch.h"
+
+namespace {
+
+struct Options {
+    size_t users = 100000;
+    size_t threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 4;
+    double seconds = 5.0;
+    int read_percent = 95;
+    size_t shards = 16;
+    std::string serializer = "json";
+    std::string data_dir;
+    size_t batch_size = 0;
+    size_t watchers = 0;
+    std::string cold_file;
+    size_t cache_mb = 64;
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            return false;
+        }
+        if (std::strcmp(arg, "--users") == 0) {
+            options.users = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--seconds") == 0) {
+            options.seconds = std::strtod(value, nullptr);
+        } else if (std::strcmp(arg, "--read-percent") == 0) {
+            options.read_percent = std::atoi(value);
+        } else if (std::strcmp(arg, "--shards") == 0) {
+            options.shards = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--serializer") == 0) {
+            options.serializer = value;
+        } else if (std::strcmp(arg, "--data-dir") == 0) {
+            options.data_dir = value;
+        } else if (std::strcmp(arg, "--batch-size") == 0) {
+            options.batch_size = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--watchers") == 0) {
+            options.watchers = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--cold-file") == 0) {
+            options.cold_file = value;
+        } else if (std::strcmp(arg, "--cache-mb") == 0) {
+            options.cache_mb = std::strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+        ++i;
+    }
+    return options.users > 0 && options.threads > 0 && options.shards > 0 &&
+           options.batch_size <= grlrpc::UserService::kMaxBatchSize;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: grlrpc_server [--users N] [--threads T] [--seconds S]"
+                     " [--read-percent P] [--shards S] [--serializer NAME] [--data-dir DIR]"
+                     " [--batch-size B] [--watchers W] [--cold-file FILE] [--cache-mb M]" << std::endl;
+        return 1;
+    }
+
+    grlrpc::RegisterBuiltinSerializers();
+    grlrpc::RegisterUserTypes();
+
+    grlrpc::UserStore store(options.shards, options.users / options.shards + 1);
+    std::unique_ptr<grlrpc::UserPersistence> persistence;
+    if (!options.data_dir.empty()) {
+        auto recover_start = std::chrono::steady_clock::now();
+        persistence = std::make_unique<grlrpc::UserPersistence>(store, options.data_dir);
+        std::string error;
+        if (!persistence->Open(error)) {
+            std::cerr << "failed to open " << options.data_dir << ": " << error << std::endl;
+            return 1;
+        }
+        const grlrpc::RecoveryStats& stats = persistence->GetRecoveryStats();
+        std::cout << "Recovered " << store.Size() << " users (" << stats.snapshot_users
+                  << " from snapshot, " << stats.log_records << " log records in "
+                  << stats.log_segments << " segments) in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - recover_start).count()
+                  << " s" << std::endl;
+    }
+    grlrpc::UserService service(store, persistence.get());
+    size_t cores = std::thread::hardware_concurrency();
+    grlrpc::FanOutPool fan_out(cores > 1 ? cores - 1 : 0);
+    service.SetFanOutPool(&fan_out);
+    grlrpc::UserColdStore cold;
+    std::unique_ptr<grlrpc::TieredUserStore> tier;
+    if (!options.cold_file.empty()) {
+        std::string error;
+        if (!cold.Open(options.cold_file, error)) {
+            std::cerr << "failed to open " << options.cold_file << ": " << error << std::endl;
+            return 1;
+        }
+        grlrpc::TierConfig tier_config;
+        tier_config.cache.capacity_bytes = options.cache_mb * 1024 * 1024;
+        tier = std::make_unique<grlrpc::TieredUserStore>(store, cold, tier_config);
+        service.SetTieredStore(tier.get());
+        std::cout << "Cold file: " << cold.Size() << " users, index " << cold.IndexBytes() / (1024 * 1024)
+                  << " MB, cache " << options.cache_mb << " MB" << std::endl;
+    }
+    std::unique_ptr<grlrpc::UserWatchHub> watch_hub;
+    if (options.watchers > 0) {
+        watch_hub = std::make_unique<grlrpc::UserWatchHub>(store);
+        service.SetWatchHub(watch_hub.get());
+    }
+    grlrpc::MethodTable methods;
+    grlrpc::ServiceSkeleton skeleton(methods, {options.serializer});
+    if (!service.Register(skeleton)) {
+        std::cerr << "failed to register the user service" << std::endl;
+        return 1;
+    }
+
+    grlrpc::LocalChannel channel(methods);
+    grlrpc::ServiceStub<grlrpc::GetUserMethod, grlrpc::CreateUserMethod, grlrpc::UpdateUserMethod,
+                        grlrpc::BatchGetUsersMethod> stub(channel, options.serializer);
+    if (!stub.IsBound()) {
+        std::cerr << "serializer '" << options.serializer << "' cannot encode user messages" << std::endl;
+        return 1;
+    }
+
+    std::cout << "GrlRPC user service: " << methods.Size() << " methods, "
+              << options.shards << " shards, serializer " << options.serializer << std::endl;
+
+    // Seed the store through the service so the write path is exercised too
+    auto seed_start = std::chrono::steady_clock::now();
+    for (size_t i = store.Size() + cold.Size(); i < options.users; ++i) {
+        grlrpc::CreateUserRequest request;
+        request.name = "user" + std::to_string(i);
+        request.email = request.name + "@example.com";
+        request.age = static_cast<int32_t>(18 + i % 60);
+        grlrpc::CreateUserResponse response;
+        if (stub.Call<grlrpc::CreateUserMethod>(request, response) != grlrpc::RpcStatus::SUCCESS ||
+            !response.success) {
+            std::cerr << "seeding failed at user " << i << std::endl;
+            return 1;
+        }
+    }
+    double seed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - seed_start).count();
+    std::cout << "Seeded " << store.Size() << " users in " << seed_seconds << " s" << std::endl;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> users_read{0};
+    std::atomic<uint64_t> writes{0};
+    std::atomic<uint64_t> errors{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            std::uniform_int_distribution<uint64_t> pick_user(1, options.users);
+            std::uniform_int_distribution<int> pick_op(0, 99);
+            uint64_t local_reads = 0;
+            uint64_t local_users_read = 0;
+            uint64_t local_writes = 0;
+            uint64_t local_errors = 0;
+            grlrpc::GetUserRequest get_request;
+            grlrpc::GetUserResponse get_response;
+            grlrpc::UpdateUserRequest update_request;
+            grlrpc::UpdateUserResponse update_response;
+            grlrpc::BatchGetUsersRequest batch_request;
+            grlrpc::BatchGetUsersResponse batch_response;
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint64_t user_id = pick_user(rng);
+                bool read = pick_op(rng) < options.read_percent;
+                if (read && options.batch_size > 0) {
+                    batch_request.user_ids.resize(options.batch_size);
+                    for (uint64_t& id : batch_request.user_ids) {
+                        id = pick_user(rng);
+                    }
+                    if (stub.Call<grlrpc::BatchGetUsersMethod>(batch_request, batch_response) !=
+                            grlrpc::RpcStatus::SUCCESS || batch_response.users.size() != options.batch_size) {
+                        ++local_errors;
+                    }
+                    ++local_reads;
+                    local_users_read += options.batch_size;
+                } else if (read) {
+                    get_request.user_id = user_id;
+                    if (stub.Call<grlrpc::GetUserMethod>(get_request, get_response) !=
+                            grlrpc::RpcStatus::SUCCESS || !get_response.found) {
+                        ++local_errors;
+                    }
+                    ++local_reads;
+                    ++local_users_read;
+                } else {
+                    update_request.user_id = user_id;
+                    update_request.age = static_cast<int32_t>(18 + rng() % 60);
+                    if (stub.Call<grlrpc::UpdateUserMethod>(update_request, update_response) !=
+                            grlrpc::RpcStatus::SUCCESS || !update_response.success) {
+                        ++local_errors;
+                    }
+                    ++local_writes;
+                }
+            }
+            reads += local_reads;
+            users_read += local_users_read;
+            writes += local_writes;
+            errors += local_errors;
+        });
+    }
+
+    // Watchers start from the current position and stop at their next
+    // empty or full poll after the run
+    std::atomic<uint64_t> events_watched{0};
+    std::atomic<uint64_t> watch_gaps{0};
+    std::vector<std::thread> watchers;
+    for (size_t w = 0; w < options.watchers; ++w) {
+        watchers.emplace_back([&] {
+            grlrpc::ServiceStub<grlrpc::WatchUsersMethod> watch_stub(channel, options.serializer);
+            grlrpc::WatchUsersRequest request;
+            request.after_sequence = watch_hub->GetLastSequence();
+            request.incarnation = watch_hub->GetIncarnation();
+            request.max_events = grlrpc::UserWatchHub::kMaxEventsPerResponse;
+            request.wait_ms = 100;
+            grlrpc::WatchUsersResponse response;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (watch_stub.Call<grlrpc::WatchUsersMethod>(request, response) != grlrpc::RpcStatus::SUCCESS) {
+                    ++errors;
+                    break;
+                }
+                events_watched += response.events.size();
+                watch_gaps += response.gap ? 1 : 0;
+                request.after_sequence = response.next_sequence;
+                request.incarnation = response.incarnation;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& watcher : watchers) {
+        watcher.join();
+    }
+
+    uint64_t total = reads + writes;
+    std::cout << "Threads: " << options.threads << ", reads: " << reads << ", writes: " << writes
+              << ", errors: " << errors << std::endl;
+    std::cout << "Throughput: " << static_cast<uint64_t>(total / options.seconds) << " req/s"
+              << ", users read: " << static_cast<uint64_t>(users_read / options.seconds) << "/s"
+              << std::endl;
+    std::cout << "Versions reclaimed: " << store.GetReclaimedCount()
+              << ", pending: " << store.GetPendingReclaimCount() << std::endl;
+    if (watch_hub) {
+        std::cout << "Watchers: " << options.watchers << ", events watched: " << events_watched
+                  << ", gaps: " << watch_gaps << std::endl;
+    }
+    if (tier) {
+        grlrpc::TierStats stats = tier->GetStats();
+        uint64_t lookups = stats.cache.hits + stats.cache.misses;
+        std::cout << "Tier: resident hits " << stats.resident_hits << ", cache hits " << stats.cache.hits
+                  << " (" << (lookups ? 100.0 * stats.cache.hits / lookups : 0.0) << "%), misses "
+                  << stats.cache.misses << ", promotions " << stats.cache.promotions << ", ghost hits "
+                  << stats.cache.ghost_hits << ", evictions " << stats.cache.evictions << std::endl;
+        std::cout << "Cold reads: " << stats.cold_reads << ", coalesced: " << stats.coalesced_reads
+                  << ", made resident: " << stats.made_resident << ", cache "
+                  << stats.cache.bytes / (1024 * 1024) << " MB in " << stats.cache.entries << " users" << std::endl;
+    }
+    if (persistence) {
+        std::cout << "Log syncs: " << persistence->GetSyncCount() << ", snapshots: "
+                  << persistence->GetSnapshotCount() << std::endl;
+    }
+    return errors == 0 ? 0 : 1;
 }
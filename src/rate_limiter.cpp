@@ -0,0 +1,163 @@
+// GrlRPC Rate Limiter Implementation
+
+#include "rate_limiter.h"
+
+#include <algorithm>
+
+namespace grlrpc {
+
+namespace {
+
+// splitmix64 finalizer: spreads sequential ids across the table
+uint64_t MixKey(uint64_t key) {
+    key += 0x9E3779B97F4A7C15ull;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    key ^= key >> 31;
+    return key ? key : 1;  // 0 marks an empty slot
+}
+
+size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+// ============================================================================
+// AtomicTokenBucket
+// ============================================================================
+
+void AtomicTokenBucket::Configure(double rate_per_second, uint32_t burst) {
+    interval_ns_ = rate_per_second > 0 ? static_cast<int64_t>(1e9 / rate_per_second) : 0;
+    tolerance_ns_ = interval_ns_ * static_cast<int64_t>(std::max<uint32_t>(burst, 1));
+    tat_ns_.store(0, std::memory_order_relaxed);
+}
+
+bool AtomicTokenBucket::TryAcquire(int64_t now_ns) {
+    int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+    for (;;) {
+        int64_t next = std::max(tat, now_ns) + interval_ns_;
+        if (next - now_ns > tolerance_ns_) {
+            return false;
+        }
+        if (tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void AtomicTokenBucket::Refund() {
+    tat_ns_.fetch_sub(interval_ns_, std::memory_order_relaxed);
+}
+
+bool AtomicTokenBucket::IsIdle(int64_t now_ns) const {
+    return tat_ns_.load(std::memory_order_relaxed) + tolerance_ns_ <= now_ns;
+}
+
+// ============================================================================
+// RateLimiter
+// ============================================================================
+
+uint64_t HashClientIdentity(std::string_view identity) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : identity) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+RateLimiter::RateLimiter(std::vector<RateLimitRule> rules, size_t slots_per_rule) {
+    size_t capacity = RoundUpPowerOfTwo(std::max<size_t>(slots_per_rule, kMaxProbes));
+    tables_.reserve(rules.size());
+    for (const auto& rule : rules) {
+        RuleTable table;
+        table.rule = rule;
+        // A method-scoped rule only ever needs one bucket per method
+        size_t size = rule.scope == RateLimitScope::METHOD && rule.method_id != 0 ? 1 : capacity;
+        table.mask = size - 1;
+        table.slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            table.slots[i].bucket.Configure(rule.rate_per_second, rule.burst);
+        }
+        tables_.push_back(std::move(table));
+    }
+}
+
+AtomicTokenBucket& RateLimiter::FindBucket(RuleTable& table, uint64_t key, int64_t now_ns) {
+    size_t home = static_cast<size_t>(key) & table.mask;
+    size_t probes = std::min(kMaxProbes, table.mask + 1);
+    // Look for the key before claiming anything, so a key that sits past an
+    // idle slot keeps its own budget instead of starting a fresh one
+    for (size_t i = 0; i < probes; ++i) {
+        Slot& slot = table.slots[(home + i) & table.mask];
+        if (slot.key.load(std::memory_order_acquire) == key) {
+            return slot.bucket;
+        }
+    }
+    // Claim the first empty or idle slot. Racing callers probe in the same
+    // order, so the loser of a CAS finds the winner's key and shares its slot.
+    // A caller still holding the previous key may take one token from the
+    // bucket after the takeover; that token was unused budget either way.
+    for (size_t i = 0; i < probes; ++i) {
+        Slot& slot = table.slots[(home + i) & table.mask];
+        uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == key) {
+            return slot.bucket;
+        }
+        if ((current == 0 || slot.bucket.IsIdle(now_ns)) &&
+            (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) ||
+             current == key)) {
+            return slot.bucket;
+        }
+    }
+    return table.slots[home].bucket;
+}
+
+AtomicTokenBucket* RateLimiter::MatchBucket(RuleTable& table, const FrameHeader& header,
+                                            uint64_t client_key, uint64_t connection_id,
+                                            int64_t now_ns) {
+    const RateLimitRule& rule = table.rule;
+    if (rule.method_id != 0 && rule.method_id != header.method_id) {
+        return nullptr;
+    }
+
+    uint64_t key = 0;
+    switch (rule.scope) {
+        case RateLimitScope::CLIENT:     key = MixKey(client_key); break;
+        case RateLimitScope::CONNECTION: key = MixKey(connection_id); break;
+        case RateLimitScope::METHOD:     key = MixKey(header.method_id); break;
+    }
+    return &FindBucket(table, key, now_ns);
+}
+
+bool RateLimiter::Admit(const FrameHeader& header, uint64_t client_key, uint64_t connection_id,
+                        RpcClock::time_point now) {
+    int64_t now_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+
+    for (size_t i = 0; i < tables_.size(); ++i) {
+        AtomicTokenBucket* bucket = MatchBucket(tables_[i], header, client_key, connection_id, now_ns);
+        if (!bucket || bucket->TryAcquire(now_ns)) {
+            continue;
+        }
+
+        // Refund the rules already charged. Their buckets were just used, so
+        // they are not idle and resolve to the same slots again
+        for (size_t j = 0; j < i; ++j) {
+            AtomicTokenBucket* taken = MatchBucket(tables_[j], header, client_key, connection_id, now_ns);
+            if (taken) {
+                taken->Refund();
+            }
+        }
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+} // namespace grlrpc
@@ -0,0 +1,190 @@
+// GrlRPC Request Arena Implementation
+
+#include "request_arena.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace grlrpc {
+
+// ============================================================================
+// RequestArena
+// ============================================================================
+
+RequestArena::RequestArena(size_t block_size, size_t retain_bytes)
+    : block_size_(block_size), retain_bytes_(retain_bytes) {}
+
+RequestArena::~RequestArena() {
+    Reset();
+    for (Block* list : {head_, spare_}) {
+        while (list) {
+            Block* next = list->next;
+            std::free(list);
+            list = next;
+        }
+    }
+}
+
+void* RequestArena::Allocate(size_t bytes, size_t alignment) {
+    uintptr_t current = reinterpret_cast<uintptr_t>(cursor_);
+    uintptr_t aligned = (current + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (cursor_ == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(limit_)) {
+        AddBlock(bytes + alignment);
+        current = reinterpret_cast<uintptr_t>(cursor_);
+        aligned = (current + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+    cursor_ = reinterpret_cast<char*>(aligned + bytes);
+    bytes_allocated_ += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void RequestArena::AddBlock(size_t min_size) {
+    // Reuse a retained block first so steady-state requests stay off malloc
+    Block** link = &spare_;
+    Block* block = nullptr;
+    while (*link) {
+        if ((*link)->size >= min_size) {
+            block = *link;
+            *link = block->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+
+    if (!block) {
+        size_t size = min_size > block_size_ ? min_size : block_size_;
+        block = static_cast<Block*>(std::malloc(sizeof(Block) + size));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        block->size = size;
+    }
+
+    block->next = head_;
+    head_ = block;
+    cursor_ = block->Data();
+    limit_ = block->Data() + block->size;
+}
+
+void RequestArena::RegisterFinalizer(void (*destroy)(void*), void* object) {
+    Finalizer* finalizer = static_cast<Finalizer*>(Allocate(sizeof(Finalizer), alignof(Finalizer)));
+    finalizer->destroy = destroy;
+    finalizer->object = object;
+    finalizer->next = finalizers_;
+    finalizers_ = finalizer;
+}
+
+void RequestArena::Reset() {
+    // Newest first, i.e. reverse construction order
+    for (Finalizer* f = finalizers_; f; f = f->next) {
+        f->destroy(f->object);
+    }
+    finalizers_ = nullptr;
+
+    size_t retained = 0;
+    for (Block* b = spare_; b; b = b->next) {
+        retained += b->size;
+    }
+    while (head_) {
+        Block* next = head_->next;
+        if (retained + head_->size <= retain_bytes_) {
+            retained += head_->size;
+            head_->next = spare_;
+            spare_ = head_;
+        } else {
+            std::free(head_);
+        }
+        head_ = next;
+    }
+
+    cursor_ = nullptr;
+    limit_ = nullptr;
+    bytes_allocated_ = 0;
+    response_buffer_.clear();
+}
+
+size_t RequestArena::BlockCount() const {
+    size_t count = 0;
+    for (Block* list : {head_, spare_}) {
+        for (Block* b = list; b; b = b->next) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// ArenaPool
+// ============================================================================
+
+namespace {
+
+struct ThreadArenaCache {
+    std::vector<RequestArena*> arenas;
+
+    ThreadArenaCache() { arenas.reserve(ArenaPool::kMaxCachedArenas); }
+    ~ThreadArenaCache() {
+        for (RequestArena* arena : arenas) {
+            delete arena;
+        }
+    }
+};
+
+ThreadArenaCache& LocalArenaCache() {
+    thread_local ThreadArenaCache cache;
+    return cache;
+}
+
+thread_local RequestArena* current_arena = nullptr;
+
+} // namespace
+
+RequestArena* ArenaPool::Acquire() {
+    auto& cache = LocalArenaCache().arenas;
+    if (!cache.empty()) {
+        RequestArena* arena = cache.back();
+        cache.pop_back();
+        return arena;
+    }
+    return new RequestArena();
+}
+
+void ArenaPool::Release(RequestArena* arena) {
+    if (!arena) {
+        return;
+    }
+    arena->Reset();
+    auto& cache = LocalArenaCache().arenas;
+    if (cache.size() < kMaxCachedArenas) {
+        cache.push_back(arena);
+    } else {
+        delete arena;
+    }
+}
+
+size_t ArenaPool::CachedCount() {
+    return LocalArenaCache().arenas.size();
+}
+
+// ============================================================================
+// RequestArenaScope
+// ============================================================================
+
+RequestArenaScope::RequestArenaScope(RequestArena* arena) : previous_(current_arena) {
+    current_arena = arena;
+}
+
+RequestArenaScope::~RequestArenaScope() {
+    current_arena = previous_;
+}
+
+RequestArena* CurrentRequestArena() {
+    return current_arena;
+}
+
+std::pmr::memory_resource* CurrentRequestResource() {
+    return current_arena ? static_cast<std::pmr::memory_resource*>(current_arena)
+                         : std::pmr::get_default_resource();
+}
+
+} // namespace grlrpc
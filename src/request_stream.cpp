@@ -0,0 +1,338 @@
+// GrlRPC Request Stream Implementation
+
+#include "request_stream.h"
+
+namespace grlrpc {
+
+namespace {
+
+void AppendU32(std::string& out, uint32_t value) {
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint32_t LoadU32(const char* in) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+// ============================================================================
+// Payload Layout
+// ============================================================================
+
+void EncodeStreamingPayload(std::string_view head, std::string_view body, std::string& out) {
+    out.reserve(out.size() + sizeof(uint32_t) + head.size() + body.size());
+    AppendU32(out, static_cast<uint32_t>(head.size()));
+    out.append(head);
+    out.append(body);
+}
+
+bool SplitStreamingPayload(std::string_view payload, std::string_view& head, std::string_view& body) {
+    if (payload.size() < sizeof(uint32_t)) {
+        return false;
+    }
+    uint32_t head_length = LoadU32(payload.data());
+    payload.remove_prefix(sizeof(uint32_t));
+    if (head_length > payload.size()) {
+        return false;
+    }
+    head = payload.substr(0, head_length);
+    body = payload.substr(head_length);
+    return true;
+}
+
+// ============================================================================
+// RequestStream
+// ============================================================================
+
+RequestStream::RequestStream(size_t max_buffered_chunks, uint64_t declared_size)
+    : ring_(max_buffered_chunks > 0 ? max_buffered_chunks : 1), declared_size_(declared_size) {}
+
+bool RequestStream::Read(StreamChunk& chunk) {
+    std::function<void()> on_space;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        readable_.wait(lock, [this] { return count_ > 0 || finished_ || aborted_; });
+        if (aborted_ || count_ == 0) {
+            return false;
+        }
+        chunk = std::move(ring_[head_]);
+        ring_[head_] = StreamChunk();
+        head_ = (head_ + 1) % ring_.size();
+        --count_;
+        if (producer_blocked_) {
+            producer_blocked_ = false;
+            on_space = on_space_;
+        }
+    }
+    if (on_space) {
+        on_space();
+    }
+    return true;
+}
+
+bool RequestStream::IsAborted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return aborted_;
+}
+
+bool RequestStream::TryPush(StreamChunk chunk) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (aborted_) {
+            return true;
+        }
+        if (count_ == ring_.size()) {
+            producer_blocked_ = true;
+            return false;
+        }
+        ring_[(head_ + count_) % ring_.size()] = std::move(chunk);
+        ++count_;
+    }
+    readable_.notify_one();
+    return true;
+}
+
+void RequestStream::Finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    readable_.notify_all();
+}
+
+void RequestStream::Abort() {
+    std::function<void()> on_space;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (aborted_) {
+            return;
+        }
+        aborted_ = true;
+        // Release the receive buffers still referenced by unread chunks
+        for (auto& chunk : ring_) {
+            chunk = StreamChunk();
+        }
+        count_ = 0;
+        if (producer_blocked_) {
+            producer_blocked_ = false;
+            on_space = on_space_;
+        }
+    }
+    readable_.notify_all();
+    if (on_space) {
+        on_space();
+    }
+}
+
+void RequestStream::SetSpaceCallback(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    on_space_ = std::move(callback);
+}
+
+RpcStatus RunStreamingHandler(const StreamingHandler& handler, const RpcRequestData& request,
+                              RpcResponseData& response) {
+    std::string_view head;
+    std::string_view body;
+    if (!SplitStreamingPayload(request.payload, head, body)) {
+        response.error_message = "truncated streaming request head";
+        return RpcStatus::INVALID_REQUEST;
+    }
+
+    PooledPtr<RpcRequestData> head_request = MakePooled<RpcRequestData>();
+    head_request->header = request.header;
+    head_request->header.payload_length = static_cast<uint32_t>(head.size());
+    head_request->method_name = request.method_name;
+    head_request->serializer_name = request.serializer_name;
+    head_request->payload.assign(head.data(), head.size());
+
+    RequestStream stream(1, body.size());
+    if (!body.empty()) {
+        stream.TryPush(StreamChunk{nullptr, body});
+    }
+    stream.Finish();
+    return handler(*head_request, stream, response);
+}
+
+// ============================================================================
+// StreamingRequestDispatcher
+// ============================================================================
+
+StreamingRequestDispatcher::StreamingRequestDispatcher(const MethodTable& methods,
+                                                       std::string serializer_name,
+                                                       StreamTaskRunner run, StreamResponder respond,
+                                                       const StreamingConfig& config)
+    : methods_(methods),
+      serializer_name_(std::move(serializer_name)),
+      run_(std::move(run)),
+      respond_(std::move(respond)),
+      config_(config) {}
+
+StreamingRequestDispatcher::~StreamingRequestDispatcher() {
+    AbortAll();
+}
+
+StreamFrameResult StreamingRequestDispatcher::OnFrame(const FrameView& frame) {
+    FrameHeader header;
+    if (!frame.storage || frame.length < FrameHeader::kSize ||
+        !MessageCodec::DecodeHeader(frame.Data(), frame.length, header) ||
+        frame.length != FrameHeader::kSize + header.payload_length) {
+        return StreamFrameResult::INVALID;
+    }
+
+    auto it = streams_.find(header.request_id);
+    if (it == streams_.end()) {
+        if (!header.HasFlag(FRAME_FLAG_CHUNK) || header.HasFlag(FRAME_FLAG_RESPONSE)) {
+            return StreamFrameResult::NOT_STREAMING;
+        }
+        const MethodEntry* entry = methods_.Find(header.method_id);
+        if (!entry || !entry->IsStreaming()) {
+            return StreamFrameResult::NOT_STREAMING;
+        }
+        return StartStream(header, *entry, frame);
+    }
+
+    ActiveStream& active = it->second;
+    std::string_view data = frame.Payload();
+    bool last = !header.HasFlag(FRAME_FLAG_CHUNK);
+    if (data.size() > active.remaining || (last && data.size() != active.remaining)) {
+        active.stream->Abort();
+        streams_.erase(it);
+        return StreamFrameResult::INVALID;
+    }
+    if (!data.empty() && !active.stream->TryPush(StreamChunk{frame.storage, data})) {
+        return StreamFrameResult::BACKPRESSURE;
+    }
+    active.remaining -= data.size();
+    if (last) {
+        active.stream->Finish();
+        streams_.erase(it);
+    }
+    return StreamFrameResult::DELIVERED;
+}
+
+StreamFrameResult StreamingRequestDispatcher::StartStream(const FrameHeader& header,
+                                                          const MethodEntry& entry,
+                                                          const FrameView& frame) {
+    // First chunk: [total_length:u32][head_length:u32][head][first body bytes]
+    std::string_view payload = frame.Payload();
+    if (payload.size() < MessageCodec::kChunkPrefixSize) {
+        return StreamFrameResult::INVALID;
+    }
+    uint32_t total = LoadU32(payload.data());
+    payload.remove_prefix(MessageCodec::kChunkPrefixSize);
+    std::string_view head;
+    std::string_view body_prefix;
+    if (total > config_.max_stream_size || payload.size() >= total ||
+        !SplitStreamingPayload(payload, head, body_prefix)) {
+        return StreamFrameResult::INVALID;
+    }
+
+    uint64_t body_size = total - sizeof(uint32_t) - head.size();
+    auto stream = std::make_shared<RequestStream>(config_.max_buffered_chunks, body_size);
+    stream->SetSpaceCallback(on_resume_);
+    if (!body_prefix.empty()) {
+        stream->TryPush(StreamChunk{frame.storage, body_prefix});
+    }
+    streams_.emplace(header.request_id, ActiveStream{stream, body_size - body_prefix.size()});
+
+    auto request = std::make_shared<RpcRequestData>();
+    request->header = header;
+    request->header.flags &= static_cast<uint8_t>(~FRAME_FLAG_CHUNK);
+    request->header.payload_length = static_cast<uint32_t>(head.size());
+    request->method_name = entry.name;
+    request->serializer_name = serializer_name_;
+    request->payload.assign(head.data(), head.size());
+
+    // Handlers may outlive this dispatcher (connection closed mid-upload),
+    // so the task holds only the method entry and its own copies
+    const MethodEntry* method = &entry;
+    StreamResponder respond = respond_;
+    run_([method, request, stream, respond]() {
+        PooledPtr<RpcResponseData> response = MakePooled<RpcResponseData>();
+        response->request_id = request->header.request_id;
+        RpcStatus status = method->streaming_handler(*request, *stream, *response);
+        // Drop whatever the handler did not read; later chunks are discarded
+        stream->Abort();
+        if (!method->ExpectsResponse(request->header)) {
+            return;
+        }
+        response->status = status;
+        respond(request->header.request_id, status, *response);
+    });
+    return StreamFrameResult::DELIVERED;
+}
+
+void StreamingRequestDispatcher::AbortAll() {
+    for (auto& entry : streams_) {
+        entry.second.stream->Abort();
+    }
+    streams_.clear();
+}
+
+std::string StreamFrameResultToString(StreamFrameResult result) {
+    switch (result) {
+        case StreamFrameResult::DELIVERED:     return "DELIVERED";
+        case StreamFrameResult::NOT_STREAMING: return "NOT_STREAMING";
+        case StreamFrameResult::BACKPRESSURE:  return "BACKPRESSURE";
+        case StreamFrameResult::INVALID:       return "INVALID";
+        default: return "UNKNOWN";
+    }
+}
+
+// ============================================================================
+// StreamingRequestWriter
+// ============================================================================
+
+StreamingRequestWriter::StreamingRequestWriter(const FrameHeader& header, std::string_view head,
+                                               std::string_view body, const ChunkingConfig& config)
+    : header_(header),
+      head_(head),
+      body_(body),
+      chunk_size_(config.chunk_size > 0 ? config.chunk_size : body.size()),
+      chunked_(!body.empty() && sizeof(uint32_t) + head.size() + body.size() > config.chunk_threshold) {}
+
+bool StreamingRequestWriter::Next(std::string& out) {
+    if (done_) {
+        return false;
+    }
+
+    FrameHeader header = header_;
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_CHUNK);
+    if (!chunked_) {
+        header.payload_length = static_cast<uint32_t>(sizeof(uint32_t) + head_.size() + body_.size());
+        MessageCodec::EncodeHeader(header, out);
+        EncodeStreamingPayload(head_, body_, out);
+        done_ = true;
+        return true;
+    }
+
+    if (!head_sent_) {
+        header.flags |= FRAME_FLAG_CHUNK;
+        header.payload_length = static_cast<uint32_t>(2 * sizeof(uint32_t) + head_.size());
+        MessageCodec::EncodeHeader(header, out);
+        AppendU32(out, static_cast<uint32_t>(sizeof(uint32_t) + head_.size() + body_.size()));
+        EncodeStreamingPayload(head_, std::string_view(), out);
+        head_sent_ = true;
+        return true;
+    }
+
+    std::string_view chunk = body_.substr(offset_, chunk_size_);
+    offset_ += chunk.size();
+    done_ = offset_ == body_.size();
+    if (!done_) {
+        header.flags |= FRAME_FLAG_CHUNK;
+    }
+    header.payload_length = static_cast<uint32_t>(chunk.size());
+    MessageCodec::EncodeHeader(header, out);
+    out.append(chunk);
+    return true;
+}
+
+} // namespace grlrpc
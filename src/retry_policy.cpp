@@ -0,0 +1,135 @@
+// GrlRPC Retry Policy Implementation
+
+#include "retry_policy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace grlrpc {
+
+// ============================================================================
+// RetryBudget
+// ============================================================================
+
+RetryBudget::RetryBudget(double ratio, double max_tokens)
+    : deposit_(static_cast<int64_t>(ratio * kScale)),
+      max_(static_cast<int64_t>(max_tokens * kScale)),
+      tokens_(static_cast<int64_t>(max_tokens * kScale)) {}
+
+void RetryBudget::OnRequest() {
+    int64_t current = tokens_.load(std::memory_order_relaxed);
+    while (current < max_) {
+        int64_t next = std::min(current + deposit_, max_);
+        if (tokens_.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+bool RetryBudget::TryAcquire() {
+    int64_t current = tokens_.load(std::memory_order_relaxed);
+    while (current >= kScale) {
+        if (tokens_.compare_exchange_weak(current, current - kScale,
+                                          std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double RetryBudget::AvailableTokens() const {
+    return static_cast<double>(tokens_.load(std::memory_order_relaxed)) / kScale;
+}
+
+// ============================================================================
+// RetryPolicy
+// ============================================================================
+
+RetryPolicy::RetryPolicy(const RetryPolicyConfig& config)
+    : config_(config),
+      budget_(config.budget_ratio, config.budget_max_tokens) {}
+
+std::chrono::milliseconds RetryPolicy::ComputeBackoff(int retry, double unit_random) const {
+    if (retry < 1) {
+        retry = 1;
+    }
+    double ceiling = static_cast<double>(config_.initial_backoff.count()) *
+                     std::pow(config_.backoff_multiplier, retry - 1);
+    ceiling = std::min(ceiling, static_cast<double>(config_.max_backoff.count()));
+
+    // Full jitter: uniform over [0, ceiling] decorrelates clients that failed together
+    unit_random = std::clamp(unit_random, 0.0, 1.0);
+    return std::chrono::milliseconds(static_cast<int64_t>(ceiling * unit_random));
+}
+
+std::chrono::milliseconds RetryPolicy::ComputeBackoff(int retry) const {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return ComputeBackoff(retry, dist(rng));
+}
+
+RetryDecision RetryPolicy::Decide(RpcStatus status, const RetryState& state,
+                                  size_t endpoint_count, RpcClock::time_point now) {
+    RetryDecision decision;
+
+    if (!IsRetryable(status) || endpoint_count == 0) {
+        decision.verdict = RetryVerdict::NOT_RETRYABLE;
+        return decision;
+    }
+    if (state.attempts >= config_.max_attempts) {
+        decision.verdict = RetryVerdict::ATTEMPTS_EXHAUSTED;
+        return decision;
+    }
+
+    decision.delay = ComputeBackoff(state.attempts);
+    if (state.deadline != RpcClock::time_point::max() &&
+        now + decision.delay >= state.deadline) {
+        decision.verdict = RetryVerdict::DEADLINE_EXCEEDED;
+        return decision;
+    }
+
+    if (!budget_.TryAcquire()) {
+        decision.verdict = RetryVerdict::BUDGET_EXHAUSTED;
+        return decision;
+    }
+
+    decision.verdict = RetryVerdict::RETRY;
+    decision.endpoint_index = SelectRetryEndpoint(endpoint_count, state.tried_endpoints);
+    return decision;
+}
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+size_t SelectRetryEndpoint(size_t endpoint_count, const std::vector<size_t>& tried) {
+    if (endpoint_count == 0) {
+        return 0;
+    }
+    size_t start = tried.empty() ? 0 : (tried.back() + 1) % endpoint_count;
+
+    // Prefer an endpoint this call has not touched yet
+    for (size_t i = 0; i < endpoint_count; ++i) {
+        size_t candidate = (start + i) % endpoint_count;
+        if (std::find(tried.begin(), tried.end(), candidate) == tried.end()) {
+            return candidate;
+        }
+    }
+
+    // All tried: rotate away from the one that just failed
+    return start;
+}
+
+std::string RetryVerdictToString(RetryVerdict verdict) {
+    switch (verdict) {
+        case RetryVerdict::RETRY:              return "RETRY";
+        case RetryVerdict::NOT_RETRYABLE:      return "NOT_RETRYABLE";
+        case RetryVerdict::ATTEMPTS_EXHAUSTED: return "ATTEMPTS_EXHAUSTED";
+        case RetryVerdict::BUDGET_EXHAUSTED:   return "BUDGET_EXHAUSTED";
+        case RetryVerdict::DEADLINE_EXCEEDED:  return "DEADLINE_EXCEEDED";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace grlrpc
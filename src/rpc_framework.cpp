@@ -2,9 +2,535 @@
 // This file will be implemented in task 9.x
 
 #include "rpc_framework.h"
+#include "compression.h"
+#include "request_stream.h"
 
 namespace grlrpc {
 
-// Placeholder - will be implemented in task 9.x
+// ============================================================================
+// Little-endian helpers
+// ============================================================================
+
+namespace {
+
+template<typename T>
+void StoreLE(char* out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+template<typename T>
+T LoadLE(const char* in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+// Spreads sequential request ids over PendingCallTable's slots
+size_t MixRequestId(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    return static_cast<size_t>(id);
+}
+
+} // namespace
+
+std::string RpcStatusToString(RpcStatus status) {
+    switch (status) {
+        case RpcStatus::SUCCESS:             return "SUCCESS";
+        case RpcStatus::METHOD_NOT_FOUND:    return "METHOD_NOT_FOUND";
+        case RpcStatus::SERIALIZATION_ERROR: return "SERIALIZATION_ERROR";
+        case RpcStatus::NETWORK_ERROR:       return "NETWORK_ERROR";
+        case RpcStatus::TIMEOUT:             return "TIMEOUT";
+        case RpcStatus::INVALID_REQUEST:     return "INVALID_REQUEST";
+        case RpcStatus::UNKNOWN_ERROR:       return "UNKNOWN_ERROR";
+        case RpcStatus::CIRCUIT_OPEN:        return "CIRCUIT_OPEN";
+        case RpcStatus::RATE_LIMITED:        return "RATE_LIMITED";
+        default: return "UNKNOWN";
+    }
+}
+
+// ============================================================================
+// MessageCodec
+// ============================================================================
+
+void MessageCodec::EncodeHeader(const FrameHeader& header, char* out) {
+    StoreLE<uint16_t>(out, FrameHeader::kMagic);
+    out[2] = static_cast<char>(header.version);
+    out[3] = static_cast<char>(header.flags);
+    StoreLE<uint32_t>(out + 4, header.method_id);
+    StoreLE<uint64_t>(out + 8, header.request_id);
+    StoreLE<uint32_t>(out + 16, header.deadline_ms);
+    StoreLE<uint32_t>(out + 20, header.payload_length);
+}
+
+void MessageCodec::EncodeHeader(const FrameHeader& header, std::string& out) {
+    size_t offset = out.size();
+    out.resize(offset + FrameHeader::kSize);
+    EncodeHeader(header, &out[offset]);
+}
+
+bool MessageCodec::DecodeHeader(const char* data, size_t length, FrameHeader& header) {
+    if (length < FrameHeader::kSize || LoadLE<uint16_t>(data) != FrameHeader::kMagic) {
+        return false;
+    }
+    header.version = static_cast<uint8_t>(data[2]);
+    if (header.version < FrameHeader::kMinVersion || header.version > FrameHeader::kVersion) {
+        return false;
+    }
+    header.flags = static_cast<uint8_t>(data[3]);
+    header.method_id = LoadLE<uint32_t>(data + 4);
+    header.request_id = LoadLE<uint64_t>(data + 8);
+    header.deadline_ms = LoadLE<uint32_t>(data + 16);
+    header.payload_length = LoadLE<uint32_t>(data + 20);
+    return true;
+}
+
+void MessageCodec::RewriteRequestId(char* header, uint64_t request_id) {
+    StoreLE<uint64_t>(header + 8, request_id);
+}
+
+void MessageCodec::RewriteDeadline(char* header, uint32_t deadline_ms) {
+    StoreLE<uint32_t>(header + 16, deadline_ms);
+}
+
+void MessageCodec::EncodeRequest(const RpcRequestData& request, std::string& out) {
+    FrameHeader header = request.header;
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_RESPONSE);
+    header.payload_length = static_cast<uint32_t>(request.payload.size());
+    out.reserve(out.size() + FrameHeader::kSize + request.payload.size());
+    EncodeHeader(header, out);
+    out.append(request.payload);
+}
+
+bool MessageCodec::CompressPayload(const CompressionPolicy& policy, FrameHeader& header,
+                                   std::string_view payload, std::string& out) {
+    out.clear();
+    if (!policy.ShouldCompress(payload)) {
+        return false;
+    }
+
+    out.resize(sizeof(uint32_t));
+    StoreLE<uint32_t>(&out[0], static_cast<uint32_t>(payload.size()));
+    if (!policy.compressor->Compress(payload, out) || out.size() >= payload.size()) {
+        out.clear();
+        return false;
+    }
+    header.flags |= FRAME_FLAG_COMPRESSED;
+    return true;
+}
+
+bool MessageCodec::DecompressPayload(ICompressor* compressor, std::string_view wire_payload,
+                                     size_t max_size, std::string& out) {
+    out.clear();
+    if (!compressor || wire_payload.size() < sizeof(uint32_t)) {
+        return false;
+    }
+    uint32_t original_size = LoadLE<uint32_t>(wire_payload.data());
+    if (original_size > max_size) {
+        return false;
+    }
+    return compressor->Decompress(wire_payload.substr(sizeof(uint32_t)), original_size, out);
+}
+
+// ============================================================================
+// FrameChunker
+// ============================================================================
+
+FrameChunker::FrameChunker(const FrameHeader& header, std::string_view payload,
+                           const ChunkingConfig& config)
+    : header_(header),
+      payload_(payload),
+      chunk_size_(config.chunk_size > 0 ? config.chunk_size : payload.size()),
+      chunked_(payload.size() > config.chunk_threshold && payload.size() > chunk_size_) {}
+
+bool FrameChunker::Next(std::string& out) {
+    if (done_) {
+        return false;
+    }
+
+    FrameHeader header = header_;
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_CHUNK);
+    if (!chunked_) {
+        header.payload_length = static_cast<uint32_t>(payload_.size());
+        out.reserve(out.size() + FrameHeader::kSize + payload_.size());
+        MessageCodec::EncodeHeader(header, out);
+        out.append(payload_);
+        done_ = true;
+        return true;
+    }
+
+    bool first = offset_ == 0;
+    std::string_view chunk = payload_.substr(offset_, chunk_size_);
+    offset_ += chunk.size();
+    done_ = offset_ == payload_.size();
+    if (!done_) {
+        header.flags |= FRAME_FLAG_CHUNK;
+    }
+
+    size_t prefix = first ? MessageCodec::kChunkPrefixSize : 0;
+    header.payload_length = static_cast<uint32_t>(prefix + chunk.size());
+    out.reserve(out.size() + FrameHeader::kSize + header.payload_length);
+    MessageCodec::EncodeHeader(header, out);
+    if (first) {
+        size_t offset = out.size();
+        out.resize(offset + prefix);
+        StoreLE<uint32_t>(&out[offset], static_cast<uint32_t>(payload_.size()));
+    }
+    out.append(chunk);
+    return true;
+}
+
+// ============================================================================
+// ChunkReassembler
+// ============================================================================
+
+ChunkReassembler::ChunkReassembler(size_t max_message_size, size_t max_pending_messages,
+                                   size_t max_pending_bytes)
+    : max_message_size_(max_message_size),
+      max_pending_messages_(max_pending_messages),
+      max_pending_bytes_(max_pending_bytes) {}
+
+ReassemblyStatus ChunkReassembler::OnFrame(FrameHeader& header, std::string_view payload,
+                                           std::string_view& message) {
+    bool more = header.HasFlag(FRAME_FLAG_CHUNK);
+    auto it = pending_.find(header.request_id);
+
+    if (it == pending_.end()) {
+        if (!more) {
+            // Ordinary single-frame message
+            if (payload.size() > max_message_size_) {
+                return ReassemblyStatus::TOO_LARGE;
+            }
+            message = payload;
+            return ReassemblyStatus::COMPLETE;
+        }
+
+        // First chunk: the total size is known before anything is buffered
+        if (payload.size() < MessageCodec::kChunkPrefixSize) {
+            return ReassemblyStatus::INVALID;
+        }
+        uint32_t total = LoadLE<uint32_t>(payload.data());
+        payload.remove_prefix(MessageCodec::kChunkPrefixSize);
+        if (total > max_message_size_) {
+            return ReassemblyStatus::TOO_LARGE;
+        }
+        if (payload.size() >= total || pending_.size() >= max_pending_messages_) {
+            return ReassemblyStatus::INVALID;
+        }
+        if (pending_bytes_ + payload.size() > max_pending_bytes_) {
+            return ReassemblyStatus::TOO_LARGE;
+        }
+        // No reserve(total): a peer could announce large totals and never
+        // send the bytes
+        Partial& partial = pending_[header.request_id];
+        partial.total_length = total;
+        partial.data.assign(payload.data(), payload.size());
+        pending_bytes_ += payload.size();
+        return ReassemblyStatus::PENDING;
+    }
+
+    Partial& partial = it->second;
+    size_t received = partial.data.size() + payload.size();
+    if (received > partial.total_length || (!more && received != partial.total_length)) {
+        Drop(it);
+        return ReassemblyStatus::INVALID;
+    }
+    if (pending_bytes_ + payload.size() > max_pending_bytes_) {
+        Drop(it);
+        return ReassemblyStatus::TOO_LARGE;
+    }
+    partial.data.append(payload.data(), payload.size());
+    pending_bytes_ += payload.size();
+    if (more) {
+        return ReassemblyStatus::PENDING;
+    }
+
+    pending_bytes_ -= partial.data.size();
+    completed_ = std::move(partial.data);
+    pending_.erase(it);
+    header.flags &= static_cast<uint8_t>(~FRAME_FLAG_CHUNK);
+    header.payload_length = static_cast<uint32_t>(completed_.size());
+    message = completed_;
+    return ReassemblyStatus::COMPLETE;
+}
+
+void ChunkReassembler::Discard(uint64_t request_id) {
+    auto it = pending_.find(request_id);
+    if (it != pending_.end()) {
+        Drop(it);
+    }
+}
+
+void ChunkReassembler::Drop(std::unordered_map<uint64_t, Partial>::iterator it) {
+    pending_bytes_ -= it->second.data.size();
+    pending_.erase(it);
+}
+
+// ============================================================================
+// PendingCallTable
+// ============================================================================
+
+PendingCallTable::PendingCallTable() : slots_(64) {}
+
+bool PendingCallTable::Track(const FrameHeader& header, RpcCallback callback,
+                             RpcClock::time_point deadline, RpcClock::time_point now) {
+    if (header.IsOneWay()) {
+        return false;
+    }
+
+    PooledPtr<PendingCall> call = MakePooled<PendingCall>();
+    call->request_id = header.request_id;
+    call->method_id = header.method_id;
+    call->sent_at = now;
+    call->deadline = deadline;
+    call->callback = std::move(callback);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (FindLocked(header.request_id) == kNotFound) {
+            InsertLocked(std::move(call));
+            return true;
+        }
+    }
+
+    // Replacing the pending call would lose its callback; fail the new one
+    if (call->callback) {
+        RpcResponseData duplicate;
+        duplicate.request_id = header.request_id;
+        duplicate.status = RpcStatus::INVALID_REQUEST;
+        duplicate.error_message = "duplicate request id";
+        call->callback(RpcStatus::INVALID_REQUEST, duplicate);
+    }
+    return false;
+}
+
+bool PendingCallTable::Complete(const RpcResponseData& response) {
+    PooledPtr<PendingCall> call;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t slot = FindLocked(response.request_id);
+        if (slot == kNotFound) {
+            return false;
+        }
+        call = RemoveLocked(slot);
+    }
+    if (call->callback) {
+        call->callback(response.status, response);
+    }
+    return true;
+}
+
+size_t PendingCallTable::ExpireBefore(RpcClock::time_point now) {
+    std::vector<PooledPtr<PendingCall>> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!deadlines_.empty() && deadlines_.front()->deadline <= now) {
+            expired.push_back(RemoveLocked(FindLocked(deadlines_.front()->request_id)));
+        }
+    }
+
+    // Callbacks run outside the lock so they may issue new calls
+    RpcResponseData timeout;
+    timeout.status = RpcStatus::TIMEOUT;
+    for (auto& call : expired) {
+        timeout.request_id = call->request_id;
+        if (call->callback) {
+            call->callback(RpcStatus::TIMEOUT, timeout);
+        }
+    }
+    return expired.size();
+}
+
+size_t PendingCallTable::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+// Linear probing; removal shifts later entries back, so there are no tombstones
+size_t PendingCallTable::FindLocked(uint64_t request_id) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = MixRequestId(request_id) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (!slot.call) {
+            return kNotFound;
+        }
+        if (slot.request_id == request_id) {
+            return i;
+        }
+    }
+}
+
+void PendingCallTable::InsertLocked(PooledPtr<PendingCall> call) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+        GrowLocked();
+    }
+    if (call->deadline != RpcClock::time_point::max()) {
+        HeapPush(call.get());
+    }
+    size_t mask = slots_.size() - 1;
+    size_t i = MixRequestId(call->request_id) & mask;
+    while (slots_[i].call) {
+        i = (i + 1) & mask;
+    }
+    slots_[i].request_id = call->request_id;
+    slots_[i].call = std::move(call);
+    ++size_;
+}
+
+PooledPtr<PendingCall> PendingCallTable::RemoveLocked(size_t slot) {
+    PooledPtr<PendingCall> call = std::move(slots_[slot].call);
+    if (call->heap_index != kNotFound) {
+        HeapRemove(call.get());
+    }
+    --size_;
+
+    size_t mask = slots_.size() - 1;
+    size_t hole = slot;
+    for (size_t i = (slot + 1) & mask; slots_[i].call; i = (i + 1) & mask) {
+        // Move an entry back into the hole unless its home lies after the hole
+        size_t home = MixRequestId(slots_[i].request_id) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            slots_[hole].request_id = slots_[i].request_id;
+            slots_[hole].call = std::move(slots_[i].call);
+            hole = i;
+        }
+    }
+    return call;
+}
+
+void PendingCallTable::GrowLocked() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (Slot& entry : old) {
+        if (entry.call) {
+            size_t i = MixRequestId(entry.request_id) & mask;
+            while (slots_[i].call) {
+                i = (i + 1) & mask;
+            }
+            slots_[i].request_id = entry.request_id;
+            slots_[i].call = std::move(entry.call);
+        }
+    }
+}
+
+void PendingCallTable::HeapPush(PendingCall* call) {
+    deadlines_.push_back(call);
+    call->heap_index = deadlines_.size() - 1;
+    HeapSiftUp(call->heap_index);
+}
+
+void PendingCallTable::HeapRemove(PendingCall* call) {
+    size_t index = call->heap_index;
+    PendingCall* last = deadlines_.back();
+    deadlines_.pop_back();
+    call->heap_index = kNotFound;
+    if (last != call) {
+        HeapPlace(last, index);
+        HeapSiftUp(index);
+        HeapSiftDown(last->heap_index);
+    }
+}
+
+void PendingCallTable::HeapSiftUp(size_t index) {
+    PendingCall* call = deadlines_[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (deadlines_[parent]->deadline <= call->deadline) {
+            break;
+        }
+        HeapPlace(deadlines_[parent], index);
+        index = parent;
+    }
+    HeapPlace(call, index);
+}
+
+void PendingCallTable::HeapSiftDown(size_t index) {
+    PendingCall* call = deadlines_[index];
+    for (;;) {
+        size_t child = index * 2 + 1;
+        if (child >= deadlines_.size()) {
+            break;
+        }
+        if (child + 1 < deadlines_.size() && deadlines_[child + 1]->deadline < deadlines_[child]->deadline) {
+            ++child;
+        }
+        if (call->deadline <= deadlines_[child]->deadline) {
+            break;
+        }
+        HeapPlace(deadlines_[child], index);
+        index = child;
+    }
+    HeapPlace(call, index);
+}
+
+void PendingCallTable::HeapPlace(PendingCall* call, size_t index) {
+    deadlines_[index] = call;
+    call->heap_index = index;
+}
+
+// ============================================================================
+// MethodTable
+// ============================================================================
+
+bool MethodTable::Register(const std::string& name, RpcHandler handler,
+                           const MethodOptions& options) {
+    uint32_t id = MethodIdOf(name);
+    if (methods_.find(id) != methods_.end()) {
+        return false;
+    }
+    MethodEntry entry;
+    entry.name = name;
+    entry.id = id;
+    entry.handler = std::move(handler);
+    entry.options = options;
+    methods_.emplace(id, std::move(entry));
+    return true;
+}
+
+bool MethodTable::RegisterStreaming(const std::string& name, StreamingHandler handler,
+                                    const MethodOptions& options) {
+    RpcHandler buffered = [handler](const RpcRequestData& request, RpcResponseData& response) {
+        return RunStreamingHandler(handler, request, response);
+    };
+    if (!Register(name, std::move(buffered), options)) {
+        return false;
+    }
+    methods_[MethodIdOf(name)].streaming_handler = std::move(handler);
+    return true;
+}
+
+const MethodEntry* MethodTable::Find(uint32_t method_id) const {
+    auto it = methods_.find(method_id);
+    return it != methods_.end() ? &it->second : nullptr;
+}
+
+const MethodEntry* MethodTable::Find(std::string_view name) const {
+    const MethodEntry* entry = Find(MethodIdOf(name));
+    return entry && entry->name == name ? entry : nullptr;
+}
+
+// ============================================================================
+// LocalChannel
+// ============================================================================
+
+RpcStatus LocalChannel::Call(const RpcRequestData& request, RpcResponseData& response) {
+    const MethodEntry* entry = methods_.Find(request.header.method_id);
+    if (!entry) {
+        return RpcStatus::METHOD_NOT_FOUND;
+    }
+    response.request_id = request.header.request_id;
+    response.status = entry->handler(request, response);
+    if (!entry->ExpectsResponse(request.header)) {
+        // Raw handlers encode regardless; nothing goes back for a one-way call
+        response.payload.clear();
+    }
+    return response.status;
+}
 
 } // namespace grlrpc
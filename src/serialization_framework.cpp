@@ -3,6 +3,11 @@
 
 #include "serialization_framework.h"
 
+#include <json/json.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
 namespace grlrpc {
 
 // Most of the implementation is in the header file as templates and inline functions.
@@ -40,4 +45,412 @@ FieldType StringToFieldType(const std::string& str) {
     return FieldType::STRING; // Default
 }
 
+// ============================================================================
+// Base64 (used for BYTES fields in text formats)
+// ============================================================================
+
+namespace {
+
+const char kBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Byte -> 6-bit value, -1 outside the alphabet; built at compile time
+struct Base64Table {
+    constexpr Base64Table() : values() {
+        for (int& value : values) {
+            value = -1;
+        }
+        for (int i = 0; i < 64; ++i) {
+            values[static_cast<unsigned char>(kBase64Alphabet[i])] = i;
+        }
+    }
+
+    int values[256];
+};
+
+constexpr Base64Table kBase64Table;
+
+int Base64Value(char c) {
+    return kBase64Table.values[static_cast<unsigned char>(c)];
+}
+
+} // namespace
+
+std::string Base64Encode(const std::string& input) {
+    std::string output;
+    AppendBase64(input, output);
+    return output;
+}
+
+// Output is sized once and written through a pointer
+void AppendBase64(const std::string& input, std::string& output) {
+    size_t offset = output.size();
+    output.resize(offset + (input.size() + 2) / 3 * 4);
+    char* out = &output[0] + offset;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(input.data());
+    size_t i = 0;
+    for (; i + 2 < input.size(); i += 3) {
+        uint32_t n = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+        *out++ = kBase64Alphabet[(n >> 18) & 63];
+        *out++ = kBase64Alphabet[(n >> 12) & 63];
+        *out++ = kBase64Alphabet[(n >> 6) & 63];
+        *out++ = kBase64Alphabet[n & 63];
+    }
+    if (i < input.size()) {
+        uint32_t n = in[i] << 16;
+        if (i + 1 < input.size()) {
+            n |= in[i + 1] << 8;
+        }
+        *out++ = kBase64Alphabet[(n >> 18) & 63];
+        *out++ = kBase64Alphabet[(n >> 12) & 63];
+        *out++ = i + 1 < input.size() ? kBase64Alphabet[(n >> 6) & 63] : '=';
+        *out++ = '=';
+    }
+}
+
+bool Base64Decode(const std::string& input, std::string& output) {
+    output.clear();
+    if (input.size() % 4 != 0) {
+        return false;
+    }
+    if (input.empty()) {
+        return true;
+    }
+    output.resize(input.size() / 4 * 3);
+    char* out = &output[0];
+    const char* in = input.data();
+    // Every group but the last is free of padding
+    const char* last = in + input.size() - 4;
+    for (; in != last; in += 4) {
+        int a = Base64Value(in[0]);
+        int b = Base64Value(in[1]);
+        int c = Base64Value(in[2]);
+        int d = Base64Value(in[3]);
+        if ((a | b | c | d) < 0) {
+            output.clear();
+            return false;
+        }
+        uint32_t n = (a << 18) | (b << 12) | (c << 6) | d;
+        *out++ = static_cast<char>((n >> 16) & 0xFF);
+        *out++ = static_cast<char>((n >> 8) & 0xFF);
+        *out++ = static_cast<char>(n & 0xFF);
+    }
+
+    int v[4];
+    int padding = 0;
+    for (int j = 0; j < 4; ++j) {
+        char c = last[j];
+        if (c == '=' && j >= 2) {
+            v[j] = 0;
+            ++padding;
+        } else if (padding > 0 || (v[j] = Base64Value(c)) < 0) {
+            output.clear();
+            return false;
+        }
+    }
+    uint32_t n = (v[0] << 18) | (v[1] << 12) | (v[2] << 6) | v[3];
+    *out++ = static_cast<char>((n >> 16) & 0xFF);
+    if (padding < 2) *out++ = static_cast<char>((n >> 8) & 0xFF);
+    if (padding < 1) *out++ = static_cast<char>(n & 0xFF);
+    output.resize(static_cast<size_t>(out - output.data()));
+    return true;
+}
+
+// ============================================================================
+// JsonSerializer
+// ============================================================================
+
+bool JsonSerializer::Serialize(const void* obj, const MessageDescriptor& desc,
+                               std::string& output) {
+    Json::Value root(Json::objectValue);
+    try {
+        for (const auto& field : desc.fields) {
+            std::any value = field.getter(obj);
+            switch (field.type) {
+                case FieldType::INT32:
+                    root[field.name] = Json::Int(std::any_cast<int32_t>(value));
+                    break;
+                case FieldType::INT64:
+                    root[field.name] = Json::Int64(std::any_cast<int64_t>(value));
+                    break;
+                case FieldType::UINT32:
+                    root[field.name] = Json::UInt(std::any_cast<uint32_t>(value));
+                    break;
+                case FieldType::UINT64:
+                    root[field.name] = Json::UInt64(std::any_cast<uint64_t>(value));
+                    break;
+                case FieldType::FLOAT:
+                    root[field.name] = std::any_cast<float>(value);
+                    break;
+                case FieldType::DOUBLE:
+                    root[field.name] = std::any_cast<double>(value);
+                    break;
+                case FieldType::STRING:
+                    root[field.name] = std::any_cast<std::string>(value);
+                    break;
+                case FieldType::BOOL:
+                    root[field.name] = std::any_cast<bool>(value);
+                    break;
+                case FieldType::BYTES:
+                    root[field.name] = Base64Encode(std::any_cast<std::string>(value));
+                    break;
+                case FieldType::MESSAGE:
+                default:
+                    return false;
+            }
+        }
+    } catch (const std::bad_any_cast&) {
+        return false;
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    output = Json::writeString(builder, root);
+    return true;
+}
+
+bool JsonSerializer::Deserialize(const std::string& input, void* obj,
+                                 const MessageDescriptor& desc) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    std::string errors;
+    if (!reader->parse(input.data(), input.data() + input.size(), &root, &errors) ||
+        !root.isObject()) {
+        return false;
+    }
+
+    try {
+        for (const auto& field : desc.fields) {
+            if (!root.isMember(field.name)) {
+                continue;  // Missing fields keep their default value
+            }
+            const Json::Value& value = root[field.name];
+            switch (field.type) {
+                case FieldType::INT32:
+                    if (!value.isInt()) return false;
+                    field.setter(obj, static_cast<int32_t>(value.asInt()));
+                    break;
+                case FieldType::INT64:
+                    if (!value.isInt64()) return false;
+                    field.setter(obj, static_cast<int64_t>(value.asInt64()));
+                    break;
+                case FieldType::UINT32:
+                    if (!value.isUInt()) return false;
+                    field.setter(obj, static_cast<uint32_t>(value.asUInt()));
+                    break;
+                case FieldType::UINT64:
+                    if (!value.isUInt64()) return false;
+                    field.setter(obj, static_cast<uint64_t>(value.asUInt64()));
+                    break;
+                case FieldType::FLOAT:
+                    if (!value.isNumeric()) return false;
+                    field.setter(obj, value.asFloat());
+                    break;
+                case FieldType::DOUBLE:
+                    if (!value.isNumeric()) return false;
+                    field.setter(obj, value.asDouble());
+                    break;
+                case FieldType::STRING:
+                    if (!value.isString()) return false;
+                    field.setter(obj, value.asString());
+                    break;
+                case FieldType::BOOL:
+                    if (!value.isBool()) return false;
+                    field.setter(obj, value.asBool());
+                    break;
+                case FieldType::BYTES: {
+                    std::string bytes;
+                    if (!value.isString() || !Base64Decode(value.asString(), bytes)) return false;
+                    field.setter(obj, bytes);
+                    break;
+                }
+                case FieldType::MESSAGE:
+                default:
+                    return false;
+            }
+        }
+    } catch (const std::bad_any_cast&) {
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// BinarySerializer
+// ============================================================================
+
+namespace {
+
+template<typename T>
+void AppendLE(std::string& output, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    output.append(bytes, sizeof(T));
+}
+
+template<typename T>
+bool ReadLE(const std::string& input, size_t& offset, T& value) {
+    if (input.size() - offset < sizeof(T)) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<uint8_t>(input[offset + i])) << (8 * i);
+    }
+    offset += sizeof(T);
+    return true;
+}
+
+bool ReadLengthPrefixed(const std::string& input, size_t& offset, std::string& value) {
+    uint32_t length = 0;
+    if (!ReadLE(input, offset, length) || input.size() - offset < length) {
+        return false;
+    }
+    value.assign(input, offset, length);
+    offset += length;
+    return true;
+}
+
+} // namespace
+
+bool BinarySerializer::Serialize(const void* obj, const MessageDescriptor& desc,
+                                 std::string& output) {
+    output.clear();
+    try {
+        for (const auto& field : desc.fields) {
+            std::any value = field.getter(obj);
+            switch (field.type) {
+                case FieldType::INT32:
+                    AppendLE(output, static_cast<uint32_t>(std::any_cast<int32_t>(value)));
+                    break;
+                case FieldType::INT64:
+                    AppendLE(output, static_cast<uint64_t>(std::any_cast<int64_t>(value)));
+                    break;
+                case FieldType::UINT32:
+                    AppendLE(output, std::any_cast<uint32_t>(value));
+                    break;
+                case FieldType::UINT64:
+                    AppendLE(output, std::any_cast<uint64_t>(value));
+                    break;
+                case FieldType::FLOAT: {
+                    float number = std::any_cast<float>(value);
+                    uint32_t bits;
+                    std::memcpy(&bits, &number, sizeof(bits));
+                    AppendLE(output, bits);
+                    break;
+                }
+                case FieldType::DOUBLE: {
+                    double number = std::any_cast<double>(value);
+                    uint64_t bits;
+                    std::memcpy(&bits, &number, sizeof(bits));
+                    AppendLE(output, bits);
+                    break;
+                }
+                case FieldType::STRING:
+                case FieldType::BYTES: {
+                    const std::string& bytes = std::any_cast<const std::string&>(value);
+                    if (bytes.size() > UINT32_MAX) {
+                        return false;
+                    }
+                    AppendLE(output, static_cast<uint32_t>(bytes.size()));
+                    output.append(bytes);
+                    break;
+                }
+                case FieldType::BOOL:
+                    output.push_back(std::any_cast<bool>(value) ? 1 : 0);
+                    break;
+                case FieldType::MESSAGE:
+                default:
+                    return false;
+            }
+        }
+    } catch (const std::bad_any_cast&) {
+        return false;
+    }
+    return true;
+}
+
+bool BinarySerializer::Deserialize(const std::string& input, void* obj,
+                                   const MessageDescriptor& desc) {
+    size_t offset = 0;
+    try {
+        for (const auto& field : desc.fields) {
+            switch (field.type) {
+                case FieldType::INT32: {
+                    uint32_t bits;
+                    if (!ReadLE(input, offset, bits)) return false;
+                    field.setter(obj, static_cast<int32_t>(bits));
+                    break;
+                }
+                case FieldType::INT64: {
+                    uint64_t bits;
+                    if (!ReadLE(input, offset, bits)) return false;
+                    field.setter(obj, static_cast<int64_t>(bits));
+                    break;
+                }
+                case FieldType::UINT32: {
+                    uint32_t number;
+                    if (!ReadLE(input, offset, number)) return false;
+                    field.setter(obj, number);
+                    break;
+                }
+                case FieldType::UINT64: {
+                    uint64_t number;
+                    if (!ReadLE(input, offset, number)) return false;
+                    field.setter(obj, number);
+                    break;
+                }
+                case FieldType::FLOAT: {
+                    uint32_t bits;
+                    if (!ReadLE(input, offset, bits)) return false;
+                    float number;
+                    std::memcpy(&number, &bits, sizeof(number));
+                    field.setter(obj, number);
+                    break;
+                }
+                case FieldType::DOUBLE: {
+                    uint64_t bits;
+                    if (!ReadLE(input, offset, bits)) return false;
+                    double number;
+                    std::memcpy(&number, &bits, sizeof(number));
+                    field.setter(obj, number);
+                    break;
+                }
+                case FieldType::STRING:
+                case FieldType::BYTES: {
+                    std::string bytes;
+                    if (!ReadLengthPrefixed(input, offset, bytes)) return false;
+                    field.setter(obj, std::move(bytes));
+                    break;
+                }
+                case FieldType::BOOL: {
+                    uint8_t byte;
+                    if (!ReadLE(input, offset, byte)) return false;
+                    field.setter(obj, byte != 0);
+                    break;
+                }
+                case FieldType::MESSAGE:
+                default:
+                    return false;
+            }
+        }
+    } catch (const std::bad_any_cast&) {
+        return false;
+    }
+    return offset == input.size();
+}
+
+void RegisterBuiltinSerializers() {
+    auto& registry = SerializerRegistry::Instance();
+    if (!registry.GetSerializer("json")) {
+        registry.RegisterSerializer("json", std::make_unique<JsonSerializer>());
+    }
+    if (!registry.GetSerializer("binary")) {
+        registry.RegisterSerializer("binary", std::make_unique<BinarySerializer>());
+    }
+}
+
 } // namespace grlrpc
@@ -0,0 +1,121 @@
+// GrlRPC Shard Router Implementation
+
+#include "shard_router.h"
+
+namespace grlrpc {
+
+namespace {
+
+thread_local size_t current_shard = ShardRouter::kAnyShard;
+
+uint64_t MixKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+} // namespace
+
+// ============================================================================
+// Routing Key Extraction
+// ============================================================================
+
+RoutingKeyExtractor FixedOffsetKeyExtractor(size_t offset) {
+    return [offset](std::string_view payload, uint64_t& key) {
+        if (payload.size() < offset + sizeof(uint64_t)) {
+            return false;
+        }
+        key = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+            key |= static_cast<uint64_t>(static_cast<uint8_t>(payload[offset + i])) << (8 * i);
+        }
+        return true;
+    };
+}
+
+// ============================================================================
+// ShardRouter
+// ============================================================================
+
+ShardRouter::ShardRouter(size_t shard_count)
+    : shard_count_(shard_count ? shard_count : 1) {}
+
+void ShardRouter::SetKeyExtractor(uint32_t method_id, RoutingKeyExtractor extractor) {
+    extractors_[method_id] = std::move(extractor);
+}
+
+size_t ShardRouter::Route(const FrameHeader& header, std::string_view payload) const {
+    auto it = extractors_.find(header.method_id);
+    if (it == extractors_.end()) {
+        return kAnyShard;
+    }
+    uint64_t key = 0;
+    if (!it->second(payload, key)) {
+        return kAnyShard;
+    }
+    return ShardOf(key);
+}
+
+size_t ShardRouter::ShardOf(uint64_t key) const {
+    // Multiply-shift maps the mixed hash onto [0, shard_count) without a division
+    return static_cast<size_t>((static_cast<__uint128_t>(MixKey(key)) * shard_count_) >> 64);
+}
+
+// ============================================================================
+// ShardExecutor
+// ============================================================================
+
+ShardExecutor::ShardExecutor(size_t shard_count, size_t inbox_capacity) {
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(inbox_capacity));
+    }
+}
+
+void ShardExecutor::BindCurrentThread(size_t shard) {
+    current_shard = shard;
+}
+
+size_t ShardExecutor::CurrentShard() {
+    return current_shard;
+}
+
+void ShardExecutor::SetWakeup(size_t shard, std::function<void()> wakeup) {
+    shards_[shard]->wakeup = std::move(wakeup);
+}
+
+bool ShardExecutor::Dispatch(size_t target_shard, ShardTask& task) {
+    if (target_shard == ShardRouter::kAnyShard || target_shard == current_shard) {
+        task();
+        return true;
+    }
+    if (target_shard >= shards_.size()) {
+        return false;
+    }
+
+    Shard& shard = *shards_[target_shard];
+    if (!shard.inbox.TryPush(task)) {
+        return false;
+    }
+    shard.forwarded.fetch_add(1, std::memory_order_relaxed);
+    if (shard.wakeup) {
+        shard.wakeup();
+    }
+    return true;
+}
+
+size_t ShardExecutor::Drain(size_t shard, size_t max_tasks) {
+    MpscQueue<ShardTask>& inbox = shards_[shard]->inbox;
+    ShardTask task;
+    size_t executed = 0;
+    while (executed < max_tasks && inbox.TryPop(task)) {
+        task();
+        ++executed;
+    }
+    return executed;
+}
+
+} // namespace grlrpc
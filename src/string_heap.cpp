@@ -0,0 +1,121 @@
+// GrlRPC String Heap Implementation
+
+#include "string_heap.h"
+
+#include <cstring>
+#include <functional>
+
+namespace grlrpc {
+
+namespace {
+
+constexpr size_t kMinTableCapacity = 64;
+
+} // namespace
+
+StringHeap::Table::Table(size_t capacity) : mask(capacity - 1), refs(new std::atomic<uint32_t>[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        refs[i].store(kNone, std::memory_order_relaxed);
+    }
+}
+
+StringHeap::StringHeap() : chunks_(new std::atomic<char*>[kMaxChunks]) {
+    for (size_t i = 0; i < kMaxChunks; ++i) {
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    tables_.push_back(std::make_unique<Table>(kMinTableCapacity));
+    table_.store(tables_.back().get(), std::memory_order_relaxed);
+}
+
+StringHeap::~StringHeap() {
+    for (size_t i = 0; i < chunk_count_; ++i) {
+        delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint32_t StringHeap::Intern(std::string_view value) {
+    if (value.empty() || value.size() > kMaxLength) {
+        return kNone;
+    }
+    size_t hash = std::hash<std::string_view>()(value);
+    uint32_t ref = Find(*table_.load(std::memory_order_acquire), value, hash);
+    if (ref != kNone) {
+        return ref;
+    }
+
+    // Another writer may have appended it since, or grown the table past ours
+    std::lock_guard<std::mutex> lock(mutex_);
+    ref = Find(*table_.load(std::memory_order_relaxed), value, hash);
+    if (ref != kNone) {
+        return ref;
+    }
+
+    // Entries never straddle chunks
+    size_t entry_size = value.size() + 1;
+    size_t offset = used_;
+    if (offset / kChunkSize >= chunk_count_ || offset % kChunkSize + entry_size > kChunkSize) {
+        if (chunk_count_ == kMaxChunks) {
+            return kNone;
+        }
+        offset = chunk_count_ * kChunkSize;
+        chunks_[chunk_count_++].store(new char[kChunkSize], std::memory_order_release);
+    }
+    char* entry = chunks_[offset / kChunkSize].load(std::memory_order_relaxed) + offset % kChunkSize;
+    entry[0] = static_cast<char>(value.size());
+    std::memcpy(entry + 1, value.data(), value.size());
+    used_ = offset + entry_size;
+
+    ref = static_cast<uint32_t>(offset + 1);
+    InsertLocked(ref, hash);
+    return ref;
+}
+
+uint32_t StringHeap::Find(const Table& table, std::string_view value, size_t hash) const {
+    for (size_t i = hash;; ++i) {
+        // Acquire pairs with the release in InsertLocked(), which follows the
+        // entry's bytes
+        uint32_t ref = table.refs[i & table.mask].load(std::memory_order_acquire);
+        if (ref == kNone || View(ref) == value) {
+            return ref;
+        }
+    }
+}
+
+void StringHeap::InsertLocked(uint32_t ref, size_t hash) {
+    Table* table = table_.load(std::memory_order_relaxed);
+    if ((count_ + 1) * 2 > table->mask + 1) {
+        auto grown = std::make_unique<Table>((table->mask + 1) * 2);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            uint32_t existing = table->refs[i].load(std::memory_order_relaxed);
+            if (existing != kNone) {
+                size_t j = std::hash<std::string_view>()(View(existing));
+                while (grown->refs[j & grown->mask].load(std::memory_order_relaxed) != kNone) {
+                    ++j;
+                }
+                grown->refs[j & grown->mask].store(existing, std::memory_order_relaxed);
+            }
+        }
+        tables_.push_back(std::move(grown));
+        table = tables_.back().get();
+    }
+    size_t i = hash;
+    while (table->refs[i & table->mask].load(std::memory_order_relaxed) != kNone) {
+        ++i;
+    }
+    table->refs[i & table->mask].store(ref, std::memory_order_release);
+    // A grown table goes out complete, new entry included
+    table_.store(table, std::memory_order_release);
+    ++count_;
+}
+
+size_t StringHeap::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+size_t StringHeap::Capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunk_count_ * kChunkSize;
+}
+
+} // namespace grlrpc
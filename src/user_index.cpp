@@ -0,0 +1,311 @@
+// GrlRPC User Index Implementation
+
+#include "user_index.h"
+
+#include <cstring>
+#include <functional>
+#include <new>
+
+namespace grlrpc {
+
+namespace {
+
+constexpr size_t kMinEmailTableCapacity = 64;
+
+size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = kMinEmailTableCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+// ============================================================================
+// EmailIndex
+// ============================================================================
+
+// Entries are published hash last, so a reader that sees a hash also sees
+// its user id. Removal zeroes the id and leaves the hash as a tombstone to
+// keep probe chains intact; tombstones go away when the table is rebuilt.
+struct EmailIndex::Table {
+    struct Entry {
+        std::atomic<uint64_t> hash{0};      // 0 = never used
+        std::atomic<uint64_t> user_id{0};   // 0 = removed
+    };
+
+    explicit Table(size_t capacity) : mask(capacity - 1), entries(new Entry[capacity]) {}
+
+    size_t mask;
+    std::unique_ptr<Entry[]> entries;
+};
+
+struct EmailIndex::Stripe {
+    explicit Stripe(EpochManager& epoch_manager)
+        : epochs(epoch_manager), table(new Table(kMinEmailTableCapacity)) {}
+
+    ~Stripe() {
+        delete table.load(std::memory_order_relaxed);
+    }
+
+    void InsertLocked(uint64_t hash, uint64_t user_id) {
+        Table* current = table.load(std::memory_order_relaxed);
+        if ((used + 1) * 10 > (current->mask + 1) * 7) {
+            current = Rebuild(current);
+        }
+        for (size_t i = hash;; ++i) {
+            Table::Entry& entry = current->entries[i & current->mask];
+            if (entry.hash.load(std::memory_order_relaxed) == 0) {
+                entry.user_id.store(user_id, std::memory_order_relaxed);
+                entry.hash.store(hash, std::memory_order_release);
+                break;
+            }
+        }
+        ++used;
+        ++live;
+    }
+
+    // Sized from the live entries so a table full of tombstones shrinks back
+    Table* Rebuild(Table* current) {
+        Table* next = new Table(RoundUpPowerOfTwo((live + 1) * 4));
+        for (size_t i = 0; i <= current->mask; ++i) {
+            const Table::Entry& entry = current->entries[i];
+            uint64_t hash = entry.hash.load(std::memory_order_relaxed);
+            uint64_t user_id = entry.user_id.load(std::memory_order_relaxed);
+            if (hash == 0 || user_id == 0) {
+                continue;
+            }
+            for (size_t j = hash;; ++j) {
+                Table::Entry& target = next->entries[j & next->mask];
+                if (target.hash.load(std::memory_order_relaxed) == 0) {
+                    target.user_id.store(user_id, std::memory_order_relaxed);
+                    target.hash.store(hash, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        used = live;
+        table.store(next, std::memory_order_release);
+        // Readers may still be probing the old table
+        epochs.Retire([current] { delete current; });
+        return next;
+    }
+
+    EpochManager& epochs;
+    std::mutex write_mutex;
+    std::atomic<Table*> table;
+    size_t used = 0;   // entries including tombstones
+    size_t live = 0;
+};
+
+EmailIndex::EmailIndex(EpochManager& epochs, size_t stripe_count) : epochs_(epochs) {
+    stripes_.reserve(stripe_count);
+    for (size_t i = 0; i < stripe_count; ++i) {
+        stripes_.push_back(std::make_unique<Stripe>(epochs_));
+    }
+}
+
+EmailIndex::~EmailIndex() = default;
+
+uint64_t EmailIndex::Hash(std::string_view email) {
+    uint64_t hash = std::hash<std::string_view>()(email);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash != 0 ? hash : 1;
+}
+
+// Slots use the low bits of the hash, stripes the high ones
+EmailIndex::Stripe& EmailIndex::StripeOf(uint64_t hash) const {
+    return *stripes_[(hash >> 40) % stripes_.size()];
+}
+
+void EmailIndex::Insert(std::string_view email, uint64_t user_id) {
+    uint64_t hash = Hash(email);
+    Stripe& stripe = StripeOf(hash);
+    std::lock_guard<std::mutex> lock(stripe.write_mutex);
+    stripe.InsertLocked(hash, user_id);
+}
+
+void EmailIndex::Remove(std::string_view email, uint64_t user_id) {
+    uint64_t hash = Hash(email);
+    Stripe& stripe = StripeOf(hash);
+    std::lock_guard<std::mutex> lock(stripe.write_mutex);
+    Table* current = stripe.table.load(std::memory_order_relaxed);
+    for (size_t i = hash, probes = 0; probes <= current->mask; ++i, ++probes) {
+        Table::Entry& entry = current->entries[i & current->mask];
+        uint64_t entry_hash = entry.hash.load(std::memory_order_relaxed);
+        if (entry_hash == 0) {
+            return;
+        }
+        if (entry_hash == hash && entry.user_id.load(std::memory_order_relaxed) == user_id) {
+            entry.user_id.store(0, std::memory_order_release);
+            --stripe.live;
+            return;
+        }
+    }
+}
+
+void EmailIndex::Find(std::string_view email, const IndexVisitor& visit) const {
+    uint64_t hash = Hash(email);
+    const Stripe& stripe = StripeOf(hash);
+    const Table* current = stripe.table.load(std::memory_order_acquire);
+    for (size_t i = hash, probes = 0; probes <= current->mask; ++i, ++probes) {
+        const Table::Entry& entry = current->entries[i & current->mask];
+        uint64_t entry_hash = entry.hash.load(std::memory_order_acquire);
+        if (entry_hash == 0) {
+            return;
+        }
+        if (entry_hash != hash) {
+            continue;
+        }
+        uint64_t user_id = entry.user_id.load(std::memory_order_acquire);
+        if (user_id != 0 && !visit(user_id)) {
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// NameIndex
+// ============================================================================
+
+// Immutable once linked except for the next pointers, which readers follow
+// with acquire loads (the layout of LevelDB's skip list). A node is one
+// allocation: the fields, `height` next pointers, then the name bytes
+struct NameIndex::Node {
+    uint64_t user_id;
+    uint32_t name_length;
+    int height;
+
+    std::atomic<Node*>& Next(int level) {
+        return reinterpret_cast<std::atomic<Node*>*>(this + 1)[level];
+    }
+
+    std::string_view Name() const {
+        const char* text = reinterpret_cast<const char*>(
+            reinterpret_cast<const std::atomic<Node*>*>(this + 1) + height);
+        return std::string_view(text, name_length);
+    }
+};
+
+NameIndex::NameIndex(EpochManager& epochs) : epochs_(epochs), head_(NewNode("", 0, kMaxHeight)) {}
+
+NameIndex::~NameIndex() {
+    Node* node = head_;
+    while (node) {
+        Node* next = node->Next(0).load(std::memory_order_relaxed);
+        DeleteNode(node);
+        node = next;
+    }
+}
+
+NameIndex::Node* NameIndex::NewNode(std::string_view name, uint64_t user_id, int height) {
+    size_t links = sizeof(std::atomic<Node*>) * height;
+    char* memory = static_cast<char*>(::operator new(sizeof(Node) + links + name.size()));
+    Node* node = new (memory) Node{user_id, static_cast<uint32_t>(name.size()), height};
+    for (int i = 0; i < height; ++i) {
+        new (&node->Next(i)) std::atomic<Node*>(nullptr);
+    }
+    std::memcpy(memory + sizeof(Node) + links, name.data(), name.size());
+    return node;
+}
+
+void NameIndex::DeleteNode(Node* node) {
+    // Every part is trivially destructible
+    ::operator delete(node);
+}
+
+bool NameIndex::Less(const Node* node, std::string_view name, uint64_t user_id) {
+    int order = node->Name().compare(name);
+    return order < 0 || (order == 0 && node->user_id < user_id);
+}
+
+// Geometric with p = 1/4; called under the write mutex
+int NameIndex::RandomHeight() {
+    int height = 1;
+    for (;;) {
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        if (height >= kMaxHeight || (rng_state_ & 3) != 0) {
+            return height;
+        }
+        ++height;
+    }
+}
+
+NameIndex::Node* NameIndex::FindGreaterOrEqual(std::string_view name, uint64_t user_id,
+                                               Node** preds) const {
+    Node* node = head_;
+    int level = height_.load(std::memory_order_relaxed) - 1;
+    for (;;) {
+        Node* next = node->Next(level).load(std::memory_order_acquire);
+        if (next && Less(next, name, user_id)) {
+            node = next;
+            continue;
+        }
+        if (preds) {
+            preds[level] = node;
+        }
+        if (level == 0) {
+            return next;
+        }
+        --level;
+    }
+}
+
+void NameIndex::Insert(std::string_view name, uint64_t user_id) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Node* preds[kMaxHeight];
+    FindGreaterOrEqual(name, user_id, preds);
+
+    int height = RandomHeight();
+    int current_height = height_.load(std::memory_order_relaxed);
+    if (height > current_height) {
+        for (int i = current_height; i < height; ++i) {
+            preds[i] = head_;
+        }
+        // A reader seeing the new height early finds null links from the
+        // head on the new levels and simply drops down
+        height_.store(height, std::memory_order_relaxed);
+    }
+
+    Node* node = NewNode(name, user_id, height);
+    for (int i = 0; i < height; ++i) {
+        node->Next(i).store(preds[i]->Next(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+        preds[i]->Next(i).store(node, std::memory_order_release);
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NameIndex::Remove(std::string_view name, uint64_t user_id) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Node* preds[kMaxHeight];
+    Node* node = FindGreaterOrEqual(name, user_id, preds);
+    if (!node || node->user_id != user_id || node->Name() != name) {
+        return;
+    }
+    // The node keeps its own links, so a reader standing on it carries on
+    for (int i = 0; i < node->height; ++i) {
+        if (preds[i]->Next(i).load(std::memory_order_relaxed) == node) {
+            preds[i]->Next(i).store(node->Next(i).load(std::memory_order_relaxed),
+                                    std::memory_order_release);
+        }
+    }
+    epochs_.Retire([node] { DeleteNode(node); });
+    size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void NameIndex::FindPrefix(std::string_view prefix, const NameIndexVisitor& visit) const {
+    Node* node = FindGreaterOrEqual(prefix, 0, nullptr);
+    while (node && node->Name().substr(0, prefix.size()) == prefix) {
+        if (!visit(node->Name(), node->user_id)) {
+            return;
+        }
+        node = node->Next(0).load(std::memory_order_acquire);
+    }
+}
+
+} // namespace grlrpc
@@ -0,0 +1,578 @@
+// GrlRPC User Persistence Implementation
+
+#include "user_persistence.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace grlrpc {
+
+namespace {
+
+// Log record types
+constexpr uint8_t kRecordPutUser = 1;     // full state including the avatar
+constexpr uint8_t kRecordPutFields = 2;   // full state, avatar unchanged
+
+// Snapshot layout: [magic:8][first_segment:u64][user_count:u64] then one
+// kRecordPutUser log record per user
+constexpr char kSnapshotMagic[8] = {'G', 'R', 'L', 'U', 'S', 'N', 'P', '1'};
+constexpr size_t kSnapshotHeaderSize = 24;
+constexpr off_t kSnapshotCountOffset = 16;
+constexpr size_t kSnapshotWriteChunk = 1 << 20;
+// Import work units; several per worker so a slow chunk does not leave the
+// others idle at the end
+constexpr size_t kImportChunksPerThread = 4;
+constexpr size_t kMinImportChunk = 1 << 20;
+// Length and CRC in front of each log record
+constexpr size_t kRecordFrameSize = 8;
+
+template<typename T>
+void AppendLE(std::string& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+template<typename T>
+bool ReadLE(std::string_view& in, T& value) {
+    if (in.size() < sizeof(T)) {
+        return false;
+    }
+    uint64_t result = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        result |= static_cast<uint64_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    value = static_cast<T>(result);
+    in.remove_prefix(sizeof(T));
+    return true;
+}
+
+template<typename Length>
+bool ReadBytes(std::string_view& in, std::string& out) {
+    Length length = 0;
+    if (!ReadLE(in, length) || in.size() < length) {
+        return false;
+    }
+    out.assign(in.data(), length);
+    in.remove_prefix(length);
+    return true;
+}
+
+// [user_id:u64][created:i64][updated:i64][age:i32][name:u16+bytes]
+// [email:u16+bytes] and for kRecordPutUser [avatar:u32+bytes]
+void EncodeUser(const UserRecord& record, bool with_avatar, std::string& out) {
+    AppendLE<uint64_t>(out, record.user_id);
+    AppendLE<int64_t>(out, record.created_at_ms);
+    AppendLE<int64_t>(out, record.updated_at_ms);
+    AppendLE<int32_t>(out, record.age);
+    AppendLE<uint16_t>(out, static_cast<uint16_t>(record.name.size()));
+    out.append(record.name);
+    AppendLE<uint16_t>(out, static_cast<uint16_t>(record.email.size()));
+    out.append(record.email);
+    if (with_avatar) {
+        AppendLE<uint32_t>(out, static_cast<uint32_t>(record.avatar.size()));
+        out.append(record.avatar);
+    }
+}
+
+// Id 0 marks an empty store slot, so a record carrying it is corrupt even
+// when its checksum holds
+bool DecodeUser(std::string_view in, bool with_avatar, UserRecord& record) {
+    if (!ReadLE(in, record.user_id) || record.user_id == 0 || !ReadLE(in, record.created_at_ms) ||
+        !ReadLE(in, record.updated_at_ms) || !ReadLE(in, record.age) ||
+        !ReadBytes<uint16_t>(in, record.name) || !ReadBytes<uint16_t>(in, record.email)) {
+        return false;
+    }
+    record.avatar.clear();
+    return !with_avatar || ReadBytes<uint32_t>(in, record.avatar);
+}
+
+struct ReplayItem {
+    uint8_t type;
+    std::string_view payload;
+};
+
+size_t WorkerCount(size_t configured) {
+    return configured > 0 ? configured : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Strips the header off `data`
+bool ParseSnapshotHeader(std::string_view& data, uint64_t& first_segment, uint64_t& user_count) {
+    if (data.size() < kSnapshotHeaderSize ||
+        std::memcmp(data.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+    data.remove_prefix(sizeof(kSnapshotMagic));
+    ReadLE(data, first_segment);
+    ReadLE(data, user_count);
+    return true;
+}
+
+bool WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t result = ::write(fd, data, size);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += result;
+        size -= static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Ids are mostly dense, so mix them before masking
+size_t ColdSlotHash(uint64_t user_id) {
+    return static_cast<size_t>((user_id * 0x9E3779B97F4A7C15ull) >> 20);
+}
+
+// Every user as of one view, written to `path` in the snapshot format and
+// synced. Workers encode whole shards and append full chunks under a lock.
+bool WriteUserFile(const UserStore& store, const std::string& path, uint64_t first_segment,
+                   size_t thread_count, BulkTransferStats& stats, std::string& error) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    std::string header(kSnapshotMagic, sizeof(kSnapshotMagic));
+    AppendLE<uint64_t>(header, first_segment);
+    AppendLE<uint64_t>(header, 0);   // user count, patched below
+    bool ok = WriteAll(fd, header.data(), header.size());
+
+    std::mutex file_mutex;
+    std::atomic<size_t> next_shard{0};
+    std::atomic<uint64_t> user_count{0};
+    uint64_t bytes = header.size();
+    UserStore::ReadView view = store.OpenView();
+    auto flush = [&](std::string& buffer) {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        ok = ok && WriteAll(fd, buffer.data(), buffer.size());
+        bytes += buffer.size();
+        buffer.clear();
+    };
+    auto encode = [&] {
+        std::string buffer;
+        std::string payload;
+        uint64_t users = 0;
+        for (size_t shard; (shard = next_shard.fetch_add(1)) < store.ShardCount();) {
+            store.ForEach(view, shard, [&](const UserRecord& record) {
+                payload.clear();
+                EncodeUser(record, true, payload);
+                AppendLogRecord(kRecordPutUser, payload, buffer);
+                ++users;
+                if (buffer.size() >= kSnapshotWriteChunk) {
+                    flush(buffer);
+                }
+            });
+        }
+        flush(buffer);
+        user_count.fetch_add(users, std::memory_order_relaxed);
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(thread_count, store.ShardCount()); ++i) {
+        threads.emplace_back(encode);
+    }
+    encode();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::string count;
+    AppendLE<uint64_t>(count, user_count.load());
+    ok = ok && ::pwrite(fd, count.data(), count.size(), kSnapshotCountOffset) ==
+                   static_cast<ssize_t>(count.size());
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        error = "write " + path + ": " + std::strerror(errno);
+        ::unlink(path.c_str());
+        return false;
+    }
+    stats.users = user_count.load();
+    stats.bytes = bytes;
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// UserPersistence
+// ============================================================================
+
+UserPersistence::UserPersistence(UserStore& store, std::string directory, PersistenceConfig config)
+    : store_(store), directory_(std::move(directory)), config_(config), log_(directory_) {}
+
+UserPersistence::~UserPersistence() {
+    {
+        std::lock_guard<std::mutex> lock(loop_mutex_);
+        stopping_ = true;
+    }
+    loop_wakeup_.notify_all();
+    if (snapshot_thread_.joinable()) {
+        snapshot_thread_.join();
+    }
+    store_.SetWriteListener(nullptr);
+}
+
+bool UserPersistence::Open(std::string& error) {
+    if (!Recover(error) || !log_.Open(error)) {
+        return false;
+    }
+
+    store_.SetWriteListener([this](const UserRecord& record, bool avatar_changed) {
+        thread_local std::string payload;
+        payload.clear();
+        EncodeUser(record, avatar_changed, payload);
+        return log_.Append(avatar_changed ? kRecordPutUser : kRecordPutFields, payload);
+    });
+
+    if (config_.snapshot_interval.count() > 0) {
+        snapshot_thread_ = std::thread([this] { SnapshotLoop(); });
+    }
+    return true;
+}
+
+bool UserPersistence::Recover(std::string& error) {
+    size_t thread_count = std::min(WorkerCount(config_.replay_threads), store_.ShardCount());
+
+    // Records are only referenced from the mappings, which stay open until
+    // the replay threads are done
+    std::vector<MappedFile> files;
+    std::vector<std::vector<ReplayItem>> partitions(thread_count);
+    bool malformed = false;
+    auto collect = [&](uint8_t type, std::string_view payload) {
+        uint64_t user_id = 0;
+        std::string_view key = payload;
+        if ((type != kRecordPutUser && type != kRecordPutFields) || !ReadLE(key, user_id)) {
+            malformed = true;
+            return;
+        }
+        partitions[store_.ShardOf(user_id) % thread_count].push_back({type, payload});
+    };
+
+    uint64_t first_segment = 1;
+    std::string snapshot_path = directory_ + "/snapshot";
+    if (::access(snapshot_path.c_str(), F_OK) == 0) {
+        MappedFile snapshot;
+        if (!snapshot.Open(snapshot_path, error)) {
+            return false;
+        }
+        std::string_view data = snapshot.Data();
+        uint64_t user_count = 0;
+        if (!ParseSnapshotHeader(data, first_segment, user_count)) {
+            error = snapshot_path + ": not a user snapshot";
+            return false;
+        }
+        uint64_t parsed = 0;
+        size_t consumed = ParseLogRecords(data, [&](uint8_t type, std::string_view payload) {
+            ++parsed;
+            collect(type, payload);
+        });
+        if (consumed != data.size() || parsed != user_count || malformed) {
+            error = snapshot_path + ": corrupt";
+            return false;
+        }
+        recovery_.snapshot_users = user_count;
+        files.push_back(std::move(snapshot));
+    }
+
+    // Segments below the snapshot's first segment are covered by it; they
+    // survive only if a crash hit between the rename and their removal
+    log_.RemoveSegmentsBefore(first_segment);
+    for (uint64_t segment : WriteAheadLog::ListSegments(directory_)) {
+        MappedFile file;
+        if (!file.Open(WriteAheadLog::SegmentPath(directory_, segment), error)) {
+            return false;
+        }
+        std::string_view data = file.Data();
+        size_t consumed = ParseLogRecords(data, [&](uint8_t type, std::string_view payload) {
+            ++recovery_.log_records;
+            collect(type, payload);
+        });
+        if (malformed) {
+            error = WriteAheadLog::SegmentPath(directory_, segment) + ": unknown record";
+            return false;
+        }
+        recovery_.torn_bytes += data.size() - consumed;
+        ++recovery_.log_segments;
+        files.push_back(std::move(file));
+    }
+
+    // Each partition owns whole shards and holds their records in log order
+    std::atomic<bool> decode_failed{false};
+    auto replay = [&](const std::vector<ReplayItem>& items) {
+        UserRecord record;
+        for (const ReplayItem& item : items) {
+            bool with_avatar = item.type == kRecordPutUser;
+            if (!DecodeUser(item.payload, with_avatar, record)) {
+                decode_failed = true;
+                return;
+            }
+            store_.Restore(record, with_avatar);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(replay, std::cref(partitions[i]));
+    }
+    replay(partitions[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (decode_failed) {
+        error = directory_ + ": corrupt user record";
+        return false;
+    }
+    return true;
+}
+
+bool UserPersistence::Snapshot(std::string& error) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+
+    uint64_t first_segment = 0;
+    if (!log_.Rotate(first_segment, error)) {
+        return false;
+    }
+
+    std::string temp_path = directory_ + "/snapshot.tmp";
+    BulkTransferStats stats;
+    if (!WriteUserFile(store_, temp_path, first_segment, config_.snapshot_threads, stats, error)) {
+        return false;
+    }
+
+    std::string snapshot_path = directory_ + "/snapshot";
+    if (::rename(temp_path.c_str(), snapshot_path.c_str()) != 0 || !SyncDirectory(directory_)) {
+        error = "rename " + temp_path + ": " + std::strerror(errno);
+        return false;
+    }
+    log_.RemoveSegmentsBefore(first_segment);
+    snapshot_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void UserPersistence::SnapshotLoop() {
+    const auto poll = std::min<std::chrono::milliseconds>(config_.snapshot_interval, std::chrono::seconds(1));
+    auto last_snapshot = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(loop_mutex_);
+    while (!loop_wakeup_.wait_for(lock, poll, [this] { return stopping_; })) {
+        uint64_t log_bytes = log_.GetSegmentBytes();
+        auto now = std::chrono::steady_clock::now();
+        bool due = now - last_snapshot >= config_.snapshot_interval ||
+                   log_bytes >= config_.snapshot_log_bytes;
+        // Nothing was written since the last snapshot
+        if (!due || log_bytes == 0) {
+            continue;
+        }
+        lock.unlock();
+        std::string error;
+        if (!Snapshot(error)) {
+            snapshot_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        last_snapshot = now;
+        lock.lock();
+    }
+}
+
+// ============================================================================
+// Bulk Transfer
+// ============================================================================
+
+bool ExportUsers(const UserStore& store, const std::string& path, const BulkTransferConfig& config,
+                 BulkTransferStats& stats, std::string& error) {
+    // Only a complete export ever appears under `path`
+    std::string temp_path = path + ".tmp";
+    if (!WriteUserFile(store, temp_path, 0, WorkerCount(config.threads), stats, error)) {
+        return false;
+    }
+    if (::rename(temp_path.c_str(), path.c_str()) != 0) {
+        error = "rename " + temp_path + ": " + std::strerror(errno);
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ImportUsers(UserStore& store, const std::string& path, const BulkTransferConfig& config,
+                 BulkTransferStats& stats, std::string& error) {
+    MappedFile file;
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    std::string_view data = file.Data();
+    uint64_t first_segment = 0;
+    uint64_t user_count = 0;
+    if (!ParseSnapshotHeader(data, first_segment, user_count)) {
+        error = path + ": not a user export";
+        return false;
+    }
+
+    // Cut at record boundaries by following the length fields alone; a
+    // corrupt tail ends up in the last chunk, whose parse then falls short
+    size_t thread_count = WorkerCount(config.threads);
+    size_t chunk_size = std::max(kMinImportChunk, data.size() / (thread_count * kImportChunksPerThread) + 1);
+    std::vector<std::string_view> chunks;
+    size_t chunk_begin = 0;
+    size_t position = 0;
+    while (data.size() - position >= kLogRecordHeaderSize) {
+        std::string_view length_field = data.substr(position, sizeof(uint32_t));
+        uint32_t length = 0;
+        ReadLE(length_field, length);
+        if (length == 0 || length > data.size() - position - kRecordFrameSize) {
+            break;
+        }
+        position += kRecordFrameSize + length;
+        if (position - chunk_begin >= chunk_size) {
+            chunks.push_back(data.substr(chunk_begin, position - chunk_begin));
+            chunk_begin = position;
+        }
+    }
+    if (chunk_begin < data.size()) {
+        chunks.push_back(data.substr(chunk_begin));
+    }
+
+    auto prefetch = [&](size_t chunk) {
+        if (chunk < chunks.size()) {
+            file.WillNeed(chunks[chunk].data() - file.Data().data(), chunks[chunk].size());
+        }
+    };
+    for (size_t i = 0; i < thread_count; ++i) {
+        prefetch(i);
+    }
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<uint64_t> restored{0};
+    std::atomic<bool> corrupt{false};
+    auto restore = [&] {
+        UserRecord record;
+        for (size_t i; !corrupt && (i = next_chunk.fetch_add(1)) < chunks.size();) {
+            // About when this worker will take its next chunk
+            prefetch(i + thread_count);
+            uint64_t users = 0;
+            size_t consumed = ParseLogRecords(chunks[i], [&](uint8_t type, std::string_view payload) {
+                if (type != kRecordPutUser || !DecodeUser(payload, true, record)) {
+                    corrupt = true;
+                    return;
+                }
+                store.Restore(record, true);
+                ++users;
+            });
+            if (consumed != chunks[i].size()) {
+                corrupt = true;
+            }
+            restored.fetch_add(users, std::memory_order_relaxed);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(thread_count, chunks.size()); ++i) {
+        threads.emplace_back(restore);
+    }
+    restore();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    stats.users = restored.load();
+    stats.bytes = file.Data().size();
+    if (corrupt || stats.users != user_count) {
+        error = path + ": corrupt";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// UserColdStore
+// ============================================================================
+
+bool UserColdStore::Open(const std::string& path, std::string& error) {
+    if (!file_.Open(path, error)) {
+        return false;
+    }
+    std::string_view data = file_.Data();
+    uint64_t first_segment = 0;
+    uint64_t user_count = 0;
+    if (!ParseSnapshotHeader(data, first_segment, user_count)) {
+        error = path + ": not a user export";
+        return false;
+    }
+
+    size_t capacity = 16;
+    while (capacity * 7 < user_count * 10) {
+        capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot());
+    size_ = 0;
+    max_user_id_ = 0;
+    size_t base = kSnapshotHeaderSize;
+    size_t position = 0;
+    while (data.size() - position >= kLogRecordHeaderSize + sizeof(uint64_t)) {
+        std::string_view frame = data.substr(position);
+        uint32_t length = 0;
+        uint64_t user_id = 0;
+        ReadLE(frame, length);
+        frame.remove_prefix(sizeof(uint32_t) + 1);   // CRC and type
+        if (length == 0 || length > data.size() - position - kRecordFrameSize ||
+            !ReadLE(frame, user_id) || user_id == 0 || size_ == user_count) {
+            break;
+        }
+        for (size_t i = ColdSlotHash(user_id);; ++i) {
+            Slot& slot = slots_[i & (capacity - 1)];
+            if (slot.user_id == 0 || slot.user_id == user_id) {
+                size_ += slot.user_id == 0;
+                slot.user_id = user_id;
+                slot.offset = base + position;
+                break;
+            }
+        }
+        max_user_id_ = std::max(max_user_id_, user_id);
+        position += kRecordFrameSize + length;
+    }
+    if (position != data.size() || size_ != user_count) {
+        error = path + ": corrupt";
+        return false;
+    }
+    return true;
+}
+
+bool UserColdStore::Find(uint64_t user_id, std::string_view& payload) const {
+    if (user_id == 0 || slots_.empty()) {
+        return false;
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t i = ColdSlotHash(user_id);; ++i) {
+        const Slot& slot = slots_[i & mask];
+        if (slot.user_id == 0) {
+            return false;
+        }
+        if (slot.user_id == user_id) {
+            // Open() checked that the frame fits in the file
+            std::string_view frame = file_.Data().substr(slot.offset);
+            std::string_view length_field = frame;
+            uint32_t length = 0;
+            ReadLE(length_field, length);
+            bool intact = false;
+            ParseLogRecords(frame.substr(0, kRecordFrameSize + length), [&](uint8_t type, std::string_view record) {
+                intact = type == kRecordPutUser;
+                payload = record;
+            });
+            return intact;
+        }
+    }
+}
+
+bool UserColdStore::Decode(std::string_view payload, UserRecord& record) {
+    return DecodeUser(payload, true, record);
+}
+
+} // namespace grlrpc
@@ -0,0 +1,191 @@
+// GrlRPC User Service Implementation
+
+#include "user_service.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace grlrpc {
+
+namespace {
+
+int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char kNotDurable[] = "NOT_DURABLE";
+
+} // namespace
+
+bool UserService::Register(ServiceSkeleton& skeleton) {
+    MethodOptions inline_options;
+    inline_options.inline_safe = true;
+
+    bool ok = skeleton.Register<GetUserMethod>(
+        [this](const GetUserRequest& request, GetUserResponse& response) {
+            return GetUser(request, response);
+        }, tier_ ? MethodOptions() : inline_options);
+    ok = skeleton.Register<CreateUserMethod>(
+        [this](const CreateUserRequest& request, CreateUserResponse& response) {
+            return CreateUser(request, response);
+        }) && ok;
+    ok = skeleton.Register<UpdateUserMethod>(
+        [this](const UpdateUserRequest& request, UpdateUserResponse& response) {
+            return UpdateUser(request, response);
+        }) && ok;
+    ok = skeleton.Register<BatchGetUsersMethod>(
+        [this](const BatchGetUsersRequest& request, BatchGetUsersResponse& response) {
+            return BatchGetUsers(request, response);
+        }) && ok;
+    ok = skeleton.Register<FindUserByEmailMethod>(
+        [this](const FindUserByEmailRequest& request, GetUserResponse& response) {
+            return FindUserByEmail(request, response);
+        }, inline_options) && ok;
+    ok = skeleton.Register<SearchUsersMethod>(
+        [this](const SearchUsersRequest& request, SearchUsersResponse& response) {
+            return SearchUsers(request, response);
+        }) && ok;
+    if (watch_hub_) {
+        ok = skeleton.RegisterEncoded<WatchUsersMethod>(
+            [this](const WatchUsersRequest& request, const std::string& serializer_name, std::string& payload) {
+                return WatchUsers(request, serializer_name, payload);
+            }) && ok;
+    }
+    return ok;
+}
+
+bool UserService::ConfigureRouting(ShardRouter& router, const std::string& serializer_name) const {
+    if (serializer_name != "binary") {
+        return false;
+    }
+    router.SetKeyExtractor(GetUserMethod::kId, FixedOffsetKeyExtractor(0));
+    router.SetKeyExtractor(UpdateUserMethod::kId, FixedOffsetKeyExtractor(0));
+    return true;
+}
+
+RpcStatus UserService::GetUser(const GetUserRequest& request, GetUserResponse& response) {
+    if (tier_) {
+        tier_->Get(request.user_id, request.include_avatar, response);
+    } else {
+        store_.Get(request.user_id, request.include_avatar, response);
+    }
+    response.user_id = request.user_id;
+    return RpcStatus::SUCCESS;
+}
+
+RpcStatus UserService::CreateUser(const CreateUserRequest& request, CreateUserResponse& response) {
+    uint64_t sequence = 0;
+    UserStoreStatus status = store_.Create(request, NowMs(), response.user_id, &sequence);
+    response.success = status == UserStoreStatus::OK;
+    if (!response.success) {
+        response.error = UserStoreStatusToString(status);
+    } else if (persistence_ && !persistence_->WaitDurable(sequence)) {
+        response.success = false;
+        response.error = kNotDurable;
+    }
+    return RpcStatus::SUCCESS;
+}
+
+RpcStatus UserService::UpdateUser(const UpdateUserRequest& request, UpdateUserResponse& response) {
+    uint64_t sequence = 0;
+    if (tier_) {
+        tier_->MakeResident(request.user_id);
+    }
+    UserStoreStatus status = store_.Update(request, NowMs(), &sequence);
+    response.user_id = request.user_id;
+    response.success = status == UserStoreStatus::OK;
+    if (!response.success) {
+        response.error = UserStoreStatusToString(status);
+    } else if (persistence_ && !persistence_->WaitDurable(sequence)) {
+        response.success = false;
+        response.error = kNotDurable;
+    }
+    return RpcStatus::SUCCESS;
+}
+
+RpcStatus UserService::BatchGetUsers(const BatchGetUsersRequest& request, BatchGetUsersResponse& response) {
+    const std::vector<uint64_t>& user_ids = request.user_ids;
+    if (user_ids.size() > kMaxBatchSize) {
+        return RpcStatus::INVALID_REQUEST;
+    }
+    response.users.clear();
+    response.users.resize(user_ids.size());
+
+    UserStore::BatchPlan plan;
+    store_.PlanBatch(user_ids, plan);
+    std::vector<size_t> shards;
+    for (size_t shard = 0; shard < store_.ShardCount(); ++shard) {
+        if (plan.shard_begin[shard] != plan.shard_begin[shard + 1]) {
+            shards.push_back(shard);
+        }
+    }
+
+    // One view for every shard: the batch is a single point in time, and its
+    // pin, taken on this thread, covers the fan-out workers too
+    UserStore::ReadView view = store_.OpenView();
+    auto lookup = [&](size_t index) {
+        store_.GetShardBatch(view, plan, shards[index], user_ids, request.include_avatar, response.users);
+    };
+    if (fan_out_ && user_ids.size() >= kParallelBatchThreshold) {
+        fan_out_->Run(shards.size(), lookup);
+    } else {
+        for (size_t i = 0; i < shards.size(); ++i) {
+            lookup(i);
+        }
+    }
+    if (tier_) {
+        ReadThroughMisses(request, response);
+    }
+    return RpcStatus::SUCCESS;
+}
+
+void UserService::ReadThroughMisses(const BatchGetUsersRequest& request, BatchGetUsersResponse& response) {
+    // Every miss is queued before waiting, so the cold reads overlap
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t outstanding = 1;
+    auto complete = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--outstanding == 0) {
+            finished.notify_one();
+        }
+    };
+    for (GetUserResponse& user : response.users) {
+        if (user.found || user.user_id == 0) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++outstanding;
+        }
+        tier_->GetAsync(user.user_id, request.include_avatar, [&user, &complete](GetUserResponse& result) {
+            user = std::move(result);
+            complete();
+        });
+    }
+    complete();
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return outstanding == 0; });
+}
+
+RpcStatus UserService::FindUserByEmail(const FindUserByEmailRequest& request, GetUserResponse& response) {
+    store_.FindByEmail(request.email, request.include_avatar, response);
+    return RpcStatus::SUCCESS;
+}
+
+RpcStatus UserService::SearchUsers(const SearchUsersRequest& request, SearchUsersResponse& response) {
+    store_.SearchByNamePrefix(request.name_prefix, request.limit, response);
+    return RpcStatus::SUCCESS;
+}
+
+RpcStatus UserService::WatchUsers(const WatchUsersRequest& request, const std::string& serializer_name,
+                                  std::string& payload) {
+    if (!watch_hub_->Watch(request, serializer_name, payload)) {
+        return RpcStatus::SERIALIZATION_ERROR;
+    }
+    return RpcStatus::SUCCESS;
+}
+
+} // namespace grlrpc
@@ -0,0 +1,799 @@
+// GrlRPC User Store Implementation
+
+#include "user_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace grlrpc {
+
+namespace {
+
+// Avatar bytes in one allocation, shared by every version of a user until
+// the avatar changes
+struct AvatarBlob {
+    std::atomic<uint32_t> refs;
+    uint32_t size;
+
+    static AvatarBlob* Create(const std::string& bytes) {
+        if (bytes.empty()) {
+            return nullptr;
+        }
+        void* memory = ::operator new(sizeof(AvatarBlob) + bytes.size());
+        AvatarBlob* blob = new (memory) AvatarBlob;
+        blob->refs.store(1, std::memory_order_relaxed);
+        blob->size = static_cast<uint32_t>(bytes.size());
+        std::memcpy(reinterpret_cast<char*>(blob + 1), bytes.data(), bytes.size());
+        return blob;
+    }
+
+    static AvatarBlob* Retain(AvatarBlob* blob) {
+        if (blob) {
+            blob->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return blob;
+    }
+
+    static void Release(AvatarBlob* blob) {
+        if (blob && blob->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            blob->~AvatarBlob();
+            ::operator delete(blob);
+        }
+    }
+
+    std::string_view View() const {
+        return std::string_view(reinterpret_cast<const char*>(this + 1), size);
+    }
+};
+
+// One immutable state of a user, in a single arena slot: the fixed-width
+// fields, then the name and email bytes. When the email's "@domain" part
+// is interned in the store's StringHeap only the local part is inline.
+// `older` is the version it replaced, kept for views opened before this
+// one was committed and freed once they are gone; the link then dangles,
+// but no view new enough to reach it ever follows it
+struct UserVersion {
+    std::atomic<UserVersion*> older{nullptr};
+    uint64_t commit_ts = 0;
+    int64_t created_at_ms = 0;
+    int64_t updated_at_ms = 0;
+    AvatarBlob* avatar = nullptr;   // one reference; null = no avatar
+    int32_t age = 0;
+    uint32_t email_domain = StringHeap::kNone;
+    uint8_t name_length = 0;
+    uint8_t email_length = 0;       // inline part only
+    uint8_t size_class = 0;
+
+    const char* Text() const { return reinterpret_cast<const char*>(this + 1); }
+    std::string_view Name() const { return std::string_view(Text(), name_length); }
+    std::string_view EmailInline() const { return std::string_view(Text() + name_length, email_length); }
+};
+
+// Fields of a version about to be built; the views must outlive NewVersion()
+struct UserFields {
+    int64_t created_at_ms = 0;
+    int64_t updated_at_ms = 0;
+    int32_t age = 0;
+    std::string_view name;
+    std::string_view email_inline;
+    uint32_t email_domain = StringHeap::kNone;
+    AvatarBlob* avatar = nullptr;   // reference handed to the version
+};
+
+// Shorter domains are cheaper inline than as a 4-byte reference
+constexpr size_t kMinInternedDomain = 5;
+
+void SetEmail(StringHeap& domains, std::string_view email, UserFields& fields) {
+    size_t at = email.rfind('@');
+    uint32_t domain = StringHeap::kNone;
+    if (at != std::string_view::npos && email.size() - at >= kMinInternedDomain) {
+        domain = domains.Intern(email.substr(at));
+    }
+    fields.email_domain = domain;
+    fields.email_inline = domain != StringHeap::kNone ? email.substr(0, at) : email;
+}
+
+// Copies views and the avatar pointer; the caller decides about the reference
+UserFields FieldsOf(const UserVersion& version) {
+    UserFields fields;
+    fields.created_at_ms = version.created_at_ms;
+    fields.updated_at_ms = version.updated_at_ms;
+    fields.age = version.age;
+    fields.name = version.Name();
+    fields.email_inline = version.EmailInline();
+    fields.email_domain = version.email_domain;
+    fields.avatar = version.avatar;
+    return fields;
+}
+
+void AssignEmail(const StringHeap& domains, const UserVersion& version, std::string& out) {
+    out.assign(version.EmailInline());
+    if (version.email_domain != StringHeap::kNone) {
+        out.append(domains.View(version.email_domain));
+    }
+}
+
+// ============================================================================
+// RecordArena
+// ============================================================================
+
+/**
+ * Slab allocator for versions: 16-byte size classes carved from 64 KB
+ * slabs, so a version costs its rounded-up size and no allocator header.
+ * Freed slots go to per-class free lists for reuse. Frees come from epoch
+ * reclaims on whichever thread collects, hence the lock.
+ */
+class RecordArena {
+public:
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kSlabSize = 64 * 1024;
+    static constexpr size_t kMaxRecordSize =
+        sizeof(UserVersion) + UserStore::kMaxNameLength + UserStore::kMaxEmailLength;
+    static constexpr size_t kClassCount = (kMaxRecordSize + kGranularity - 1) / kGranularity + 1;
+
+    void* Allocate(size_t bytes, uint8_t& size_class) {
+        size_class = static_cast<uint8_t>((bytes + kGranularity - 1) / kGranularity);
+        size_t rounded = size_class * kGranularity;
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_ += rounded;
+        if (FreeSlot* slot = free_[size_class]) {
+            free_[size_class] = slot->next;
+            return slot;
+        }
+        if (static_cast<size_t>(end_ - cursor_) < rounded) {
+            // Abandons the current slab's tail, at most one record's worth
+            slabs_.emplace_back(new char[kSlabSize]);
+            cursor_ = slabs_.back().get();
+            end_ = cursor_ + kSlabSize;
+        }
+        void* memory = cursor_;
+        cursor_ += rounded;
+        return memory;
+    }
+
+    void Free(void* memory, uint8_t size_class) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_ -= size_class * kGranularity;
+        FreeSlot* slot = static_cast<FreeSlot*>(memory);
+        slot->next = free_[size_class];
+        free_[size_class] = slot;
+    }
+
+    size_t BytesInUse() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_use_;
+    }
+
+    size_t BytesReserved() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slabs_.size() * kSlabSize;
+    }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    mutable std::mutex mutex_;
+    FreeSlot* free_[kClassCount] = {};
+    std::vector<std::unique_ptr<char[]>> slabs_;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    size_t in_use_ = 0;
+};
+
+// Newest version committed at or before `timestamp`
+const UserVersion* VersionAt(const UserVersion* version, uint64_t timestamp) {
+    while (version && version->commit_ts > timestamp) {
+        version = version->older.load(std::memory_order_acquire);
+    }
+    return version;
+}
+
+struct Slot {
+    std::atomic<uint64_t> key{0};   // user id, 0 = empty
+    std::atomic<UserVersion*> head{nullptr};
+};
+
+struct Table {
+    explicit Table(size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {}
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+};
+
+size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 16;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Shard selection uses the high bits of a multiply-shift hash; slot
+// selection mixes the id independently so both stay uniform
+size_t SlotHash(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    return static_cast<size_t>(id);
+}
+
+void ToRecord(const StringHeap& domains, uint64_t id, const UserVersion& version, UserRecord& record) {
+    record.user_id = id;
+    record.name.assign(version.Name());
+    AssignEmail(domains, version, record.email);
+    record.age = version.age;
+    record.created_at_ms = version.created_at_ms;
+    record.updated_at_ms = version.updated_at_ms;
+    if (version.avatar) {
+        record.avatar.assign(version.avatar->View());
+    } else {
+        record.avatar.clear();
+    }
+}
+
+void ToResponse(const StringHeap& domains, uint64_t id, const UserVersion& version,
+                bool include_avatar, GetUserResponse& response) {
+    response.user_id = id;
+    response.found = true;
+    response.name.assign(version.Name());
+    AssignEmail(domains, version, response.email);
+    response.age = version.age;
+    response.created_at_ms = version.created_at_ms;
+    response.updated_at_ms = version.updated_at_ms;
+    if (include_avatar && version.avatar) {
+        response.avatar.assign(version.avatar->View());
+    } else {
+        response.avatar.clear();
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Shard
+// ============================================================================
+
+struct UserStore::Shard {
+    Shard(UserStore& store, size_t capacity) : owner(store), table(new Table(capacity)) {}
+
+    // The owner has drained its epochs, which freed every version but the
+    // heads; their `older` links are left dangling
+    ~Shard() {
+        Table* current = table.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= current->mask; ++i) {
+            FreeVersion(current->slots[i].head.load(std::memory_order_relaxed));
+        }
+        delete current;
+    }
+
+    // Takes over fields.avatar's reference
+    UserVersion* NewVersion(const UserFields& fields) {
+        size_t text = fields.name.size() + fields.email_inline.size();
+        uint8_t size_class = 0;
+        void* memory = arena.Allocate(sizeof(UserVersion) + text, size_class);
+        UserVersion* version = new (memory) UserVersion;
+        version->created_at_ms = fields.created_at_ms;
+        version->updated_at_ms = fields.updated_at_ms;
+        version->avatar = fields.avatar;
+        version->age = fields.age;
+        version->email_domain = fields.email_domain;
+        version->name_length = static_cast<uint8_t>(fields.name.size());
+        version->email_length = static_cast<uint8_t>(fields.email_inline.size());
+        version->size_class = size_class;
+        char* out = reinterpret_cast<char*>(version + 1);
+        std::memcpy(out, fields.name.data(), fields.name.size());
+        std::memcpy(out + fields.name.size(), fields.email_inline.data(), fields.email_inline.size());
+        return version;
+    }
+
+    void FreeVersion(UserVersion* version) {
+        if (version) {
+            AvatarBlob::Release(version->avatar);
+            uint8_t size_class = version->size_class;
+            version->~UserVersion();
+            arena.Free(version, size_class);
+        }
+    }
+
+    Slot* FindLocked(uint64_t id) {
+        Table* current = table.load(std::memory_order_relaxed);
+        for (size_t i = SlotHash(id);; ++i) {
+            Slot& slot = current->slots[i & current->mask];
+            uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == id) {
+                return &slot;
+            }
+            if (key == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    Slot& InsertLocked(uint64_t id) {
+        Table* current = table.load(std::memory_order_relaxed);
+        // Keep the load factor at or below 0.7 so probe runs stay short
+        if ((count.load(std::memory_order_relaxed) + 1) * 10 > (current->mask + 1) * 7) {
+            current = Grow(current);
+        }
+        for (size_t i = SlotHash(id);; ++i) {
+            Slot& slot = current->slots[i & current->mask];
+            if (slot.key.load(std::memory_order_relaxed) == 0) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                return slot;
+            }
+        }
+    }
+
+    Table* Grow(Table* current) {
+        Table* next = new Table((current->mask + 1) * 2);
+        for (size_t i = 0; i <= current->mask; ++i) {
+            const Slot& slot = current->slots[i];
+            uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == 0) {
+                continue;
+            }
+            for (size_t j = SlotHash(key);; ++j) {
+                Slot& target = next->slots[j & next->mask];
+                if (target.key.load(std::memory_order_relaxed) == 0) {
+                    target.head.store(slot.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    target.key.store(key, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        table.store(next, std::memory_order_release);
+        // Readers may still be probing the old table; its slots only point
+        // at versions, which stay owned by the new one
+        owner.epochs_.Retire([current] { delete current; });
+        return next;
+    }
+
+    /**
+     * @brief Make `version` the newest version of `id`; the shard mutex is
+     *        held and the caller is pinned
+     *
+     * The commit section stamps the version and publishes it before the
+     * store's timestamp moves past it, so a view at timestamp t finds every
+     * version up to t in the table it loads afterwards.
+     */
+    void Publish(Slot& slot, uint64_t id, UserVersion* version) {
+        UserVersion* previous = slot.head.load(std::memory_order_relaxed);
+        version->older.store(previous, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(owner.commit_mutex_);
+            uint64_t timestamp = owner.commit_ts_.load(std::memory_order_relaxed) + 1;
+            version->commit_ts = timestamp;
+            slot.head.store(version, std::memory_order_release);
+            if (!previous) {
+                slot.key.store(id, std::memory_order_release);
+            }
+            owner.commit_ts_.store(timestamp, std::memory_order_seq_cst);
+        }
+        if (previous) {
+            // Frees only `previous`, so it does not matter whether the
+            // versions it replaced were freed already: different writers'
+            // retirements are reclaimed in no particular order. Nothing
+            // follows `version->older` once no view old enough is pinned
+            owner.epochs_.Retire([this, previous] { FreeVersion(previous); });
+        }
+    }
+
+    // Newest version of `id` committed at or before `timestamp`; the caller is pinned
+    const UserVersion* Read(uint64_t id, uint64_t timestamp) const {
+        const Slot* slot = Probe(id);
+        return slot ? VersionAt(slot->head.load(std::memory_order_acquire), timestamp) : nullptr;
+    }
+
+    const Slot* Probe(uint64_t id) const {
+        const Table* current = table.load(std::memory_order_acquire);
+        for (size_t i = SlotHash(id), probes = 0; probes <= current->mask; ++i, ++probes) {
+            const Slot& slot = current->slots[i & current->mask];
+            uint64_t key = slot.key.load(std::memory_order_acquire);
+            if (key == 0) {
+                return nullptr;
+            }
+            if (key == id) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    // Pull the first probe slot of `id` towards the cache ahead of Read()
+    void PrefetchSlot(uint64_t id) const {
+        const Table* current = table.load(std::memory_order_acquire);
+        __builtin_prefetch(&current->slots[SlotHash(id) & current->mask]);
+    }
+
+    // Second stage, once the slot is (likely) cached: pull its head version
+    void PrefetchVersion(uint64_t id) const {
+        const Slot* slot = Probe(id);
+        if (slot) {
+            const char* version = reinterpret_cast<const char*>(slot->head.load(std::memory_order_acquire));
+            __builtin_prefetch(version);
+            __builtin_prefetch(version + 64);
+        }
+    }
+
+    // New index entries go in before the version is published and stale
+    // ones come out after, so a concurrent index reader always finds the
+    // user under whichever version it then checks
+    //
+    // The caller pins before it takes the shard lock, which keeps `before`
+    // alive and defers the collections our retirements trigger until that
+    // lock has been released
+    void PublishIndexed(Slot& slot, uint64_t id, const UserVersion* before, UserVersion* version) {
+        // Indexes key on whole emails; only writers build them, under the shard lock
+        thread_local std::string before_email;
+        thread_local std::string after_email;
+        AssignEmail(owner.strings_, *version, after_email);
+        if (before) {
+            AssignEmail(owner.strings_, *before, before_email);
+        }
+        bool name_changed = !before || before->Name() != version->Name();
+        bool email_changed = !before || before_email != after_email;
+        if (name_changed) {
+            owner.name_index_.Insert(version->Name(), id);
+        }
+        if (email_changed && !after_email.empty()) {
+            owner.email_index_.Insert(after_email, id);
+        }
+        Publish(slot, id, version);
+        if (name_changed && before) {
+            owner.name_index_.Remove(before->Name(), id);
+        }
+        if (email_changed && before && !before_email.empty()) {
+            owner.email_index_.Remove(before_email, id);
+        }
+    }
+
+    UserStore& owner;
+    RecordArena arena;
+
+    // Writers
+    std::mutex write_mutex;
+    std::atomic<Table*> table;
+    std::atomic<size_t> count{0};
+};
+
+// ============================================================================
+// UserStore
+// ============================================================================
+
+UserStore::UserStore(size_t shard_count, size_t initial_capacity)
+    : router_(shard_count), email_index_(epochs_), name_index_(epochs_) {
+    size_t capacity = RoundUpPowerOfTwo(initial_capacity);
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(*this, capacity));
+    }
+}
+
+UserStore::~UserStore() {
+    // Cut every chain down to its head before the shards free the heads
+    epochs_.Drain();
+}
+
+UserStoreStatus UserStore::Create(const CreateUserRequest& request, int64_t now_ms,
+                                  uint64_t& user_id, uint64_t* write_sequence) {
+    if (request.name.empty() || request.name.size() > kMaxNameLength ||
+        request.email.size() > kMaxEmailLength || request.age < 0) {
+        return UserStoreStatus::INVALID_ARGUMENT;
+    }
+
+    UserFields fields;
+    fields.created_at_ms = now_ms;
+    fields.updated_at_ms = now_ms;
+    fields.age = request.age;
+    fields.name = request.name;
+    SetEmail(strings_, request.email, fields);
+    fields.avatar = AvatarBlob::Create(request.avatar);
+
+    user_id = next_user_id_.fetch_add(1, std::memory_order_relaxed);
+    Shard& shard = *shards_[ShardOf(user_id)];
+    EpochManager::Guard pin = epochs_.Pin();
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+    UserVersion* published = shard.NewVersion(fields);
+    shard.PublishIndexed(shard.InsertLocked(user_id), user_id, nullptr, published);
+    if (listener_ || change_listener_) {
+        UserRecord record;
+        ToRecord(strings_, user_id, *published, record);
+        if (listener_) {
+            uint64_t sequence = listener_(record, true);
+            if (write_sequence) {
+                *write_sequence = sequence;
+            }
+        }
+        if (change_listener_) {
+            change_listener_(record, true, !record.avatar.empty());
+        }
+    }
+    return UserStoreStatus::OK;
+}
+
+UserStoreStatus UserStore::Update(const UpdateUserRequest& request, int64_t now_ms,
+                                  uint64_t* write_sequence) {
+    if (request.name.size() > kMaxNameLength || request.email.size() > kMaxEmailLength ||
+        request.age < 0) {
+        return UserStoreStatus::INVALID_ARGUMENT;
+    }
+
+    Shard& shard = *shards_[ShardOf(request.user_id)];
+    EpochManager::Guard pin = epochs_.Pin();
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+    Slot* slot = request.user_id != 0 ? shard.FindLocked(request.user_id) : nullptr;
+    if (!slot) {
+        return UserStoreStatus::NOT_FOUND;
+    }
+
+    // Only writers replace the head, and the write lock excludes them
+    const UserVersion& before = *slot->head.load(std::memory_order_relaxed);
+    UserFields fields = FieldsOf(before);
+    AvatarBlob::Retain(fields.avatar);
+    if (!request.name.empty()) {
+        fields.name = request.name;
+    }
+    if (!request.email.empty()) {
+        SetEmail(strings_, request.email, fields);
+    }
+    if (request.age != 0) {
+        fields.age = request.age;
+    }
+    fields.updated_at_ms = now_ms;
+    UserVersion* published = shard.NewVersion(fields);
+    shard.PublishIndexed(*slot, request.user_id, &before, published);
+    if (listener_ || change_listener_) {
+        UserRecord record;
+        ToRecord(strings_, request.user_id, *published, record);
+        record.avatar.clear();
+        if (listener_) {
+            uint64_t sequence = listener_(record, false);
+            if (write_sequence) {
+                *write_sequence = sequence;
+            }
+        }
+        if (change_listener_) {
+            change_listener_(record, false, false);
+        }
+    }
+    return UserStoreStatus::OK;
+}
+
+void UserStore::Restore(const UserRecord& record, bool set_avatar) {
+    Put(record, set_avatar, false, nullptr);
+}
+
+void UserStore::Promote(const UserRecord& record, uint64_t* write_sequence) {
+    Put(record, true, true, write_sequence);
+}
+
+void UserStore::Put(const UserRecord& record, bool set_avatar, bool logged, uint64_t* write_sequence) {
+    UserFields fields;
+    fields.created_at_ms = record.created_at_ms;
+    fields.updated_at_ms = record.updated_at_ms;
+    fields.age = record.age;
+    fields.name = std::string_view(record.name).substr(0, kMaxNameLength);
+    SetEmail(strings_, std::string_view(record.email).substr(0, kMaxEmailLength), fields);
+
+    Shard& shard = *shards_[ShardOf(record.user_id)];
+    EpochManager::Guard pin = epochs_.Pin();
+    std::lock_guard<std::mutex> lock(shard.write_mutex);
+    Slot* slot = shard.FindLocked(record.user_id);
+    const UserVersion* before = slot ? slot->head.load(std::memory_order_relaxed) : nullptr;
+    if (set_avatar) {
+        fields.avatar = AvatarBlob::Create(record.avatar);
+    } else if (before) {
+        fields.avatar = AvatarBlob::Retain(before->avatar);
+    }
+    if (!slot) {
+        slot = &shard.InsertLocked(record.user_id);
+    }
+    UserVersion* published = shard.NewVersion(fields);
+    shard.PublishIndexed(*slot, record.user_id, before, published);
+    if (logged && listener_) {
+        UserRecord written;
+        ToRecord(strings_, record.user_id, *published, written);
+        uint64_t sequence = listener_(written, true);
+        if (write_sequence) {
+            *write_sequence = sequence;
+        }
+    }
+
+    ReserveUserIds(record.user_id);
+}
+
+void UserStore::ReserveUserIds(uint64_t user_id) {
+    uint64_t next = next_user_id_.load(std::memory_order_relaxed);
+    while (next <= user_id &&
+           !next_user_id_.compare_exchange_weak(next, user_id + 1, std::memory_order_relaxed)) {
+    }
+}
+
+void UserStore::ForEach(const std::function<void(const UserRecord& record)>& visit) const {
+    ReadView view = OpenView();
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        ForEach(view, shard, visit);
+    }
+}
+
+void UserStore::ForEach(const ReadView& view, size_t shard,
+                        const std::function<void(const UserRecord& record)>& visit) const {
+    // Loaded after the view's timestamp: holds every version up to it
+    const Table* current = shards_[shard]->table.load(std::memory_order_acquire);
+    UserRecord record;
+    for (size_t i = 0; i <= current->mask; ++i) {
+        const Slot& slot = current->slots[i];
+        uint64_t key = slot.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+        const UserVersion* version = VersionAt(slot.head.load(std::memory_order_acquire), view.timestamp_);
+        if (version) {
+            ToRecord(strings_, key, *version, record);
+            visit(record);
+        }
+    }
+}
+
+bool UserStore::Get(uint64_t user_id, bool include_avatar, GetUserResponse& response) const {
+    EpochManager::Guard pin = epochs_.Pin();
+    const UserVersion* version =
+        user_id != 0 ? shards_[ShardOf(user_id)]->Read(user_id, UINT64_MAX) : nullptr;
+    if (!version) {
+        response.found = false;
+        return false;
+    }
+    ToResponse(strings_, user_id, *version, include_avatar, response);
+    return true;
+}
+
+UserStore::ReadView UserStore::OpenView() const {
+    // Pin first: versions the timestamp still needs cannot be retired yet
+    EpochManager::Guard pin = epochs_.Pin();
+    uint64_t timestamp = commit_ts_.load(std::memory_order_seq_cst);
+    return ReadView(std::move(pin), timestamp);
+}
+
+bool UserStore::Get(const ReadView& view, uint64_t user_id, bool include_avatar,
+                    GetUserResponse& response) const {
+    const UserVersion* version =
+        user_id != 0 ? shards_[ShardOf(user_id)]->Read(user_id, view.timestamp_) : nullptr;
+    if (!version) {
+        response.found = false;
+        return false;
+    }
+    ToResponse(strings_, user_id, *version, include_avatar, response);
+    return true;
+}
+
+void UserStore::PlanBatch(const std::vector<uint64_t>& user_ids, BatchPlan& plan) const {
+    // Counting sort by shard keeps each group in request order
+    plan.shard_begin.assign(shards_.size() + 1, 0);
+    for (uint64_t user_id : user_ids) {
+        ++plan.shard_begin[ShardOf(user_id) + 1];
+    }
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        plan.shard_begin[shard + 1] += plan.shard_begin[shard];
+    }
+    plan.order.resize(user_ids.size());
+    std::vector<uint32_t> cursor(plan.shard_begin.begin(), plan.shard_begin.end() - 1);
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+        plan.order[cursor[ShardOf(user_ids[i])]++] = static_cast<uint32_t>(i);
+    }
+}
+
+void UserStore::GetShardBatch(const ReadView& view, const BatchPlan& plan, size_t shard,
+                              const std::vector<uint64_t>& user_ids, bool include_avatar,
+                              std::vector<GetUserResponse>& responses) const {
+    // Slots far enough ahead to cover a memory miss, close enough to stay
+    // in L1; their versions once the slot has had half that time to arrive
+    constexpr uint32_t kSlotDistance = 8;
+    constexpr uint32_t kVersionDistance = 4;
+    const Shard& owner = *shards_[shard];
+    uint32_t begin = plan.shard_begin[shard];
+    uint32_t end = plan.shard_begin[shard + 1];
+    for (uint32_t i = begin; i < std::min(end, begin + kSlotDistance); ++i) {
+        owner.PrefetchSlot(user_ids[plan.order[i]]);
+    }
+    for (uint32_t i = begin; i < std::min(end, begin + kVersionDistance); ++i) {
+        owner.PrefetchVersion(user_ids[plan.order[i]]);
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+        if (i + kSlotDistance < end) {
+            owner.PrefetchSlot(user_ids[plan.order[i + kSlotDistance]]);
+        }
+        if (i + kVersionDistance < end) {
+            owner.PrefetchVersion(user_ids[plan.order[i + kVersionDistance]]);
+        }
+        uint32_t position = plan.order[i];
+        Get(view, user_ids[position], include_avatar, responses[position]);
+        responses[position].user_id = user_ids[position];
+    }
+}
+
+bool UserStore::FindByEmail(const std::string& email, bool include_avatar,
+                            GetUserResponse& response) const {
+    EpochManager::Guard pin = epochs_.Pin();
+    std::vector<uint64_t> candidates;
+    if (!email.empty()) {
+        email_index_.Find(email, [&](uint64_t user_id) {
+            candidates.push_back(user_id);
+            return true;
+        });
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (uint64_t user_id : candidates) {
+        if (Get(user_id, include_avatar, response) && response.email == email) {
+            return true;
+        }
+    }
+    response.found = false;
+    return false;
+}
+
+void UserStore::SearchByNamePrefix(const std::string& prefix, size_t limit,
+                                   SearchUsersResponse& response) const {
+    limit = std::min(limit, kMaxSearchResults);
+    response.users.clear();
+    response.more = false;
+    EpochManager::Guard pin = epochs_.Pin();
+    name_index_.FindPrefix(prefix, [&](std::string_view name, uint64_t user_id) {
+        const UserVersion* version = shards_[ShardOf(user_id)]->Read(user_id, UINT64_MAX);
+        if (!version || version->Name() != name) {
+            return true;   // stale entry
+        }
+        // A rename racing with the walk can show one user under both names
+        for (const UserSummary& seen : response.users) {
+            if (seen.user_id == user_id) {
+                return true;
+            }
+        }
+        if (response.users.size() == limit) {
+            response.more = true;
+            return false;
+        }
+        UserSummary summary;
+        summary.user_id = user_id;
+        summary.name.assign(name);
+        AssignEmail(strings_, *version, summary.email);
+        summary.age = version->age;
+        response.users.push_back(std::move(summary));
+        return true;
+    });
+}
+
+size_t UserStore::Size() const {
+    size_t size = 0;
+    for (const auto& shard : shards_) {
+        size += shard->count.load(std::memory_order_relaxed);
+    }
+    return size;
+}
+
+UserStoreMemory UserStore::GetMemoryUsage() const {
+    UserStoreMemory usage;
+    for (const auto& shard : shards_) {
+        usage.record_bytes += shard->arena.BytesInUse();
+        usage.arena_bytes += shard->arena.BytesReserved();
+        std::lock_guard<std::mutex> lock(shard->write_mutex);
+        usage.table_bytes += (shard->table.load(std::memory_order_relaxed)->mask + 1) * sizeof(Slot);
+    }
+    usage.interned_bytes = strings_.Capacity();
+    usage.interned_strings = strings_.Size();
+    return usage;
+}
+
+std::string UserStoreStatusToString(UserStoreStatus status) {
+    switch (status) {
+        case UserStoreStatus::OK:               return "OK";
+        case UserStoreStatus::NOT_FOUND:        return "NOT_FOUND";
+        case UserStoreStatus::INVALID_ARGUMENT: return "INVALID_ARGUMENT";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace grlrpc
@@ -0,0 +1,382 @@
+// GrlRPC User Tier Implementation
+
+#include "user_tier.h"
+
+#include <algorithm>
+
+namespace grlrpc {
+
+namespace {
+
+// Map node, entry and queue slot, roughly
+constexpr size_t kEntryOverhead = 96;
+constexpr uint8_t kMaxFrequency = 3;
+
+size_t MixId(uint64_t user_id) {
+    user_id ^= user_id >> 33;
+    user_id *= 0xff51afd7ed558ccdull;
+    user_id ^= user_id >> 33;
+    return static_cast<size_t>(user_id);
+}
+
+bool DecodeResponse(std::string_view payload, uint64_t user_id, bool include_avatar,
+                    GetUserResponse& response) {
+    UserRecord record;
+    if (!UserColdStore::Decode(payload, record) || record.user_id != user_id) {
+        return false;
+    }
+    response.user_id = user_id;
+    response.found = true;
+    response.name = std::move(record.name);
+    response.email = std::move(record.email);
+    response.age = record.age;
+    response.created_at_ms = record.created_at_ms;
+    response.updated_at_ms = record.updated_at_ms;
+    if (include_avatar) {
+        response.avatar = std::move(record.avatar);
+    } else {
+        response.avatar.clear();
+    }
+    return true;
+}
+
+void NotFound(uint64_t user_id, GetUserResponse& response) {
+    response = GetUserResponse();
+    response.user_id = user_id;
+    response.found = false;
+}
+
+} // namespace
+
+// ============================================================================
+// UserCache
+// ============================================================================
+
+struct UserCache::Entry {
+    uint64_t user_id;
+    std::string payload;
+    size_t charge;
+    uint8_t frequency = 0;
+    bool erased = false;   // replaced or erased; freed when it leaves its queue
+};
+
+struct UserCache::Shard {
+    // Pop queue fronts until the shard fits; the mutex is held
+    void EvictLocked() {
+        while (small_bytes + main_bytes > capacity) {
+            if (small_bytes > small_capacity || main.empty()) {
+                EvictSmall();
+            } else {
+                EvictMain();
+            }
+        }
+    }
+
+    void EvictSmall() {
+        Entry* entry = small.front();
+        small.pop_front();
+        small_bytes -= entry->charge;
+        if (entry->erased) {
+            delete entry;
+        } else if (entry->frequency > 0) {
+            // Read again while in the small queue
+            entry->frequency = 0;
+            main.push_back(entry);
+            main_bytes += entry->charge;
+            ++stats.promotions;
+        } else {
+            Remember(entry->user_id);
+            entries.erase(entry->user_id);
+            delete entry;
+            ++stats.evictions;
+        }
+    }
+
+    void EvictMain() {
+        Entry* entry = main.front();
+        main.pop_front();
+        main_bytes -= entry->charge;
+        if (entry->erased) {
+            delete entry;
+        } else if (entry->frequency > 0) {
+            --entry->frequency;
+            main.push_back(entry);
+            main_bytes += entry->charge;
+        } else {
+            entries.erase(entry->user_id);
+            delete entry;
+            ++stats.evictions;
+        }
+    }
+
+    // The ghost queue holds about as many ids as the shard holds entries
+    void Remember(uint64_t user_id) {
+        ghost[user_id] = ++ghost_clock;
+        ghost_order.emplace_back(user_id, ghost_clock);
+        while (ghost_order.size() > std::max<size_t>(entries.size(), 16)) {
+            auto oldest = ghost_order.front();
+            ghost_order.pop_front();
+            auto it = ghost.find(oldest.first);
+            if (it != ghost.end() && it->second == oldest.second) {
+                ghost.erase(it);
+            }
+        }
+    }
+
+    ~Shard() {
+        for (Entry* entry : small) {
+            delete entry;
+        }
+        for (Entry* entry : main) {
+            delete entry;
+        }
+    }
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, Entry*> entries;
+    std::deque<Entry*> small;
+    std::deque<Entry*> main;
+    size_t small_bytes = 0;
+    size_t main_bytes = 0;
+    size_t capacity = 0;
+    size_t small_capacity = 0;
+    // Evicted ids with the clock value of their latest eviction
+    std::unordered_map<uint64_t, uint64_t> ghost;
+    std::deque<std::pair<uint64_t, uint64_t>> ghost_order;
+    uint64_t ghost_clock = 0;
+    UserCacheStats stats;
+};
+
+UserCache::UserCache(UserCacheConfig config) {
+    size_t shard_count = std::max<size_t>(config.shards, 1);
+    double small_ratio = std::min(std::max(config.small_ratio, 0.0), 1.0);
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->capacity = config.capacity_bytes / shard_count;
+        shard->small_capacity = static_cast<size_t>(shard->capacity * small_ratio);
+        shards_.push_back(std::move(shard));
+    }
+}
+
+UserCache::~UserCache() = default;
+
+UserCache::Shard& UserCache::ShardOf(uint64_t user_id) const {
+    return *shards_[MixId(user_id) % shards_.size()];
+}
+
+bool UserCache::Lookup(uint64_t user_id, const std::function<void(std::string_view payload)>& visit) {
+    Shard& shard = ShardOf(user_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(user_id);
+    if (it == shard.entries.end()) {
+        ++shard.stats.misses;
+        return false;
+    }
+    Entry* entry = it->second;
+    entry->frequency = std::min<uint8_t>(entry->frequency + 1, kMaxFrequency);
+    ++shard.stats.hits;
+    visit(entry->payload);
+    return true;
+}
+
+void UserCache::Insert(uint64_t user_id, std::string_view payload) {
+    Shard& shard = ShardOf(user_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t charge = payload.size() + kEntryOverhead;
+    if (charge > shard.capacity) {
+        return;
+    }
+    auto it = shard.entries.find(user_id);
+    if (it != shard.entries.end()) {
+        it->second->erased = true;
+        shard.entries.erase(it);
+    }
+    Entry* entry = new Entry{user_id, std::string(payload), charge};
+    shard.entries.emplace(user_id, entry);
+    ++shard.stats.inserts;
+    auto ghost = shard.ghost.find(user_id);
+    if (ghost != shard.ghost.end()) {
+        shard.ghost.erase(ghost);
+        shard.main.push_back(entry);
+        shard.main_bytes += charge;
+        ++shard.stats.ghost_hits;
+    } else {
+        shard.small.push_back(entry);
+        shard.small_bytes += charge;
+    }
+    shard.EvictLocked();
+}
+
+void UserCache::Erase(uint64_t user_id) {
+    Shard& shard = ShardOf(user_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(user_id);
+    if (it != shard.entries.end()) {
+        it->second->erased = true;
+        // The payload goes now; the rest when the entry leaves its queue
+        std::string().swap(it->second->payload);
+        shard.entries.erase(it);
+    }
+}
+
+UserCacheStats UserCache::GetStats() const {
+    UserCacheStats total;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        const UserCacheStats& stats = shard->stats;
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.inserts += stats.inserts;
+        total.promotions += stats.promotions;
+        total.ghost_hits += stats.ghost_hits;
+        total.evictions += stats.evictions;
+        total.bytes += shard->small_bytes + shard->main_bytes;
+        total.entries += shard->entries.size();
+    }
+    return total;
+}
+
+// ============================================================================
+// TieredUserStore
+// ============================================================================
+
+TieredUserStore::TieredUserStore(UserStore& store, const UserColdStore& cold, TierConfig config)
+    : store_(store), cold_(cold), cache_(config.cache) {
+    store_.ReserveUserIds(cold_.MaxUserId());
+    for (size_t i = 0; i < std::max<size_t>(config.io_threads, 1); ++i) {
+        io_threads_.emplace_back([this] { IoLoop(); });
+    }
+}
+
+TieredUserStore::~TieredUserStore() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    read_queued_.notify_all();
+    for (auto& thread : io_threads_) {
+        thread.join();
+    }
+}
+
+bool TieredUserStore::GetInMemory(uint64_t user_id, bool include_avatar, GetUserResponse& response) {
+    if (store_.Get(user_id, include_avatar, response)) {
+        resident_hits_.fetch_add(1, std::memory_order_relaxed);
+        response.user_id = user_id;
+        return true;
+    }
+    bool decoded = false;
+    bool hit = cache_.Lookup(user_id, [&](std::string_view payload) {
+        decoded = DecodeResponse(payload, user_id, include_avatar, response);
+    });
+    return hit && decoded;
+}
+
+void TieredUserStore::GetAsync(uint64_t user_id, bool include_avatar, GetCallback done) {
+    GetUserResponse response;
+    if (GetInMemory(user_id, include_avatar, response)) {
+        done(response);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Waiter>& waiters = pending_[user_id];
+        waiters.push_back(Waiter{include_avatar, std::move(done)});
+        if (waiters.size() > 1) {
+            coalesced_reads_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        read_queue_.push_back(user_id);
+    }
+    read_queued_.notify_one();
+}
+
+bool TieredUserStore::Get(uint64_t user_id, bool include_avatar, GetUserResponse& response) {
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool ready = false;
+    GetAsync(user_id, include_avatar, [&](GetUserResponse& result) {
+        response = std::move(result);
+        std::lock_guard<std::mutex> lock(mutex);
+        ready = true;
+        finished.notify_one();
+    });
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return ready; });
+    return response.found;
+}
+
+void TieredUserStore::IoLoop() {
+    std::string payload;
+    for (;;) {
+        uint64_t user_id = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            read_queued_.wait(lock, [this] { return stopping_ || !read_queue_.empty(); });
+            if (read_queue_.empty()) {
+                return;
+            }
+            user_id = read_queue_.front();
+            read_queue_.pop_front();
+        }
+
+        // The page faults of a cold record happen here, off the caller's thread
+        std::string_view record;
+        bool found = cold_.Find(user_id, record);
+        if (found) {
+            cold_reads_.fetch_add(1, std::memory_order_relaxed);
+            payload.assign(record);
+            cache_.Insert(user_id, payload);
+        }
+
+        std::vector<Waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = pending_.find(user_id);
+            waiters = std::move(it->second);
+            pending_.erase(it);
+        }
+        for (Waiter& waiter : waiters) {
+            GetUserResponse response;
+            if (!found || !DecodeResponse(payload, user_id, waiter.include_avatar, response)) {
+                NotFound(user_id, response);
+            }
+            waiter.done(response);
+        }
+    }
+}
+
+bool TieredUserStore::MakeResident(uint64_t user_id) {
+    GetUserResponse response;
+    std::lock_guard<std::mutex> lock(resident_locks_[MixId(user_id) % kResidentLockStripes]);
+    if (store_.Get(user_id, false, response)) {
+        return true;
+    }
+    std::string_view payload;
+    UserRecord record;
+    if (!cold_.Find(user_id, payload) || !UserColdStore::Decode(payload, record)) {
+        return false;
+    }
+    // Logged in full: later updates log only the changed fields, and a
+    // restart must find the avatar in the store, not behind it in the cold file
+    store_.Promote(record);
+    // The store answers for the user from now on
+    cache_.Erase(user_id);
+    made_resident_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+TierStats TieredUserStore::GetStats() const {
+    TierStats stats;
+    stats.resident_hits = resident_hits_.load(std::memory_order_relaxed);
+    stats.cache = cache_.GetStats();
+    stats.cold_reads = cold_reads_.load(std::memory_order_relaxed);
+    stats.coalesced_reads = coalesced_reads_.load(std::memory_order_relaxed);
+    stats.made_resident = made_resident_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.pending_reads = pending_.size();
+    return stats;
+}
+
+} // namespace grlrpc
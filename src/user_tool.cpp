@@ -0,0 +1,118 @@
+// GrlRPC User Tool
+// Offline bulk transfer between a data directory and an export file:
+//   grlrpc_user_tool export --data-dir DIR --file FILE [--threads T] [--shards S]
+//   grlrpc_user_tool import --data-dir DIR --file FILE [--threads T] [--shards S]
+// Both recover DIR first; run them while no server uses DIR. Import
+// overwrites users that already exist and ends with a snapshot of DIR.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "user_persistence.h"
+#include "user_store.h"
+
+namespace {
+
+struct Options {
+    std::string command;
+    std::string data_dir;
+    std::string file;
+    size_t threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 4;
+    size_t shards = 16;
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 2) {
+        return false;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            return false;
+        }
+        if (std::strcmp(arg, "--data-dir") == 0) {
+            options.data_dir = value;
+        } else if (std::strcmp(arg, "--file") == 0) {
+            options.file = value;
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--shards") == 0) {
+            options.shards = std::strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+        ++i;
+    }
+    return (options.command == "export" || options.command == "import") && !options.data_dir.empty() &&
+           !options.file.empty() && options.threads > 0 && options.shards > 0;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char* what, const grlrpc::BulkTransferStats& stats, double seconds) {
+    std::cout << what << " " << stats.users << " users (" << stats.bytes / (1024 * 1024) << " MB) in "
+              << seconds << " s, " << static_cast<uint64_t>(stats.users / std::max(seconds, 1e-9))
+              << " users/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: grlrpc_user_tool export|import --data-dir DIR --file FILE"
+                     " [--threads T] [--shards S]" << std::endl;
+        return 1;
+    }
+
+    grlrpc::UserStore store(options.shards);
+    grlrpc::PersistenceConfig config;
+    config.replay_threads = options.threads;
+    config.snapshot_threads = options.threads;
+    config.snapshot_interval = std::chrono::milliseconds(0);
+    grlrpc::UserPersistence persistence(store, options.data_dir, config);
+    grlrpc::BulkTransferConfig transfer;
+    transfer.threads = options.threads;
+    std::string error;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!persistence.Open(error)) {
+        std::cerr << "failed to open " << options.data_dir << ": " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Recovered " << store.Size() << " users in " << SecondsSince(start) << " s" << std::endl;
+
+    grlrpc::BulkTransferStats stats;
+    start = std::chrono::steady_clock::now();
+    if (options.command == "export") {
+        if (!grlrpc::ExportUsers(store, options.file, transfer, stats, error)) {
+            std::cerr << "export failed: " << error << std::endl;
+            return 1;
+        }
+        Report("Exported", stats, SecondsSince(start));
+        return 0;
+    }
+
+    if (!grlrpc::ImportUsers(store, options.file, transfer, stats, error)) {
+        std::cerr << "import failed: " << error << std::endl;
+        return 1;
+    }
+    Report("Imported", stats, SecondsSince(start));
+    start = std::chrono::steady_clock::now();
+    if (!persistence.Snapshot(error)) {
+        std::cerr << "snapshot failed: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Snapshot of " << store.Size() << " users written in " << SecondsSince(start) << " s"
+              << std::endl;
+    return 0;
+}
@@ -1,10 +1,1219 @@
 // GrlRPC User Type Serializers Implementation
-// This file will be implemented in task 11.2
 
 #include "user_type_serializers.h"
 
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
 namespace grlrpc {
 
-// Placeholder - will be implemented in task 11.2
+namespace {
+
+// ============================================================================
+// Binary encoding
+// The exact size is computed first, so the output is allocated once and
+// filled through a raw cursor
+// ============================================================================
+
+constexpr size_t kLengthSize = sizeof(uint32_t);
+
+template<typename T>
+char* Put(char* out, T value) {
+    auto bits = static_cast<std::make_unsigned_t<T>>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+    return out + sizeof(T);
+}
+
+char* Put(char* out, bool value) {
+    *out = value ? 1 : 0;
+    return out + 1;
+}
+
+char* Put(char* out, const std::string& value) {
+    out = Put(out, static_cast<uint32_t>(value.size()));
+    std::memcpy(out, value.data(), value.size());
+    return out + value.size();
+}
+
+size_t SizeOf(const std::string& value) {
+    return kLengthSize + value.size();
+}
+
+struct BinaryReader {
+    const char* pos;
+    const char* end;
+
+    size_t Remaining() const { return static_cast<size_t>(end - pos); }
+};
+
+template<typename T>
+bool Get(BinaryReader& in, T& value) {
+    using Bits = std::make_unsigned_t<T>;
+    if (in.Remaining() < sizeof(T)) {
+        return false;
+    }
+    Bits bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<Bits>(static_cast<uint8_t>(in.pos[i])) << (8 * i);
+    }
+    value = static_cast<T>(bits);
+    in.pos += sizeof(T);
+    return true;
+}
+
+bool Get(BinaryReader& in, bool& value) {
+    if (in.Remaining() < 1) {
+        return false;
+    }
+    value = *in.pos++ != 0;
+    return true;
+}
+
+bool Get(BinaryReader& in, std::string& value) {
+    uint32_t length = 0;
+    if (!Get(in, length) || in.Remaining() < length) {
+        return false;
+    }
+    value.assign(in.pos, length);
+    in.pos += length;
+    return true;
+}
+
+// ---- Messages, field by field in descriptor order ----
+
+size_t BinarySize(uint64_t) { return sizeof(uint64_t); }
+char* WriteBinary(char* out, uint64_t value) { return Put(out, value); }
+bool ReadBinary(BinaryReader& in, uint64_t& value) { return Get(in, value); }
+
+size_t BinarySize(const GetUserRequest&) {
+    return sizeof(uint64_t) + 1;
+}
+
+char* WriteBinary(char* out, const GetUserRequest& m) {
+    out = Put(out, m.user_id);
+    return Put(out, m.include_avatar);
+}
+
+bool ReadBinary(BinaryReader& in, GetUserRequest& m) {
+    return Get(in, m.user_id) && Get(in, m.include_avatar);
+}
+
+size_t BinarySize(const GetUserResponse& m) {
+    return sizeof(uint64_t) + 1 + SizeOf(m.name) + SizeOf(m.email) + sizeof(int32_t) +
+           2 * sizeof(int64_t) + SizeOf(m.avatar);
+}
+
+char* WriteBinary(char* out, const GetUserResponse& m) {
+    out = Put(out, m.user_id);
+    out = Put(out, m.found);
+    out = Put(out, m.name);
+    out = Put(out, m.email);
+    out = Put(out, m.age);
+    out = Put(out, m.created_at_ms);
+    out = Put(out, m.updated_at_ms);
+    return Put(out, m.avatar);
+}
+
+bool ReadBinary(BinaryReader& in, GetUserResponse& m) {
+    return Get(in, m.user_id) && Get(in, m.found) && Get(in, m.name) && Get(in, m.email) &&
+           Get(in, m.age) && Get(in, m.created_at_ms) && Get(in, m.updated_at_ms) &&
+           Get(in, m.avatar);
+}
+
+size_t BinarySize(const CreateUserRequest& m) {
+    return SizeOf(m.name) + SizeOf(m.email) + sizeof(int32_t) + SizeOf(m.avatar);
+}
+
+char* WriteBinary(char* out, const CreateUserRequest& m) {
+    out = Put(out, m.name);
+    out = Put(out, m.email);
+    out = Put(out, m.age);
+    return Put(out, m.avatar);
+}
+
+bool ReadBinary(BinaryReader& in, CreateUserRequest& m) {
+    return Get(in, m.name) && Get(in, m.email) && Get(in, m.age) && Get(in, m.avatar);
+}
+
+// CreateUserResponse and UpdateUserResponse share their layout
+template<typename Response>
+size_t ResultSize(const Response& m) {
+    return sizeof(uint64_t) + 1 + SizeOf(m.error);
+}
+
+template<typename Response>
+char* WriteResult(char* out, const Response& m) {
+    out = Put(out, m.user_id);
+    out = Put(out, m.success);
+    return Put(out, m.error);
+}
+
+template<typename Response>
+bool ReadResult(BinaryReader& in, Response& m) {
+    return Get(in, m.user_id) && Get(in, m.success) && Get(in, m.error);
+}
+
+size_t BinarySize(const CreateUserResponse& m) { return ResultSize(m); }
+char* WriteBinary(char* out, const CreateUserResponse& m) { return WriteResult(out, m); }
+bool ReadBinary(BinaryReader& in, CreateUserResponse& m) { return ReadResult(in, m); }
+
+size_t BinarySize(const UpdateUserRequest& m) {
+    return sizeof(uint64_t) + SizeOf(m.name) + SizeOf(m.email) + sizeof(int32_t);
+}
+
+char* WriteBinary(char* out, const UpdateUserRequest& m) {
+    out = Put(out, m.user_id);
+    out = Put(out, m.name);
+    out = Put(out, m.email);
+    return Put(out, m.age);
+}
+
+bool ReadBinary(BinaryReader& in, UpdateUserRequest& m) {
+    return Get(in, m.user_id) && Get(in, m.name) && Get(in, m.email) && Get(in, m.age);
+}
+
+size_t BinarySize(const UpdateUserResponse& m) { return ResultSize(m); }
+char* WriteBinary(char* out, const UpdateUserResponse& m) { return WriteResult(out, m); }
+bool ReadBinary(BinaryReader& in, UpdateUserResponse& m) { return ReadResult(in, m); }
+
+size_t BinarySize(const FindUserByEmailRequest& m) {
+    return SizeOf(m.email) + 1;
+}
+
+char* WriteBinary(char* out, const FindUserByEmailRequest& m) {
+    out = Put(out, m.email);
+    return Put(out, m.include_avatar);
+}
+
+bool ReadBinary(BinaryReader& in, FindUserByEmailRequest& m) {
+    return Get(in, m.email) && Get(in, m.include_avatar);
+}
+
+size_t BinarySize(const SearchUsersRequest& m) {
+    return SizeOf(m.name_prefix) + sizeof(uint32_t);
+}
+
+char* WriteBinary(char* out, const SearchUsersRequest& m) {
+    out = Put(out, m.name_prefix);
+    return Put(out, m.limit);
+}
+
+bool ReadBinary(BinaryReader& in, SearchUsersRequest& m) {
+    return Get(in, m.name_prefix) && Get(in, m.limit);
+}
+
+size_t BinarySize(const UserSummary& m) {
+    return sizeof(uint64_t) + SizeOf(m.name) + SizeOf(m.email) + sizeof(int32_t);
+}
+
+char* WriteBinary(char* out, const UserSummary& m) {
+    out = Put(out, m.user_id);
+    out = Put(out, m.name);
+    out = Put(out, m.email);
+    return Put(out, m.age);
+}
+
+bool ReadBinary(BinaryReader& in, UserSummary& m) {
+    return Get(in, m.user_id) && Get(in, m.name) && Get(in, m.email) && Get(in, m.age);
+}
+
+size_t BinarySize(const UserChangeEvent& m) {
+    return 2 * sizeof(uint64_t) + 1 + SizeOf(m.name) + SizeOf(m.email) + sizeof(int32_t) +
+           sizeof(int64_t) + 1;
+}
+
+char* WriteBinary(char* out, const UserChangeEvent& m) {
+    out = Put(out, m.user_id);
+    out = Put(out, m.sequence);
+    out = Put(out, m.created);
+    out = Put(out, m.name);
+    out = Put(out, m.email);
+    out = Put(out, m.age);
+    out = Put(out, m.updated_at_ms);
+    return Put(out, m.avatar_changed);
+}
+
+bool ReadBinary(BinaryReader& in, UserChangeEvent& m) {
+    return Get(in, m.user_id) && Get(in, m.sequence) && Get(in, m.created) && Get(in, m.name) &&
+           Get(in, m.email) && Get(in, m.age) && Get(in, m.updated_at_ms) && Get(in, m.avatar_changed);
+}
+
+// ---- Lists ----
+
+template<typename T>
+size_t ListSize(const std::vector<T>& items) {
+    size_t size = kLengthSize;
+    for (const T& item : items) {
+        size += BinarySize(item);
+    }
+    return size;
+}
+
+template<typename T>
+char* WriteList(char* out, const std::vector<T>& items) {
+    out = Put(out, static_cast<uint32_t>(items.size()));
+    for (const T& item : items) {
+        out = WriteBinary(out, item);
+    }
+    return out;
+}
+
+// A count the remaining input cannot hold is rejected before allocating
+template<typename T>
+bool ReadList(BinaryReader& in, std::vector<T>& items) {
+    uint32_t count = 0;
+    if (!Get(in, count) || count > in.Remaining() / BinarySize(T())) {
+        return false;
+    }
+    items.resize(count);
+    for (T& item : items) {
+        if (!ReadBinary(in, item)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BinarySize(const BatchGetUsersRequest& m) {
+    return ListSize(m.user_ids) + 1;
+}
+
+char* WriteBinary(char* out, const BatchGetUsersRequest& m) {
+    out = WriteList(out, m.user_ids);
+    return Put(out, m.include_avatar);
+}
+
+bool ReadBinary(BinaryReader& in, BatchGetUsersRequest& m) {
+    return ReadList(in, m.user_ids) && Get(in, m.include_avatar);
+}
+
+size_t BinarySize(const BatchGetUsersResponse& m) {
+    return ListSize(m.users);
+}
+
+char* WriteBinary(char* out, const BatchGetUsersResponse& m) {
+    return WriteList(out, m.users);
+}
+
+bool ReadBinary(BinaryReader& in, BatchGetUsersResponse& m) {
+    return ReadList(in, m.users);
+}
+
+size_t BinarySize(const SearchUsersResponse& m) {
+    return ListSize(m.users) + 1;
+}
+
+char* WriteBinary(char* out, const SearchUsersResponse& m) {
+    out = WriteList(out, m.users);
+    return Put(out, m.more);
+}
+
+bool ReadBinary(BinaryReader& in, SearchUsersResponse& m) {
+    return ReadList(in, m.users) && Get(in, m.more);
+}
+
+size_t BinarySize(const WatchUsersRequest& m) {
+    return 2 * sizeof(uint64_t) + ListSize(m.user_ids) + 2 * sizeof(uint32_t);
+}
+
+char* WriteBinary(char* out, const WatchUsersRequest& m) {
+    out = Put(out, m.after_sequence);
+    out = Put(out, m.incarnation);
+    out = WriteList(out, m.user_ids);
+    out = Put(out, m.max_events);
+    return Put(out, m.wait_ms);
+}
+
+bool ReadBinary(BinaryReader& in, WatchUsersRequest& m) {
+    return Get(in, m.after_sequence) && Get(in, m.incarnation) && ReadList(in, m.user_ids) &&
+           Get(in, m.max_events) && Get(in, m.wait_ms);
+}
+
+// The list is written out in full by WriteList(); the trailer alone lets
+// watch responses be assembled around events encoded earlier
+constexpr size_t kWatchTrailerSize = 2 * sizeof(uint64_t) + 1;
+
+char* WriteWatchTrailer(char* out, uint64_t next_sequence, bool gap, uint64_t incarnation) {
+    out = Put(out, next_sequence);
+    out = Put(out, gap);
+    return Put(out, incarnation);
+}
+
+size_t BinarySize(const WatchUsersResponse& m) {
+    return ListSize(m.events) + kWatchTrailerSize;
+}
+
+char* WriteBinary(char* out, const WatchUsersResponse& m) {
+    out = WriteList(out, m.events);
+    return WriteWatchTrailer(out, m.next_sequence, m.gap, m.incarnation);
+}
+
+bool ReadBinary(BinaryReader& in, WatchUsersResponse& m) {
+    return ReadList(in, m.events) && Get(in, m.next_sequence) && Get(in, m.gap) &&
+           Get(in, m.incarnation);
+}
+
+// ============================================================================
+// JSON writing
+// Output is reserved from a size hint up front; keys and punctuation are
+// appended as literals
+// ============================================================================
+
+constexpr size_t kMaxNumberLength = 20;
+
+template<size_t N>
+void AppendLiteral(std::string& out, const char (&text)[N]) {
+    out.append(text, N - 1);
+}
+
+template<typename T>
+void AppendNumber(std::string& out, T value) {
+    char buffer[kMaxNumberLength + 1];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+}
+
+void AppendBool(std::string& out, bool value) {
+    if (value) {
+        AppendLiteral(out, "true");
+    } else {
+        AppendLiteral(out, "false");
+    }
+}
+
+// Quotes, backslashes and control characters are escaped; everything else,
+// including UTF-8 sequences, is copied in runs
+void AppendString(std::string& out, const std::string& value) {
+    static const char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    const char* run = value.data();
+    const char* end = run + value.size();
+    for (const char* p = run; p != end; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(run, static_cast<size_t>(p - run));
+        switch (c) {
+            case '"':  AppendLiteral(out, "\\\""); break;
+            case '\\': AppendLiteral(out, "\\\\"); break;
+            case '\n': AppendLiteral(out, "\\n"); break;
+            case '\r': AppendLiteral(out, "\\r"); break;
+            case '\t': AppendLiteral(out, "\\t"); break;
+            case '\b': AppendLiteral(out, "\\b"); break;
+            case '\f': AppendLiteral(out, "\\f"); break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+        run = p + 1;
+    }
+    out.append(run, static_cast<size_t>(end - run));
+    out.push_back('"');
+}
+
+void AppendBytes(std::string& out, const std::string& value) {
+    out.push_back('"');
+    AppendBase64(value, out);
+    out.push_back('"');
+}
+
+// Room for quotes and a few escapes; longer output just grows the string
+size_t StringHint(const std::string& value) {
+    return value.size() + 8;
+}
+
+size_t BytesHint(const std::string& value) {
+    return (value.size() + 2) / 3 * 4 + 2;
+}
+
+size_t JsonSizeHint(uint64_t) { return kMaxNumberLength; }
+void WriteJson(std::string& out, uint64_t value) { AppendNumber(out, value); }
+
+size_t JsonSizeHint(const GetUserRequest&) {
+    return 48 + kMaxNumberLength;
+}
+
+void WriteJson(std::string& out, const GetUserRequest& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"include_avatar\":");
+    AppendBool(out, m.include_avatar);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const GetUserResponse& m) {
+    return 112 + 4 * kMaxNumberLength + StringHint(m.name) + StringHint(m.email) +
+           BytesHint(m.avatar);
+}
+
+void WriteJson(std::string& out, const GetUserResponse& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"found\":");
+    AppendBool(out, m.found);
+    AppendLiteral(out, ",\"name\":");
+    AppendString(out, m.name);
+    AppendLiteral(out, ",\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"age\":");
+    AppendNumber(out, m.age);
+    AppendLiteral(out, ",\"created_at_ms\":");
+    AppendNumber(out, m.created_at_ms);
+    AppendLiteral(out, ",\"updated_at_ms\":");
+    AppendNumber(out, m.updated_at_ms);
+    AppendLiteral(out, ",\"avatar\":");
+    AppendBytes(out, m.avatar);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const CreateUserRequest& m) {
+    return 48 + kMaxNumberLength + StringHint(m.name) + StringHint(m.email) + BytesHint(m.avatar);
+}
+
+void WriteJson(std::string& out, const CreateUserRequest& m) {
+    AppendLiteral(out, "{\"name\":");
+    AppendString(out, m.name);
+    AppendLiteral(out, ",\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"age\":");
+    AppendNumber(out, m.age);
+    AppendLiteral(out, ",\"avatar\":");
+    AppendBytes(out, m.avatar);
+    out.push_back('}');
+}
+
+template<typename Response>
+size_t ResultHint(const Response& m) {
+    return 48 + kMaxNumberLength + StringHint(m.error);
+}
+
+template<typename Response>
+void WriteResultJson(std::string& out, const Response& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"success\":");
+    AppendBool(out, m.success);
+    AppendLiteral(out, ",\"error\":");
+    AppendString(out, m.error);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const CreateUserResponse& m) { return ResultHint(m); }
+void WriteJson(std::string& out, const CreateUserResponse& m) { WriteResultJson(out, m); }
+
+size_t JsonSizeHint(const UpdateUserRequest& m) {
+    return 48 + 2 * kMaxNumberLength + StringHint(m.name) + StringHint(m.email);
+}
+
+void WriteJson(std::string& out, const UpdateUserRequest& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"name\":");
+    AppendString(out, m.name);
+    AppendLiteral(out, ",\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"age\":");
+    AppendNumber(out, m.age);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const UpdateUserResponse& m) { return ResultHint(m); }
+void WriteJson(std::string& out, const UpdateUserResponse& m) { WriteResultJson(out, m); }
+
+size_t JsonSizeHint(const FindUserByEmailRequest& m) {
+    return 40 + StringHint(m.email);
+}
+
+void WriteJson(std::string& out, const FindUserByEmailRequest& m) {
+    AppendLiteral(out, "{\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"include_avatar\":");
+    AppendBool(out, m.include_avatar);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const SearchUsersRequest& m) {
+    return 32 + kMaxNumberLength + StringHint(m.name_prefix);
+}
+
+void WriteJson(std::string& out, const SearchUsersRequest& m) {
+    AppendLiteral(out, "{\"name_prefix\":");
+    AppendString(out, m.name_prefix);
+    AppendLiteral(out, ",\"limit\":");
+    AppendNumber(out, m.limit);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const UserSummary& m) {
+    return 40 + 2 * kMaxNumberLength + StringHint(m.name) + StringHint(m.email);
+}
+
+void WriteJson(std::string& out, const UserSummary& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"name\":");
+    AppendString(out, m.name);
+    AppendLiteral(out, ",\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"age\":");
+    AppendNumber(out, m.age);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const UserChangeEvent& m) {
+    return 128 + 4 * kMaxNumberLength + StringHint(m.name) + StringHint(m.email);
+}
+
+void WriteJson(std::string& out, const UserChangeEvent& m) {
+    AppendLiteral(out, "{\"user_id\":");
+    AppendNumber(out, m.user_id);
+    AppendLiteral(out, ",\"sequence\":");
+    AppendNumber(out, m.sequence);
+    AppendLiteral(out, ",\"created\":");
+    AppendBool(out, m.created);
+    AppendLiteral(out, ",\"name\":");
+    AppendString(out, m.name);
+    AppendLiteral(out, ",\"email\":");
+    AppendString(out, m.email);
+    AppendLiteral(out, ",\"age\":");
+    AppendNumber(out, m.age);
+    AppendLiteral(out, ",\"updated_at_ms\":");
+    AppendNumber(out, m.updated_at_ms);
+    AppendLiteral(out, ",\"avatar_changed\":");
+    AppendBool(out, m.avatar_changed);
+    out.push_back('}');
+}
+
+template<typename T>
+size_t ListHint(const std::vector<T>& items) {
+    size_t size = 2;
+    for (const T& item : items) {
+        size += JsonSizeHint(item) + 1;
+    }
+    return size;
+}
+
+template<typename T>
+void WriteJsonList(std::string& out, const std::vector<T>& items) {
+    out.push_back('[');
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i != 0) {
+            out.push_back(',');
+        }
+        WriteJson(out, items[i]);
+    }
+    out.push_back(']');
+}
+
+size_t JsonSizeHint(const BatchGetUsersRequest& m) {
+    return 40 + ListHint(m.user_ids);
+}
+
+void WriteJson(std::string& out, const BatchGetUsersRequest& m) {
+    AppendLiteral(out, "{\"user_ids\":");
+    WriteJsonList(out, m.user_ids);
+    AppendLiteral(out, ",\"include_avatar\":");
+    AppendBool(out, m.include_avatar);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const BatchGetUsersResponse& m) {
+    return 16 + ListHint(m.users);
+}
+
+void WriteJson(std::string& out, const BatchGetUsersResponse& m) {
+    AppendLiteral(out, "{\"users\":");
+    WriteJsonList(out, m.users);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const SearchUsersResponse& m) {
+    return 32 + ListHint(m.users);
+}
+
+void WriteJson(std::string& out, const SearchUsersResponse& m) {
+    AppendLiteral(out, "{\"users\":");
+    WriteJsonList(out, m.users);
+    AppendLiteral(out, ",\"more\":");
+    AppendBool(out, m.more);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const WatchUsersRequest& m) {
+    return 96 + 4 * kMaxNumberLength + ListHint(m.user_ids);
+}
+
+void WriteJson(std::string& out, const WatchUsersRequest& m) {
+    AppendLiteral(out, "{\"after_sequence\":");
+    AppendNumber(out, m.after_sequence);
+    AppendLiteral(out, ",\"incarnation\":");
+    AppendNumber(out, m.incarnation);
+    AppendLiteral(out, ",\"user_ids\":");
+    WriteJsonList(out, m.user_ids);
+    AppendLiteral(out, ",\"max_events\":");
+    AppendNumber(out, m.max_events);
+    AppendLiteral(out, ",\"wait_ms\":");
+    AppendNumber(out, m.wait_ms);
+    out.push_back('}');
+}
+
+// As with the binary trailer, split so watch responses can be assembled
+// around events encoded earlier: head, events array, tail
+constexpr size_t kWatchJsonFrameHint = 64 + 2 * kMaxNumberLength;
+
+void WriteWatchJsonHead(std::string& out) {
+    AppendLiteral(out, "{\"events\":");
+}
+
+void WriteWatchJsonTail(std::string& out, uint64_t next_sequence, bool gap, uint64_t incarnation) {
+    AppendLiteral(out, ",\"next_sequence\":");
+    AppendNumber(out, next_sequence);
+    AppendLiteral(out, ",\"gap\":");
+    AppendBool(out, gap);
+    AppendLiteral(out, ",\"incarnation\":");
+    AppendNumber(out, incarnation);
+    out.push_back('}');
+}
+
+size_t JsonSizeHint(const WatchUsersResponse& m) {
+    return kWatchJsonFrameHint + ListHint(m.events);
+}
+
+void WriteJson(std::string& out, const WatchUsersResponse& m) {
+    WriteWatchJsonHead(out);
+    WriteJsonList(out, m.events);
+    WriteWatchJsonTail(out, m.next_sequence, m.gap, m.incarnation);
+}
+
+// ============================================================================
+// JSON reading
+// A small pull parser: members are matched by name as they are read, with
+// no intermediate document. Same rules as JsonSerializer: missing (or null)
+// members keep their default, unknown members are skipped and a value of
+// the wrong type fails the message.
+// ============================================================================
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& input)
+        : pos_(input.data()), end_(input.data() + input.size()) {}
+
+    // Only whitespace may follow the top-level value
+    bool AtEnd() {
+        SkipSpace();
+        return pos_ == end_;
+    }
+
+    bool Consume(char c) {
+        SkipSpace();
+        if (pos_ != end_ && *pos_ == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool Read(uint64_t& value) { return ReadInteger(value); }
+    bool Read(int64_t& value) { return ReadInteger(value); }
+    bool Read(uint32_t& value) { return ReadInteger(value); }
+    bool Read(int32_t& value) { return ReadInteger(value); }
+
+    bool Read(bool& value) {
+        SkipSpace();
+        if (MatchLiteral("true")) {
+            value = true;
+            return true;
+        }
+        value = false;
+        return MatchLiteral("false");
+    }
+
+    bool Read(std::string& value) {
+        return Consume('"') && ReadStringBody(value);
+    }
+
+    // Base64 in a JSON string
+    bool ReadBytes(std::string& value) {
+        return Read(scratch_) && Base64Decode(scratch_, value);
+    }
+
+    /**
+     * @brief Read an object, calling member(name) with the reader at each
+     *        member's value; null members are skipped
+     */
+    template<typename Member>
+    bool ReadObject(Member&& member) {
+        if (!Consume('{')) {
+            return false;
+        }
+        if (Consume('}')) {
+            return true;
+        }
+        do {
+            if (!Read(key_) || !Consume(':')) {
+                return false;
+            }
+            SkipSpace();
+            if (MatchLiteral("null")) {
+                continue;
+            }
+            if (!member(std::string_view(key_))) {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+    template<typename Element>
+    bool ReadArray(Element&& element) {
+        if (!Consume('[')) {
+            return false;
+        }
+        if (Consume(']')) {
+            return true;
+        }
+        do {
+            if (!element()) {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume(']');
+    }
+
+    // Skip a value of any type, e.g. an unknown member
+    bool Skip(int depth = 0) {
+        SkipSpace();
+        if (pos_ == end_ || depth > kMaxDepth) {
+            return false;
+        }
+        switch (*pos_) {
+            case '"': return Read(scratch_);
+            case '{': return ReadObject([this, depth](std::string_view) { return Skip(depth + 1); });
+            case '[': return ReadArray([this, depth] { return Skip(depth + 1); });
+            case 't': return MatchLiteral("true");
+            case 'f': return MatchLiteral("false");
+            case 'n': return MatchLiteral("null");
+            default: {
+                const char* start = pos_;
+                while (pos_ != end_ && ((*pos_ >= '0' && *pos_ <= '9') || *pos_ == '-' ||
+                                        *pos_ == '+' || *pos_ == '.' || *pos_ == 'e' || *pos_ == 'E')) {
+                    ++pos_;
+                }
+                return pos_ != start;
+            }
+        }
+    }
+
+private:
+    static constexpr int kMaxDepth = 64;
+
+    void SkipSpace() {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+            ++pos_;
+        }
+    }
+
+    template<size_t N>
+    bool MatchLiteral(const char (&text)[N]) {
+        if (static_cast<size_t>(end_ - pos_) < N - 1 || std::memcmp(pos_, text, N - 1) != 0) {
+            return false;
+        }
+        pos_ += N - 1;
+        return true;
+    }
+
+    // Integers only, as JsonSerializer requires for integer fields
+    template<typename T>
+    bool ReadInteger(T& value) {
+        SkipSpace();
+        std::from_chars_result result = std::from_chars(pos_, end_, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        pos_ = result.ptr;
+        return true;
+    }
+
+    // After the opening quote; unescaped runs are copied in one go
+    bool ReadStringBody(std::string& value) {
+        value.clear();
+        const char* run = pos_;
+        while (pos_ != end_) {
+            char c = *pos_;
+            if (c == '"') {
+                value.append(run, static_cast<size_t>(pos_ - run));
+                ++pos_;
+                return true;
+            }
+            if (c != '\\') {
+                ++pos_;
+                continue;
+            }
+            value.append(run, static_cast<size_t>(pos_ - run));
+            if (++pos_ == end_) {
+                return false;
+            }
+            switch (*pos_++) {
+                case '"':  value.push_back('"'); break;
+                case '\\': value.push_back('\\'); break;
+                case '/':  value.push_back('/'); break;
+                case 'b':  value.push_back('\b'); break;
+                case 'f':  value.push_back('\f'); break;
+                case 'n':  value.push_back('\n'); break;
+                case 'r':  value.push_back('\r'); break;
+                case 't':  value.push_back('\t'); break;
+                case 'u':
+                    if (!ReadUnicodeEscape(value)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+            run = pos_;
+        }
+        return false;
+    }
+
+    bool ReadHex4(uint32_t& code) {
+        if (end_ - pos_ < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *pos_++;
+            char lower = static_cast<char>(c | 0x20);
+            uint32_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<uint32_t>(c - '0');
+            } else if (lower >= 'a' && lower <= 'f') {
+                digit = static_cast<uint32_t>(lower - 'a' + 10);
+            } else {
+                return false;
+            }
+            code = (code << 4) | digit;
+        }
+        return true;
+    }
+
+    // \uXXXX appended as UTF-8; surrogate pairs are combined, lone halves rejected
+    bool ReadUnicodeEscape(std::string& value) {
+        uint32_t code = 0;
+        if (!ReadHex4(code) || (code >= 0xDC00 && code < 0xE000)) {
+            return false;
+        }
+        if (code >= 0xD800 && code < 0xDC00) {
+            uint32_t low = 0;
+            if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u') {
+                return false;
+            }
+            pos_ += 2;
+            if (!ReadHex4(low) || low < 0xDC00 || low >= 0xE000) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (code < 0x80) {
+            value.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            value.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            value.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            value.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            value.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            value.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            value.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            value.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            value.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            value.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+
+    const char* pos_;
+    const char* end_;
+    std::string key_;
+    std::string scratch_;
+};
+
+bool ReadJson(JsonReader& in, uint64_t& value) {
+    return in.Read(value);
+}
+
+bool ReadJson(JsonReader& in, GetUserRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "include_avatar") return in.Read(m.include_avatar);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, GetUserResponse& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "found") return in.Read(m.found);
+        if (key == "name") return in.Read(m.name);
+        if (key == "email") return in.Read(m.email);
+        if (key == "age") return in.Read(m.age);
+        if (key == "created_at_ms") return in.Read(m.created_at_ms);
+        if (key == "updated_at_ms") return in.Read(m.updated_at_ms);
+        if (key == "avatar") return in.ReadBytes(m.avatar);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, CreateUserRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "name") return in.Read(m.name);
+        if (key == "email") return in.Read(m.email);
+        if (key == "age") return in.Read(m.age);
+        if (key == "avatar") return in.ReadBytes(m.avatar);
+        return in.Skip();
+    });
+}
+
+template<typename Response>
+bool ReadResultJson(JsonReader& in, Response& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "success") return in.Read(m.success);
+        if (key == "error") return in.Read(m.error);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, CreateUserResponse& m) { return ReadResultJson(in, m); }
+bool ReadJson(JsonReader& in, UpdateUserResponse& m) { return ReadResultJson(in, m); }
+
+bool ReadJson(JsonReader& in, UpdateUserRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "name") return in.Read(m.name);
+        if (key == "email") return in.Read(m.email);
+        if (key == "age") return in.Read(m.age);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, FindUserByEmailRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "email") return in.Read(m.email);
+        if (key == "include_avatar") return in.Read(m.include_avatar);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, SearchUsersRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "name_prefix") return in.Read(m.name_prefix);
+        if (key == "limit") return in.Read(m.limit);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, UserSummary& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "name") return in.Read(m.name);
+        if (key == "email") return in.Read(m.email);
+        if (key == "age") return in.Read(m.age);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, UserChangeEvent& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_id") return in.Read(m.user_id);
+        if (key == "sequence") return in.Read(m.sequence);
+        if (key == "created") return in.Read(m.created);
+        if (key == "name") return in.Read(m.name);
+        if (key == "email") return in.Read(m.email);
+        if (key == "age") return in.Read(m.age);
+        if (key == "updated_at_ms") return in.Read(m.updated_at_ms);
+        if (key == "avatar_changed") return in.Read(m.avatar_changed);
+        return in.Skip();
+    });
+}
+
+template<typename T>
+bool ReadJsonList(JsonReader& in, std::vector<T>& items) {
+    items.clear();
+    return in.ReadArray([&] {
+        items.emplace_back();
+        return ReadJson(in, items.back());
+    });
+}
+
+bool ReadJson(JsonReader& in, BatchGetUsersRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "user_ids") return ReadJsonList(in, m.user_ids);
+        if (key == "include_avatar") return in.Read(m.include_avatar);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, BatchGetUsersResponse& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "users") return ReadJsonList(in, m.users);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, SearchUsersResponse& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "users") return ReadJsonList(in, m.users);
+        if (key == "more") return in.Read(m.more);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, WatchUsersRequest& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "after_sequence") return in.Read(m.after_sequence);
+        if (key == "incarnation") return in.Read(m.incarnation);
+        if (key == "user_ids") return ReadJsonList(in, m.user_ids);
+        if (key == "max_events") return in.Read(m.max_events);
+        if (key == "wait_ms") return in.Read(m.wait_ms);
+        return in.Skip();
+    });
+}
+
+bool ReadJson(JsonReader& in, WatchUsersResponse& m) {
+    return in.ReadObject([&](std::string_view key) {
+        if (key == "events") return ReadJsonList(in, m.events);
+        if (key == "next_sequence") return in.Read(m.next_sequence);
+        if (key == "gap") return in.Read(m.gap);
+        if (key == "incarnation") return in.Read(m.incarnation);
+        return in.Skip();
+    });
+}
+
+// ============================================================================
+// Serializers
+// ============================================================================
+
+template<typename T>
+class BinaryTypeSerializer : public ITypeSerializer<T> {
+public:
+    bool Serialize(const T& obj, std::string& output) override {
+        output.resize(BinarySize(obj));
+        WriteBinary(&output[0], obj);
+        return true;
+    }
+
+    // Every field is overwritten, so obj needs no reset; trailing bytes fail
+    bool Deserialize(const std::string& input, T& obj) override {
+        BinaryReader in{input.data(), input.data() + input.size()};
+        return ReadBinary(in, obj) && in.pos == in.end;
+    }
+
+    std::string GetName() const override { return "binary"; }
+};
+
+template<typename T>
+class JsonTypeSerializer : public ITypeSerializer<T> {
+public:
+    bool Serialize(const T& obj, std::string& output) override {
+        output.clear();
+        output.reserve(JsonSizeHint(obj));
+        WriteJson(output, obj);
+        return true;
+    }
+
+    bool Deserialize(const std::string& input, T& obj) override {
+        obj = T();
+        JsonReader in(input);
+        return ReadJson(in, obj) && in.AtEnd();
+    }
+
+    std::string GetName() const override { return "json"; }
+};
+
+template<typename T>
+void RegisterIfMissing(SerializerRegistry& registry) {
+    if (!registry.HasTypeSerializer<T>("binary")) {
+        registry.RegisterTypeSerializer<T>("binary", std::make_unique<BinaryTypeSerializer<T>>());
+    }
+    if (!registry.HasTypeSerializer<T>("json")) {
+        registry.RegisterTypeSerializer<T>("json", std::make_unique<JsonTypeSerializer<T>>());
+    }
+}
+
+} // namespace
+
+void RegisterUserTypeSerializers() {
+    auto& registry = SerializerRegistry::Instance();
+    RegisterIfMissing<GetUserRequest>(registry);
+    RegisterIfMissing<GetUserResponse>(registry);
+    RegisterIfMissing<CreateUserRequest>(registry);
+    RegisterIfMissing<CreateUserResponse>(registry);
+    RegisterIfMissing<UpdateUserRequest>(registry);
+    RegisterIfMissing<UpdateUserResponse>(registry);
+    RegisterIfMissing<BatchGetUsersRequest>(registry);
+    RegisterIfMissing<BatchGetUsersResponse>(registry);
+    RegisterIfMissing<FindUserByEmailRequest>(registry);
+    RegisterIfMissing<SearchUsersRequest>(registry);
+    RegisterIfMissing<SearchUsersResponse>(registry);
+    RegisterIfMissing<WatchUsersRequest>(registry);
+    RegisterIfMissing<WatchUsersResponse>(registry);
+}
+
+bool EncodeUserChangeEvent(const std::string& format, const UserChangeEvent& event, std::string& out) {
+    if (format == "binary") {
+        out.resize(BinarySize(event));
+        WriteBinary(&out[0], event);
+        return true;
+    }
+    if (format == "json") {
+        out.clear();
+        out.reserve(JsonSizeHint(event));
+        WriteJson(out, event);
+        return true;
+    }
+    return false;
+}
+
+bool AssembleWatchUsersResponse(const std::string& format, const std::vector<std::string_view>& events,
+                                uint64_t next_sequence, bool gap, uint64_t incarnation, std::string& out) {
+    size_t size = 0;
+    for (std::string_view event : events) {
+        size += event.size() + 1;
+    }
+    if (format == "binary") {
+        out.resize(kLengthSize + size - events.size() + kWatchTrailerSize);
+        char* cursor = Put(&out[0], static_cast<uint32_t>(events.size()));
+        for (std::string_view event : events) {
+            std::memcpy(cursor, event.data(), event.size());
+            cursor += event.size();
+        }
+        WriteWatchTrailer(cursor, next_sequence, gap, incarnation);
+        return true;
+    }
+    if (format == "json") {
+        out.clear();
+        out.reserve(kWatchJsonFrameHint + 2 + size);
+        WriteWatchJsonHead(out);
+        out.push_back('[');
+        for (size_t i = 0; i < events.size(); ++i) {
+            if (i != 0) {
+                out.push_back(',');
+            }
+            out.append(events[i]);
+        }
+        out.push_back(']');
+        WriteWatchJsonTail(out, next_sequence, gap, incarnation);
+        return true;
+    }
+    return false;
+}
 
 } // namespace grlrpc
@@ -1,10 +1,85 @@
 // GrlRPC User Types Implementation
-// This file will be implemented in task 11.1
 
 #include "user_types.h"
+#include "serialization_framework.h"
+#include "user_type_serializers.h"
 
 namespace grlrpc {
 
-// Placeholder - will be implemented in task 11.1
+namespace {
+
+// Descriptors are registered under the demangled name SerializerFactory
+// and SerializerHandle look up ("grlrpc::GetUserRequest")
+template<typename T>
+void RegisterDescriptor(MessageDescriptor& desc) {
+    desc.message_name = SerializerFactory::GetDemangled<T>();
+    ReflectionRegistry::Instance().RegisterType(desc.message_name, desc);
+}
+
+} // namespace
+
+void RegisterUserTypes() {
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, GetUserRequest, user_id, FieldType::UINT64, 1);
+        GRLRPC_REGISTER_FIELD(desc, GetUserRequest, include_avatar, FieldType::BOOL, 2);
+        RegisterDescriptor<GetUserRequest>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, user_id, FieldType::UINT64, 1);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, found, FieldType::BOOL, 2);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, name, FieldType::STRING, 3);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, email, FieldType::STRING, 4);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, age, FieldType::INT32, 5);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, created_at_ms, FieldType::INT64, 6);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, updated_at_ms, FieldType::INT64, 7);
+        GRLRPC_REGISTER_FIELD(desc, GetUserResponse, avatar, FieldType::BYTES, 8);
+        RegisterDescriptor<GetUserResponse>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, CreateUserRequest, name, FieldType::STRING, 1);
+        GRLRPC_REGISTER_FIELD(desc, CreateUserRequest, email, FieldType::STRING, 2);
+        GRLRPC_REGISTER_FIELD(desc, CreateUserRequest, age, FieldType::INT32, 3);
+        GRLRPC_REGISTER_FIELD(desc, CreateUserRequest, avatar, FieldType::BYTES, 4);
+        RegisterDescriptor<CreateUserRequest>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, CreateUserResponse, user_id, FieldType::UINT64, 1);
+        GRLRPC_REGISTER_FIELD(desc, CreateUserResponse, success, FieldType::BOOL, 2);
+        GRLRPC_REGISTER_FIELD(desc, CreateUserResponse, error, FieldType::STRING, 3);
+        RegisterDescriptor<CreateUserResponse>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserRequest, user_id, FieldType::UINT64, 1);
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserRequest, name, FieldType::STRING, 2);
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserRequest, email, FieldType::STRING, 3);
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserRequest, age, FieldType::INT32, 4);
+        RegisterDescriptor<UpdateUserRequest>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserResponse, user_id, FieldType::UINT64, 1);
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserResponse, success, FieldType::BOOL, 2);
+        GRLRPC_REGISTER_FIELD(desc, UpdateUserResponse, error, FieldType::STRING, 3);
+        RegisterDescriptor<UpdateUserResponse>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, FindUserByEmailRequest, email, FieldType::STRING, 1);
+        GRLRPC_REGISTER_FIELD(desc, FindUserByEmailRequest, include_avatar, FieldType::BOOL, 2);
+        RegisterDescriptor<FindUserByEmailRequest>(desc);
+    }
+    {
+        MessageDescriptor desc;
+        GRLRPC_REGISTER_FIELD(desc, SearchUsersRequest, name_prefix, FieldType::STRING, 1);
+        GRLRPC_REGISTER_FIELD(desc, SearchUsersRequest, limit, FieldType::UINT32, 2);
+        RegisterDescriptor<SearchUsersRequest>(desc);
+    }
+    RegisterUserTypeSerializers();
+}
 
 } // namespace grlrpc
@@ -0,0 +1,139 @@
+// GrlRPC User Watch Implementation
+
+#include "user_watch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string_view>
+
+#include "user_type_serializers.h"
+
+namespace grlrpc {
+
+namespace {
+
+uint64_t NewIncarnation() {
+    // The clock covers a random_device that is deterministic on some platforms
+    std::random_device device;
+    uint64_t incarnation = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                           static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    return incarnation != 0 ? incarnation : 1;
+}
+
+} // namespace
+
+// ============================================================================
+// UserWatchHub
+// ============================================================================
+
+UserWatchHub::UserWatchHub(UserStore& store, size_t capacity)
+    : store_(store), incarnation_(NewIncarnation()), ring_(std::max<size_t>(capacity, 1)) {
+    store_.SetChangeListener([this](const UserRecord& record, bool created, bool avatar_changed) {
+        Publish(record, created, avatar_changed);
+    });
+}
+
+UserWatchHub::~UserWatchHub() {
+    store_.SetChangeListener(nullptr);
+    Close();
+}
+
+void UserWatchHub::Publish(const UserRecord& record, bool created, bool avatar_changed) {
+    UserChangeEvent change;
+    change.user_id = record.user_id;
+    change.created = created;
+    change.name = record.name;
+    change.email = record.email;
+    change.age = record.age;
+    change.updated_at_ms = record.updated_at_ms;
+    change.avatar_changed = avatar_changed;
+
+    auto event = std::make_shared<Event>();
+    event->user_id = record.user_id;
+    {
+        // The sequence is part of the encoding, so events are encoded under
+        // the lock that orders them; a few hundred nanoseconds per write
+        std::lock_guard<std::mutex> lock(mutex_);
+        change.sequence = ++last_sequence_;
+        EncodeUserChangeEvent("binary", change, event->binary);
+        EncodeUserChangeEvent("json", change, event->json);
+        ring_[change.sequence % ring_.size()] = std::move(event);
+    }
+    published_.notify_all();
+}
+
+bool UserWatchHub::Watch(const WatchUsersRequest& request, const std::string& format,
+                         std::string& payload) {
+    bool binary = format == "binary";
+    if (!binary && format != "json") {
+        return false;
+    }
+
+    std::vector<uint64_t> filter = request.user_ids;
+    std::sort(filter.begin(), filter.end());
+    size_t max_events = std::min<size_t>(request.max_events, kMaxEventsPerResponse);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::min(request.wait_ms, kMaxWaitMs));
+
+    // References keep the encoded events alive after the lock is dropped,
+    // even if the ring overwrites them meanwhile
+    std::vector<std::shared_ptr<const Event>> events;
+    uint64_t position = request.after_sequence;
+    bool gap = false;
+    if (request.incarnation != 0 && request.incarnation != incarnation_) {
+        // Sequences from another hub say nothing about this one, even when
+        // they happen to be behind ours
+        gap = true;
+        position = 0;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (max_events == 0) {
+            position = last_sequence_;
+        }
+        size_t scanned = 0;
+        while (max_events > 0) {
+            uint64_t oldest = last_sequence_ >= ring_.size() ? last_sequence_ - ring_.size() + 1 : 1;
+            if (position > last_sequence_ || position + 1 < oldest) {
+                gap = true;
+                position = oldest - 1;
+            }
+            while (position < last_sequence_ && scanned < kMaxScanPerCall && events.size() < max_events) {
+                ++position;
+                ++scanned;
+                const std::shared_ptr<const Event>& event = ring_[position % ring_.size()];
+                if (filter.empty() || std::binary_search(filter.begin(), filter.end(), event->user_id)) {
+                    events.push_back(event);
+                }
+            }
+            if (!events.empty() || scanned >= kMaxScanPerCall || closed_ ||
+                !published_.wait_until(lock, deadline, [&] { return closed_ || last_sequence_ > position; })) {
+                break;
+            }
+        }
+    }
+
+    std::vector<std::string_view> encoded;
+    encoded.reserve(events.size());
+    for (const auto& event : events) {
+        encoded.emplace_back(binary ? event->binary : event->json);
+    }
+    delivered_.fetch_add(events.size(), std::memory_order_relaxed);
+    return AssembleWatchUsersResponse(format, encoded, position, gap, incarnation_, payload);
+}
+
+void UserWatchHub::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    published_.notify_all();
+}
+
+uint64_t UserWatchHub::GetLastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_sequence_;
+}
+
+} // namespace grlrpc
@@ -0,0 +1,370 @@
+// GrlRPC Write-Ahead Log Implementation
+
+#include "write_ahead_log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace grlrpc {
+
+namespace {
+
+template<typename T>
+void StoreLE(char* out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+template<typename T>
+T LoadLE(const char* in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+struct Crc32Table {
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            }
+            entries[i] = crc;
+        }
+    }
+
+    uint32_t entries[256];
+};
+
+constexpr char kSegmentPrefix[] = "wal.";
+
+std::string ErrnoMessage(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+// ============================================================================
+// Record Framing
+// ============================================================================
+
+uint32_t Crc32(std::string_view data) {
+    static const Crc32Table table;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (char c : data) {
+        crc = table.entries[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void AppendLogRecord(uint8_t type, std::string_view payload, std::string& out) {
+    size_t offset = out.size();
+    out.resize(offset + kLogRecordHeaderSize + payload.size());
+    char* record = &out[offset];
+    record[8] = static_cast<char>(type);
+    std::memcpy(record + kLogRecordHeaderSize, payload.data(), payload.size());
+    std::string_view body(record + 8, payload.size() + 1);
+    StoreLE<uint32_t>(record, static_cast<uint32_t>(body.size()));
+    StoreLE<uint32_t>(record + 4, Crc32(body));
+}
+
+size_t ParseLogRecords(std::string_view data,
+                       const std::function<void(uint8_t type, std::string_view payload)>& visit) {
+    size_t offset = 0;
+    while (data.size() - offset >= kLogRecordHeaderSize) {
+        uint32_t length = LoadLE<uint32_t>(data.data() + offset);
+        uint32_t crc = LoadLE<uint32_t>(data.data() + offset + 4);
+        if (length == 0 || length > data.size() - offset - 8) {
+            break;
+        }
+        std::string_view body = data.substr(offset + 8, length);
+        if (Crc32(body) != crc) {
+            break;
+        }
+        visit(static_cast<uint8_t>(body[0]), body.substr(1));
+        offset += 8 + length;
+    }
+    return offset;
+}
+
+bool SyncDirectory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// ============================================================================
+// MappedFile
+// ============================================================================
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& path, std::string& error) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = ErrnoMessage("open " + path);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        error = ErrnoMessage("stat " + path);
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            error = ErrnoMessage("mmap " + path);
+            size_ = 0;
+            ::close(fd);
+            return false;
+        }
+        // Files are read front to back once
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapping);
+    }
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::WillNeed(size_t offset, size_t length) const {
+    if (offset >= size_) {
+        return;
+    }
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    size_t end = offset + std::min(length, size_ - offset);
+    ::madvise(const_cast<char*>(data_) + begin, end - begin, MADV_WILLNEED);
+}
+
+void MappedFile::Close() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// ============================================================================
+// WriteAheadLog
+// ============================================================================
+
+WriteAheadLog::WriteAheadLog(std::string directory) : directory_(std::move(directory)) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (fd_ >= 0) {
+        WaitDurable(last_lsn_);
+        ::close(fd_);
+    }
+}
+
+bool WriteAheadLog::Open(std::string& error) {
+    if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST) {
+        error = ErrnoMessage("mkdir " + directory_);
+        return false;
+    }
+    std::vector<uint64_t> segments = ListSegments(directory_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return OpenSegment(segments.empty() ? 1 : segments.back() + 1, error);
+}
+
+bool WriteAheadLog::OpenSegment(uint64_t segment, std::string& error) {
+    std::string path = SegmentPath(directory_, segment);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = ErrnoMessage("open " + path);
+        return false;
+    }
+    SyncDirectory(directory_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    segment_ = segment;
+    segment_bytes_ = 0;
+    return true;
+}
+
+uint64_t WriteAheadLog::Append(uint8_t type, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Nothing will be written again; the sequence number still makes
+    // WaitDurable() report the failure to this record's writer
+    if (!failed_) {
+        AppendLogRecord(type, payload, buffer_);
+    }
+    return ++last_lsn_;
+}
+
+bool WriteAheadLog::WaitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (durable_lsn_ < lsn && !failed_) {
+        if (flushing_) {
+            durable_.wait(lock);
+            continue;
+        }
+
+        // Become the leader for everything buffered so far
+        flushing_ = true;
+        std::string batch;
+        batch.swap(spare_);
+        batch.swap(buffer_);
+        uint64_t target = last_lsn_;
+        int fd = fd_;
+        lock.unlock();
+
+        bool ok = WriteBatch(fd, batch);
+
+        lock.lock();
+        flushing_ = false;
+        if (ok) {
+            durable_lsn_ = target;
+            segment_bytes_ += batch.size();
+            ++sync_count_;
+        } else {
+            FailLocked();
+        }
+        batch.clear();
+        spare_.swap(batch);
+        durable_.notify_all();
+    }
+    return durable_lsn_ >= lsn;
+}
+
+void WriteAheadLog::FailLocked() {
+    failed_ = true;
+    std::string().swap(buffer_);
+}
+
+bool WriteAheadLog::HasFailed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+bool WriteAheadLog::WriteBatch(int fd, const std::string& batch) {
+    size_t written = 0;
+    while (written < batch.size()) {
+        ssize_t result = ::write(fd, batch.data() + written, batch.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return ::fdatasync(fd) == 0;
+}
+
+bool WriteAheadLog::Rotate(uint64_t& segment, std::string& error) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Appenders wait for the mutex meanwhile; rotation is rare (once per
+    // snapshot), so the pause is one sync long
+    durable_.wait(lock, [this] { return !flushing_; });
+    if (failed_) {
+        error = "log failed earlier";
+        return false;
+    }
+    if (!buffer_.empty()) {
+        if (!WriteBatch(fd_, buffer_)) {
+            FailLocked();
+            durable_.notify_all();
+            error = ErrnoMessage("write " + SegmentPath(directory_, segment_));
+            return false;
+        }
+        ++sync_count_;
+        buffer_.clear();
+    }
+    durable_lsn_ = last_lsn_;
+    durable_.notify_all();
+    if (!OpenSegment(segment_ + 1, error)) {
+        return false;
+    }
+    segment = segment_;
+    return true;
+}
+
+void WriteAheadLog::RemoveSegmentsBefore(uint64_t segment) {
+    for (uint64_t existing : ListSegments(directory_)) {
+        if (existing < segment) {
+            ::unlink(SegmentPath(directory_, existing).c_str());
+        }
+    }
+}
+
+uint64_t WriteAheadLog::GetSegmentBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segment_bytes_;
+}
+
+uint64_t WriteAheadLog::GetSyncCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sync_count_;
+}
+
+std::vector<uint64_t> WriteAheadLog::ListSegments(const std::string& directory) {
+    std::vector<uint64_t> segments;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) {
+        return segments;
+    }
+    const size_t prefix_length = sizeof(kSegmentPrefix) - 1;
+    while (struct dirent* entry = ::readdir(dir)) {
+        const char* name = entry->d_name;
+        if (std::strncmp(name, kSegmentPrefix, prefix_length) != 0) {
+            continue;
+        }
+        char* end = nullptr;
+        uint64_t segment = std::strtoull(name + prefix_length, &end, 10);
+        if (segment > 0 && end && *end == '\0') {
+            segments.push_back(segment);
+        }
+    }
+    ::closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+std::string WriteAheadLog::SegmentPath(const std::string& directory, uint64_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%016llu", kSegmentPrefix,
+                  static_cast<unsigned long long>(segment));
+    return directory + "/" + name;
+}
+
+} // namespace grlrpc
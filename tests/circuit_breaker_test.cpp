@@ -0,0 +1,81 @@
+// GrlRPC Circuit Breaker Tests
+// Tests for: state transitions, fail-fast, half-open probe limiting
+
+#include <iostream>
+#include <cassert>
+#include "circuit_breaker.h"
+
+using namespace std::chrono_literals;
+
+int main() {
+    grlrpc::CircuitBreakerConfig config;
+    config.window = 1000ms;
+    config.bucket_count = 10;
+    config.min_requests = 10;
+    config.failure_rate_threshold = 0.5;
+    config.open_duration = 500ms;
+    config.half_open_max_probes = 1;
+    config.half_open_probe_interval = 10ms;
+    config.half_open_success_threshold = 2;
+
+    auto t0 = grlrpc::RpcClock::now();
+
+    // Test 1: Breaker stays closed below min_requests
+    std::cout << "Test 1: Closed below min_requests..." << std::endl;
+    grlrpc::CircuitBreaker breaker(config);
+    for (int i = 0; i < 9; ++i) {
+        assert(breaker.AllowRequest(t0));
+        breaker.RecordResult(grlrpc::RpcStatus::TIMEOUT, 1ms, t0);
+    }
+    assert(breaker.GetState() == grlrpc::CircuitState::CLOSED);
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Trips once the failure rate crosses the threshold and fails fast
+    std::cout << "Test 2: Trip and fail fast..." << std::endl;
+    breaker.RecordResult(grlrpc::RpcStatus::NETWORK_ERROR, 1ms, t0);
+    assert(breaker.GetState() == grlrpc::CircuitState::OPEN);
+    assert(!breaker.AllowRequest(t0 + 100ms));
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Half-open admits rate-limited probes
+    std::cout << "Test 3: Half-open probe limiting..." << std::endl;
+    auto t1 = t0 + 600ms;
+    assert(breaker.AllowRequest(t1));
+    assert(breaker.GetState() == grlrpc::CircuitState::HALF_OPEN);
+    assert(!breaker.AllowRequest(t1));            // max probes in flight
+    breaker.RecordResult(grlrpc::RpcStatus::SUCCESS, 1ms, t1 + 2ms);
+    assert(!breaker.AllowRequest(t1 + 5ms));      // probe interval not elapsed
+    assert(breaker.AllowRequest(t1 + 40ms));
+    breaker.RecordResult(grlrpc::RpcStatus::SUCCESS, 1ms, t1 + 40ms);
+    assert(breaker.GetState() == grlrpc::CircuitState::CLOSED);
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Failed probe reopens the circuit
+    std::cout << "Test 4: Failed probe reopens..." << std::endl;
+    auto t2 = t1 + 2000ms;
+    for (int i = 0; i < 10; ++i) {
+        breaker.RecordResult(grlrpc::RpcStatus::TIMEOUT, 1ms, t2);
+    }
+    assert(breaker.GetState() == grlrpc::CircuitState::OPEN);
+    assert(breaker.AllowRequest(t2 + 600ms));
+    breaker.RecordResult(grlrpc::RpcStatus::TIMEOUT, 1ms, t2 + 600ms);
+    assert(breaker.GetState() == grlrpc::CircuitState::OPEN);
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Caller errors never trip; registry isolates methods
+    std::cout << "Test 5: Registry per endpoint and method..." << std::endl;
+    grlrpc::CircuitBreakerRegistry registry(config);
+    for (int i = 0; i < 20; ++i) {
+        registry.RecordResult("a:1", "Get", grlrpc::RpcStatus::INVALID_REQUEST, 1ms, t0);
+    }
+    assert(registry.AllowRequest("a:1", "Get", t0));
+    for (int i = 0; i < 10; ++i) {
+        registry.GetMethodBreaker("a:1", "Slow")->RecordResult(grlrpc::RpcStatus::TIMEOUT, 1ms, t0);
+    }
+    assert(!registry.AllowRequest("a:1", "Slow", t0));
+    assert(registry.AllowRequest("a:1", "Get", t0));
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,246 @@
+// GrlRPC Compression Tests
+// Tests for: compression threshold, compressed-data detection, no-gain
+// fallback, decompression limits, FRAME_FLAG_COMPRESSED round trip, and the
+// LZ4/zstd compressors when they are built in
+
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+#include "compression.h"
+#include "handshake.h"
+
+namespace {
+
+// Run-length coder: [count][byte] pairs. Shrinks runs, doubles everything else
+class RunLengthCompressor : public grlrpc::ICompressor {
+public:
+    bool Compress(std::string_view input, std::string& output) override {
+        ++compress_calls;
+        for (size_t i = 0; i < input.size();) {
+            size_t run = 1;
+            while (i + run < input.size() && run < 255 && input[i + run] == input[i]) {
+                ++run;
+            }
+            output.push_back(static_cast<char>(run));
+            output.push_back(input[i]);
+            i += run;
+        }
+        return true;
+    }
+
+    bool Decompress(std::string_view input, size_t original_size, std::string& output) override {
+        size_t start = output.size();
+        for (size_t i = 0; i + 1 < input.size(); i += 2) {
+            output.append(static_cast<uint8_t>(input[i]), input[i + 1]);
+            if (output.size() - start > original_size) {
+                output.resize(start);
+                return false;
+            }
+        }
+        if (input.size() % 2 != 0 || output.size() - start != original_size) {
+            output.resize(start);
+            return false;
+        }
+        return true;
+    }
+
+    std::string GetName() const override { return "rle"; }
+
+    int compress_calls = 0;
+};
+
+// Text without repeated neighbours: low byte diversity, but no runs to shrink
+std::string Alternating(size_t size) {
+    std::string text;
+    for (size_t i = 0; i < size; ++i) {
+        text.push_back("abcdefgh"[i % 8]);
+    }
+    return text;
+}
+
+#if defined(GRLRPC_HAVE_LZ4) || defined(GRLRPC_HAVE_ZSTD)
+void CheckRoundTrip(grlrpc::ICompressor& compressor, const std::string& payload) {
+    grlrpc::CompressionPolicy policy;
+    policy.compressor = &compressor;
+    grlrpc::FrameHeader header;
+    std::string wire;
+    assert(grlrpc::MessageCodec::CompressPayload(policy, header, payload, wire));
+    assert(header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+    assert(wire.size() < payload.size());
+    std::string restored;
+    assert(grlrpc::MessageCodec::DecompressPayload(&compressor, wire, payload.size(), restored));
+    assert(restored == payload);
+}
+#endif
+
+} // namespace
+
+int main() {
+    RunLengthCompressor rle;
+    grlrpc::CompressionPolicy policy;
+    policy.compressor = &rle;
+    policy.min_bytes = 1024;
+
+    // Test 1: Only payloads at or above the threshold are compressed
+    std::cout << "Test 1: Size threshold..." << std::endl;
+    {
+        grlrpc::FrameHeader header;
+        std::string out = "stale";
+        assert(!grlrpc::MessageCodec::CompressPayload(policy, header, std::string(1023, 'a'), out));
+        assert(out.empty());
+        assert(!header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(rle.compress_calls == 0);
+
+        assert(grlrpc::MessageCodec::CompressPayload(policy, header, std::string(1024, 'a'), out));
+        assert(header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(out.size() < 64);
+
+        grlrpc::CompressionPolicy none;
+        header = grlrpc::FrameHeader();
+        assert(!grlrpc::MessageCodec::CompressPayload(none, header, std::string(4096, 'a'), out));
+        assert(!header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Payloads that are already compressed are sent as they are
+    std::cout << "Test 2: Already-compressed payloads are skipped..." << std::endl;
+    {
+        int calls = rle.compress_calls;
+        std::string gzip = "\x1f\x8b" + std::string(4096, 'a');
+        std::string png = "\x89PNG" + std::string(4096, 'a');
+        std::string random(4096, '\0');
+        std::mt19937 rng(7);
+        for (char& c : random) {
+            c = static_cast<char>(rng());
+        }
+        assert(grlrpc::LooksCompressed(gzip));
+        assert(grlrpc::LooksCompressed(png));
+        assert(grlrpc::LooksCompressed(random));
+        assert(!grlrpc::LooksCompressed(Alternating(4096)));
+        assert(!grlrpc::LooksCompressed(std::string(4096, 'a')));
+
+        grlrpc::FrameHeader header;
+        std::string out;
+        assert(!grlrpc::MessageCodec::CompressPayload(policy, header, gzip, out));
+        assert(!grlrpc::MessageCodec::CompressPayload(policy, header, png, out));
+        assert(!grlrpc::MessageCodec::CompressPayload(policy, header, random, out));
+        assert(!header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(rle.compress_calls == calls);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Compression that does not shrink the payload is discarded
+    std::cout << "Test 3: No-gain fallback..." << std::endl;
+    {
+        int calls = rle.compress_calls;
+        grlrpc::FrameHeader header;
+        std::string out;
+        assert(!grlrpc::MessageCodec::CompressPayload(policy, header, Alternating(4096), out));
+        assert(rle.compress_calls == calls + 1);
+        assert(out.empty());
+        assert(!header.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Decompression is bounded by the caller's limit and the claimed size
+    std::cout << "Test 4: Decompression limits..." << std::endl;
+    {
+        std::string payload(4096, 'z');
+        grlrpc::FrameHeader header;
+        std::string wire;
+        assert(grlrpc::MessageCodec::CompressPayload(policy, header, payload, wire));
+
+        std::string out;
+        assert(!grlrpc::MessageCodec::DecompressPayload(&rle, wire, payload.size() - 1, out));
+        assert(grlrpc::MessageCodec::DecompressPayload(&rle, wire, payload.size(), out));
+        assert(out == payload);
+
+        assert(!grlrpc::MessageCodec::DecompressPayload(nullptr, wire, payload.size(), out));
+        assert(!grlrpc::MessageCodec::DecompressPayload(&rle, wire.substr(0, 3), payload.size(), out));
+
+        // An original size that does not match what the data expands to
+        std::string lying = wire;
+        lying[1] = static_cast<char>(lying[1] - 1);
+        assert(!grlrpc::MessageCodec::DecompressPayload(&rle, lying, payload.size(), out));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: The flag travels with the frame and is cleared once decoded
+    std::cout << "Test 5: COMPRESSED flag round trip..." << std::endl;
+    {
+        grlrpc::CompressorRegistry::Instance().RegisterCompressor(
+            "rle", std::make_unique<RunLengthCompressor>());
+        grlrpc::ConnectionHello server;
+        server.serializers = {"json"};
+        server.compressions = {"rle", "none"};
+        grlrpc::ConnectionHello client = server;
+        grlrpc::ConnectionCodec codec;
+        assert(codec.Bind(grlrpc::NegotiateConnection(server, client)));
+        assert(codec.compression_name == "rle" && codec.compressor != nullptr);
+
+        grlrpc::FrameHeader header;
+        header.request_id = 12;
+        std::string payload = std::string(3000, 'x') + std::string(3000, 'y');
+        std::string wire;
+        std::string scratch;
+        codec.EncodeFrame(header, payload, wire, scratch);
+        grlrpc::FrameHeader on_wire;
+        assert(grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), on_wire));
+        assert(on_wire.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(wire.size() < 100);
+
+        grlrpc::FrameHeader decoded;
+        std::string_view body;
+        std::string inflated;
+        assert(codec.DecodeFrame(wire.data(), wire.size(), payload.size(), decoded, body, inflated));
+        assert(!decoded.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(decoded.request_id == 12);
+        assert(decoded.payload_length == payload.size());
+        assert(body == payload);
+        assert(!codec.DecodeFrame(wire.data(), wire.size(), payload.size() - 1, decoded, body, inflated));
+
+        // Below the threshold the frame goes out plain
+        wire.clear();
+        codec.EncodeFrame(header, "small", wire, scratch);
+        assert(grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), on_wire));
+        assert(!on_wire.HasFlag(grlrpc::FRAME_FLAG_COMPRESSED));
+        assert(codec.DecodeFrame(wire.data(), wire.size(), 1024, decoded, body, inflated));
+        assert(body == "small");
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Library compressors, when built in
+    std::cout << "Test 6: LZ4 and zstd round trips..." << std::endl;
+    {
+        std::string payload;
+        for (int i = 0; i < 200; ++i) {
+            payload += "{\"user_id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i) +
+                       "\",\"email\":\"user" + std::to_string(i) + "@example.com\"}";
+        }
+#ifdef GRLRPC_HAVE_LZ4
+        CheckRoundTrip(*grlrpc::MakeLz4Compressor(), payload);
+        assert(grlrpc::CompressorRegistry::Instance().GetCompressor("lz4") != nullptr);
+#endif
+#ifdef GRLRPC_HAVE_ZSTD
+        CheckRoundTrip(*grlrpc::MakeZstdCompressor(), payload);
+        assert(grlrpc::CompressorRegistry::Instance().GetCompressor("zstd") != nullptr);
+
+        std::vector<std::string> samples;
+        for (int i = 0; i < 1000; ++i) {
+            samples.push_back("{\"user_id\":" + std::to_string(i * 7) + ",\"name\":\"member" +
+                              std::to_string(i) + "\",\"email\":\"member" + std::to_string(i) +
+                              "@example.com\",\"age\":" + std::to_string(20 + i % 50) + "}");
+        }
+        std::string dictionary = grlrpc::TrainZstdDictionary(samples, 4096);
+        assert(!dictionary.empty());
+        auto with_dictionary = grlrpc::MakeZstdCompressor(3, dictionary, "zstd-dict-test");
+        assert(with_dictionary->GetName() == "zstd-dict-test");
+        CheckRoundTrip(*with_dictionary, payload);
+#endif
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
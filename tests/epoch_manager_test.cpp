@@ -0,0 +1,202 @@
+// GrlRPC Epoch Manager Tests
+// Tests for: deferred reclamation, nested pins, drain, concurrent readers,
+//            collection deferred to unpin, thread exit
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "epoch_manager.h"
+
+int main() {
+    // Test 1: Nothing retired while a reader is pinned is reclaimed until it unpins
+    std::cout << "Test 1: Deferred reclamation..." << std::endl;
+    {
+        grlrpc::EpochManager epochs;
+        int reclaimed = 0;
+        {
+            grlrpc::EpochManager::Guard pin = epochs.Pin();
+            epochs.Retire([&] { ++reclaimed; });
+            for (int i = 0; i < 10; ++i) {
+                epochs.Collect();
+            }
+            assert(reclaimed == 0 && epochs.GetPendingCount() == 1);
+        }
+        epochs.Collect();
+        epochs.Collect();
+        assert(reclaimed == 1 && epochs.GetPendingCount() == 0);
+        assert(epochs.GetReclaimedCount() == 1);
+
+        // Without readers two collections are enough
+        epochs.Retire([&] { ++reclaimed; });
+        epochs.Collect();
+        epochs.Collect();
+        assert(reclaimed == 2);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Pins nest; only the outermost release unpins
+    std::cout << "Test 2: Nested pins..." << std::endl;
+    {
+        grlrpc::EpochManager epochs;
+        int reclaimed = 0;
+        grlrpc::EpochManager::Guard outer = epochs.Pin();
+        {
+            grlrpc::EpochManager::Guard inner = epochs.Pin();
+            grlrpc::EpochManager::Guard moved = std::move(inner);
+        }
+        epochs.Retire([&] { ++reclaimed; });
+        for (int i = 0; i < 10; ++i) {
+            epochs.Collect();
+        }
+        assert(reclaimed == 0);
+        outer = grlrpc::EpochManager::Guard();
+        epochs.Collect();
+        epochs.Collect();
+        assert(reclaimed == 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Destruction runs whatever is still pending, in retirement order
+    std::cout << "Test 3: Drain on destruction..." << std::endl;
+    {
+        std::vector<int> order;
+        {
+            grlrpc::EpochManager epochs;
+            for (int i = 0; i < 5; ++i) {
+                epochs.Retire([&order, i] { order.push_back(i); });
+            }
+        }
+        assert((order == std::vector<int>{0, 1, 2, 3, 4}));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Readers never see a node freed under them while a writer
+    // keeps replacing it
+    std::cout << "Test 4: Concurrent readers and writer..." << std::endl;
+    {
+        struct Node {
+            std::atomic<uint64_t> value;
+            std::atomic<bool> freed{false};
+        };
+        grlrpc::EpochManager epochs;
+        std::atomic<Node*> current{new Node{{0}}};
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> bad{0};
+        std::vector<Node*> graveyard;   // freed nodes stay mapped so readers can check the flag
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                while (!stop) {
+                    grlrpc::EpochManager::Guard pin = epochs.Pin();
+                    Node* node = current.load(std::memory_order_acquire);
+                    for (int i = 0; i < 100; ++i) {
+                        if (node->freed.load(std::memory_order_acquire)) {
+                            ++bad;
+                        }
+                    }
+                }
+            });
+        }
+        for (uint64_t i = 1; i <= 20000; ++i) {
+            Node* old = current.exchange(new Node{{i}}, std::memory_order_acq_rel);
+            epochs.Retire([old, &graveyard] {
+                old->freed.store(true, std::memory_order_release);
+                graveyard.push_back(old);
+            });
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(bad == 0);
+        // A reader descheduled while pinned may have held everything back
+        // until now; with all of them gone two collections free the backlog
+        epochs.Collect();
+        epochs.Collect();
+        assert(epochs.GetReclaimedCount() > 0 && epochs.GetPendingCount() == 0);
+        epochs.Drain();
+        assert(epochs.GetReclaimedCount() == 20000);
+        for (Node* node : graveyard) {
+            delete node;
+        }
+        delete current.load();
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: A pinned thread retires without collecting and collects on unpin
+    std::cout << "Test 5: Collection deferred to unpin..." << std::endl;
+    {
+        grlrpc::EpochManager epochs;
+        int reclaimed = 0;
+        uint64_t epoch = epochs.GetEpoch();
+        {
+            grlrpc::EpochManager::Guard pin = epochs.Pin();
+            for (size_t i = 0; i < 3 * grlrpc::EpochManager::kCollectInterval; ++i) {
+                epochs.Retire([&] { ++reclaimed; });
+            }
+            assert(epochs.GetEpoch() == epoch);
+        }
+        assert(epochs.GetEpoch() == epoch + 1);
+        assert(epochs.GetPendingCount() == 3 * grlrpc::EpochManager::kCollectInterval);
+
+        // Unpinned, the interval's last retirement collects at once
+        for (size_t i = 0; i < grlrpc::EpochManager::kCollectInterval; ++i) {
+            epochs.Retire([&] { ++reclaimed; });
+        }
+        assert(epochs.GetEpoch() == epoch + 2);
+        assert(reclaimed == 3 * static_cast<int>(grlrpc::EpochManager::kCollectInterval));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Exited threads give back their slot and leave their retirements behind
+    std::cout << "Test 6: Thread exit..." << std::endl;
+    {
+        grlrpc::EpochManager epochs;
+        std::atomic<int> reclaimed{0};
+        for (int t = 0; t < 20; ++t) {
+            std::thread worker([&] {
+                grlrpc::EpochManager::Guard pin = epochs.Pin();
+                for (int i = 0; i < 10; ++i) {
+                    epochs.Retire([&] { ++reclaimed; });
+                }
+            });
+            worker.join();
+        }
+        assert(epochs.GetParticipantCount() == 1);
+        assert(epochs.GetPendingCount() + reclaimed == 200);
+
+        epochs.Collect();
+        epochs.Collect();
+        assert(reclaimed == 200 && epochs.GetPendingCount() == 0);
+        // This thread took over the slot the workers kept passing on
+        assert(epochs.GetParticipantCount() == 1);
+
+        // A thread that outlives its manager leaves nothing to hand back
+        std::atomic<bool> done{false};
+        std::thread late;
+        {
+            grlrpc::EpochManager short_lived;
+            std::atomic<bool> retired{false};
+            late = std::thread([&] {
+                short_lived.Retire([&] { ++reclaimed; });
+                retired = true;
+                while (!done) {
+                    std::this_thread::yield();
+                }
+            });
+            while (!retired) {
+                std::this_thread::yield();
+            }
+        }
+        assert(reclaimed == 201);
+        done = true;
+        late.join();
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+// GrlRPC Fan-Out Pool Tests
+// Tests for: every index runs once, caller-only pool, concurrent callers
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "fan_out_pool.h"
+
+int main() {
+    // Test 1: Each index runs exactly once before Run() returns
+    std::cout << "Test 1: Run covers every index..." << std::endl;
+    {
+        grlrpc::FanOutPool pool(3);
+        assert(pool.WorkerCount() == 3);
+        for (size_t count : {0, 1, 2, 16, 100}) {
+            std::vector<std::atomic<int>> hits(count);
+            pool.Run(count, [&](size_t index) { ++hits[index]; });
+            for (auto& hit : hits) {
+                assert(hit == 1);
+            }
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Without workers everything runs on the caller
+    std::cout << "Test 2: Caller-only pool..." << std::endl;
+    {
+        grlrpc::FanOutPool pool(0);
+        std::thread::id caller = std::this_thread::get_id();
+        bool all_on_caller = true;
+        pool.Run(8, [&](size_t) { all_on_caller = all_on_caller && std::this_thread::get_id() == caller; });
+        assert(all_on_caller);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Concurrent callers share the workers without losing tasks
+    std::cout << "Test 3: Concurrent callers..." << std::endl;
+    {
+        grlrpc::FanOutPool pool(2);
+        std::atomic<uint64_t> total{0};
+        std::vector<std::thread> callers;
+        for (int c = 0; c < 4; ++c) {
+            callers.emplace_back([&] {
+                for (int round = 0; round < 200; ++round) {
+                    std::atomic<uint64_t> sum{0};
+                    pool.Run(10, [&](size_t index) { sum += index + 1; });
+                    assert(sum == 55);
+                    total += sum;
+                }
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        assert(total == 4 * 200 * 55);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
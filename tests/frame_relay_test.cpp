@@ -0,0 +1,356 @@
+// GrlRPC Frame Relay Tests
+// Tests for: request id remapping, deadline propagation, upstream selection
+// failures, route cleanup and expiry, chunked requests, aborted chunked requests
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+#include "frame_relay.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct SentFrame {
+    uint64_t connection;
+    grlrpc::FrameHeader header;
+    std::string payload;
+};
+
+grlrpc::FrameView MakeFrame(const grlrpc::FrameHeader& header, const std::string& payload) {
+    grlrpc::FrameHeader copy = header;
+    copy.payload_length = static_cast<uint32_t>(payload.size());
+    auto storage = std::make_shared<std::string>();
+    grlrpc::MessageCodec::EncodeHeader(copy, *storage);
+    storage->append(payload);
+    grlrpc::FrameView frame;
+    frame.storage = storage;
+    frame.length = storage->size();
+    return frame;
+}
+
+grlrpc::FrameView MakeRequest(uint64_t request_id, uint32_t deadline_ms, const std::string& payload) {
+    grlrpc::FrameHeader header;
+    header.method_id = grlrpc::MethodIdOf("UserService/GetUser");
+    header.request_id = request_id;
+    header.deadline_ms = deadline_ms;
+    return MakeFrame(header, payload);
+}
+
+// One chunk of a chunked request; the first carries the message's total length
+grlrpc::FrameView MakeChunk(uint64_t request_id, uint32_t deadline_ms, bool first, bool last,
+                            const std::string& data, uint32_t total = 0) {
+    grlrpc::FrameHeader header;
+    header.method_id = grlrpc::MethodIdOf("UserService/UploadAvatar");
+    header.request_id = request_id;
+    header.deadline_ms = deadline_ms;
+    header.flags = last ? grlrpc::FRAME_FLAG_NONE : grlrpc::FRAME_FLAG_CHUNK;
+    std::string payload;
+    if (first) {
+        for (int i = 0; i < 4; ++i) {
+            payload.push_back(static_cast<char>((total >> (8 * i)) & 0xFF));
+        }
+    }
+    payload += data;
+    return MakeFrame(header, payload);
+}
+
+grlrpc::FrameView MakeResponse(uint64_t request_id, const std::string& payload) {
+    grlrpc::FrameHeader header;
+    header.flags = grlrpc::FRAME_FLAG_RESPONSE;
+    header.request_id = request_id;
+    return MakeFrame(header, payload);
+}
+
+// Send the rest of chunked request `request_id` after it was given up on
+void ExpectRestAborted(grlrpc::FrameRelay& relay, uint64_t connection, uint64_t request_id,
+                       grlrpc::RpcClock::time_point now) {
+    assert(relay.OnInboundFrame(connection, MakeChunk(request_id, 0, false, false, "bbbb"), now) ==
+           grlrpc::RelayResult::MESSAGE_ABORTED);
+    assert(relay.OnInboundFrame(connection, MakeChunk(request_id, 0, false, true, "cccc"), now) ==
+           grlrpc::RelayResult::MESSAGE_ABORTED);
+    assert(relay.GetAbortedRunCount() == 0 && relay.GetChunkRunCount() == 0);
+}
+
+// Sinks that record what they were given and fail on demand
+struct Harness {
+    explicit Harness(size_t upstreams = 2, size_t selected = 1)
+        : selected(selected),
+          relay(upstreams,
+                [this](uint64_t connection, const grlrpc::FrameView& frame) {
+                    return Record(upstream, connection, frame, upstream_ok);
+                },
+                [this](uint64_t connection, const grlrpc::FrameView& frame) {
+                    return Record(downstream, connection, frame, downstream_ok);
+                },
+                [this](const grlrpc::FrameHeader&, std::string_view) { return this->selected; }) {}
+
+    static bool Record(std::vector<SentFrame>& sent, uint64_t connection,
+                       const grlrpc::FrameView& frame, bool ok) {
+        if (!ok) {
+            return false;
+        }
+        SentFrame record;
+        record.connection = connection;
+        assert(grlrpc::MessageCodec::DecodeHeader(frame.Data(), frame.length, record.header));
+        record.payload = std::string(frame.Payload());
+        sent.push_back(record);
+        return true;
+    }
+
+    size_t selected;
+    bool upstream_ok = true;
+    bool downstream_ok = true;
+    std::vector<SentFrame> upstream;
+    std::vector<SentFrame> downstream;
+    grlrpc::FrameRelay relay;
+};
+
+} // namespace
+
+int main() {
+    // Test 1: Request ids are remapped upstream and restored downstream
+    std::cout << "Test 1: Request id remapping..." << std::endl;
+    {
+        Harness h;
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(3, MakeRequest(7, 0, "get 42"), now) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.OnInboundFrame(4, MakeRequest(7, 0, "get 43"), now) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.upstream.size() == 2);
+        assert(h.upstream[0].connection == 1);
+        assert(h.upstream[0].payload == "get 42");
+        uint64_t first = h.upstream[0].header.request_id;
+        uint64_t second = h.upstream[1].header.request_id;
+        assert(first != second);
+        assert(h.relay.GetPendingCount() == 2);
+
+        assert(h.relay.OnUpstreamFrame(MakeResponse(second, "user 43")) == grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.OnUpstreamFrame(MakeResponse(first, "user 42")) == grlrpc::RelayResult::FORWARDED);
+        assert(h.downstream.size() == 2);
+        assert(h.downstream[0].connection == 4);
+        assert(h.downstream[0].header.request_id == 7);
+        assert(h.downstream[0].payload == "user 43");
+        assert(h.downstream[1].connection == 3);
+        assert(h.downstream[1].header.request_id == 7);
+        assert(h.relay.GetPendingCount() == 0);
+
+        // A second response to the same id has nowhere to go
+        assert(h.relay.OnUpstreamFrame(MakeResponse(first, "again")) ==
+               grlrpc::RelayResult::UNKNOWN_REQUEST);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: The remaining deadline shrinks by the time spent in the relay
+    std::cout << "Test 2: Deadline propagation..." << std::endl;
+    {
+        Harness h;
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(1, MakeRequest(1, 100, "x"), now - 20ms) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.upstream.size() == 1);
+        uint32_t forwarded = h.upstream[0].header.deadline_ms;
+        assert(forwarded > 0 && forwarded <= 79);
+
+        assert(h.relay.OnInboundFrame(1, MakeRequest(2, 100, "x"), now - 200ms) ==
+               grlrpc::RelayResult::DEADLINE_EXCEEDED);
+        assert(h.upstream.size() == 1);
+        assert(h.relay.GetPendingCount() == 1);
+
+        // No deadline stays no deadline
+        assert(h.relay.OnInboundFrame(1, MakeRequest(3, 0, "x"), now - 200ms) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.upstream.back().header.deadline_ms == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Invalid frames and unknown upstreams are refused
+    std::cout << "Test 3: Invalid frames and missing upstreams..." << std::endl;
+    {
+        Harness h(2, 5);
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(1, MakeRequest(1, 0, "x"), now) == grlrpc::RelayResult::NO_UPSTREAM);
+
+        grlrpc::FrameView truncated = MakeRequest(2, 0, "payload");
+        truncated.length -= 3;
+        assert(h.relay.OnInboundFrame(1, truncated, now) == grlrpc::RelayResult::INVALID_FRAME);
+        assert(h.upstream.empty());
+        assert(h.relay.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: A failed send leaves no route behind
+    std::cout << "Test 4: Route cleanup on send failure..." << std::endl;
+    {
+        Harness h;
+        h.upstream_ok = false;
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(1, MakeRequest(1, 0, "x"), now) == grlrpc::RelayResult::SEND_FAILED);
+        assert(h.relay.GetPendingCount() == 0);
+
+        h.upstream_ok = true;
+        h.downstream_ok = false;
+        assert(h.relay.OnInboundFrame(1, MakeRequest(2, 0, "x"), now) == grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.OnUpstreamFrame(MakeResponse(h.upstream[0].header.request_id, "y")) ==
+               grlrpc::RelayResult::SEND_FAILED);
+        assert(h.relay.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Requests the upstream never answers expire
+    std::cout << "Test 5: Route expiry..." << std::endl;
+    {
+        grlrpc::FrameRelayConfig config;
+        config.route_timeout = 1000ms;
+        std::vector<SentFrame> upstream;
+        grlrpc::FrameRelay relay(
+            1,
+            [&upstream](uint64_t connection, const grlrpc::FrameView& frame) {
+                return Harness::Record(upstream, connection, frame, true);
+            },
+            [](uint64_t, const grlrpc::FrameView&) { return true; },
+            [](const grlrpc::FrameHeader&, std::string_view) { return size_t(0); },
+            config);
+        auto now = grlrpc::RpcClock::now();
+        assert(relay.OnInboundFrame(1, MakeRequest(1, 50, "x"), now) == grlrpc::RelayResult::FORWARDED);
+        assert(relay.OnInboundFrame(1, MakeRequest(2, 0, "x"), now) == grlrpc::RelayResult::FORWARDED);
+        assert(relay.OnInboundFrame(1, MakeRequest(3, 0, "x"), now) == grlrpc::RelayResult::FORWARDED);
+        // The third is answered before anything expires
+        assert(relay.OnUpstreamFrame(MakeResponse(upstream[2].header.request_id, "y")) ==
+               grlrpc::RelayResult::FORWARDED);
+
+        assert(relay.ExpireBefore(now + 10ms) == 0);
+        assert(relay.ExpireBefore(now + 60ms) == 1);
+        assert(relay.GetPendingCount() == 1);
+        assert(relay.ExpireBefore(now + 2000ms) == 1);
+        assert(relay.GetPendingCount() == 0);
+        assert(relay.OnUpstreamFrame(MakeResponse(upstream[0].header.request_id, "late")) ==
+               grlrpc::RelayResult::UNKNOWN_REQUEST);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Chunks follow their first chunk even past the deadline
+    std::cout << "Test 6: Chunked request relaying..." << std::endl;
+    {
+        Harness h;
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(5, MakeChunk(9, 100, true, false, "aaaa", 12), now) ==
+               grlrpc::RelayResult::FORWARDED);
+        // Another request on the same connection interleaves
+        assert(h.relay.OnInboundFrame(5, MakeRequest(10, 0, "get"), now) == grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.GetChunkRunCount() == 1);
+        // Received long after the caller's deadline; dropping it would truncate the message
+        assert(h.relay.OnInboundFrame(5, MakeChunk(9, 100, false, false, "bbbb"), now - 500ms) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.OnInboundFrame(5, MakeChunk(9, 100, false, true, "cccc"), now - 500ms) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.GetChunkRunCount() == 0);
+
+        assert(h.upstream.size() == 4);
+        uint64_t relay_id = h.upstream[0].header.request_id;
+        assert(h.upstream[1].header.request_id != relay_id);
+        assert(h.upstream[2].header.request_id == relay_id);
+        assert(h.upstream[3].header.request_id == relay_id);
+        assert(h.upstream[2].payload == "bbbb" && h.upstream[3].payload == "cccc");
+        // Only the first chunk's deadline is rewritten
+        assert(h.upstream[0].header.deadline_ms < 100);
+        assert(h.upstream[2].header.deadline_ms == 100);
+
+        assert(h.relay.OnUpstreamFrame(MakeResponse(relay_id, "ok")) == grlrpc::RelayResult::FORWARDED);
+        assert(h.downstream.back().connection == 5 && h.downstream.back().header.request_id == 9);
+
+        // A first chunk past its deadline is refused and so is the rest of its message
+        assert(h.relay.OnInboundFrame(5, MakeChunk(11, 100, true, false, "aaaa", 8), now - 500ms) ==
+               grlrpc::RelayResult::DEADLINE_EXCEEDED);
+        assert(h.relay.GetChunkRunCount() == 0 && h.relay.GetAbortedRunCount() == 1);
+        size_t sent = h.upstream.size();
+        ExpectRestAborted(h.relay, 5, 11, now);
+        assert(h.upstream.size() == sent);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 7: A chunked request that cannot be completed is forgotten
+    std::cout << "Test 7: Chunk run cleanup..." << std::endl;
+    {
+        Harness h;
+        auto now = grlrpc::RpcClock::now();
+        assert(h.relay.OnInboundFrame(1, MakeChunk(1, 0, true, false, "aaaa", 12), now) ==
+               grlrpc::RelayResult::FORWARDED);
+        h.upstream_ok = false;
+        assert(h.relay.OnInboundFrame(1, MakeChunk(1, 0, false, false, "bbbb"), now) ==
+               grlrpc::RelayResult::SEND_FAILED);
+        assert(h.relay.GetChunkRunCount() == 0);
+        assert(h.relay.GetPendingCount() == 0);
+        // Even once the upstream is back, the truncated message stays dropped
+        h.upstream_ok = true;
+        ExpectRestAborted(h.relay, 1, 1, now);
+        assert(h.upstream.size() == 1 && h.relay.GetPendingCount() == 0);
+
+        // The caller stops sending chunks; expiry drops both the route and the run
+        h.upstream_ok = true;
+        assert(h.relay.OnInboundFrame(1, MakeChunk(2, 50, true, false, "aaaa", 12), now) ==
+               grlrpc::RelayResult::FORWARDED);
+        assert(h.relay.GetChunkRunCount() == 1 && h.relay.GetPendingCount() == 1);
+        assert(h.relay.ExpireBefore(now + 100ms) == 1);
+        assert(h.relay.GetChunkRunCount() == 0 && h.relay.GetPendingCount() == 0);
+        ExpectRestAborted(h.relay, 1, 2, now);
+        assert(h.upstream.size() == 2 && h.relay.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 8: Every way of refusing a first chunk drops the rest of its message
+    std::cout << "Test 8: Aborted chunked requests..." << std::endl;
+    {
+        auto now = grlrpc::RpcClock::now();
+        {
+            Harness h(2, 5);
+            assert(h.relay.OnInboundFrame(1, MakeChunk(1, 0, true, false, "aaaa", 12), now) ==
+                   grlrpc::RelayResult::NO_UPSTREAM);
+            h.selected = 0;
+            ExpectRestAborted(h.relay, 1, 1, now);
+            assert(h.upstream.empty());
+        }
+        {
+            Harness h;
+            h.upstream_ok = false;
+            assert(h.relay.OnInboundFrame(1, MakeChunk(1, 0, true, false, "aaaa", 12), now) ==
+                   grlrpc::RelayResult::SEND_FAILED);
+            h.upstream_ok = true;
+            ExpectRestAborted(h.relay, 1, 1, now);
+            assert(h.upstream.empty() && h.relay.GetPendingCount() == 0);
+        }
+        {
+            Harness h;
+            // Too short to hold the total length
+            assert(h.relay.OnInboundFrame(1, MakeChunk(1, 0, false, false, "aa"), now) ==
+                   grlrpc::RelayResult::INVALID_FRAME);
+            ExpectRestAborted(h.relay, 1, 1, now);
+            assert(h.upstream.empty());
+
+            // Aborting one message leaves others with the same id elsewhere alone
+            h.upstream_ok = false;
+            assert(h.relay.OnInboundFrame(1, MakeChunk(3, 0, true, false, "aaaa", 12), now) ==
+                   grlrpc::RelayResult::SEND_FAILED);
+            h.upstream_ok = true;
+            assert(h.relay.OnInboundFrame(2, MakeChunk(3, 0, true, false, "aaaa", 8), now) ==
+                   grlrpc::RelayResult::FORWARDED);
+            assert(h.relay.OnInboundFrame(2, MakeChunk(3, 0, false, true, "bbbb"), now) ==
+                   grlrpc::RelayResult::FORWARDED);
+            assert(h.upstream.size() == 2 && h.upstream[1].payload == "bbbb");
+
+            // A final chunk that never comes is forgotten after route_timeout
+            assert(h.relay.GetAbortedRunCount() == 1);
+            h.relay.ExpireBefore(now + 1000ms);
+            assert(h.relay.GetAbortedRunCount() == 1);
+            h.relay.ExpireBefore(now + grlrpc::FrameRelayConfig().route_timeout);
+            assert(h.relay.GetAbortedRunCount() == 0);
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
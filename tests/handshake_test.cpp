@@ -0,0 +1,157 @@
+// GrlRPC Handshake Tests
+// Tests for: hello/accept encoding, incremental decoding, negotiation,
+// per-connection framing with the agreed version
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "handshake.h"
+
+namespace {
+
+grlrpc::ConnectionHello MakeHello(std::vector<std::string> serializers,
+                                  std::vector<std::string> compressions, uint64_t features) {
+    grlrpc::ConnectionHello hello;
+    hello.serializers = std::move(serializers);
+    hello.compressions = std::move(compressions);
+    hello.features = features;
+    return hello;
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Hello and accept survive encoding, one byte at a time
+    std::cout << "Test 1: Handshake encoding..." << std::endl;
+    {
+        grlrpc::ConnectionHello hello = MakeHello({"binary", "json"}, {"zstd", "none"},
+                                                  grlrpc::FEATURE_ONE_WAY);
+        hello.min_version = 1;
+        hello.max_version = 3;
+        std::string wire;
+        grlrpc::HandshakeCodec::EncodeHello(hello, wire);
+        wire.append("trailing frame bytes");
+
+        size_t hello_size = wire.size() - 20;
+        for (size_t length = 0; length < hello_size; ++length) {
+            grlrpc::ConnectionHello partial;
+            size_t consumed = 0;
+            assert(grlrpc::HandshakeCodec::DecodeHello(wire.data(), length, partial, consumed) ==
+                   grlrpc::HandshakeParse::INCOMPLETE);
+        }
+        grlrpc::ConnectionHello decoded;
+        size_t consumed = 0;
+        assert(grlrpc::HandshakeCodec::DecodeHello(wire.data(), wire.size(), decoded, consumed) ==
+               grlrpc::HandshakeParse::OK);
+        assert(consumed == hello_size);
+        assert(decoded.min_version == 1 && decoded.max_version == 3);
+        assert(decoded.serializers == hello.serializers);
+        assert(decoded.compressions == hello.compressions);
+        assert(decoded.features == grlrpc::FEATURE_ONE_WAY);
+
+        grlrpc::HandshakeAccept accept;
+        accept.accepted = true;
+        accept.version = 1;
+        accept.serializer = "binary";
+        accept.compression = "none";
+        wire.clear();
+        grlrpc::HandshakeCodec::EncodeAccept(accept, wire);
+        for (size_t length = 0; length < wire.size(); ++length) {
+            grlrpc::HandshakeAccept partial;
+            assert(grlrpc::HandshakeCodec::DecodeAccept(wire.data(), length, partial, consumed) ==
+                   grlrpc::HandshakeParse::INCOMPLETE);
+        }
+        grlrpc::HandshakeAccept decoded_accept;
+        assert(grlrpc::HandshakeCodec::DecodeAccept(wire.data(), wire.size(), decoded_accept, consumed) ==
+               grlrpc::HandshakeParse::OK);
+        assert(consumed == wire.size());
+        assert(decoded_accept.accepted && decoded_accept.version == 1);
+        assert(decoded_accept.serializer == "binary" && decoded_accept.compression == "none");
+
+        // Not a handshake at all: a hello where an accept is expected, and a frame
+        assert(grlrpc::HandshakeCodec::DecodeHello(wire.data(), wire.size(), decoded, consumed) ==
+               grlrpc::HandshakeParse::INVALID);
+        std::string frame;
+        grlrpc::MessageCodec::EncodeHeader(grlrpc::FrameHeader(), frame);
+        assert(grlrpc::HandshakeCodec::DecodeAccept(frame.data(), frame.size(), decoded_accept, consumed) ==
+               grlrpc::HandshakeParse::INVALID);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Negotiation follows the client's preferences within the common set
+    std::cout << "Test 2: Negotiation..." << std::endl;
+    {
+        grlrpc::ConnectionHello server = MakeHello({"json", "binary"}, {"lz4", "none"},
+                                                   grlrpc::FEATURE_ONE_WAY);
+        server.max_version = 2;
+        grlrpc::ConnectionHello client = MakeHello({"msgpack", "binary", "json"}, {"zstd", "lz4"},
+                                                   grlrpc::FEATURE_NONE);
+        client.max_version = 3;
+
+        grlrpc::HandshakeAccept accept = grlrpc::NegotiateConnection(server, client);
+        assert(accept.accepted);
+        assert(accept.version == 2);
+        assert(accept.serializer == "binary");
+        assert(accept.compression == "lz4");
+        assert(accept.features == grlrpc::FEATURE_NONE);
+
+        client.compressions = {"zstd"};
+        assert(grlrpc::NegotiateConnection(server, client).compression == "none");
+
+        client.serializers = {"msgpack"};
+        accept = grlrpc::NegotiateConnection(server, client);
+        assert(!accept.accepted && accept.error_message == "no common serializer");
+
+        client.serializers = {"json"};
+        client.min_version = 3;
+        accept = grlrpc::NegotiateConnection(server, client);
+        assert(!accept.accepted && accept.error_message == "no common protocol version");
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: A bound connection frames with the agreed version only
+    std::cout << "Test 3: Connection codec framing..." << std::endl;
+    {
+        grlrpc::ConnectionCodec codec;
+        grlrpc::HandshakeAccept rejected;
+        assert(!codec.Bind(rejected));
+
+        grlrpc::ConnectionHello server = MakeHello({"json"}, {"none"}, grlrpc::FEATURE_ONE_WAY);
+        grlrpc::ConnectionHello client = MakeHello({"json"}, {"none"}, grlrpc::FEATURE_ONE_WAY);
+        assert(codec.Bind(grlrpc::NegotiateConnection(server, client)));
+        assert(codec.version == grlrpc::FrameHeader::kVersion);
+        assert(codec.serializer_name == "json");
+        assert(codec.compressor == nullptr);
+        assert(codec.HasFeature(grlrpc::FEATURE_ONE_WAY));
+
+        grlrpc::FrameHeader header;
+        header.method_id = grlrpc::MethodIdOf("UserService/GetUser");
+        header.request_id = 77;
+        std::string payload(4096, 'a');
+        std::string wire;
+        std::string scratch;
+        codec.EncodeFrame(header, payload, wire, scratch);
+        assert(wire.size() == grlrpc::FrameHeader::kSize + payload.size());
+
+        grlrpc::FrameHeader decoded;
+        std::string_view body;
+        assert(codec.DecodeFrame(wire.data(), wire.size(), payload.size(), decoded, body, scratch));
+        assert(decoded.request_id == 77 && body == payload);
+        assert(!codec.DecodeFrame(wire.data(), wire.size(), payload.size() - 1, decoded, body, scratch));
+        assert(!codec.DecodeFrame(wire.data(), wire.size() - 1, payload.size(), decoded, body, scratch));
+
+        // Versions outside what this build speaks never decode
+        wire[2] = static_cast<char>(grlrpc::FrameHeader::kVersion + 1);
+        assert(!grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), decoded));
+        assert(!codec.DecodeFrame(wire.data(), wire.size(), payload.size(), decoded, body, scratch));
+
+        // A compressed frame on a connection that agreed on "none" is refused
+        wire[2] = static_cast<char>(grlrpc::FrameHeader::kVersion);
+        wire[3] = static_cast<char>(grlrpc::FRAME_FLAG_COMPRESSED);
+        assert(!codec.DecodeFrame(wire.data(), wire.size(), payload.size(), decoded, body, scratch));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+// GrlRPC HTTP Gateway Tests
+// Tests for: incremental parsing, pipelining, dispatch, error responses, JSON bodies
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "http_gateway.h"
+#include "serialization_framework.h"
+
+namespace {
+struct EchoRequest {
+    std::string name;
+    int32_t count = 0;
+    std::string blob;
+};
+}
+
+int main() {
+    // Test 1: Headers split across reads are completed on the next call
+    std::cout << "Test 1: Incremental parse..." << std::endl;
+    {
+        grlrpc::HttpRequestParser parser;
+        grlrpc::HttpRequestView request;
+        size_t consumed = 0;
+        std::string buffer = "POST /Echo HTTP/1.1\r\nHost: x\r\nContent-Le";
+        assert(parser.Parse(buffer, request, consumed) == grlrpc::HttpParseStatus::INCOMPLETE);
+        buffer += "ngth: 5\r\n\r";
+        assert(parser.Parse(buffer, request, consumed) == grlrpc::HttpParseStatus::INCOMPLETE);
+        buffer += "\nhel";
+        assert(parser.Parse(buffer, request, consumed) == grlrpc::HttpParseStatus::INCOMPLETE);
+        buffer += "lo";
+        assert(parser.Parse(buffer, request, consumed) == grlrpc::HttpParseStatus::COMPLETE);
+        assert(consumed == buffer.size());
+        assert(request.method == "POST");
+        assert(request.target == "/Echo");
+        assert(request.GetHeader("host") == "x");
+        assert(request.body == "hello");
+        assert(request.keep_alive);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Malformed and unsupported requests
+    std::cout << "Test 2: Parse errors..." << std::endl;
+    {
+        grlrpc::HttpRequestParser parser(64, 16);
+        grlrpc::HttpRequestView request;
+        size_t consumed = 0;
+        assert(parser.Parse("GARBAGE\r\n\r\n", request, consumed) ==
+               grlrpc::HttpParseStatus::BAD_REQUEST);
+        assert(parser.Parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                            request, consumed) == grlrpc::HttpParseStatus::UNSUPPORTED);
+        assert(parser.Parse("POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\n",
+                            request, consumed) == grlrpc::HttpParseStatus::TOO_LARGE);
+        assert(parser.Parse(std::string(100, 'a'), request, consumed) ==
+               grlrpc::HttpParseStatus::TOO_LARGE);
+        // A repeated Content-Length, equal or not, could frame the body two ways
+        assert(parser.Parse("POST / HTTP/1.1\r\nContent-Length: 0\r\ncontent-length: 5\r\n\r\nhello",
+                            request, consumed) == grlrpc::HttpParseStatus::BAD_REQUEST);
+        assert(parser.Parse("POST / HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nhi",
+                            request, consumed) == grlrpc::HttpParseStatus::BAD_REQUEST);
+        assert(parser.Parse("POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\nhi", request, consumed) ==
+               grlrpc::HttpParseStatus::COMPLETE);
+        assert(request.body == "hi");
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    grlrpc::MethodTable methods;
+    bool registered = methods.Register("Echo",
+        [](const grlrpc::RpcRequestData& request, grlrpc::RpcResponseData& response) {
+            assert(request.serializer_name == "json");
+            response.payload = request.payload;
+            return grlrpc::RpcStatus::SUCCESS;
+        });
+    assert(registered);
+    methods.Register("Fail",
+        [](const grlrpc::RpcRequestData&, grlrpc::RpcResponseData& response) {
+            response.error_message = "bad \"input\"";
+            return grlrpc::RpcStatus::INVALID_REQUEST;
+        });
+
+    // Test 3: Pipelined requests are answered in order
+    std::cout << "Test 3: Pipelining..." << std::endl;
+    {
+        grlrpc::HttpGatewayConnection connection(methods);
+        std::string input =
+            "POST /Echo HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+            "POST /Echo?trace=1 HTTP/1.1\r\nContent-Length: 4\r\n\r\n[1,2"
+            "POST /Echo HTTP/1.1\r\nContent-Length: 11\r\n\r\n{\"par";
+        std::string output;
+        bool close = false;
+        size_t consumed = connection.OnData(input, output, close);
+        assert(!close);
+        assert(output.find("HTTP/1.1 200 OK") == 0);
+        assert(output.find("Content-Length: 2\r\n\r\n{}") != std::string::npos);
+        assert(output.find("Content-Length: 4\r\n\r\n[1,2") != std::string::npos);
+
+        // The partial third request stays in the caller's buffer
+        input.erase(0, consumed);
+        input += "tial\"}";
+        output.clear();
+        consumed = connection.OnData(input, output, close);
+        assert(consumed == input.size());
+        assert(output.find("{\"partial\"}") != std::string::npos);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Routing and handler errors map to HTTP statuses
+    std::cout << "Test 4: Error responses..." << std::endl;
+    {
+        grlrpc::HttpGatewayConnection connection(methods);
+        std::string output;
+        bool close = false;
+
+        connection.OnData("GET /Echo HTTP/1.1\r\n\r\n", output, close);
+        assert(output.find("HTTP/1.1 405") == 0);
+        assert(output.find("Allow: POST") != std::string::npos);
+
+        output.clear();
+        connection.OnData("POST /Missing HTTP/1.1\r\n\r\n", output, close);
+        assert(output.find("HTTP/1.1 404") == 0);
+
+        output.clear();
+        connection.OnData("POST /Fail HTTP/1.1\r\n\r\n", output, close);
+        assert(output.find("HTTP/1.1 400") == 0);
+        assert(output.find("{\"error\":\"INVALID_REQUEST\",\"message\":\"bad \\\"input\\\"\"}") !=
+               std::string::npos);
+        assert(!close);
+
+        output.clear();
+        connection.OnData("POST /Echo HTTP/1.0\r\nContent-Length: 0\r\n\r\n", output, close);
+        assert(output.find("Connection: close") != std::string::npos);
+        assert(close);
+
+        assert(grlrpc::HttpStatusFromRpcStatus(grlrpc::RpcStatus::RATE_LIMITED) == 429);
+        assert(grlrpc::HttpStatusFromRpcStatus(grlrpc::RpcStatus::TIMEOUT) == 504);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: JSON serializer round trip, including base64 bytes
+    std::cout << "Test 5: JsonSerializer round trip..." << std::endl;
+    {
+        grlrpc::MessageDescriptor desc;
+        desc.message_name = "EchoRequest";
+        GRLRPC_REGISTER_FIELD(desc, EchoRequest, name, grlrpc::FieldType::STRING, 1);
+        GRLRPC_REGISTER_FIELD(desc, EchoRequest, count, grlrpc::FieldType::INT32, 2);
+        GRLRPC_REGISTER_FIELD(desc, EchoRequest, blob, grlrpc::FieldType::BYTES, 3);
+
+        grlrpc::RegisterBuiltinSerializers();
+        auto serializer = grlrpc::SerializerRegistry::Instance().GetSerializer("json");
+        assert(serializer != nullptr);
+
+        EchoRequest in{"alice", 3, std::string("\x00\xff\x10", 3)};
+        std::string json;
+        assert(serializer->Serialize(&in, desc, json));
+
+        EchoRequest out;
+        assert(serializer->Deserialize(json, &out, desc));
+        assert(out.name == "alice" && out.count == 3 && out.blob == in.blob);
+        assert(!serializer->Deserialize("{not json", &out, desc));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
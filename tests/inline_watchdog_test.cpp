@@ -0,0 +1,95 @@
+// GrlRPC Inline Watchdog Tests
+// Tests for: inline method options, overrun on return, overrun while running
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <vector>
+#include "inline_watchdog.h"
+
+int main() {
+    using namespace std::chrono_literals;
+
+    grlrpc::MethodTable methods;
+    grlrpc::MethodOptions inline_options;
+    inline_options.inline_safe = true;
+    inline_options.inline_budget = 50us;
+    methods.Register("Cache/Get",
+        [](const grlrpc::RpcRequestData& request, grlrpc::RpcResponseData& response) {
+            response.payload = request.payload;
+            return grlrpc::RpcStatus::SUCCESS;
+        }, inline_options);
+    methods.Register("Store/Put",
+        [](const grlrpc::RpcRequestData&, grlrpc::RpcResponseData&) {
+            return grlrpc::RpcStatus::SUCCESS;
+        });
+
+    const grlrpc::MethodEntry* get = methods.Find("Cache/Get");
+    const grlrpc::MethodEntry* put = methods.Find("Store/Put");
+
+    std::vector<grlrpc::InlineOverrun> overruns;
+    grlrpc::InlineWatchdog watchdog(2, [&](const grlrpc::InlineOverrun& overrun) {
+        overruns.push_back(overrun);
+    });
+
+    // Test 1: Options are kept on the entry
+    std::cout << "Test 1: Method options..." << std::endl;
+    {
+        assert(get->options.inline_safe);
+        assert(get->options.inline_budget == 50us);
+        assert(!put->options.inline_safe);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Run invokes the handler on the caller's thread
+    std::cout << "Test 2: Inline run..." << std::endl;
+    {
+        grlrpc::RpcRequestData request;
+        grlrpc::RpcResponseData response;
+        request.payload = "key";
+        assert(watchdog.Run(0, *get, request, response) == grlrpc::RpcStatus::SUCCESS);
+        assert(response.payload == "key");
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    auto t0 = grlrpc::RpcClock::now();
+
+    // Test 3: A handler that returns late is reported once
+    std::cout << "Test 3: Overrun on return..." << std::endl;
+    {
+        overruns.clear();
+        watchdog.Enter(1, *get, t0);
+        watchdog.Exit(1, t0 + 20us);
+        assert(overruns.empty());
+
+        watchdog.Enter(1, *get, t0);
+        watchdog.Exit(1, t0 + 80us);
+        assert(overruns.size() == 1);
+        assert(overruns[0].method == get);
+        assert(overruns[0].elapsed == 80us);
+        assert(!overruns[0].still_running);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Scan flags a handler that is still blocking its loop
+    std::cout << "Test 4: Overrun while running..." << std::endl;
+    {
+        overruns.clear();
+        uint64_t before = watchdog.GetOverrunCount();
+        watchdog.Enter(0, *get, t0);
+        assert(watchdog.Scan(t0 + 10us) == 0);
+        assert(watchdog.Scan(t0 + 1ms) == 1);
+        assert(overruns.size() == 1 && overruns[0].still_running);
+
+        // Not reported again by later scans or on return
+        assert(watchdog.Scan(t0 + 2ms) == 0);
+        watchdog.Exit(0, t0 + 3ms);
+        assert(overruns.size() == 1);
+        assert(watchdog.GetOverrunCount() == before + 1);
+        assert(watchdog.Scan(t0 + 4ms) == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,163 @@
+// GrlRPC Object Pool Tests
+// Tests for: thread cache hits and misses, spilling to and refilling from the
+// global ring, discards, concurrent acquire/release
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <set>
+#include <thread>
+#include <vector>
+#include "object_pool.h"
+
+namespace {
+
+// Pools are per type, so each test gets a type of its own and starts empty
+template<int N>
+struct Widget {
+    std::atomic<int> in_use{0};
+    int cleared = 0;
+    void Clear() { ++cleared; }
+};
+
+} // namespace
+
+int main() {
+    // Test 1: A released object is handed out again from the thread cache
+    std::cout << "Test 1: Thread cache hit and miss..." << std::endl;
+    {
+        using W = Widget<1>;
+        auto& pool = grlrpc::ObjectPool<W>::Instance();
+        W* first = pool.Acquire();
+        assert(pool.GetStats().misses == 1);
+        assert(pool.GetStats().hits == 0);
+        pool.Release(first);
+        assert(first->cleared == 1);
+
+        W* again = pool.Acquire();
+        assert(again == first);
+        grlrpc::PoolStats stats = pool.GetStats();
+        assert(stats.hits == 1 && stats.misses == 1);
+        assert(stats.HitRate() == 0.5);
+        pool.Release(again);
+
+        {
+            grlrpc::PooledPtr<W> pooled = grlrpc::MakePooled<W>();
+            assert(pooled.get() == first);
+        }
+        assert(first->cleared == 3);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: A full thread cache spills to the ring, another thread refills from it
+    std::cout << "Test 2: Spill and refill through the global ring..." << std::endl;
+    {
+        using W = Widget<2>;
+        using Pool = grlrpc::ObjectPool<W>;
+        auto& pool = Pool::Instance();
+        const size_t kCount = Pool::kLocalCapacity + 44;
+        std::set<W*> spilled;
+        std::vector<W*> objects;
+        for (size_t i = 0; i < kCount; ++i) {
+            objects.push_back(pool.Acquire());
+        }
+        // The release past kLocalCapacity moves the kBatchSize most recent ones out
+        for (W* object : objects) {
+            pool.Release(object);
+        }
+        for (size_t i = Pool::kLocalCapacity - Pool::kBatchSize; i < Pool::kLocalCapacity; ++i) {
+            spilled.insert(objects[i]);
+        }
+
+        std::thread other([&pool, &spilled]() {
+            std::vector<W*> taken;
+            for (size_t i = 0; i < Pool::kBatchSize; ++i) {
+                W* object = pool.Acquire();
+                assert(spilled.count(object) == 1);
+                spilled.erase(object);
+                taken.push_back(object);
+            }
+            // The ring is drained, so the next one is new
+            taken.push_back(pool.Acquire());
+            assert(spilled.empty());
+            for (W* object : taken) {
+                pool.Release(object);
+            }
+        });
+        other.join();
+
+        // The other thread's hits reached the shared counters when it exited
+        grlrpc::PoolStats stats = pool.GetStats();
+        assert(stats.misses == kCount + 1);
+        assert(stats.hits == Pool::kBatchSize);
+        assert(stats.discards == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Objects released while the ring is full are deleted and counted
+    std::cout << "Test 3: Discards when the ring is full..." << std::endl;
+    {
+        using W = Widget<3>;
+        using Pool = grlrpc::ObjectPool<W>;
+        auto& pool = Pool::Instance();
+        const size_t kCount = Pool::kGlobalCapacity + 3 * Pool::kLocalCapacity;
+        std::thread owner([&pool, kCount]() {
+            std::vector<W*> objects;
+            for (size_t i = 0; i < kCount; ++i) {
+                objects.push_back(pool.Acquire());
+            }
+            for (W* object : objects) {
+                pool.Release(object);
+            }
+            // Exiting spills the rest of the thread cache
+        });
+        owner.join();
+        grlrpc::PoolStats stats = pool.GetStats();
+        assert(stats.misses == kCount);
+        assert(stats.discards == kCount - Pool::kGlobalCapacity);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: No object is ever handed to two holders at once
+    std::cout << "Test 4: Concurrent acquire/release..." << std::endl;
+    {
+        using W = Widget<4>;
+        using Pool = grlrpc::ObjectPool<W>;
+        auto& pool = Pool::Instance();
+        const int kThreads = 4;
+        const int kRounds = 200;
+        std::atomic<int> double_handouts{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&pool, &double_handouts, t]() {
+                std::vector<W*> held;
+                for (int round = 0; round < kRounds; ++round) {
+                    // Batches around the cache size keep the ring busy in both directions
+                    size_t batch = Pool::kLocalCapacity / 2 + (round * 37 + t * 11) % Pool::kLocalCapacity;
+                    for (size_t i = 0; i < batch; ++i) {
+                        W* object = pool.Acquire();
+                        if (object->in_use.exchange(1) != 0) {
+                            double_handouts.fetch_add(1);
+                        }
+                        held.push_back(object);
+                    }
+                    for (W* object : held) {
+                        object->in_use.store(0);
+                        pool.Release(object);
+                    }
+                    held.clear();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(double_handouts.load() == 0);
+        grlrpc::PoolStats stats = pool.GetStats();
+        assert(stats.hits > stats.misses);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// GrlRPC Rate Limiter Tests
+// Tests for: frame header codec, token bucket, per-client/method limits,
+//            idle bucket reclaim, refunds on rejection
+
+#include <iostream>
+#include <cassert>
+#include "rate_limiter.h"
+
+using namespace std::chrono_literals;
+
+int main() {
+    // Test 1: Frame header round trip
+    std::cout << "Test 1: Frame header round trip..." << std::endl;
+    {
+        grlrpc::FrameHeader header;
+        header.flags = grlrpc::FRAME_FLAG_RESPONSE;
+        header.method_id = grlrpc::MethodIdOf("UserService/GetUser");
+        header.request_id = 0x0102030405060708ull;
+        header.deadline_ms = 250;
+        header.payload_length = 42;
+
+        std::string wire;
+        grlrpc::MessageCodec::EncodeHeader(header, wire);
+        assert(wire.size() == grlrpc::FrameHeader::kSize);
+
+        grlrpc::FrameHeader decoded;
+        assert(grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), decoded));
+        assert(decoded.HasFlag(grlrpc::FRAME_FLAG_RESPONSE));
+        assert(decoded.method_id == header.method_id);
+        assert(decoded.request_id == header.request_id);
+        assert(decoded.deadline_ms == 250);
+        assert(decoded.payload_length == 42);
+        assert(!grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size() - 1, decoded));
+        wire[0] = 'x';
+        assert(!grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), decoded));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Token bucket burst and refill
+    std::cout << "Test 2: Token bucket burst and refill..." << std::endl;
+    {
+        grlrpc::AtomicTokenBucket bucket(1000.0, 3);
+        int64_t now = 1000000000;
+        assert(bucket.TryAcquire(now));
+        assert(bucket.TryAcquire(now));
+        assert(bucket.TryAcquire(now));
+        assert(!bucket.TryAcquire(now));
+        assert(bucket.TryAcquire(now + 1000000));  // 1ms refills one token
+        assert(!bucket.TryAcquire(now + 1000000));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Per-client limits are independent
+    std::cout << "Test 3: Per-client limits..." << std::endl;
+    {
+        grlrpc::RateLimitRule rule;
+        rule.scope = grlrpc::RateLimitScope::CLIENT;
+        rule.rate_per_second = 1.0;
+        rule.burst = 2;
+        grlrpc::RateLimiter limiter({rule});
+
+        grlrpc::FrameHeader header;
+        auto now = grlrpc::RpcClock::now();
+        uint64_t alice = grlrpc::HashClientIdentity("alice");
+        uint64_t bob = grlrpc::HashClientIdentity("bob");
+        assert(limiter.Admit(header, alice, 1, now));
+        assert(limiter.Admit(header, alice, 1, now));
+        assert(!limiter.Admit(header, alice, 1, now));
+        assert(limiter.Admit(header, bob, 2, now));
+        assert(limiter.GetRejectedCount() == 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Method-scoped rule only applies to its method
+    std::cout << "Test 4: Method-scoped rule..." << std::endl;
+    {
+        grlrpc::RateLimitRule rule;
+        rule.scope = grlrpc::RateLimitScope::METHOD;
+        rule.method_id = grlrpc::MethodIdOf("UserService/CreateUser");
+        rule.rate_per_second = 1.0;
+        rule.burst = 1;
+        grlrpc::RateLimiter limiter({rule});
+
+        auto now = grlrpc::RpcClock::now();
+        grlrpc::FrameHeader create;
+        create.method_id = rule.method_id;
+        grlrpc::FrameHeader get;
+        get.method_id = grlrpc::MethodIdOf("UserService/GetUser");
+        assert(limiter.Admit(create, 1, 1, now));
+        assert(!limiter.Admit(create, 2, 2, now));
+        assert(limiter.Admit(get, 1, 1, now));
+        assert(limiter.Admit(get, 1, 1, now));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Buckets of connections that went quiet are handed to new ones
+    std::cout << "Test 5: Idle bucket reclaim..." << std::endl;
+    {
+        grlrpc::RateLimitRule rule;
+        rule.scope = grlrpc::RateLimitScope::CONNECTION;
+        rule.rate_per_second = 1.0;
+        rule.burst = 1;
+        grlrpc::RateLimiter limiter({rule}, 8);
+
+        grlrpc::FrameHeader header;
+        auto now = grlrpc::RpcClock::now();
+        for (uint64_t connection = 1; connection <= 8; ++connection) {
+            assert(limiter.Admit(header, 0, connection, now));
+        }
+        // Every slot is busy: the ninth connection shares an exhausted bucket
+        assert(!limiter.Admit(header, 0, 9, now));
+
+        // Two seconds later the first eight are idle; each newcomer gets a
+        // bucket of its own, so none is charged for another's request
+        auto later = now + 2s;
+        for (uint64_t connection = 100; connection < 108; ++connection) {
+            assert(limiter.Admit(header, 0, connection, later));
+            assert(!limiter.Admit(header, 0, connection, later));
+        }
+        // A connection still inside its burst period keeps its bucket
+        assert(limiter.Admit(header, 0, 100, later + 1s));
+        assert(!limiter.Admit(header, 0, 100, later + 1s));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: A request rejected by a later rule keeps no tokens from earlier ones
+    std::cout << "Test 6: Refund on rejection..." << std::endl;
+    {
+        grlrpc::RateLimitRule client;
+        client.scope = grlrpc::RateLimitScope::CLIENT;
+        client.rate_per_second = 1.0;
+        client.burst = 2;
+        grlrpc::RateLimitRule method;
+        method.scope = grlrpc::RateLimitScope::METHOD;
+        method.method_id = grlrpc::MethodIdOf("UserService/CreateUser");
+        method.rate_per_second = 1.0;
+        method.burst = 1;
+        grlrpc::RateLimiter limiter({client, method});
+
+        auto now = grlrpc::RpcClock::now();
+        grlrpc::FrameHeader create;
+        create.method_id = method.method_id;
+        grlrpc::FrameHeader get;
+        get.method_id = grlrpc::MethodIdOf("UserService/GetUser");
+        uint64_t alice = grlrpc::HashClientIdentity("alice");
+        assert(limiter.Admit(create, alice, 1, now));
+        for (int i = 0; i < 5; ++i) {
+            assert(!limiter.Admit(create, alice, 1, now));
+        }
+        assert(limiter.Admit(get, alice, 1, now));
+        assert(!limiter.Admit(get, alice, 1, now));
+        assert(limiter.GetRejectedCount() == 6);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+// GrlRPC Request Arena Tests
+// Tests for: bump allocation, finalizers, block retention, per-thread pool
+
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "request_arena.h"
+
+namespace {
+int destroyed = 0;
+struct Tracked {
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    ~Tracked() { ++destroyed; }
+};
+}
+
+int main() {
+    // Test 1: Allocations honour alignment
+    std::cout << "Test 1: Aligned allocation..." << std::endl;
+    {
+        grlrpc::RequestArena arena(256);
+        for (size_t align : {1, 2, 8, 16, 64}) {
+            void* p = arena.Allocate(3, align);
+            assert(reinterpret_cast<uintptr_t>(p) % align == 0);
+        }
+        void* big = arena.Allocate(4096);
+        assert(big != nullptr);
+        assert(arena.BlockCount() == 2);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Objects are destroyed on Reset, blocks are retained
+    std::cout << "Test 2: Finalizers and retention..." << std::endl;
+    {
+        grlrpc::RequestArena arena(1024, 4096);
+        Tracked* t = arena.New<Tracked>(7);
+        assert(t->value == 7);
+        arena.New<Tracked>(8);
+        arena.Allocate(2000);
+        size_t blocks = arena.BlockCount();
+        arena.Reset();
+        assert(destroyed == 2);
+        assert(arena.BytesAllocated() == 0);
+        assert(arena.BlockCount() == blocks);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: pmr containers allocate from the current request arena
+    std::cout << "Test 3: Handler-visible allocator..." << std::endl;
+    {
+        assert(grlrpc::CurrentRequestArena() == nullptr);
+        grlrpc::ArenaHandle arena = grlrpc::AcquireRequestArena();
+        {
+            grlrpc::RequestArenaScope scope(arena.get());
+            assert(grlrpc::CurrentRequestArena() == arena.get());
+            std::pmr::vector<int> values(grlrpc::CurrentRequestResource());
+            for (int i = 0; i < 100; ++i) {
+                values.push_back(i);
+            }
+            assert(arena->BytesAllocated() >= 100 * sizeof(int));
+        }
+        assert(grlrpc::CurrentRequestArena() == nullptr);
+        arena->ResponseBuffer().assign(512, 'x');
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Released arenas are reused by the same thread
+    std::cout << "Test 4: Per-thread pool reuse..." << std::endl;
+    {
+        size_t cached = grlrpc::ArenaPool::CachedCount();
+        assert(cached >= 1);
+        grlrpc::RequestArena* arena = grlrpc::ArenaPool::Acquire();
+        assert(arena->ResponseBuffer().empty());
+        assert(arena->ResponseBuffer().capacity() >= 512);
+        grlrpc::ArenaPool::Release(arena);
+        assert(grlrpc::ArenaPool::CachedCount() == cached);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,215 @@
+// GrlRPC Request Stream Tests
+// Tests for: streaming payload layout, buffered fallback, chunk hand-off, backpressure
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "request_stream.h"
+
+namespace {
+
+std::vector<std::shared_ptr<std::string>> ToFrames(grlrpc::StreamingRequestWriter& writer) {
+    std::vector<std::shared_ptr<std::string>> frames;
+    std::string frame;
+    while (writer.Next(frame)) {
+        frames.push_back(std::make_shared<std::string>(frame));
+        frame.clear();
+    }
+    return frames;
+}
+
+grlrpc::FrameView ViewOf(const std::shared_ptr<std::string>& frame) {
+    return grlrpc::FrameView{frame, 0, frame->size()};
+}
+
+} // namespace
+
+int main() {
+    struct Upload {
+        std::string head;
+        size_t bytes = 0;
+        size_t chunks = 0;
+        bool zero_copy = true;
+    };
+
+    // Reads the whole body, checking that chunks point into frame buffers
+    auto upload_handler = [](Upload& upload) {
+        return [&upload](const grlrpc::RpcRequestData& request, grlrpc::RequestStream& body,
+                         grlrpc::RpcResponseData& response) {
+            upload.head = request.payload;
+            grlrpc::StreamChunk chunk;
+            while (body.Read(chunk)) {
+                upload.bytes += chunk.data.size();
+                ++upload.chunks;
+                if (chunk.storage) {
+                    const char* begin = chunk.storage->data();
+                    upload.zero_copy = upload.zero_copy && chunk.data.data() >= begin &&
+                                       chunk.data.data() + chunk.data.size() <= begin + chunk.storage->size();
+                }
+            }
+            response.payload = std::to_string(upload.bytes);
+            return body.IsAborted() ? grlrpc::RpcStatus::NETWORK_ERROR : grlrpc::RpcStatus::SUCCESS;
+        };
+    };
+
+    // Test 1: Small uploads go through the regular buffered handler
+    std::cout << "Test 1: Buffered fallback..." << std::endl;
+    {
+        Upload upload;
+        grlrpc::MethodTable methods;
+        assert(methods.RegisterStreaming("Users/UploadAvatar", upload_handler(upload)));
+        const grlrpc::MethodEntry* entry = methods.Find("Users/UploadAvatar");
+        assert(entry && entry->IsStreaming());
+
+        grlrpc::RpcRequestData request;
+        grlrpc::EncodeStreamingPayload("{\"user_id\":7}", std::string(100, 'p'), request.payload);
+        grlrpc::RpcResponseData response;
+        assert(entry->handler(request, response) == grlrpc::RpcStatus::SUCCESS);
+        assert(upload.head == "{\"user_id\":7}");
+        assert(upload.bytes == 100 && upload.chunks == 1);
+
+        request.payload = "xx";
+        assert(entry->handler(request, response) == grlrpc::RpcStatus::INVALID_REQUEST);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: A chunked upload reaches the handler while it is being received
+    std::cout << "Test 2: Streamed upload with backpressure..." << std::endl;
+    {
+        Upload upload;
+        grlrpc::MethodTable methods;
+        methods.RegisterStreaming("Users/UploadAvatar", upload_handler(upload));
+
+        std::vector<std::thread> workers;
+        std::atomic<bool> responded{false};
+        std::string reply;
+        grlrpc::StreamingConfig config;
+        config.max_buffered_chunks = 2;
+        grlrpc::StreamingRequestDispatcher dispatcher(methods, "json",
+            [&](std::function<void()> task) { workers.emplace_back(std::move(task)); },
+            [&](uint64_t request_id, grlrpc::RpcStatus status, const grlrpc::RpcResponseData& response) {
+                assert(request_id == 9 && status == grlrpc::RpcStatus::SUCCESS);
+                reply = response.payload;
+                responded = true;
+            }, config);
+        std::atomic<int> resumed{0};
+        dispatcher.SetResumeCallback([&] { ++resumed; });
+
+        grlrpc::FrameHeader header;
+        header.request_id = 9;
+        header.method_id = grlrpc::MethodIdOf("Users/UploadAvatar");
+        std::string avatar(256 * 1024, 'a');
+        grlrpc::ChunkingConfig chunking;
+        chunking.chunk_threshold = 1024;
+        chunking.chunk_size = 4096;
+        grlrpc::StreamingRequestWriter writer(header, "{\"user_id\":7}", avatar, chunking);
+        auto frames = ToFrames(writer);
+        assert(frames.size() == 1 + avatar.size() / chunking.chunk_size);
+
+        size_t backpressured = 0;
+        for (const auto& frame : frames) {
+            grlrpc::StreamFrameResult result;
+            while ((result = dispatcher.OnFrame(ViewOf(frame))) ==
+                   grlrpc::StreamFrameResult::BACKPRESSURE) {
+                ++backpressured;
+                std::this_thread::yield();
+            }
+            assert(result == grlrpc::StreamFrameResult::DELIVERED);
+        }
+        assert(dispatcher.GetActiveCount() == 0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        assert(responded);
+        assert(reply == std::to_string(avatar.size()));
+        assert(upload.head == "{\"user_id\":7}");
+        assert(upload.bytes == avatar.size());
+        assert(upload.chunks == frames.size() - 1);
+        assert(upload.zero_copy);
+        assert(backpressured == 0 || resumed > 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Non-streaming frames and oversize streams
+    std::cout << "Test 3: Routing and limits..." << std::endl;
+    {
+        Upload upload;
+        grlrpc::MethodTable methods;
+        methods.RegisterStreaming("Users/UploadAvatar", upload_handler(upload));
+        methods.Register("Users/Get", [](const grlrpc::RpcRequestData&, grlrpc::RpcResponseData&) {
+            return grlrpc::RpcStatus::SUCCESS;
+        });
+        std::vector<std::thread> workers;
+        grlrpc::StreamingConfig config;
+        config.max_stream_size = 64 * 1024;
+        grlrpc::StreamingRequestDispatcher dispatcher(methods, "json",
+            [&](std::function<void()> task) { workers.emplace_back(std::move(task)); },
+            [](uint64_t, grlrpc::RpcStatus, const grlrpc::RpcResponseData&) {}, config);
+
+        grlrpc::ChunkingConfig chunking;
+        chunking.chunk_threshold = 1024;
+        chunking.chunk_size = 4096;
+        std::string body(128 * 1024, 'b');
+
+        // Chunked request to a regular method goes to the reassembler instead
+        grlrpc::FrameHeader header;
+        header.request_id = 1;
+        header.method_id = grlrpc::MethodIdOf("Users/Get");
+        grlrpc::FrameChunker chunker(header, body, chunking);
+        std::string frame;
+        chunker.Next(frame);
+        assert(dispatcher.OnFrame(ViewOf(std::make_shared<std::string>(frame))) ==
+               grlrpc::StreamFrameResult::NOT_STREAMING);
+
+        header.request_id = 2;
+        header.method_id = grlrpc::MethodIdOf("Users/UploadAvatar");
+        grlrpc::StreamingRequestWriter writer(header, "{}", body, chunking);
+        auto frames = ToFrames(writer);
+        assert(dispatcher.OnFrame(ViewOf(frames[0])) == grlrpc::StreamFrameResult::INVALID);
+        assert(dispatcher.GetActiveCount() == 0);
+        assert(workers.empty());
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Closing the connection wakes a handler waiting for more body
+    std::cout << "Test 4: Abort on disconnect..." << std::endl;
+    {
+        Upload upload;
+        grlrpc::MethodTable methods;
+        methods.RegisterStreaming("Users/UploadAvatar", upload_handler(upload));
+        std::vector<std::thread> workers;
+        grlrpc::RpcStatus final_status = grlrpc::RpcStatus::SUCCESS;
+        {
+            grlrpc::StreamingRequestDispatcher dispatcher(methods, "json",
+                [&](std::function<void()> task) { workers.emplace_back(std::move(task)); },
+                [&](uint64_t, grlrpc::RpcStatus status, const grlrpc::RpcResponseData&) {
+                    final_status = status;
+                });
+
+            grlrpc::FrameHeader header;
+            header.request_id = 3;
+            header.method_id = grlrpc::MethodIdOf("Users/UploadAvatar");
+            grlrpc::ChunkingConfig chunking;
+            chunking.chunk_threshold = 16;
+            chunking.chunk_size = 16;
+            std::string body(64, 'c');
+            grlrpc::StreamingRequestWriter writer(header, "{}", body, chunking);
+            auto frames = ToFrames(writer);
+            assert(dispatcher.OnFrame(ViewOf(frames[0])) == grlrpc::StreamFrameResult::DELIVERED);
+            assert(dispatcher.OnFrame(ViewOf(frames[1])) == grlrpc::StreamFrameResult::DELIVERED);
+            assert(dispatcher.GetActiveCount() == 1);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        assert(final_status == grlrpc::RpcStatus::NETWORK_ERROR);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
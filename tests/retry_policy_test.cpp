@@ -0,0 +1,101 @@
+// GrlRPC Retry Policy Tests
+// Tests for: status classification, jittered backoff, retry budget, deadlines
+
+#include <iostream>
+#include <cassert>
+#include "retry_policy.h"
+
+using namespace std::chrono_literals;
+
+int main() {
+    // Test 1: Status classification
+    std::cout << "Test 1: Status classification..." << std::endl;
+    {
+        grlrpc::RetryPolicy policy;
+        assert(policy.IsRetryable(grlrpc::RpcStatus::NETWORK_ERROR));
+        assert(policy.IsRetryable(grlrpc::RpcStatus::TIMEOUT));
+        assert(!policy.IsRetryable(grlrpc::RpcStatus::SUCCESS));
+        assert(!policy.IsRetryable(grlrpc::RpcStatus::METHOD_NOT_FOUND));
+        assert(!policy.IsRetryable(grlrpc::RpcStatus::INVALID_REQUEST));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Full-jitter backoff is capped
+    std::cout << "Test 2: Full-jitter backoff..." << std::endl;
+    {
+        grlrpc::RetryPolicyConfig config;
+        config.initial_backoff = 10ms;
+        config.max_backoff = 50ms;
+        grlrpc::RetryPolicy policy(config);
+        assert(policy.ComputeBackoff(1, 0.0) == 0ms);
+        assert(policy.ComputeBackoff(1, 1.0) == 10ms);
+        assert(policy.ComputeBackoff(3, 1.0) == 40ms);
+        assert(policy.ComputeBackoff(10, 1.0) == 50ms);
+        for (int i = 0; i < 100; ++i) {
+            assert(policy.ComputeBackoff(4) <= 50ms);
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Retry budget limits retries to a fraction of traffic
+    std::cout << "Test 3: Retry budget..." << std::endl;
+    {
+        grlrpc::RetryBudget budget(0.1, 2.0);
+        assert(budget.TryAcquire());
+        assert(budget.TryAcquire());
+        assert(!budget.TryAcquire());
+        for (int i = 0; i < 9; ++i) {
+            budget.OnRequest();
+        }
+        assert(!budget.TryAcquire());
+        budget.OnRequest();
+        assert(budget.TryAcquire());
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Retries go to a different endpoint
+    std::cout << "Test 4: Endpoint selection..." << std::endl;
+    {
+        assert(grlrpc::SelectRetryEndpoint(3, {0}) == 1);
+        assert(grlrpc::SelectRetryEndpoint(3, {2}) == 0);
+        assert(grlrpc::SelectRetryEndpoint(3, {1, 2}) == 0);
+        assert(grlrpc::SelectRetryEndpoint(3, {0, 1, 2}) == 0);
+        assert(grlrpc::SelectRetryEndpoint(1, {0}) == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Decisions honour attempts and deadline
+    std::cout << "Test 5: Retry decisions..." << std::endl;
+    {
+        grlrpc::RetryPolicyConfig config;
+        config.initial_backoff = 100ms;
+        config.max_backoff = 100ms;
+        grlrpc::RetryPolicy policy(config);
+        auto now = grlrpc::RpcClock::now();
+
+        grlrpc::RetryState state;
+        state.RecordAttempt(0);
+        auto decision = policy.Decide(grlrpc::RpcStatus::NETWORK_ERROR, state, 2, now);
+        assert(decision.ShouldRetry());
+        assert(decision.endpoint_index == 1);
+
+        decision = policy.Decide(grlrpc::RpcStatus::INVALID_REQUEST, state, 2, now);
+        assert(decision.verdict == grlrpc::RetryVerdict::NOT_RETRYABLE);
+
+        state.RecordAttempt(1);
+        state.RecordAttempt(0);
+        decision = policy.Decide(grlrpc::RpcStatus::TIMEOUT, state, 2, now);
+        assert(decision.verdict == grlrpc::RetryVerdict::ATTEMPTS_EXHAUSTED);
+
+        // A deadline already behind the earliest retry time never retries
+        grlrpc::RetryState late;
+        late.deadline = now;
+        late.RecordAttempt(0);
+        decision = policy.Decide(grlrpc::RpcStatus::TIMEOUT, late, 2, now);
+        assert(decision.verdict == grlrpc::RetryVerdict::DEADLINE_EXCEEDED);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
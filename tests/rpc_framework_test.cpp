@@ -0,0 +1,418 @@
+// GrlRPC Framework Tests
+// Tests for: request encoding, one-way calls, pending call tracking, chunking,
+// typed stubs, duplicate ids and deadline-ordered expiry, reassembly limits,
+// one-way calls on the server side
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include "rpc_framework.h"
+
+using namespace std::chrono_literals;
+
+struct SumRequest {
+    int32_t a = 0;
+    int32_t b = 0;
+};
+
+struct SumResponse {
+    int64_t sum = 0;
+};
+
+// Hand-written fast path for one of the two types
+class SumResponseTextSerializer : public grlrpc::ITypeSerializer<SumResponse> {
+public:
+    static inline int encoded = 0;
+
+    bool Serialize(const SumResponse& obj, std::string& output) override {
+        ++encoded;
+        output = std::to_string(obj.sum);
+        return true;
+    }
+    bool Deserialize(const std::string& input, SumResponse& obj) override {
+        obj.sum = std::stoll(input);
+        return true;
+    }
+    std::string GetName() const override { return "json"; }
+};
+
+GRLRPC_METHOD(SumMethod, "Math/Sum", SumRequest, SumResponse);
+GRLRPC_METHOD(MissingMethod, "Math/Missing", SumRequest, SumResponse);
+GRLRPC_METHOD(RecordMethod, "Math/Record", SumRequest, SumResponse);
+
+int main() {
+    // Test 1: One-way flag survives request encoding
+    std::cout << "Test 1: One-way request encoding..." << std::endl;
+    {
+        grlrpc::RpcRequestData request;
+        request.header.flags = grlrpc::FRAME_FLAG_ONE_WAY;
+        request.header.method_id = grlrpc::MethodIdOf("MetricsService/Push");
+        request.header.request_id = 5;
+        request.payload = "cpu=0.5";
+
+        std::string wire;
+        grlrpc::MessageCodec::EncodeRequest(request, wire);
+        assert(wire.size() == grlrpc::FrameHeader::kSize + request.payload.size());
+
+        grlrpc::FrameHeader header;
+        assert(grlrpc::MessageCodec::DecodeHeader(wire.data(), wire.size(), header));
+        assert(header.IsOneWay());
+        assert(header.payload_length == request.payload.size());
+        assert(!grlrpc::MessageCodec::ExpectsResponse(header));
+
+        header.flags = grlrpc::FRAME_FLAG_NONE;
+        assert(grlrpc::MessageCodec::ExpectsResponse(header));
+        header.flags = grlrpc::FRAME_FLAG_RESPONSE;
+        assert(!grlrpc::MessageCodec::ExpectsResponse(header));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: One-way calls are never tracked
+    std::cout << "Test 2: One-way calls are not tracked..." << std::endl;
+    grlrpc::PendingCallTable table;
+    auto now = grlrpc::RpcClock::now();
+    {
+        grlrpc::FrameHeader header;
+        header.flags = grlrpc::FRAME_FLAG_ONE_WAY;
+        header.request_id = 1;
+        bool called = false;
+        assert(!table.Track(header, [&called](grlrpc::RpcStatus, const grlrpc::RpcResponseData&) {
+            called = true;
+        }, now + 1s, now));
+        assert(table.Size() == 0);
+        assert(table.ExpireBefore(now + 2s) == 0);
+        assert(!called);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Regular calls complete or time out exactly once
+    std::cout << "Test 3: Pending call completion and timeout..." << std::endl;
+    {
+        grlrpc::RpcStatus last_status = grlrpc::RpcStatus::UNKNOWN_ERROR;
+        int calls = 0;
+        auto callback = [&](grlrpc::RpcStatus status, const grlrpc::RpcResponseData&) {
+            last_status = status;
+            ++calls;
+        };
+
+        grlrpc::FrameHeader header;
+        header.request_id = 2;
+        assert(table.Track(header, callback, now + 1s, now));
+        header.request_id = 3;
+        assert(table.Track(header, callback, now + 5s, now));
+        assert(table.Size() == 2);
+
+        grlrpc::RpcResponseData response;
+        response.request_id = 2;
+        assert(table.Complete(response));
+        assert(last_status == grlrpc::RpcStatus::SUCCESS && calls == 1);
+        assert(!table.Complete(response));
+
+        assert(table.ExpireBefore(now + 2s) == 0);
+        assert(table.ExpireBefore(now + 5s) == 1);
+        assert(last_status == grlrpc::RpcStatus::TIMEOUT && calls == 2);
+        assert(table.Size() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Interleaved chunked messages are reassembled
+    std::cout << "Test 4: Chunking and reassembly..." << std::endl;
+    {
+        grlrpc::ChunkingConfig config;
+        config.chunk_threshold = 64;
+        config.chunk_size = 40;
+
+        std::string big(150, '\0');
+        for (size_t i = 0; i < big.size(); ++i) {
+            big[i] = static_cast<char>('a' + i % 26);
+        }
+        grlrpc::FrameHeader big_header;
+        big_header.request_id = 1;
+        grlrpc::FrameHeader small_header;
+        small_header.request_id = 2;
+
+        // Writer interleaves the small message between chunks of the big one
+        grlrpc::FrameChunker big_chunker(big_header, big, config);
+        grlrpc::FrameChunker small_chunker(small_header, "ping", config);
+        std::vector<std::string> frames;
+        while (!big_chunker.Done() || !small_chunker.Done()) {
+            std::string frame;
+            if (big_chunker.Next(frame)) frames.push_back(frame);
+            frame.clear();
+            if (small_chunker.Next(frame)) frames.push_back(frame);
+        }
+        assert(frames.size() == 5);  // 4 chunks + 1 small frame
+
+        grlrpc::ChunkReassembler reassembler(1024);
+        std::vector<std::string> messages;
+        for (const auto& frame : frames) {
+            grlrpc::FrameHeader header;
+            assert(grlrpc::MessageCodec::DecodeHeader(frame.data(), frame.size(), header));
+            assert(!grlrpc::MessageCodec::ExceedsMessageLimit(header, 1024));
+            std::string_view message;
+            auto status = reassembler.OnFrame(
+                header, std::string_view(frame).substr(grlrpc::FrameHeader::kSize), message);
+            if (status == grlrpc::ReassemblyStatus::COMPLETE) {
+                assert(!header.HasFlag(grlrpc::FRAME_FLAG_CHUNK));
+                assert(header.payload_length == message.size());
+                messages.emplace_back(message);
+            } else {
+                assert(status == grlrpc::ReassemblyStatus::PENDING);
+            }
+        }
+        assert(messages.size() == 2);
+        assert(messages[0] == "ping");
+        assert(messages[1] == big);
+        assert(reassembler.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Oversize messages are rejected before they are buffered
+    std::cout << "Test 5: Message size limit..." << std::endl;
+    {
+        grlrpc::FrameHeader header;
+        header.payload_length = 4096;
+        assert(grlrpc::MessageCodec::ExceedsMessageLimit(header, 1024));
+
+        grlrpc::ChunkingConfig config;
+        config.chunk_threshold = 16;
+        config.chunk_size = 16;
+        std::string big(2048, 'x');
+        grlrpc::FrameChunker chunker(header, big, config);
+        std::string frame;
+        assert(chunker.Next(frame));
+
+        grlrpc::ChunkReassembler reassembler(1024);
+        grlrpc::FrameHeader decoded;
+        assert(grlrpc::MessageCodec::DecodeHeader(frame.data(), frame.size(), decoded));
+        std::string_view message;
+        assert(reassembler.OnFrame(decoded, std::string_view(frame).substr(grlrpc::FrameHeader::kSize),
+                                   message) == grlrpc::ReassemblyStatus::TOO_LARGE);
+        assert(reassembler.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Typed stub and skeleton over a local channel
+    std::cout << "Test 6: Typed service API..." << std::endl;
+    {
+        static_assert(SumMethod::kId == grlrpc::MethodIdOf("Math/Sum"), "compile-time id");
+
+        grlrpc::RegisterBuiltinSerializers();
+        grlrpc::MessageDescriptor desc;
+        desc.message_name = "SumRequest";
+        GRLRPC_REGISTER_FIELD(desc, SumRequest, a, grlrpc::FieldType::INT32, 1);
+        GRLRPC_REGISTER_FIELD(desc, SumRequest, b, grlrpc::FieldType::INT32, 2);
+        grlrpc::ReflectionRegistry::Instance().RegisterType("SumRequest", desc);
+        grlrpc::SerializerRegistry::Instance().RegisterTypeSerializer<SumResponse>(
+            "json", std::make_unique<SumResponseTextSerializer>());
+
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json"});
+        assert(skeleton.Register<SumMethod>([](const SumRequest& request, SumResponse& response) {
+            response.sum = static_cast<int64_t>(request.a) + request.b;
+            return grlrpc::RpcStatus::SUCCESS;
+        }));
+        assert(!skeleton.Register<SumMethod>(grlrpc::TypedHandler<SumMethod>()));
+        assert(methods.Find("Math/Sum") != nullptr);
+
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<SumMethod, MissingMethod> stub(channel, "json");
+        assert(stub.IsBound());
+
+        SumResponse response;
+        assert(stub.Call<SumMethod>(SumRequest{2, 40}, response) == grlrpc::RpcStatus::SUCCESS);
+        assert(response.sum == 42);
+        assert(stub.Call<MissingMethod>(SumRequest{}, response) ==
+               grlrpc::RpcStatus::METHOD_NOT_FOUND);
+
+        int64_t async_sum = 0;
+        stub.CallAsync<SumMethod>(SumRequest{1, 2},
+            [&](grlrpc::RpcStatus status, const SumResponse& reply) {
+                assert(status == grlrpc::RpcStatus::SUCCESS);
+                async_sum = reply.sum;
+            });
+        assert(async_sum == 3);
+
+        // A format the server does not accept is rejected, not misparsed
+        grlrpc::ServiceStub<SumMethod> unbound(channel, "binary");
+        assert(!unbound.IsBound());
+        assert(unbound.Call<SumMethod>(SumRequest{}, response) ==
+               grlrpc::RpcStatus::SERIALIZATION_ERROR);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 7: Duplicate ids are refused and expiry follows deadline order
+    std::cout << "Test 7: Duplicate ids and deadline ordering..." << std::endl;
+    {
+        grlrpc::PendingCallTable calls;
+        auto start = grlrpc::RpcClock::now();
+        std::vector<uint64_t> timed_out;
+        auto on_done = [&timed_out](grlrpc::RpcStatus status, const grlrpc::RpcResponseData& response) {
+            if (status == grlrpc::RpcStatus::TIMEOUT) {
+                timed_out.push_back(response.request_id);
+            }
+        };
+
+        grlrpc::FrameHeader header;
+        header.request_id = 9;
+        assert(calls.Track(header, on_done, start + 10s, start));
+        grlrpc::RpcStatus duplicate_status = grlrpc::RpcStatus::SUCCESS;
+        assert(!calls.Track(header, [&](grlrpc::RpcStatus status, const grlrpc::RpcResponseData&) {
+            duplicate_status = status;
+        }, start + 1s, start));
+        assert(duplicate_status == grlrpc::RpcStatus::INVALID_REQUEST);
+        assert(calls.Size() == 1);
+        // The original call keeps its own deadline
+        assert(calls.ExpireBefore(start + 5s) == 0);
+
+        // Enough calls to grow the table, deadlines out of id order, some
+        // without a deadline, some completed before they expire
+        const uint64_t kCalls = 1000;
+        for (uint64_t id = 100; id < 100 + kCalls; ++id) {
+            header.request_id = id;
+            auto deadline = id % 10 == 0 ? grlrpc::RpcClock::time_point::max()
+                                         : start + std::chrono::milliseconds((id * 7919) % 1000);
+            assert(calls.Track(header, on_done, deadline, start));
+        }
+        assert(calls.Size() == kCalls + 1);
+        grlrpc::RpcResponseData response;
+        for (uint64_t id = 101; id < 100 + kCalls; id += 3) {
+            response.request_id = id;
+            assert(calls.Complete(response));
+        }
+        size_t remaining = calls.Size();
+
+        size_t first_sweep = calls.ExpireBefore(start + 500ms);
+        size_t expired = first_sweep + calls.ExpireBefore(start + 1000ms);
+        assert(first_sweep > 0 && expired > first_sweep);
+        assert(calls.Size() + expired == remaining);
+        // Each sweep expires in deadline order
+        for (size_t i = 1; i < timed_out.size(); ++i) {
+            if (i != first_sweep) {
+                assert((timed_out[i - 1] * 7919) % 1000 <= (timed_out[i] * 7919) % 1000);
+            }
+        }
+        for (uint64_t id : timed_out) {
+            assert(id % 10 != 0 && id % 3 != 2);
+        }
+
+        // Left: the calls without a deadline, and id 9
+        assert(calls.ExpireBefore(start + 10s) == 1);
+        for (uint64_t id = 100; id < 100 + kCalls; id += 10) {
+            response.request_id = id;
+            assert(calls.Complete(response) == (id % 3 != 2));
+        }
+        assert(calls.Size() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 8: Announced totals are not buffered up front, buffered bytes are capped
+    std::cout << "Test 8: Reassembly buffering limits..." << std::endl;
+    {
+        grlrpc::ChunkReassembler reassembler(1024 * 1024, 64, 1024);
+        auto first_chunk = [](uint32_t total, const std::string& data) {
+            std::string payload(4, '\0');
+            for (int i = 0; i < 4; ++i) {
+                payload[i] = static_cast<char>((total >> (8 * i)) & 0xFF);
+            }
+            return payload + data;
+        };
+        grlrpc::FrameHeader header;
+        std::string_view message;
+        // Headers announcing a megabyte each hold only what they carry
+        for (uint64_t id = 1; id <= 64; ++id) {
+            header.flags = grlrpc::FRAME_FLAG_CHUNK;
+            header.request_id = id;
+            assert(reassembler.OnFrame(header, first_chunk(1024 * 1024, "12345678"), message) ==
+                   grlrpc::ReassemblyStatus::PENDING);
+        }
+        assert(reassembler.GetPendingCount() == 64);
+        assert(reassembler.GetPendingBytes() == 64 * 8);
+
+        // A chunk that would pass the byte cap drops its message
+        header.request_id = 1;
+        assert(reassembler.OnFrame(header, std::string(600, 'x'), message) ==
+               grlrpc::ReassemblyStatus::TOO_LARGE);
+        assert(reassembler.GetPendingCount() == 63);
+        assert(reassembler.GetPendingBytes() == 63 * 8);
+        for (uint64_t id = 2; id <= 64; ++id) {
+            reassembler.Discard(id);
+        }
+        assert(reassembler.GetPendingBytes() == 0);
+
+        // A message that completes gives its bytes back
+        header.request_id = 100;
+        assert(reassembler.OnFrame(header, first_chunk(1000, std::string(500, 'a')), message) ==
+               grlrpc::ReassemblyStatus::PENDING);
+        header.request_id = 101;
+        assert(reassembler.OnFrame(header, first_chunk(1000, std::string(600, 'b')), message) ==
+               grlrpc::ReassemblyStatus::TOO_LARGE);
+        header.request_id = 100;
+        header.flags = grlrpc::FRAME_FLAG_NONE;
+        assert(reassembler.OnFrame(header, std::string(500, 'a'), message) ==
+               grlrpc::ReassemblyStatus::COMPLETE);
+        assert(message == std::string(1000, 'a'));
+        assert(reassembler.GetPendingBytes() == 0 && reassembler.GetPendingCount() == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 9: One-way requests run their handler but produce no response payload
+    std::cout << "Test 9: One-way calls on the server..." << std::endl;
+    {
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json"});
+        int64_t last_sum = 0;
+        auto handler = [&](const SumRequest& request, SumResponse& response) {
+            last_sum = response.sum = static_cast<int64_t>(request.a) + request.b;
+            return grlrpc::RpcStatus::SUCCESS;
+        };
+        grlrpc::MethodOptions one_way;
+        one_way.one_way = true;
+        assert(skeleton.Register<SumMethod>(handler));
+        assert(skeleton.Register<RecordMethod>(handler, one_way));
+        assert(methods.Register("Math/Raw", [](const grlrpc::RpcRequestData&, grlrpc::RpcResponseData& reply) {
+            reply.payload = "raw";
+            return grlrpc::RpcStatus::SUCCESS;
+        }));
+
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<SumMethod, RecordMethod> stub(channel, "json");
+        int encoded = SumResponseTextSerializer::encoded;
+        assert(stub.Send<SumMethod>(SumRequest{3, 4}) == grlrpc::RpcStatus::SUCCESS);
+        assert(last_sum == 7 && SumResponseTextSerializer::encoded == encoded);
+
+        // The response is skipped before it is encoded, not after
+        grlrpc::RpcRequestData request;
+        request.header.flags = grlrpc::FRAME_FLAG_ONE_WAY;
+        request.header.method_id = SumMethod::kId;
+        request.serializer_name = "json";
+        request.payload = "{\"a\":1,\"b\":2}";
+        grlrpc::RpcResponseData reply;
+        assert(channel.Call(request, reply) == grlrpc::RpcStatus::SUCCESS);
+        assert(last_sum == 3 && reply.payload.empty());
+        assert(SumResponseTextSerializer::encoded == encoded);
+
+        // A one-way method never answers, whatever the caller asked for
+        request.header.flags = grlrpc::FRAME_FLAG_NONE;
+        request.header.method_id = RecordMethod::kId;
+        assert(channel.Call(request, reply) == grlrpc::RpcStatus::SUCCESS);
+        assert(reply.payload.empty() && SumResponseTextSerializer::encoded == encoded);
+        assert(!methods.Find(RecordMethod::kId)->ExpectsResponse(request.header));
+
+        // Raw handlers may fill the payload; it is dropped all the same
+        request.header.flags = grlrpc::FRAME_FLAG_ONE_WAY;
+        request.header.method_id = grlrpc::MethodIdOf("Math/Raw");
+        assert(channel.Call(request, reply) == grlrpc::RpcStatus::SUCCESS);
+        assert(reply.payload.empty());
+
+        // Regular calls still get their response
+        SumResponse response;
+        assert(stub.Call<SumMethod>(SumRequest{5, 6}, response) == grlrpc::RpcStatus::SUCCESS);
+        assert(response.sum == 11 && SumResponseTextSerializer::encoded == encoded + 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+// GrlRPC Shard Router Tests
+// Tests for: MPSC queue, routing key extraction, cross-shard forwarding,
+// rejected dispatch
+
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include "shard_router.h"
+
+int main() {
+    // Test 1: MPSC queue with concurrent producers
+    std::cout << "Test 1: MPSC queue with concurrent producers..." << std::endl;
+    {
+        grlrpc::MpscQueue<uint64_t> queue(1024);
+        const int kProducers = 4;
+        const uint64_t kPerProducer = 10000;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&queue, p, kPerProducer]() {
+                for (uint64_t i = 1; i <= kPerProducer; ++i) {
+                    while (!queue.TryPush(i + p * kPerProducer)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        uint64_t sum = 0;
+        uint64_t count = 0;
+        uint64_t value = 0;
+        while (count < kProducers * kPerProducer) {
+            if (queue.TryPop(value)) {
+                sum += value;
+                ++count;
+            }
+        }
+        for (auto& t : producers) {
+            t.join();
+        }
+        uint64_t n = kProducers * kPerProducer;
+        assert(sum == n * (n + 1) / 2);
+        assert(!queue.TryPop(value));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Routing key read without decoding the payload
+    std::cout << "Test 2: Routing key extraction..." << std::endl;
+    {
+        grlrpc::ShardRouter router(8);
+        uint32_t get_user = grlrpc::MethodIdOf("UserService/GetUser");
+        router.SetKeyExtractor(get_user, grlrpc::FixedOffsetKeyExtractor(0));
+
+        std::string payload(8, '\0');
+        payload[0] = 42;
+        grlrpc::FrameHeader header;
+        header.method_id = get_user;
+        size_t shard = router.Route(header, payload);
+        assert(shard == router.ShardOf(42));
+        assert(shard < 8);
+        assert(router.Route(header, payload.substr(0, 4)) == grlrpc::ShardRouter::kAnyShard);
+
+        header.method_id = grlrpc::MethodIdOf("UserService/CreateUser");
+        assert(router.Route(header, payload) == grlrpc::ShardRouter::kAnyShard);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Tasks for a foreign shard are forwarded, local ones run inline
+    std::cout << "Test 3: Cross-shard forwarding..." << std::endl;
+    {
+        grlrpc::ShardExecutor executor(2);
+        grlrpc::ShardLocal<int> counters(2);
+        int wakeups = 0;
+        executor.SetWakeup(1, [&wakeups]() { ++wakeups; });
+
+        grlrpc::ShardExecutor::BindCurrentThread(0);
+        assert(executor.Dispatch(0, [&counters]() { ++counters.Get(0); }));
+        assert(counters.Get(0) == 1);
+        assert(executor.Dispatch(1, [&counters]() { ++counters.Get(1); }));
+        assert(counters.Get(1) == 0);
+        assert(wakeups == 1);
+        assert(executor.GetForwardedCount(1) == 1);
+
+        std::thread owner([&executor]() {
+            grlrpc::ShardExecutor::BindCurrentThread(1);
+            assert(executor.Drain(1) == 1);
+        });
+        owner.join();
+        assert(counters.Get(1) == 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: A rejected task stays with the caller
+    std::cout << "Test 4: Rejected dispatch keeps the task..." << std::endl;
+    {
+        grlrpc::ShardExecutor executor(2, 2);
+        grlrpc::ShardExecutor::BindCurrentThread(0);
+        int ran = 0;
+        for (int i = 0; i < 2; ++i) {
+            assert(executor.Dispatch(1, [&ran]() { ++ran; }));
+        }
+        int replied = 0;
+        grlrpc::ShardTask task = [&replied]() { ++replied; };
+        assert(!executor.Dispatch(1, task));
+        assert(task);
+        task();
+        assert(replied == 1);
+
+        grlrpc::ShardTask stray = [&ran]() { ++ran; };
+        assert(!executor.Dispatch(7, stray));
+        assert(stray);
+
+        grlrpc::ShardExecutor::BindCurrentThread(1);
+        assert(executor.Drain(1) == 2);
+        assert(ran == 2);
+        grlrpc::ShardExecutor::BindCurrentThread(grlrpc::ShardRouter::kAnyShard);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
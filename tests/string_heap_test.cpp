@@ -0,0 +1,103 @@
+// GrlRPC String Heap Tests
+// Tests for: interning, rejected values, chunk boundaries, concurrent readers and lookups
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "string_heap.h"
+
+int main() {
+    // Test 1: Equal strings share one reference
+    std::cout << "Test 1: Interning..." << std::endl;
+    {
+        grlrpc::StringHeap heap;
+        uint32_t a = heap.Intern("@example.com");
+        uint32_t b = heap.Intern("@mail.test");
+        assert(a != grlrpc::StringHeap::kNone && b != grlrpc::StringHeap::kNone && a != b);
+        assert(heap.Intern(std::string("@example.com")) == a);
+        assert(heap.View(a) == "@example.com" && heap.View(b) == "@mail.test");
+        assert(heap.Size() == 2 && heap.Capacity() == grlrpc::StringHeap::kChunkSize);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Empty and over-long values are not interned
+    std::cout << "Test 2: Rejected values..." << std::endl;
+    {
+        grlrpc::StringHeap heap;
+        assert(heap.Intern("") == grlrpc::StringHeap::kNone);
+        assert(heap.Intern(std::string(grlrpc::StringHeap::kMaxLength + 1, 'x')) == grlrpc::StringHeap::kNone);
+        std::string longest(grlrpc::StringHeap::kMaxLength, 'y');
+        assert(heap.View(heap.Intern(longest)) == longest);
+        assert(heap.Size() == 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Entries never straddle chunks and stay put as the heap grows
+    std::cout << "Test 3: Chunk boundaries..." << std::endl;
+    {
+        grlrpc::StringHeap heap;
+        std::vector<std::pair<uint32_t, std::string>> entries;
+        for (int i = 0; i < 2000; ++i) {
+            std::string value = std::to_string(i) + std::string(100, 'a' + i % 26);
+            entries.emplace_back(heap.Intern(value), value);
+        }
+        assert(heap.Capacity() > grlrpc::StringHeap::kChunkSize);
+        for (const auto& entry : entries) {
+            assert(heap.View(entry.first) == entry.second);
+            assert(heap.Intern(entry.second) == entry.first);
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Readers view references handed over while writers intern
+    std::cout << "Test 4: Concurrent interning..." << std::endl;
+    {
+        grlrpc::StringHeap heap;
+        std::atomic<uint32_t> published[256];
+        for (auto& ref : published) {
+            ref.store(grlrpc::StringHeap::kNone);
+        }
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&] {
+                for (int round = 0; round < 50; ++round) {
+                    for (int i = 0; i < 256; ++i) {
+                        std::string value = "@domain" + std::to_string(i) + ".test";
+                        uint32_t ref = heap.Intern(value);
+                        uint32_t expected = grlrpc::StringHeap::kNone;
+                        if (!published[i].compare_exchange_strong(expected, ref, std::memory_order_release)) {
+                            assert(expected == ref);
+                        }
+                    }
+                }
+            });
+        }
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            while (!done.load()) {
+                for (int i = 0; i < 256; ++i) {
+                    uint32_t ref = published[i].load(std::memory_order_acquire);
+                    if (ref != grlrpc::StringHeap::kNone) {
+                        std::string value = "@domain" + std::to_string(i) + ".test";
+                        assert(heap.View(ref) == value);
+                        // Found without the lock, in whichever table is current
+                        assert(heap.Intern(value) == ref);
+                    }
+                }
+            }
+        });
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        done.store(true);
+        reader.join();
+        assert(heap.Size() == 256);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
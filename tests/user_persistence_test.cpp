@@ -0,0 +1,528 @@
+// GrlRPC User Persistence Tests
+// Tests for: log framing, group commit, restart recovery, snapshots, torn tails, parallel replay,
+//            bulk export and import, failed syncs, records with user id 0
+
+#include <iostream>
+#include <cassert>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "user_persistence.h"
+#include "user_service.h"
+#include "user_store.h"
+#include "write_ahead_log.h"
+#include <sys/resource.h>
+
+namespace {
+
+std::string MakeTempDir() {
+    char pattern[] = "/tmp/grlrpc_persistence_XXXXXX";
+    char* dir = mkdtemp(pattern);
+    assert(dir);
+    return dir;
+}
+
+grlrpc::PersistenceConfig ManualSnapshots(size_t replay_threads = 0) {
+    grlrpc::PersistenceConfig config;
+    config.snapshot_interval = std::chrono::milliseconds(0);
+    config.replay_threads = replay_threads;
+    return config;
+}
+
+std::map<uint64_t, std::string> Dump(const grlrpc::UserStore& store) {
+    std::map<uint64_t, std::string> users;
+    store.ForEach([&](const grlrpc::UserRecord& record) {
+        users[record.user_id] = record.name + "|" + record.email + "|" + std::to_string(record.age) +
+                                "|" + std::to_string(record.updated_at_ms) + "|" + record.avatar;
+    });
+    return users;
+}
+
+uint64_t Create(grlrpc::UserService& service, const std::string& name, const std::string& avatar = "") {
+    grlrpc::CreateUserRequest request;
+    request.name = name;
+    request.email = name + "@example.com";
+    request.age = 20;
+    request.avatar = avatar;
+    grlrpc::CreateUserResponse response;
+    service.CreateUser(request, response);
+    assert(response.success);
+    return response.user_id;
+}
+
+void SetAge(grlrpc::UserService& service, uint64_t user_id, int32_t age) {
+    grlrpc::UpdateUserRequest request;
+    request.user_id = user_id;
+    request.age = age;
+    grlrpc::UpdateUserResponse response;
+    service.UpdateUser(request, response);
+    assert(response.success);
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Record framing stops at a torn or corrupt tail
+    std::cout << "Test 1: Log record framing..." << std::endl;
+    {
+        std::string log;
+        grlrpc::AppendLogRecord(1, "first", log);
+        grlrpc::AppendLogRecord(2, "", log);
+        size_t intact = log.size();
+        grlrpc::AppendLogRecord(3, "third", log);
+
+        std::vector<std::string> seen;
+        auto visit = [&](uint8_t type, std::string_view payload) {
+            seen.push_back(std::to_string(type) + ":" + std::string(payload));
+        };
+        assert(grlrpc::ParseLogRecords(log, visit) == log.size());
+        assert(seen.size() == 3 && seen[0] == "1:first" && seen[1] == "2:" && seen[2] == "3:third");
+
+        seen.clear();
+        std::string torn = log.substr(0, log.size() - 2);
+        assert(grlrpc::ParseLogRecords(torn, visit) == intact && seen.size() == 2);
+
+        seen.clear();
+        std::string corrupt = log;
+        corrupt.back() ^= 0x01;
+        assert(grlrpc::ParseLogRecords(corrupt, visit) == intact && seen.size() == 2);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Buffered records share one sync; concurrent writers all commit
+    std::cout << "Test 2: Group commit..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        {
+            grlrpc::WriteAheadLog log(dir);
+            std::string error;
+            assert(log.Open(error));
+            log.Append(1, "a");
+            log.Append(1, "b");
+            uint64_t lsn = log.Append(1, "c");
+            assert(log.WaitDurable(lsn));
+            assert(log.GetSyncCount() == 1);
+            assert(log.WaitDurable(1) && log.GetSyncCount() == 1);
+
+            std::vector<std::thread> writers;
+            for (int t = 0; t < 8; ++t) {
+                writers.emplace_back([&log] {
+                    for (int i = 0; i < 50; ++i) {
+                        assert(log.WaitDurable(log.Append(2, "payload")));
+                    }
+                });
+            }
+            for (auto& writer : writers) {
+                writer.join();
+            }
+            assert(log.GetSyncCount() <= 1 + 8 * 50);
+        }
+
+        std::vector<uint64_t> segments = grlrpc::WriteAheadLog::ListSegments(dir);
+        assert(segments.size() == 1);
+        grlrpc::MappedFile file;
+        std::string error;
+        assert(file.Open(grlrpc::WriteAheadLog::SegmentPath(dir, segments[0]), error));
+        size_t records = 0;
+        assert(grlrpc::ParseLogRecords(file.Data(), [&](uint8_t, std::string_view) { ++records; }) ==
+               file.Data().size());
+        assert(records == 3 + 8 * 50);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Creates and updates survive a restart through the log alone
+    std::cout << "Test 3: Recovery from the log..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        std::map<uint64_t, std::string> before;
+        uint64_t last_id = 0;
+        {
+            grlrpc::UserStore store(4, 16);
+            grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+            std::string error;
+            assert(persistence.Open(error));
+            grlrpc::UserService service(store, &persistence);
+            for (int i = 0; i < 100; ++i) {
+                last_id = Create(service, "u" + std::to_string(i), i % 3 == 0 ? std::string(64, 'a' + i % 26) : "");
+            }
+            for (uint64_t id = 1; id <= 100; id += 2) {
+                SetAge(service, id, 30 + static_cast<int32_t>(id));
+            }
+            before = Dump(store);
+        }
+
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+        std::string error;
+        assert(persistence.Open(error));
+        assert(persistence.GetRecoveryStats().log_records == 150);
+        assert(persistence.GetRecoveryStats().snapshot_users == 0);
+        assert(Dump(store) == before);
+        grlrpc::GetUserResponse user;
+        assert(store.FindByEmail("u42@example.com", false, user) && user.user_id == 43);
+
+        // Ids keep counting from where the previous run stopped
+        grlrpc::UserService service(store, &persistence);
+        assert(Create(service, "next") == last_id + 1);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: A snapshot replaces the log it covers; later writes replay on top
+    std::cout << "Test 4: Snapshots..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        std::map<uint64_t, std::string> before;
+        {
+            grlrpc::UserStore store(4, 16);
+            grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+            std::string error;
+            assert(persistence.Open(error));
+            grlrpc::UserService service(store, &persistence);
+            for (int i = 0; i < 50; ++i) {
+                Create(service, "s" + std::to_string(i), std::string(16, 'x'));
+            }
+            assert(persistence.Snapshot(error));
+            assert(persistence.GetSnapshotCount() == 1);
+            assert(grlrpc::WriteAheadLog::ListSegments(dir).size() == 1);
+
+            // Field updates after the snapshot must keep the snapshotted avatar
+            SetAge(service, 7, 77);
+            Create(service, "after");
+            before = Dump(store);
+        }
+
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+        std::string error;
+        assert(persistence.Open(error));
+        assert(persistence.GetRecoveryStats().snapshot_users == 50);
+        assert(persistence.GetRecoveryStats().log_records == 2);
+        assert(Dump(store) == before);
+        grlrpc::GetUserResponse user;
+        assert(store.Get(7, true, user) && user.age == 77 && user.avatar == std::string(16, 'x'));
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: A torn record at the end of the log is dropped
+    std::cout << "Test 5: Torn log tail..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        {
+            grlrpc::UserStore store(2, 16);
+            grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+            std::string error;
+            assert(persistence.Open(error));
+            grlrpc::UserService service(store, &persistence);
+            Create(service, "kept");
+        }
+        std::vector<uint64_t> segments = grlrpc::WriteAheadLog::ListSegments(dir);
+        {
+            std::ofstream tail(grlrpc::WriteAheadLog::SegmentPath(dir, segments.back()),
+                               std::ios::binary | std::ios::app);
+            tail << std::string("\x30\x00\x00\x00garbage", 11);
+        }
+
+        grlrpc::UserStore store(2, 16);
+        grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+        std::string error;
+        assert(persistence.Open(error));
+        assert(persistence.GetRecoveryStats().torn_bytes == 11);
+        assert(store.Size() == 1);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Parallel replay rebuilds the same store as a single thread
+    std::cout << "Test 6: Parallel replay..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        {
+            grlrpc::UserStore store(8, 16);
+            grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+            std::string error;
+            assert(persistence.Open(error));
+            grlrpc::UserService service(store, &persistence);
+            for (int i = 0; i < 500; ++i) {
+                Create(service, "p" + std::to_string(i));
+            }
+            assert(persistence.Snapshot(error));
+            for (int round = 0; round < 3; ++round) {
+                for (uint64_t id = 1; id <= 500; id += 3) {
+                    SetAge(service, id, round + 1);
+                }
+            }
+        }
+
+        grlrpc::UserStore serial(8, 16);
+        grlrpc::UserStore parallel(8, 16);
+        {
+            grlrpc::UserPersistence first(serial, dir, ManualSnapshots(1));
+            std::string error;
+            assert(first.Open(error));
+        }
+        {
+            grlrpc::UserPersistence second(parallel, dir, ManualSnapshots(4));
+            std::string error;
+            assert(second.Open(error));
+        }
+        assert(serial.Size() == 500);
+        assert(Dump(serial) == Dump(parallel));
+        grlrpc::GetUserResponse user;
+        assert(parallel.Get(1, false, user) && user.age == 3);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 7: An export imports into an equal store, in parallel, and
+    // doubles as a snapshot for an empty directory
+    std::cout << "Test 7: Bulk export and import..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        grlrpc::UserStore source(8, 16);
+        for (int i = 0; i < 5000; ++i) {
+            grlrpc::UserRecord record;
+            record.user_id = i * 3 + 1;
+            record.name = "user" + std::to_string(i);
+            record.email = record.name + "@example.com";
+            record.age = i % 90;
+            record.updated_at_ms = i;
+            record.avatar = i % 7 == 0 ? std::string(300, static_cast<char>(i)) : "";
+            source.Restore(record, true);
+        }
+
+        grlrpc::BulkTransferConfig config;
+        config.threads = 4;
+        grlrpc::BulkTransferStats exported;
+        std::string error;
+        std::string path = dir + "/users.export";
+        assert(grlrpc::ExportUsers(source, path, config, exported, error));
+        assert(exported.users == 5000 && exported.bytes == std::filesystem::file_size(path));
+        assert(!std::filesystem::exists(path + ".tmp"));
+
+        grlrpc::UserStore target(4, 16);
+        grlrpc::BulkTransferStats imported;
+        assert(grlrpc::ImportUsers(target, path, config, imported, error));
+        assert(imported.users == 5000 && Dump(target) == Dump(source));
+        uint64_t id = 0;
+        grlrpc::CreateUserRequest create;
+        create.name = "next";
+        assert(target.Create(create, 0, id) == grlrpc::UserStoreStatus::OK && id == 4999 * 3 + 2);
+
+        std::string data_dir = dir + "/data";
+        std::filesystem::create_directory(data_dir);
+        std::filesystem::copy_file(path, data_dir + "/snapshot");
+        grlrpc::UserStore recovered(8, 16);
+        {
+            grlrpc::UserPersistence persistence(recovered, data_dir, ManualSnapshots());
+            assert(persistence.Open(error));
+        }
+        assert(Dump(recovered) == Dump(source));
+
+        // Damage anywhere in the records is found by whichever worker owns it
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        bytes[bytes.size() / 2] ^= 0x01;
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << bytes;
+        }
+        grlrpc::UserStore damaged(4, 16);
+        assert(!grlrpc::ImportUsers(damaged, path, config, imported, error));
+        assert(error.find("corrupt") != std::string::npos);
+        assert(!grlrpc::ImportUsers(damaged, dir + "/missing", config, imported, error));
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 8: An export is one consistent view while writers keep going
+    std::cout << "Test 8: Export under writes..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        grlrpc::UserStore store(8, 16);
+        for (int i = 0; i < 2000; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "user" + std::to_string(i);
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+        }
+        // Rounds set every user's age in id order, so a consistent view
+        // sees ages that never rise with the id and differ by at most one
+        std::atomic<bool> stop{false};
+        std::thread writer([&] {
+            for (int round = 1; !stop; ++round) {
+                for (uint64_t id = 1; id <= 2000; ++id) {
+                    grlrpc::UpdateUserRequest update;
+                    update.user_id = id;
+                    update.age = round;
+                    store.Update(update, round);
+                }
+            }
+        });
+        grlrpc::BulkTransferConfig config;
+        config.threads = 3;
+        for (int i = 0; i < 5; ++i) {
+            grlrpc::BulkTransferStats stats;
+            std::string error;
+            assert(grlrpc::ExportUsers(store, dir + "/users.export", config, stats, error));
+            grlrpc::UserStore copy(8, 16);
+            assert(grlrpc::ImportUsers(copy, dir + "/users.export", config, stats, error));
+            assert(stats.users == 2000);
+            grlrpc::GetUserResponse first;
+            grlrpc::GetUserResponse user;
+            assert(copy.Get(1, false, first));
+            int32_t previous = first.age;
+            for (uint64_t id = 2; id <= 2000; ++id) {
+                assert(copy.Get(id, false, user));
+                assert(user.age <= previous && first.age - user.age <= 1);
+                previous = user.age;
+            }
+        }
+        stop = true;
+        writer.join();
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 9: After a failed write the log drops records and creates keep their id
+    std::cout << "Test 9: Failed log..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserPersistence persistence(store, dir, ManualSnapshots());
+        std::string error;
+        assert(persistence.Open(error));
+        grlrpc::UserService service(store, &persistence);
+        Create(service, "before");
+
+        // A zero file size limit makes every later write fail with EFBIG
+        std::signal(SIGXFSZ, SIG_IGN);
+        rlimit saved;
+        assert(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+        rlimit none = saved;
+        none.rlim_cur = 0;
+        assert(setrlimit(RLIMIT_FSIZE, &none) == 0);
+
+        grlrpc::CreateUserRequest request;
+        request.name = "lost";
+        request.email = "lost@example.com";
+        grlrpc::CreateUserResponse response;
+        service.CreateUser(request, response);
+        assert(setrlimit(RLIMIT_FSIZE, &saved) == 0);
+        assert(!response.success && response.error == "NOT_DURABLE");
+        assert(response.user_id == 2);
+        grlrpc::GetUserResponse user;
+        assert(store.Get(response.user_id, false, user) && user.name == "lost");
+
+        // Later writes still apply in memory but never reach the disk
+        uint64_t syncs = persistence.GetSyncCount();
+        for (uint64_t i = 0; i < 100; ++i) {
+            grlrpc::CreateUserRequest more;
+            more.name = "after" + std::to_string(i);
+            more.email = more.name + "@example.com";
+            grlrpc::CreateUserResponse reply;
+            service.CreateUser(more, reply);
+            assert(!reply.success && reply.error == "NOT_DURABLE" && reply.user_id == 3 + i);
+        }
+        assert(persistence.GetSyncCount() == syncs);
+
+        std::filesystem::create_directories(dir + "/direct");
+        grlrpc::WriteAheadLog log(dir + "/direct");
+        assert(log.Open(error));
+        assert(setrlimit(RLIMIT_FSIZE, &none) == 0);
+        bool durable = log.WaitDurable(log.Append(1, "x"));
+        assert(setrlimit(RLIMIT_FSIZE, &saved) == 0);
+        assert(!durable && log.HasFailed());
+        assert(!log.WaitDurable(log.Append(1, "y")));
+        uint64_t segment = 0;
+        assert(!log.Rotate(segment, error));
+        std::signal(SIGXFSZ, SIG_DFL);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 10: A well-formed record for user id 0 fails import and recovery
+    std::cout << "Test 10: Records with user id 0..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        grlrpc::UserStore source(2, 16);
+        grlrpc::UserRecord record;
+        record.user_id = 7;
+        record.name = "zero";
+        source.Restore(record, true);
+        grlrpc::BulkTransferConfig config;
+        grlrpc::BulkTransferStats stats;
+        std::string error;
+        std::string path = dir + "/users.export";
+        assert(grlrpc::ExportUsers(source, path, config, stats, error));
+
+        // Rewrite the id and frame the record again, so its checksum holds
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        const size_t header_size = 24;
+        uint8_t type = 0;
+        std::string payload;
+        grlrpc::ParseLogRecords(std::string_view(bytes).substr(header_size),
+                                [&](uint8_t record_type, std::string_view record_payload) {
+            type = record_type;
+            payload.assign(record_payload);
+        });
+        assert(payload.size() > sizeof(uint64_t));
+        payload.replace(0, sizeof(uint64_t), sizeof(uint64_t), '\0');
+        std::string zero = bytes.substr(0, header_size);
+        grlrpc::AppendLogRecord(type, payload, zero);
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << zero;
+        }
+
+        grlrpc::UserStore imported(2, 16);
+        assert(!grlrpc::ImportUsers(imported, path, config, stats, error));
+        assert(error.find("corrupt") != std::string::npos && imported.Size() == 0);
+
+        std::string snapshot_dir = dir + "/snapshot";
+        std::filesystem::create_directory(snapshot_dir);
+        std::filesystem::copy_file(path, snapshot_dir + "/snapshot");
+        grlrpc::UserStore from_snapshot(2, 16);
+        {
+            grlrpc::UserPersistence persistence(from_snapshot, snapshot_dir, ManualSnapshots());
+            assert(!persistence.Open(error));
+            assert(error.find("corrupt") != std::string::npos);
+        }
+        assert(from_snapshot.Size() == 0);
+
+        std::string log_dir = dir + "/log";
+        std::filesystem::create_directory(log_dir);
+        {
+            grlrpc::WriteAheadLog log(log_dir);
+            assert(log.Open(error));
+            assert(log.WaitDurable(log.Append(type, payload)));
+        }
+        grlrpc::UserStore from_log(2, 16);
+        {
+            grlrpc::UserPersistence persistence(from_log, log_dir, ManualSnapshots());
+            assert(!persistence.Open(error));
+            assert(error.find("corrupt") != std::string::npos);
+        }
+        assert(from_log.Size() == 0);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,601 @@
+// GrlRPC User Store Tests
+// Tests for: create/get/update, validation, growth, concurrent readers, user service,
+//            secondary indexes, batched multi-get, snapshot views, compact records
+
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "user_service.h"
+#include "user_store.h"
+
+int main() {
+    // Test 1: Basic create, get and partial update
+    std::cout << "Test 1: Create, get, update..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        grlrpc::CreateUserRequest create;
+        create.name = "alice";
+        create.email = "alice@example.com";
+        create.age = 30;
+        create.avatar = std::string(1000, '\x7f');
+        uint64_t id = 0;
+        assert(store.Create(create, 1000, id) == grlrpc::UserStoreStatus::OK);
+        assert(id == 1);
+
+        grlrpc::GetUserResponse user;
+        assert(store.Get(id, false, user));
+        assert(user.found && user.name == "alice" && user.email == "alice@example.com");
+        assert(user.age == 30 && user.created_at_ms == 1000 && user.avatar.empty());
+        assert(store.Get(id, true, user) && user.avatar == create.avatar);
+
+        grlrpc::UpdateUserRequest update;
+        update.user_id = id;
+        update.email = "a@example.org";
+        assert(store.Update(update, 2000) == grlrpc::UserStoreStatus::OK);
+        assert(store.Get(id, false, user));
+        assert(user.name == "alice" && user.email == "a@example.org" && user.age == 30);
+        assert(user.updated_at_ms == 2000 && user.created_at_ms == 1000);
+
+        assert(!store.Get(999, false, user) && !user.found);
+        assert(!store.Get(0, false, user));
+        update.user_id = 999;
+        assert(store.Update(update, 0) == grlrpc::UserStoreStatus::NOT_FOUND);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Invalid fields are rejected
+    std::cout << "Test 2: Validation..." << std::endl;
+    {
+        grlrpc::UserStore store(2, 16);
+        uint64_t id = 0;
+        grlrpc::CreateUserRequest create;
+        assert(store.Create(create, 0, id) == grlrpc::UserStoreStatus::INVALID_ARGUMENT);
+        create.name = std::string(grlrpc::UserStore::kMaxNameLength + 1, 'n');
+        assert(store.Create(create, 0, id) == grlrpc::UserStoreStatus::INVALID_ARGUMENT);
+        create.name = std::string(grlrpc::UserStore::kMaxNameLength, 'n');
+        assert(store.Create(create, 0, id) == grlrpc::UserStoreStatus::OK);
+        assert(store.Size() == 1);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Shards grow past their initial capacity
+    std::cout << "Test 3: Growth..." << std::endl;
+    {
+        grlrpc::UserStore store(2, 16);
+        for (int i = 0; i < 5000; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "u" + std::to_string(i);
+            create.age = i % 100;
+            uint64_t id = 0;
+            assert(store.Create(create, i, id) == grlrpc::UserStoreStatus::OK);
+        }
+        assert(store.Size() == 5000);
+        for (uint64_t id = 1; id <= 5000; ++id) {
+            grlrpc::GetUserResponse user;
+            assert(store.Get(id, false, user));
+            assert(user.name == "u" + std::to_string(id - 1));
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Readers never observe a torn record while writers update it
+    std::cout << "Test 4: Concurrent readers and writers..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 64);
+        for (int i = 0; i < 64; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "n0";
+            create.email = "e0";
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> torn{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < 4; ++r) {
+            threads.emplace_back([&] {
+                grlrpc::GetUserResponse user;
+                while (!stop) {
+                    for (uint64_t id = 1; id <= 64; ++id) {
+                        store.Get(id, false, user);
+                        // name, email and age are always written together
+                        if (user.name.substr(1) != user.email.substr(1) ||
+                            user.name.substr(1) != std::to_string(user.age)) {
+                            ++torn;
+                        }
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            for (int round = 1; round <= 2000; ++round) {
+                for (uint64_t id = 1; id <= 64; ++id) {
+                    grlrpc::UpdateUserRequest update;
+                    update.user_id = id;
+                    update.name = "n" + std::to_string(round);
+                    update.email = "e" + std::to_string(round);
+                    update.age = round;
+                    store.Update(update, round);
+                }
+            }
+            stop = true;
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(torn == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: The user service end to end over a local channel
+    std::cout << "Test 5: User service..." << std::endl;
+    {
+        grlrpc::RegisterBuiltinSerializers();
+        grlrpc::RegisterUserTypes();
+        grlrpc::UserStore store(4);
+        grlrpc::UserService service(store);
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json"});
+        assert(service.Register(skeleton));
+        assert(methods.Find(grlrpc::GetUserMethod::kId)->options.inline_safe);
+
+        // JSON payloads carry no fixed-offset key, so they are not routed
+        grlrpc::GetUserRequest keyed;
+        keyed.user_id = 42;
+        grlrpc::FrameHeader header;
+        header.method_id = grlrpc::GetUserMethod::kId;
+        grlrpc::ShardRouter json_router(4);
+        assert(!service.ConfigureRouting(json_router, "json"));
+        std::string payload;
+        assert(grlrpc::SerializerHandle<grlrpc::GetUserRequest>::Resolve("json").Serialize(keyed, payload));
+        assert(json_router.Route(header, payload) == grlrpc::ShardRouter::kAnyShard);
+
+        grlrpc::ShardRouter router(4);
+        assert(service.ConfigureRouting(router, "binary"));
+        assert(grlrpc::SerializerHandle<grlrpc::GetUserRequest>::Resolve("binary").Serialize(keyed, payload));
+        assert(router.Route(header, payload) == store.ShardOf(42));
+
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<grlrpc::GetUserMethod, grlrpc::CreateUserMethod,
+                            grlrpc::UpdateUserMethod> stub(channel, "json");
+        assert(stub.IsBound());
+
+        grlrpc::CreateUserRequest create;
+        create.name = "bob";
+        create.email = "bob@example.com";
+        create.age = 41;
+        grlrpc::CreateUserResponse created;
+        assert(stub.Call<grlrpc::CreateUserMethod>(create, created) == grlrpc::RpcStatus::SUCCESS);
+        assert(created.success && created.user_id == 1);
+
+        grlrpc::UpdateUserRequest update;
+        update.user_id = created.user_id;
+        update.age = 42;
+        grlrpc::UpdateUserResponse updated;
+        assert(stub.Call<grlrpc::UpdateUserMethod>(update, updated) == grlrpc::RpcStatus::SUCCESS);
+        assert(updated.success);
+
+        grlrpc::GetUserRequest get;
+        get.user_id = created.user_id;
+        grlrpc::GetUserResponse user;
+        assert(stub.Call<grlrpc::GetUserMethod>(get, user) == grlrpc::RpcStatus::SUCCESS);
+        assert(user.found && user.name == "bob" && user.age == 42);
+
+        get.user_id = 77;
+        assert(stub.Call<grlrpc::GetUserMethod>(get, user) == grlrpc::RpcStatus::SUCCESS);
+        assert(!user.found);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Email lookups follow creates and updates
+    std::cout << "Test 6: Email index..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        for (int i = 0; i < 1000; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "user" + std::to_string(i);
+            create.email = create.name + "@example.com";
+            uint64_t id = 0;
+            assert(store.Create(create, 0, id) == grlrpc::UserStoreStatus::OK);
+        }
+        grlrpc::GetUserResponse user;
+        assert(store.FindByEmail("user500@example.com", false, user));
+        assert(user.found && user.user_id == 501 && user.name == "user500");
+        assert(!store.FindByEmail("nobody@example.com", false, user) && !user.found);
+        assert(!store.FindByEmail("", false, user));
+
+        grlrpc::UpdateUserRequest update;
+        update.user_id = 501;
+        update.email = "moved@example.com";
+        assert(store.Update(update, 1) == grlrpc::UserStoreStatus::OK);
+        assert(!store.FindByEmail("user500@example.com", false, user));
+        assert(store.FindByEmail("moved@example.com", false, user) && user.user_id == 501);
+
+        // Duplicates resolve to the lowest id
+        update.user_id = 7;
+        assert(store.Update(update, 2) == grlrpc::UserStoreStatus::OK);
+        assert(store.FindByEmail("moved@example.com", false, user) && user.user_id == 7);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 7: Name prefix search is ordered, bounded and follows renames
+    std::cout << "Test 7: Name prefix search..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        for (const char* name : {"carol", "alice", "albert", "bob", "alina", "alice"}) {
+            grlrpc::CreateUserRequest create;
+            create.name = name;
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+        }
+        grlrpc::SearchUsersResponse result;
+        store.SearchByNamePrefix("al", 10, result);
+        assert(result.users.size() == 4 && !result.more);
+        assert(result.users[0].name == "albert");
+        assert(result.users[1].name == "alice" && result.users[1].user_id == 2);
+        assert(result.users[2].name == "alice" && result.users[2].user_id == 6);
+        assert(result.users[3].name == "alina");
+
+        store.SearchByNamePrefix("al", 2, result);
+        assert(result.users.size() == 2 && result.more);
+        store.SearchByNamePrefix("", 100, result);
+        assert(result.users.size() == 6 && result.users.back().name == "carol");
+        store.SearchByNamePrefix("zed", 10, result);
+        assert(result.users.empty() && !result.more);
+
+        grlrpc::UpdateUserRequest update;
+        update.user_id = 4;
+        update.name = "alfred";
+        store.Update(update, 1);
+        store.SearchByNamePrefix("b", 10, result);
+        assert(result.users.empty());
+        store.SearchByNamePrefix("alf", 10, result);
+        assert(result.users.size() == 1 && result.users[0].user_id == 4);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 8: Index readers only ever see matching users while writers rename
+    std::cout << "Test 8: Concurrent index readers..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 64);
+        for (int i = 0; i < 32; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "a" + std::to_string(i);
+            create.email = "a" + std::to_string(i) + "@x";
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> wrong{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < 3; ++r) {
+            threads.emplace_back([&, r] {
+                grlrpc::GetUserResponse user;
+                grlrpc::SearchUsersResponse result;
+                while (!stop) {
+                    std::string email = (r % 2 ? "a" : "b") + std::to_string(r * 7 % 32) + "@x";
+                    if (store.FindByEmail(email, false, user) && user.email != email) {
+                        ++wrong;
+                    }
+                    store.SearchByNamePrefix("b", 100, result);
+                    for (const auto& found : result.users) {
+                        if (found.name[0] != 'b' || found.email != found.name + "@x") {
+                            ++wrong;
+                        }
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            for (int round = 0; round < 500; ++round) {
+                for (uint64_t id = 1; id <= 32; ++id) {
+                    std::string name = (round % 2 ? "a" : "b") + std::to_string(id - 1);
+                    grlrpc::UpdateUserRequest update;
+                    update.user_id = id;
+                    update.name = name;
+                    update.email = name + "@x";
+                    store.Update(update, round);
+                }
+            }
+            stop = true;
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(wrong == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 9: Index lookups through the service
+    std::cout << "Test 9: Lookup methods..." << std::endl;
+    {
+        grlrpc::RegisterBuiltinSerializers();
+        grlrpc::RegisterUserTypes();
+        grlrpc::UserStore store(4);
+        grlrpc::UserService service(store);
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json"});
+        assert(service.Register(skeleton));
+        assert(methods.Find(grlrpc::FindUserByEmailMethod::kId)->options.inline_safe);
+
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<grlrpc::CreateUserMethod, grlrpc::FindUserByEmailMethod,
+                            grlrpc::SearchUsersMethod> stub(channel, "json");
+        assert(stub.IsBound());
+        for (const char* name : {"dana", "dave", "erin"}) {
+            grlrpc::CreateUserRequest create;
+            create.name = name;
+            create.email = std::string(name) + "@example.com";
+            create.age = 33;
+            grlrpc::CreateUserResponse created;
+            assert(stub.Call<grlrpc::CreateUserMethod>(create, created) == grlrpc::RpcStatus::SUCCESS);
+        }
+
+        grlrpc::FindUserByEmailRequest find;
+        find.email = "erin@example.com";
+        grlrpc::GetUserResponse user;
+        assert(stub.Call<grlrpc::FindUserByEmailMethod>(find, user) == grlrpc::RpcStatus::SUCCESS);
+        assert(user.found && user.user_id == 3 && user.name == "erin");
+
+        grlrpc::SearchUsersRequest search;
+        search.name_prefix = "da";
+        grlrpc::SearchUsersResponse result;
+        assert(stub.Call<grlrpc::SearchUsersMethod>(search, result) == grlrpc::RpcStatus::SUCCESS);
+        assert(result.users.size() == 2 && !result.more);
+        assert(result.users[0].name == "dana" && result.users[0].email == "dana@example.com");
+        assert(result.users[1].user_id == 2 && result.users[1].age == 33);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 10: BatchGetUsers answers in request order, serially and fanned out
+    std::cout << "Test 10: Batched multi-get..." << std::endl;
+    {
+        grlrpc::RegisterBuiltinSerializers();
+        grlrpc::RegisterUserTypes();
+        grlrpc::UserStore store(8, 16);
+        for (int i = 0; i < 300; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "f" + std::to_string(i);
+            create.avatar = i == 9 ? "pic" : "";
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+        }
+
+        grlrpc::UserService service(store);
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json"});
+        assert(service.Register(skeleton));
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<grlrpc::BatchGetUsersMethod> stub(channel, "json");
+        assert(stub.IsBound());
+
+        grlrpc::BatchGetUsersRequest request;
+        for (uint64_t id = 300; id >= 1; --id) {
+            request.user_ids.push_back(id);
+        }
+        request.user_ids.push_back(999);
+        request.user_ids.push_back(10);
+
+        grlrpc::FanOutPool pool(3);
+        for (grlrpc::FanOutPool* fan_out : {static_cast<grlrpc::FanOutPool*>(nullptr), &pool}) {
+            service.SetFanOutPool(fan_out);
+            for (bool include_avatar : {false, true}) {
+                request.include_avatar = include_avatar;
+                grlrpc::BatchGetUsersResponse response;
+                assert(stub.Call<grlrpc::BatchGetUsersMethod>(request, response) == grlrpc::RpcStatus::SUCCESS);
+                assert(response.users.size() == request.user_ids.size());
+                for (size_t i = 0; i < 300; ++i) {
+                    const grlrpc::GetUserResponse& user = response.users[i];
+                    assert(user.found && user.user_id == 300 - i);
+                    assert(user.name == "f" + std::to_string(299 - i));
+                }
+                assert(!response.users[300].found && response.users[300].user_id == 999);
+                assert(response.users[301].found && response.users[301].name == "f9");
+                assert(response.users[301].avatar == (include_avatar ? "pic" : ""));
+            }
+        }
+
+        request.user_ids.assign(grlrpc::UserService::kMaxBatchSize + 1, 1);
+        grlrpc::BatchGetUsersResponse response;
+        assert(stub.Call<grlrpc::BatchGetUsersMethod>(request, response) == grlrpc::RpcStatus::INVALID_REQUEST);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 11: A view keeps reading the store as it was when opened
+    std::cout << "Test 11: Snapshot views..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        uint64_t first = 0;
+        grlrpc::CreateUserRequest create;
+        create.name = "gina";
+        create.avatar = "v1";
+        store.Create(create, 0, first);
+
+        grlrpc::UserStore::ReadView view = store.OpenView();
+        assert(view.Timestamp() == store.GetCommitTimestamp());
+        grlrpc::UpdateUserRequest update;
+        update.user_id = first;
+        update.name = "gwen";
+        update.age = 50;
+        store.Update(update, 1);
+        grlrpc::UserRecord replaced;
+        replaced.user_id = first;
+        replaced.name = "gwen";
+        replaced.avatar = "v2";
+        store.Restore(replaced, true);
+        uint64_t second = 0;
+        create.name = "hal";
+        store.Create(create, 2, second);
+
+        grlrpc::GetUserResponse user;
+        assert(store.Get(view, first, true, user));
+        assert(user.name == "gina" && user.age == 0 && user.avatar == "v1");
+        assert(!store.Get(view, second, false, user) && !user.found);
+        assert(store.Get(first, true, user) && user.name == "gwen" && user.avatar == "v2");
+        assert(store.Get(second, false, user));
+        assert(store.GetCommitTimestamp() == view.Timestamp() + 3);
+
+        // Nothing the view can see is reclaimed while it is open
+        for (int i = 0; i < 1000; ++i) {
+            update.age = i + 1;
+            store.Update(update, i);
+        }
+        assert(store.Get(view, first, true, user) && user.name == "gina" && user.avatar == "v1");
+        view = store.OpenView();
+        assert(store.Get(view, first, false, user) && user.age == 1000);
+
+        size_t visited = 0;
+        store.ForEach([&](const grlrpc::UserRecord& record) {
+            ++visited;
+            assert(record.user_id != first || (record.age == 1000 && record.avatar == "v2"));
+        });
+        assert(visited == 2);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 12: Views see multi-user writes atomically in commit order while
+    // writers keep replacing versions, which are reclaimed as views close
+    std::cout << "Test 12: Consistent views under updates..." << std::endl;
+    {
+        grlrpc::UserStore store(8, 16);
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < 64; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "p" + std::to_string(i);
+            uint64_t id = 0;
+            store.Create(create, 0, id);
+            ids.push_back(id);
+        }
+
+        // Each round sets every user's age in order, so any consistent view
+        // sees ages that never increase along `ids` and differ by at most one
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> inconsistent{0};
+        std::atomic<uint64_t> views{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < 3; ++r) {
+            threads.emplace_back([&, r] {
+                grlrpc::GetUserResponse user;
+                while (!stop) {
+                    int32_t first = -1;
+                    int32_t previous = -1;
+                    if (r == 0) {
+                        std::vector<int32_t> ages;
+                        store.ForEach([&](const grlrpc::UserRecord& record) {
+                            ages.resize(std::max<size_t>(ages.size(), record.user_id), -1);
+                            ages[record.user_id - 1] = record.age;
+                        });
+                        for (uint64_t id : ids) {
+                            int32_t age = ages[id - 1];
+                            first = first < 0 ? age : first;
+                            if ((previous >= 0 && age > previous) || first - age > 1) {
+                                ++inconsistent;
+                            }
+                            previous = age;
+                        }
+                    } else {
+                        grlrpc::UserStore::ReadView view = store.OpenView();
+                        for (uint64_t id : ids) {
+                            store.Get(view, id, false, user);
+                            first = first < 0 ? user.age : first;
+                            if ((previous >= 0 && user.age > previous) || first - user.age > 1) {
+                                ++inconsistent;
+                            }
+                            previous = user.age;
+                        }
+                    }
+                    ++views;
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            for (int round = 1; round <= 1000; ++round) {
+                for (uint64_t id : ids) {
+                    grlrpc::UpdateUserRequest update;
+                    update.user_id = id;
+                    update.age = round;
+                    store.Update(update, round);
+                }
+            }
+            stop = true;
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(inconsistent == 0 && views > 0);
+        assert(store.GetReclaimedCount() > 0);
+
+        // With no view open a few more writes let everything older go
+        for (int i = 0; i < 256; ++i) {
+            grlrpc::UpdateUserRequest update;
+            update.user_id = ids[i % ids.size()];
+            update.age = 2000;
+            store.Update(update, 2000);
+        }
+        assert(store.GetPendingReclaimCount() < 256);
+        assert(store.GetReclaimedCount() + store.GetPendingReclaimCount() >= 64 * 1000 + 256);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 13: Email domains are interned and records round-trip exactly;
+    // replaced versions give their arena space back
+    std::cout << "Test 13: Compact records..." << std::endl;
+    {
+        grlrpc::UserStore store(2, 16);
+        for (int i = 0; i < 1000; ++i) {
+            grlrpc::CreateUserRequest create;
+            create.name = "user" + std::to_string(i);
+            create.email = create.name + (i % 2 ? "@example.com" : "@mail.test");
+            create.age = i;
+            uint64_t id = 0;
+            assert(store.Create(create, i, id) == grlrpc::UserStoreStatus::OK);
+        }
+        // Too short to intern, no domain at all, and the longest allowed
+        grlrpc::CreateUserRequest odd;
+        odd.name = std::string(grlrpc::UserStore::kMaxNameLength, 'n');
+        odd.email = "x@a.b";
+        odd.avatar = "png";
+        uint64_t short_id = 0, plain_id = 0, long_id = 0;
+        assert(store.Create(odd, 0, short_id) == grlrpc::UserStoreStatus::OK);
+        odd.email = "no-domain";
+        assert(store.Create(odd, 0, plain_id) == grlrpc::UserStoreStatus::OK);
+        odd.email = std::string(grlrpc::UserStore::kMaxEmailLength - 12, 'e') + "@example.com";
+        assert(store.Create(odd, 0, long_id) == grlrpc::UserStoreStatus::OK);
+
+        grlrpc::UserStoreMemory usage = store.GetMemoryUsage();
+        assert(usage.interned_strings == 2);
+        assert(usage.record_bytes > 0 && usage.record_bytes <= usage.arena_bytes);
+        assert(usage.record_bytes < 1003 * 128);
+
+        grlrpc::GetUserResponse user;
+        assert(store.Get(7, false, user) && user.name == "user6" && user.email == "user6@mail.test");
+        assert(store.Get(short_id, true, user) && user.email == "x@a.b" && user.avatar == "png");
+        assert(store.Get(plain_id, false, user) && user.email == "no-domain");
+        assert(store.Get(long_id, false, user) && user.email == odd.email && user.name == odd.name);
+        assert(store.FindByEmail("user7@example.com", false, user) && user.user_id == 8);
+
+        // Moving users between domains; the avatar survives the rewrites
+        for (int round = 0; round < 1000; ++round) {
+            grlrpc::UpdateUserRequest update;
+            update.user_id = short_id;
+            update.email = round % 2 ? "x@example.com" : "x@mail.test";
+            assert(store.Update(update, round) == grlrpc::UserStoreStatus::OK);
+        }
+        assert(store.Get(short_id, true, user) && user.email == "x@example.com" && user.avatar == "png");
+        assert(!store.FindByEmail("x@mail.test", false, user));
+        assert(store.GetMemoryUsage().interned_strings == 2);
+        // Only the versions still waiting for their epoch hold space
+        assert(store.GetPendingReclaimCount() < 256);
+        assert(store.GetMemoryUsage().record_bytes < usage.record_bytes + 256 * 160);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
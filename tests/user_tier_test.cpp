@@ -0,0 +1,334 @@
+// GrlRPC User Tier Tests
+// Tests for: S3-FIFO eviction, cold file lookups, read-through tiers,
+//            asynchronous misses, write promotion, concurrent readers,
+//            promotions surviving a restart
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "user_service.h"
+#include "user_tier.h"
+
+namespace {
+
+std::string MakeTempDir() {
+    char pattern[] = "/tmp/grlrpc_tier_XXXXXX";
+    char* dir = mkdtemp(pattern);
+    assert(dir);
+    return dir;
+}
+
+// Export `count` users with ids 1..count to `path`
+void WriteColdFile(const std::string& path, size_t count) {
+    grlrpc::UserStore source(4, 16);
+    for (size_t i = 1; i <= count; ++i) {
+        grlrpc::UserRecord record;
+        record.user_id = i;
+        record.name = "cold" + std::to_string(i);
+        record.email = record.name + "@example.com";
+        record.age = static_cast<int32_t>(i % 90);
+        record.avatar = i % 5 == 0 ? std::string(100, 'a') : "";
+        source.Restore(record, true);
+    }
+    grlrpc::BulkTransferConfig config;
+    grlrpc::BulkTransferStats stats;
+    std::string error;
+    assert(grlrpc::ExportUsers(source, path, config, stats, error));
+}
+
+grlrpc::UserCacheConfig SmallCache(size_t bytes) {
+    grlrpc::UserCacheConfig config;
+    config.capacity_bytes = bytes;
+    config.shards = 1;
+    return config;
+}
+
+} // namespace
+
+int main() {
+    // Test 1: Entries read twice survive a scan of one-time entries
+    std::cout << "Test 1: S3-FIFO eviction..." << std::endl;
+    {
+        grlrpc::UserCache cache(SmallCache(100 * 200));
+        std::string payload(100, 'x');
+        auto hit = [&](uint64_t id) { return cache.Lookup(id, [](std::string_view) {}); };
+        for (uint64_t id = 1; id <= 10; ++id) {
+            cache.Insert(id, payload);
+            assert(hit(id));
+        }
+        // A long scan pushes everything through the small queue
+        for (uint64_t id = 1000; id < 2000; ++id) {
+            cache.Insert(id, payload);
+        }
+        for (uint64_t id = 1; id <= 10; ++id) {
+            assert(hit(id));
+        }
+        assert(!hit(1000) && !hit(1500));
+
+        grlrpc::UserCacheStats stats = cache.GetStats();
+        assert(stats.promotions == 10 && stats.evictions > 900);
+        assert(stats.bytes <= 100 * 200 && stats.entries > 10);
+
+        // A scanned id coming back soon goes straight to main
+        cache.Insert(1999 - stats.entries, payload);
+        assert(cache.GetStats().ghost_hits == 1);
+
+        cache.Erase(1);
+        assert(!hit(1));
+        cache.Insert(2, "replaced");
+        std::string seen;
+        assert(cache.Lookup(2, [&](std::string_view value) { seen.assign(value); }) && seen == "replaced");
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: The cold file answers by id and notices damage
+    std::cout << "Test 2: Cold store..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        std::string path = dir + "/cold.export";
+        WriteColdFile(path, 1000);
+        grlrpc::UserColdStore cold;
+        std::string error;
+        assert(cold.Open(path, error));
+        assert(cold.Size() == 1000 && cold.MaxUserId() == 1000 && cold.IndexBytes() < 1000 * 40);
+        std::string_view payload;
+        grlrpc::UserRecord record;
+        assert(cold.Find(777, payload) && grlrpc::UserColdStore::Decode(payload, record));
+        assert(record.user_id == 777 && record.name == "cold777" && record.age == 777 % 90);
+        assert(!cold.Find(0, payload) && !cold.Find(1001, payload));
+
+        // Flip one byte inside the last record: the file still opens, that user does not read
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        bytes[bytes.size() - 3] ^= 0x20;
+        {
+            std::ofstream out(dir + "/damaged.export", std::ios::binary);
+            out << bytes;
+        }
+        grlrpc::UserColdStore damaged;
+        assert(damaged.Open(dir + "/damaged.export", error));
+        size_t unreadable = 0;
+        for (uint64_t id = 1; id <= 1000; ++id) {
+            unreadable += damaged.Find(id, payload) ? 0 : 1;
+        }
+        assert(unreadable == 1);
+        {
+            std::ofstream out(dir + "/truncated.export", std::ios::binary);
+            out << bytes.substr(0, bytes.size() - 10);
+        }
+        assert(!damaged.Open(dir + "/truncated.export", error));
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Reads go store -> cache -> cold file; misses complete on IO threads
+    std::cout << "Test 3: Read-through tiers..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        WriteColdFile(dir + "/cold.export", 1000);
+        grlrpc::UserColdStore cold;
+        std::string error;
+        assert(cold.Open(dir + "/cold.export", error));
+        grlrpc::UserStore store(4, 16);
+        grlrpc::TieredUserStore tier(store, cold);
+
+        // New users never reuse cold ids
+        grlrpc::CreateUserRequest create;
+        create.name = "hot";
+        uint64_t hot_id = 0;
+        assert(store.Create(create, 0, hot_id) == grlrpc::UserStoreStatus::OK && hot_id == 1001);
+
+        grlrpc::GetUserResponse user;
+        assert(tier.Get(hot_id, false, user) && user.name == "hot");
+        assert(tier.Get(10, true, user) && user.name == "cold10" && user.avatar.size() == 100);
+        assert(tier.Get(10, false, user) && user.avatar.empty());
+        assert(!tier.Get(5000, false, user) && !user.found && user.user_id == 5000);
+
+        grlrpc::TierStats stats = tier.GetStats();
+        assert(stats.resident_hits == 1 && stats.cold_reads == 1);
+        assert(stats.cache.hits == 1 && stats.cache.entries == 1 && stats.pending_reads == 0);
+
+        // A miss does not complete on the caller; misses for one user
+        // queued behind its read share it, later ones hit the cache
+        std::atomic<int> completed{0};
+        std::atomic<int> inline_hits{0};
+        std::thread::id caller = std::this_thread::get_id();
+        for (int i = 0; i < 8; ++i) {
+            tier.GetAsync(20 + i % 2, false, [&](grlrpc::GetUserResponse& result) {
+                assert(result.found && result.name == "cold" + std::to_string(result.user_id));
+                if (std::this_thread::get_id() == caller) {
+                    ++inline_hits;
+                }
+                ++completed;
+            });
+        }
+        while (completed < 8) {
+            std::this_thread::yield();
+        }
+        stats = tier.GetStats();
+        uint64_t hits = inline_hits.load();
+        // Each call hit the cache, joined a read or started one
+        assert(stats.cold_reads >= 3 && hits <= 6 && stats.cache.hits == 1 + hits);
+        assert(stats.cold_reads - 1 + stats.coalesced_reads + hits == 8);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Through the service, writes make cold users resident and
+    // batches read through
+    std::cout << "Test 4: Service over tiers..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        WriteColdFile(dir + "/cold.export", 1000);
+        grlrpc::UserColdStore cold;
+        std::string error;
+        assert(cold.Open(dir + "/cold.export", error));
+        grlrpc::UserStore store(4, 16);
+        grlrpc::TieredUserStore tier(store, cold);
+        grlrpc::UserService service(store);
+        service.SetTieredStore(&tier);
+
+        grlrpc::GetUserRequest get;
+        get.user_id = 42;
+        grlrpc::GetUserResponse user;
+        service.GetUser(get, user);
+        assert(user.found && user.name == "cold42");
+
+        grlrpc::UpdateUserRequest update;
+        update.user_id = 42;
+        update.age = 99;
+        grlrpc::UpdateUserResponse updated;
+        service.UpdateUser(update, updated);
+        assert(updated.success && store.Size() == 1);
+        service.GetUser(get, user);
+        assert(user.age == 99 && user.name == "cold42");
+        update.user_id = 4242;
+        service.UpdateUser(update, updated);
+        assert(!updated.success);
+        assert(tier.GetStats().made_resident == 1);
+
+        grlrpc::BatchGetUsersRequest batch;
+        batch.user_ids = {42, 1, 999, 5000, 1, 0};
+        grlrpc::BatchGetUsersResponse users;
+        service.BatchGetUsers(batch, users);
+        assert(users.users.size() == 6);
+        assert(users.users[0].age == 99 && users.users[1].name == "cold1" && users.users[2].name == "cold999");
+        assert(!users.users[3].found && users.users[4].name == "cold1" && !users.users[5].found);
+        for (size_t i = 0; i < batch.user_ids.size(); ++i) {
+            assert(users.users[i].user_id == batch.user_ids[i]);
+        }
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Readers, a small cache and writers promoting users all at once
+    std::cout << "Test 5: Concurrent tiers..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        WriteColdFile(dir + "/cold.export", 2000);
+        grlrpc::UserColdStore cold;
+        std::string error;
+        assert(cold.Open(dir + "/cold.export", error));
+        grlrpc::UserStore store(4, 16);
+        grlrpc::TierConfig config;
+        config.cache.capacity_bytes = 64 * 1024;
+        config.io_threads = 2;
+        grlrpc::TieredUserStore tier(store, cold, config);
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> bad{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([&, t] {
+                uint64_t state = t + 1;
+                grlrpc::GetUserResponse user;
+                for (int i = 0; i < 20000; ++i) {
+                    state = state * 6364136223846793005ull + 1442695040888963407ull;
+                    // Skewed: most reads land on the first 100 users
+                    uint64_t id = (state >> 33) % 4 != 0 ? (state >> 40) % 100 + 1 : (state >> 40) % 2000 + 1;
+                    if (!tier.Get(id, false, user) || user.name != "cold" + std::to_string(id)) {
+                        ++bad;
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            for (uint64_t id = 1; !stop && id <= 2000; id += 7) {
+                assert(tier.MakeResident(id));
+                grlrpc::UpdateUserRequest update;
+                update.user_id = id;
+                update.age = 1;
+                assert(store.Update(update, 0) == grlrpc::UserStoreStatus::OK);
+            }
+        });
+        for (size_t t = 0; t < 3; ++t) {
+            threads[t].join();
+        }
+        stop = true;
+        threads.back().join();
+        assert(bad == 0);
+
+        grlrpc::TierStats stats = tier.GetStats();
+        assert(stats.cache.bytes <= config.cache.capacity_bytes);
+        assert(stats.cache.hits > stats.cache.misses && stats.cache.promotions > 0);
+        assert(stats.pending_reads == 0);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: A promoted user comes back from the log with its avatar
+    std::cout << "Test 6: Promotion survives a restart..." << std::endl;
+    {
+        std::string dir = MakeTempDir();
+        WriteColdFile(dir + "/cold.export", 100);
+        grlrpc::UserColdStore cold;
+        std::string error;
+        assert(cold.Open(dir + "/cold.export", error));
+        grlrpc::PersistenceConfig persistence_config;
+        persistence_config.snapshot_interval = std::chrono::milliseconds(0);
+        {
+            grlrpc::UserStore store(4, 16);
+            grlrpc::UserPersistence persistence(store, dir + "/data", persistence_config);
+            assert(persistence.Open(error));
+            grlrpc::TieredUserStore tier(store, cold);
+            grlrpc::UserService service(store, &persistence);
+            service.SetTieredStore(&tier);
+
+            // User 35 has an avatar in the cold file only
+            grlrpc::UpdateUserRequest update;
+            update.user_id = 35;
+            update.age = 77;
+            grlrpc::UpdateUserResponse updated;
+            service.UpdateUser(update, updated);
+            assert(updated.success);
+        }
+
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserPersistence persistence(store, dir + "/data", persistence_config);
+        assert(persistence.Open(error));
+        assert(persistence.GetRecoveryStats().log_records == 2);
+        grlrpc::GetUserResponse user;
+        assert(store.Get(35, true, user));
+        assert(user.name == "cold35" && user.age == 77);
+        assert(user.avatar == std::string(100, 'a'));
+
+        // Served from the store, so the tier never reaches the cold avatar
+        grlrpc::TieredUserStore tier(store, cold);
+        assert(tier.Get(35, true, user) && user.avatar == std::string(100, 'a'));
+        assert(tier.GetStats().resident_hits == 1);
+        std::filesystem::remove_all(dir);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,262 @@
+// GrlRPC User Type Serializer Tests
+// Tests for: generic binary serializer, typed vs generic wire compatibility,
+//            list messages, JSON parsing rules, typed stubs over "binary"
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <type_traits>
+#include "serialization_framework.h"
+#include "user_service.h"
+#include "user_store.h"
+#include "user_types.h"
+
+namespace {
+
+template<typename T>
+bool GenericEncode(const T& obj, const std::string& format, std::string& output) {
+    const grlrpc::MessageDescriptor* desc = grlrpc::ReflectionRegistry::Instance().GetDescriptor(
+        grlrpc::SerializerFactory::GetDemangled<T>());
+    grlrpc::ISerializer* serializer = grlrpc::SerializerRegistry::Instance().GetSerializer(format);
+    assert(desc && serializer);
+    return serializer->Serialize(&obj, *desc, output);
+}
+
+template<typename T>
+bool GenericDecode(const std::string& input, const std::string& format, T& obj) {
+    const grlrpc::MessageDescriptor* desc = grlrpc::ReflectionRegistry::Instance().GetDescriptor(
+        grlrpc::SerializerFactory::GetDemangled<T>());
+    grlrpc::ISerializer* serializer = grlrpc::SerializerRegistry::Instance().GetSerializer(format);
+    assert(desc && serializer);
+    return serializer->Deserialize(input, &obj, *desc);
+}
+
+template<typename T>
+grlrpc::ITypeSerializer<T>& Typed(const std::string& format) {
+    grlrpc::ITypeSerializer<T>* serializer =
+        grlrpc::SerializerRegistry::Instance().GetTypeSerializer<T>(format);
+    assert(serializer);
+    return *serializer;
+}
+
+grlrpc::GetUserResponse SampleUser() {
+    grlrpc::GetUserResponse user;
+    user.user_id = 0x0102030405060708ull;
+    user.found = true;
+    user.name = "Zoë \"the\" \\admin\\\n\ttab";
+    user.email = "zoe@example.com";
+    user.age = -7;
+    user.created_at_ms = -1;
+    user.updated_at_ms = 1700000000123;
+    user.avatar = std::string("\x00\xff\x10\x80 avatar", 10);
+    return user;
+}
+
+bool SameUser(const grlrpc::GetUserResponse& a, const grlrpc::GetUserResponse& b) {
+    return a.user_id == b.user_id && a.found == b.found && a.name == b.name && a.email == b.email &&
+           a.age == b.age && a.created_at_ms == b.created_at_ms &&
+           a.updated_at_ms == b.updated_at_ms && a.avatar == b.avatar;
+}
+
+} // namespace
+
+int main() {
+    grlrpc::RegisterBuiltinSerializers();
+    grlrpc::RegisterUserTypes();
+
+    // Test 1: Generic binary layout, strict about truncation and trailing bytes
+    std::cout << "Test 1: Generic binary serializer..." << std::endl;
+    {
+        grlrpc::GetUserRequest request;
+        request.user_id = 0x1122334455667788ull;
+        request.include_avatar = true;
+        std::string bytes;
+        assert(GenericEncode(request, "binary", bytes));
+        assert(bytes == std::string("\x88\x77\x66\x55\x44\x33\x22\x11\x01", 9));
+
+        grlrpc::GetUserRequest decoded;
+        assert(GenericDecode(bytes, "binary", decoded));
+        assert(decoded.user_id == request.user_id && decoded.include_avatar);
+        assert(!GenericDecode(bytes.substr(0, 8), "binary", decoded));
+        assert(!GenericDecode(bytes + "x", "binary", decoded));
+
+        grlrpc::GetUserResponse user = SampleUser();
+        assert(GenericEncode(user, "binary", bytes));
+        grlrpc::GetUserResponse user_out;
+        assert(GenericDecode(bytes, "binary", user_out) && SameUser(user, user_out));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Typed binary encodings are byte-for-byte the generic ones
+    std::cout << "Test 2: Typed binary matches generic..." << std::endl;
+    {
+        auto check = [](const auto& obj) {
+            using T = std::decay_t<decltype(obj)>;
+            std::string generic;
+            std::string typed;
+            assert(GenericEncode(obj, "binary", generic));
+            assert(Typed<T>("binary").Serialize(obj, typed));
+            assert(typed == generic);
+
+            T decoded;
+            assert(Typed<T>("binary").Deserialize(generic, decoded));
+            std::string again;
+            assert(GenericEncode(decoded, "binary", again) && again == generic);
+            assert(!Typed<T>("binary").Deserialize(generic.substr(0, generic.size() - 1), decoded));
+            assert(!Typed<T>("binary").Deserialize(generic + '\0', decoded));
+        };
+
+        check(grlrpc::GetUserRequest{42, true});
+        check(SampleUser());
+        check(grlrpc::CreateUserRequest{"bob", "bob@example.com", 41, std::string(300, '\x01')});
+        check(grlrpc::CreateUserResponse{9, false, "INVALID_EMAIL"});
+        check(grlrpc::UpdateUserRequest{9, "", "new@example.com", 0});
+        check(grlrpc::UpdateUserResponse{9, true, ""});
+        check(grlrpc::FindUserByEmailRequest{"bob@example.com", true});
+        check(grlrpc::SearchUsersRequest{"bo", 5});
+
+        // user_id leads, as FixedOffsetKeyExtractor(0) expects
+        std::string bytes;
+        assert(Typed<grlrpc::UpdateUserRequest>("binary").Serialize(
+            grlrpc::UpdateUserRequest{0xAB, "x", "", 1}, bytes));
+        assert(static_cast<uint8_t>(bytes[0]) == 0xAB && bytes.compare(1, 7, std::string(7, '\0')) == 0);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Typed JSON and the generic JsonSerializer read each other
+    std::cout << "Test 3: Typed JSON interoperates with generic..." << std::endl;
+    {
+        grlrpc::GetUserResponse user = SampleUser();
+        user.user_id = UINT64_MAX;
+        user.name += std::string("\x01\x1f", 2);
+
+        std::string typed;
+        assert(Typed<grlrpc::GetUserResponse>("json").Serialize(user, typed));
+        grlrpc::GetUserResponse from_typed;
+        assert(GenericDecode(typed, "json", from_typed) && SameUser(user, from_typed));
+
+        std::string generic;
+        assert(GenericEncode(user, "json", generic));
+        grlrpc::GetUserResponse from_generic;
+        assert(Typed<grlrpc::GetUserResponse>("json").Deserialize(generic, from_generic));
+        assert(SameUser(user, from_generic));
+
+        grlrpc::CreateUserRequest create{"carol", "carol@example.com", 25, "png"};
+        assert(Typed<grlrpc::CreateUserRequest>("json").Serialize(create, typed));
+        assert(typed == "{\"name\":\"carol\",\"email\":\"carol@example.com\",\"age\":25,\"avatar\":\"cG5n\"}");
+
+        grlrpc::SearchUsersRequest search{"ca", 7};
+        assert(GenericEncode(search, "json", generic));
+        grlrpc::SearchUsersRequest search_out;
+        assert(Typed<grlrpc::SearchUsersRequest>("json").Deserialize(generic, search_out));
+        assert(search_out.name_prefix == "ca" && search_out.limit == 7);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: List messages in both formats; bogus counts are rejected up front
+    std::cout << "Test 4: List messages..." << std::endl;
+    {
+        grlrpc::BatchGetUsersResponse batch;
+        batch.users.push_back(SampleUser());
+        batch.users.emplace_back();
+        batch.users.back().user_id = 5;
+
+        for (const char* format : {"binary", "json"}) {
+            std::string bytes;
+            assert(Typed<grlrpc::BatchGetUsersResponse>(format).Serialize(batch, bytes));
+            grlrpc::BatchGetUsersResponse out;
+            assert(Typed<grlrpc::BatchGetUsersResponse>(format).Deserialize(bytes, out));
+            assert(out.users.size() == 2 && SameUser(out.users[0], batch.users[0]));
+            assert(out.users[1].user_id == 5 && !out.users[1].found);
+
+            grlrpc::BatchGetUsersRequest ids{{1, 2, UINT64_MAX}, true};
+            assert(Typed<grlrpc::BatchGetUsersRequest>(format).Serialize(ids, bytes));
+            grlrpc::BatchGetUsersRequest ids_out;
+            assert(Typed<grlrpc::BatchGetUsersRequest>(format).Deserialize(bytes, ids_out));
+            assert(ids_out.user_ids == ids.user_ids && ids_out.include_avatar);
+
+            grlrpc::SearchUsersResponse search;
+            search.users.push_back(grlrpc::UserSummary{3, "dave", "dave@example.com", 33});
+            search.more = true;
+            assert(Typed<grlrpc::SearchUsersResponse>(format).Serialize(search, bytes));
+            grlrpc::SearchUsersResponse search_out;
+            assert(Typed<grlrpc::SearchUsersResponse>(format).Deserialize(bytes, search_out));
+            assert(search_out.users.size() == 1 && search_out.users[0].name == "dave");
+            assert(search_out.users[0].age == 33 && search_out.more);
+        }
+
+        // Claims a billion users in a five-byte message
+        grlrpc::BatchGetUsersResponse out;
+        assert(!Typed<grlrpc::BatchGetUsersResponse>("binary").Deserialize(
+            std::string("\x00\xca\x9a\x3b\x00", 5), out));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: JSON parsing rules
+    std::cout << "Test 5: JSON parsing..." << std::endl;
+    {
+        auto& json = Typed<grlrpc::UpdateUserRequest>("json");
+        grlrpc::UpdateUserRequest out;
+        assert(json.Deserialize(" { \"age\" : 3 ,\n\"extra\":{\"a\":[1,-2.5e3,\"}\",null,true]},"
+                                "\"user_id\":12, \"name\":null }  ", out));
+        assert(out.user_id == 12 && out.age == 3 && out.name.empty());
+
+        assert(json.Deserialize("{\"name\":\"caf\\u00e9 \\ud83d\\ude00 \\/\\\"\"}", out));
+        assert(out.name == "caf\xc3\xa9 \xf0\x9f\x98\x80 /\"" && out.user_id == 0);
+
+        assert(!json.Deserialize("{\"name\":\"\\ud83d\"}", out));   // lone surrogate
+        assert(!json.Deserialize("{\"age\":1.5}", out));
+        assert(!json.Deserialize("{\"user_id\":-1}", out));
+        assert(!json.Deserialize("{\"age\":\"3\"}", out));
+        assert(!json.Deserialize("{\"age\":3", out));
+        assert(!json.Deserialize("{\"age\":3} x", out));
+        assert(!json.Deserialize("{\"age\":3,}", out));
+        assert(!json.Deserialize("{\"x\":" + std::string(200, '[') + std::string(200, ']') + "}", out));
+        assert(json.Deserialize("{}", out) && out.age == 0);
+
+        grlrpc::CreateUserRequest create;
+        assert(!Typed<grlrpc::CreateUserRequest>("json").Deserialize("{\"avatar\":\"abc\"}", create));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: Typed stubs work end to end over "binary"
+    std::cout << "Test 6: User service over binary..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserService service(store);
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"binary"});
+        assert(service.Register(skeleton));
+
+        grlrpc::LocalChannel channel(methods);
+        grlrpc::ServiceStub<grlrpc::CreateUserMethod, grlrpc::GetUserMethod,
+                            grlrpc::BatchGetUsersMethod, grlrpc::SearchUsersMethod> stub(channel, "binary");
+        assert(stub.IsBound());
+
+        grlrpc::CreateUserResponse created;
+        assert(stub.Call<grlrpc::CreateUserMethod>(
+                   grlrpc::CreateUserRequest{"erin", "erin@example.com", 28, "img"}, created) ==
+               grlrpc::RpcStatus::SUCCESS);
+        assert(created.success);
+
+        grlrpc::GetUserResponse user;
+        assert(stub.Call<grlrpc::GetUserMethod>(grlrpc::GetUserRequest{created.user_id, true}, user) ==
+               grlrpc::RpcStatus::SUCCESS);
+        assert(user.found && user.name == "erin" && user.avatar == "img");
+
+        grlrpc::BatchGetUsersResponse batch;
+        assert(stub.Call<grlrpc::BatchGetUsersMethod>(
+                   grlrpc::BatchGetUsersRequest{{created.user_id, 999}, false}, batch) ==
+               grlrpc::RpcStatus::SUCCESS);
+        assert(batch.users.size() == 2 && batch.users[0].found && !batch.users[1].found);
+
+        grlrpc::SearchUsersResponse search;
+        assert(stub.Call<grlrpc::SearchUsersMethod>(grlrpc::SearchUsersRequest{"er", 10}, search) ==
+               grlrpc::RpcStatus::SUCCESS);
+        assert(search.users.size() == 1 && search.users[0].user_id == created.user_id);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,373 @@
+// GrlRPC User Watch Tests
+// Tests for: assembled responses match the typed serializers, resume and
+//            filtering, gaps, long-polling, WatchUsers over the service
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "serialization_framework.h"
+#include "user_service.h"
+#include "user_store.h"
+#include "user_type_serializers.h"
+#include "user_watch.h"
+
+namespace {
+
+grlrpc::WatchUsersResponse Watch(grlrpc::UserWatchHub& hub, const grlrpc::WatchUsersRequest& request,
+                                 const std::string& format = "binary") {
+    std::string payload;
+    assert(hub.Watch(request, format, payload));
+    grlrpc::WatchUsersResponse response;
+    grlrpc::ITypeSerializer<grlrpc::WatchUsersResponse>* serializer =
+        grlrpc::SerializerRegistry::Instance().GetTypeSerializer<grlrpc::WatchUsersResponse>(format);
+    assert(serializer && serializer->Deserialize(payload, response));
+    return response;
+}
+
+uint64_t CreateUser(grlrpc::UserStore& store, const std::string& name, const std::string& avatar = "") {
+    grlrpc::CreateUserRequest create;
+    create.name = name;
+    create.email = name + "@example.com";
+    create.age = 20;
+    create.avatar = avatar;
+    uint64_t id = 0;
+    assert(store.Create(create, 100, id) == grlrpc::UserStoreStatus::OK);
+    return id;
+}
+
+void Rename(grlrpc::UserStore& store, uint64_t id, const std::string& name) {
+    grlrpc::UpdateUserRequest update;
+    update.user_id = id;
+    update.name = name;
+    assert(store.Update(update, 200) == grlrpc::UserStoreStatus::OK);
+}
+
+} // namespace
+
+int main() {
+    grlrpc::RegisterBuiltinSerializers();
+    grlrpc::RegisterUserTypes();
+
+    // Test 1: Responses assembled from pre-encoded events equal the typed encoding
+    std::cout << "Test 1: Assembled responses..." << std::endl;
+    {
+        grlrpc::WatchUsersResponse response;
+        response.next_sequence = 77;
+        response.gap = true;
+        response.incarnation = 0x1122334455667788ULL;
+        for (uint64_t i = 1; i <= 3; ++i) {
+            grlrpc::UserChangeEvent event;
+            event.user_id = i * 10;
+            event.sequence = 74 + i;
+            event.created = i == 1;
+            event.name = "n\"" + std::to_string(i);
+            event.email = "e" + std::to_string(i);
+            event.age = static_cast<int32_t>(i);
+            event.updated_at_ms = -5;
+            event.avatar_changed = i == 2;
+            response.events.push_back(event);
+        }
+        for (const std::string format : {"binary", "json"}) {
+            for (size_t count : {0, 3}) {
+                grlrpc::WatchUsersResponse expected = response;
+                expected.events.resize(count);
+                std::vector<std::string> encoded(count);
+                std::vector<std::string_view> views;
+                for (size_t i = 0; i < count; ++i) {
+                    assert(grlrpc::EncodeUserChangeEvent(format, expected.events[i], encoded[i]));
+                    views.emplace_back(encoded[i]);
+                }
+                std::string assembled;
+                std::string typed;
+                assert(grlrpc::AssembleWatchUsersResponse(format, views, 77, true, response.incarnation,
+                                                          assembled));
+                auto* serializer = grlrpc::SerializerRegistry::Instance()
+                    .GetTypeSerializer<grlrpc::WatchUsersResponse>(format);
+                assert(serializer->Serialize(expected, typed));
+                assert(assembled == typed);
+
+                grlrpc::WatchUsersResponse decoded;
+                assert(serializer->Deserialize(assembled, decoded));
+                assert(decoded.events.size() == count && decoded.next_sequence == 77 && decoded.gap);
+                assert(decoded.incarnation == response.incarnation);
+                if (count) {
+                    assert(decoded.events[0].name == "n\"1" && decoded.events[0].created);
+                    assert(decoded.events[1].avatar_changed && decoded.events[2].updated_at_ms == -5);
+                }
+            }
+        }
+        std::string out;
+        assert(!grlrpc::EncodeUserChangeEvent("xml", response.events[0], out));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 2: Watchers resume from a sequence and filter by user id
+    std::cout << "Test 2: Resume and filter..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserWatchHub hub(store, 64);
+        uint64_t alice = CreateUser(store, "alice", "pic");
+        uint64_t bob = CreateUser(store, "bob");
+        Rename(store, alice, "alicia");
+        assert(hub.GetLastSequence() == 3);
+
+        grlrpc::WatchUsersRequest request;
+        grlrpc::WatchUsersResponse response = Watch(hub, request, "json");
+        assert(response.events.size() == 3 && response.next_sequence == 3 && !response.gap);
+        assert(response.events[0].created && response.events[0].avatar_changed);
+        assert(response.events[0].user_id == alice && response.events[0].sequence == 1);
+        assert(response.events[1].user_id == bob && !response.events[1].avatar_changed);
+        assert(!response.events[2].created && response.events[2].name == "alicia");
+        assert(response.events[2].email == "alice@example.com" && response.events[2].updated_at_ms == 200);
+
+        request.after_sequence = 1;
+        request.max_events = 1;
+        response = Watch(hub, request);
+        assert(response.events.size() == 1 && response.events[0].sequence == 2);
+        assert(response.next_sequence == 2);
+
+        request.after_sequence = 0;
+        request.max_events = 100;
+        request.user_ids = {alice, 999};
+        response = Watch(hub, request);
+        assert(response.events.size() == 2 && response.next_sequence == 3);
+        assert(response.events[0].sequence == 1 && response.events[1].sequence == 3);
+
+        // Filtered-out events still move the resume point
+        request.user_ids = {bob};
+        request.after_sequence = 2;
+        response = Watch(hub, request);
+        assert(response.events.empty() && response.next_sequence == 3);
+
+        // max_events = 0 only reports where the stream is
+        request.user_ids.clear();
+        request.after_sequence = 0;
+        request.max_events = 0;
+        response = Watch(hub, request);
+        assert(response.events.empty() && response.next_sequence == 3);
+
+        // Restored records are recovery, not changes
+        grlrpc::UserRecord record;
+        record.user_id = 50;
+        record.name = "restored";
+        store.Restore(record, true);
+        assert(hub.GetLastSequence() == 3);
+
+        std::string payload;
+        assert(!hub.Watch(request, "xml", payload));
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 3: Watchers that fall behind the ring are told about the gap
+    std::cout << "Test 3: Gaps..." << std::endl;
+    {
+        grlrpc::UserStore store(2, 16);
+        grlrpc::UserWatchHub hub(store, 8);
+        uint64_t id = CreateUser(store, "carl");
+        for (int i = 0; i < 19; ++i) {
+            Rename(store, id, "carl" + std::to_string(i));
+        }
+        grlrpc::WatchUsersRequest request;
+        request.after_sequence = 5;
+        grlrpc::WatchUsersResponse response = Watch(hub, request);
+        assert(response.gap && response.events.size() == 8);
+        assert(response.events.front().sequence == 13 && response.next_sequence == 20);
+        assert(response.events.back().name == "carl18");
+
+        assert(response.incarnation != 0 && response.incarnation == hub.GetIncarnation());
+        request.after_sequence = 12;
+        request.incarnation = response.incarnation;
+        response = Watch(hub, request, "json");
+        assert(!response.gap && response.events.size() == 8);
+
+        // A resume point from before a restart
+        request.after_sequence = 1000;
+        response = Watch(hub, request);
+        assert(response.gap && response.events.size() == 8 && response.next_sequence == 20);
+
+        // ...which the restarted hub has already passed: only the
+        // incarnation tells the watcher that sequences 1-5 are not the ones it saw
+        grlrpc::UserStore restarted_store(2, 16);
+        grlrpc::UserWatchHub restarted(restarted_store, 8);
+        uint64_t other = CreateUser(restarted_store, "dana");
+        for (int i = 0; i < 9; ++i) {
+            Rename(restarted_store, other, "dana" + std::to_string(i));
+        }
+        assert(restarted.GetIncarnation() != hub.GetIncarnation());
+        for (const char* format : {"binary", "json"}) {
+            request.after_sequence = 5;
+            request.incarnation = hub.GetIncarnation();
+            response = Watch(restarted, request, format);
+            assert(response.gap && response.events.size() == 8);
+            assert(response.events.front().sequence == 3 && response.next_sequence == 10);
+            assert(response.incarnation == restarted.GetIncarnation());
+
+            request.incarnation = response.incarnation;
+            response = Watch(restarted, request, format);
+            assert(!response.gap && response.events.size() == 5);
+
+            // Still reported when no events are asked for
+            request.incarnation = hub.GetIncarnation();
+            request.max_events = 0;
+            response = Watch(restarted, request, format);
+            assert(response.gap && response.events.empty() && response.next_sequence == 10);
+            request.max_events = 256;
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 4: Long-polling watchers wake on matching writes and time out otherwise
+    std::cout << "Test 4: Long-polling..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 16);
+        grlrpc::UserWatchHub hub(store);
+        uint64_t dora = CreateUser(store, "dora");
+        uint64_t ed = CreateUser(store, "ed");
+
+        grlrpc::WatchUsersRequest request;
+        request.after_sequence = hub.GetLastSequence();
+        request.user_ids = {ed};
+        request.wait_ms = 10000;
+        std::atomic<bool> done{false};
+        grlrpc::WatchUsersResponse response;
+        std::thread watcher([&] {
+            response = Watch(hub, request);
+            done = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        Rename(store, dora, "dot");   // filtered out: keeps waiting
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        assert(!done);
+        Rename(store, ed, "eddie");
+        watcher.join();
+        assert(response.events.size() == 1 && response.events[0].name == "eddie");
+        assert(response.next_sequence == 4);
+
+        request.after_sequence = 4;
+        request.wait_ms = 30;
+        auto start = std::chrono::steady_clock::now();
+        response = Watch(hub, request);
+        assert(response.events.empty() && response.next_sequence == 4);
+        assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+
+        // Closing releases waiters at once
+        request.wait_ms = 10000;
+        std::thread closed([&] { Watch(hub, request); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        hub.Close();
+        closed.join();
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 5: Concurrent writers and watchers see every event once, in order
+    std::cout << "Test 5: Concurrent writers and watchers..." << std::endl;
+    {
+        grlrpc::UserStore store(4, 64);
+        grlrpc::UserWatchHub hub(store, 1 << 16);
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < 8; ++i) {
+            ids.push_back(CreateUser(store, "w" + std::to_string(i)));
+        }
+        uint64_t start = hub.GetLastSequence();
+        constexpr int kRounds = 500;
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&, w] {
+                for (int round = 0; round < kRounds; ++round) {
+                    for (size_t i = w; i < ids.size(); i += 2) {
+                        Rename(store, ids[i], "r" + std::to_string(round));
+                    }
+                }
+            });
+        }
+        std::atomic<uint64_t> wrong{0};
+        std::vector<std::thread> watchers;
+        for (int r = 0; r < 3; ++r) {
+            watchers.emplace_back([&, r] {
+                grlrpc::WatchUsersRequest request;
+                request.after_sequence = start;
+                request.wait_ms = 1000;
+                if (r == 2) {
+                    request.user_ids = {ids[3]};
+                }
+                std::vector<int> last_round(ids.size() + 1, -1);
+                size_t expected = r == 2 ? kRounds : kRounds * ids.size();
+                size_t received = 0;
+                while (received < expected) {
+                    grlrpc::WatchUsersResponse response = Watch(hub, request, r == 0 ? "json" : "binary");
+                    for (const auto& event : response.events) {
+                        int round = std::stoi(event.name.substr(1));
+                        // Each user's renames arrive in the order they were made
+                        if (event.sequence <= request.after_sequence || round != last_round[event.user_id] + 1 ||
+                            response.gap) {
+                            ++wrong;
+                        }
+                        last_round[event.user_id] = round;
+                        request.after_sequence = event.sequence;
+                        ++received;
+                    }
+                    request.after_sequence = response.next_sequence;
+                }
+                if (received != expected) {
+                    ++wrong;
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        for (auto& watcher : watchers) {
+            watcher.join();
+        }
+        assert(wrong == 0);
+        assert(hub.GetDeliveredCount() == 2 * kRounds * ids.size() + kRounds);
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    // Test 6: WatchUsers through the service
+    std::cout << "Test 6: WatchUsers method..." << std::endl;
+    {
+        grlrpc::UserStore store(4);
+        grlrpc::UserService plain(store);
+        grlrpc::MethodTable plain_methods;
+        grlrpc::ServiceSkeleton plain_skeleton(plain_methods, {"json"});
+        assert(plain.Register(plain_skeleton));
+        assert(!plain_methods.Find(grlrpc::WatchUsersMethod::kId));
+
+        grlrpc::UserWatchHub hub(store);
+        grlrpc::UserService service(store);
+        service.SetWatchHub(&hub);
+        grlrpc::MethodTable methods;
+        grlrpc::ServiceSkeleton skeleton(methods, {"json", "binary"});
+        assert(service.Register(skeleton));
+        const grlrpc::MethodEntry* entry = methods.Find(grlrpc::WatchUsersMethod::kId);
+        assert(entry && !entry->options.inline_safe);
+
+        grlrpc::LocalChannel channel(methods);
+        for (const char* format : {"json", "binary"}) {
+            grlrpc::ServiceStub<grlrpc::CreateUserMethod, grlrpc::WatchUsersMethod> stub(channel, format);
+            assert(stub.IsBound());
+            uint64_t before = hub.GetLastSequence();
+            grlrpc::CreateUserRequest create;
+            create.name = std::string("fay-") + format;
+            grlrpc::CreateUserResponse created;
+            assert(stub.Call<grlrpc::CreateUserMethod>(create, created) == grlrpc::RpcStatus::SUCCESS);
+
+            grlrpc::WatchUsersRequest request;
+            request.after_sequence = before;
+            grlrpc::WatchUsersResponse response;
+            assert(stub.Call<grlrpc::WatchUsersMethod>(request, response) == grlrpc::RpcStatus::SUCCESS);
+            assert(response.events.size() == 1 && response.events[0].user_id == created.user_id);
+            assert(response.events[0].name == create.name && response.next_sequence == before + 1);
+        }
+    }
+    std::cout << "  PASSED" << std::endl;
+
+    std::cout << "\nAll tests passed!" << std::endl;
+    return 0;
+}